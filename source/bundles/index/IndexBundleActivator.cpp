@@ -419,7 +419,8 @@ IndexBundleActivator::createDocumentManager_() const
             dir,
             config_->indexSchema_,
             config_->encoding_,
-            config_->documentCacheNum_
+            config_->documentCacheNum_,
+            config_->enable_column_doc_store_
         )
     );
 
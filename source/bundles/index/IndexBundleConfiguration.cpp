@@ -16,6 +16,11 @@ IndexBundleConfiguration::IndexBundleConfiguration(const std::string& collection
     , isAutoRebuild_(false)
     , enable_parallel_searching_(false)
     , enable_forceget_doc_(false)
+    , enable_column_doc_store_(false)
+    , distSearchDeadline_(0)
+    , distSearchHedgeDelay_(0)
+    , distSearchPrefetchSummaryNum_(20)
+    , distSearchResultTTL_(30)
     , isMasterAggregator_(false)
     , isWorkerNode_(false)
     , encoding_(izenelib::util::UString::UNKNOWN)
@@ -158,6 +158,10 @@ public:
     /// @brief force get document even if it has been deleted
     bool enable_forceget_doc_;
 
+    /// @brief store each document property in a separate column,
+    /// so that getting a few properties would not read the whole document
+    bool enable_column_doc_store_;
+
     /// @brief document cache number
     size_t documentCacheNum_;
 
@@ -176,6 +180,24 @@ public:
     /// @brief master search cache number
     size_t masterSearchCacheNum_;
 
+    /// @brief the milliseconds master waits for the search results of workers,
+    ///        the workers not responded are left out of a partial result.
+    ///        0 means waiting for all workers.
+    size_t distSearchDeadline_;
+
+    /// @brief the milliseconds after which the search request is sent again
+    ///        for the workers not responded, 0 means never.
+    size_t distSearchHedgeDelay_;
+
+    /// @brief the workers attach the summary of their top hits to the search
+    ///        result if the page ends within this number, so that master
+    ///        needs no more request for the summary. 0 means never.
+    size_t distSearchPrefetchSummaryNum_;
+
+    /// @brief the seconds a worker keeps the search result of a query for
+    ///        the requests of its next pages, 0 means not kept.
+    time_t distSearchResultTTL_;
+
     /// @brief top results number
     size_t topKNum_;
 
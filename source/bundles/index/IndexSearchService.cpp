@@ -5,20 +5,101 @@
 #include <aggregator-manager/SearchWorker.h>
 
 #include <common/SearchCache.h>
+#include <common/DistTermStatsCache.h>
 #include <common/SFLogger.h>
 #include <common/type_defs.h>
 
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include <algorithm> // max
+
 namespace sf1r
 {
 
 const static int CACHE_THRESHOLD = 100;
 
+// the max number of dist search requests running at the same time,
+// per cpu core, the other requests are queued in pool.
+const static unsigned int DIST_SEARCH_THREAD_NUM_PER_CPU = 4;
+
+namespace
+{
+
+/**
+ * the search results of workers, shared with the request threads,
+ * which may still be running after the deadline.
+ */
+struct DistSearchGatherState
+{
+    boost::mutex mutex;
+    boost::condition_variable cond;
+    std::map<workerid_t, KeywordSearchResult> results;
+
+    // set when the results are gathered, so that the requests
+    // still queued in pool are not sent any more.
+    bool isExpired;
+
+    DistSearchGatherState() : isExpired(false) {}
+};
+
+void requestWorkerSearchResult(
+    boost::shared_ptr<SearchAggregator> aggregator,
+    boost::shared_ptr<DistSearchGatherState> state,
+    KeywordSearchActionItem actionItem,
+    KeywordSearchResult resultItem,
+    uint32_t requestIndex,
+    workerid_t workerId)
+{
+    {
+        boost::unique_lock<boost::mutex> lock(state->mutex);
+        if (state->isExpired)
+            return;
+    }
+
+    bool ret = false;
+    try
+    {
+        ret = aggregator->singleRequest(actionItem.collectionName_, requestIndex,
+            "getDistSearchResult", actionItem, resultItem, workerId);
+    }
+    catch (const std::exception& e)
+    {
+        LOG(ERROR) << "request search result from worker " << workerId << " failed: " << e.what();
+    }
+
+    if (!ret && resultItem.error_.empty())
+    {
+        resultItem.error_ = "request search result from worker failed.";
+    }
+
+    boost::unique_lock<boost::mutex> lock(state->mutex);
+    std::map<workerid_t, KeywordSearchResult>::iterator it = state->results.find(workerId);
+    // the first successful result wins, as the request may have been sent twice
+    if (it == state->results.end())
+    {
+        state->results[workerId].swap(resultItem);
+        state->results[workerId].error_.swap(resultItem.error_);
+    }
+    else if (!it->second.error_.empty() && resultItem.error_.empty())
+    {
+        it->second.swap(resultItem);
+        it->second.error_.clear();
+    }
+    state->cond.notify_all();
+}
+
+}
+
 IndexSearchService::IndexSearchService(IndexBundleConfiguration* config)
     : bundleConfig_(config)
     , searchMerger_(NULL)
     , searchCache_(new SearchCache(bundleConfig_->masterSearchCacheNum_,
                                     bundleConfig_->refreshCacheInterval_,
                                     bundleConfig_->refreshSearchCache_))
+    , termStatsCache_(new DistTermStatsCache(bundleConfig_->masterSearchCacheNum_))
+    , distSearchPool_(std::max(boost::thread::hardware_concurrency(), 1U) * DIST_SEARCH_THREAD_NUM_PER_CPU)
 {
     ro_index_ = 0;
 }
@@ -41,6 +122,30 @@ void IndexSearchService::OnUpdateSearchCache()
 {
     LOG(INFO) << "clearing master search cache.";
     searchCache_->clear();
+    termStatsCache_->clear();
+}
+
+void IndexSearchService::OnUpdateTermStats()
+{
+    LOG(INFO) << "invalidating master term statistics.";
+    termStatsCache_->clear();
+}
+
+void IndexSearchService::OnInvalidateSearchCache(const std::vector<std::string>& properties)
+{
+    LOG(INFO) << "invalidating master search cache on " << properties.size()
+              << " properties.";
+    searchCache_->invalidate(properties);
+    termStatsCache_->invalidate(properties);
+}
+
+void IndexSearchService::getSearchCacheStats(CacheStats& masterStats, CacheStats& workerStats) const
+{
+    masterStats = searchCache_->getStats();
+    if (searchWorker_)
+    {
+        workerStats = searchWorker_->getSearchCacheStats();
+    }
 }
 
 bool IndexSearchService::getSearchResult(
@@ -71,14 +176,30 @@ bool IndexSearchService::getSearchResult(
 
     if (actionItem.searchingMode_.mode_ == SearchingMode::WAND)
     {
-        distResultItem.distSearchInfo_.option_ = DistKeywordSearchInfo::OPTION_GATHER_INFO;
-        bool ret = ro_searchAggregator_->distributeRequest<KeywordSearchActionItem, DistKeywordSearchInfo>(
-            actionItem.collectionName_, request_index, "getDistSearchInfo", actionItem, distResultItem.distSearchInfo_);
+        // the term statistics are gathered from workers only if not cached
+        QueryIdentity statsKey;
+        DistTermStatsCache::makeKey(actionItem, statsKey);
 
-        if (!ret)
+        if (termStatsCache_->get(statsKey, distResultItem.distSearchInfo_))
         {
-            LOG(ERROR) << "get dist search info error.";
-            return false;
+            LOG(INFO) << "term statistics cache hit, no need gather dist search info.";
+        }
+        else
+        {
+            GenerationSnapshot snapshot;
+            termStatsCache_->takeSnapshot(statsKey, snapshot);
+
+            distResultItem.distSearchInfo_.option_ = DistKeywordSearchInfo::OPTION_GATHER_INFO;
+            bool ret = ro_searchAggregator_->distributeRequest<KeywordSearchActionItem, DistKeywordSearchInfo>(
+                actionItem.collectionName_, request_index, "getDistSearchInfo", actionItem, distResultItem.distSearchInfo_);
+
+            if (!ret)
+            {
+                LOG(ERROR) << "get dist search info error.";
+                return false;
+            }
+
+            termStatsCache_->set(statsKey, distResultItem.distSearchInfo_, snapshot);
         }
 
         distResultItem.distSearchInfo_.option_ = DistKeywordSearchInfo::OPTION_CARRIED_INFO;
@@ -102,11 +223,21 @@ bool IndexSearchService::getSearchResult(
     if (!searchCache_->get(identity, resultItem))
     {
         LOG(INFO) << "cache miss, begin do search";
+        GenerationSnapshot snapshot;
+        searchCache_->takeSnapshot(identity, snapshot);
+
         // Get and aggregate keyword search results from mutliple nodes
         distResultItem.setStartCount(actionItem.pageInfo_);
 
-        ret = ro_searchAggregator_->distributeRequest(
-                actionItem.collectionName_, request_index, "getDistSearchResult", actionItem, distResultItem);
+        if (bundleConfig_->distSearchDeadline_ > 0)
+        {
+            ret = getDistSearchResultInDeadline_(actionItem, request_index, distResultItem);
+        }
+        else
+        {
+            ret = ro_searchAggregator_->distributeRequest(
+                    actionItem.collectionName_, request_index, "getDistSearchResult", actionItem, distResultItem);
+        }
         if (!ret)
         {
             LOG(ERROR) << "got dist search result failed.";
@@ -186,8 +317,9 @@ bool IndexSearchService::getSearchResult(
                     actionItem.collectionName_, request_index, "getSummaryMiningResult", requestGroup, resultItem);
             }
         }
-        if (searchCache_ && !resultItem.topKDocs_.empty() && interval_ms > CACHE_THRESHOLD)
-            searchCache_->set(identity, resultItem);
+        if (searchCache_ && !resultItem.topKDocs_.empty() && interval_ms > CACHE_THRESHOLD &&
+            !resultItem.distSearchInfo_.isPartial_)
+            searchCache_->set(identity, resultItem, snapshot);
     }
     else
     {
@@ -236,6 +368,88 @@ bool IndexSearchService::getSearchResult(
     return true;
 }
 
+bool IndexSearchService::getDistSearchResultInDeadline_(
+    const KeywordSearchActionItem& actionItem,
+    uint32_t request_index,
+    KeywordSearchResult& distResultItem)
+{
+    const std::vector<shardid_t>& shardList = bundleConfig_->col_shard_info_.shardList_;
+    if (shardList.empty())
+    {
+        LOG(ERROR) << "no shard for dist search.";
+        return false;
+    }
+
+    boost::shared_ptr<DistSearchGatherState> state(new DistSearchGatherState);
+    for (size_t i = 0; i < shardList.size(); ++i)
+    {
+        distSearchPool_.schedule(boost::bind(&requestWorkerSearchResult,
+            ro_searchAggregator_, state, actionItem, distResultItem, request_index, shardList[i]));
+    }
+
+    const boost::system_time startTime = boost::get_system_time();
+    const boost::system_time deadline = startTime +
+        boost::posix_time::milliseconds(bundleConfig_->distSearchDeadline_);
+    const boost::system_time hedgeTime = startTime +
+        boost::posix_time::milliseconds(bundleConfig_->distSearchHedgeDelay_);
+    bool isHedged = bundleConfig_->distSearchHedgeDelay_ == 0 ||
+        bundleConfig_->distSearchHedgeDelay_ >= bundleConfig_->distSearchDeadline_;
+
+    net::aggregator::WorkerResults<KeywordSearchResult> workerResults;
+    {
+        boost::unique_lock<boost::mutex> lock(state->mutex);
+        while (state->results.size() < shardList.size())
+        {
+            if (!isHedged)
+            {
+                if (!state->cond.timed_wait(lock, hedgeTime))
+                {
+                    // send the request again for the slow workers,
+                    // the aggregator may choose another replica of them.
+                    isHedged = true;
+                    for (size_t i = 0; i < shardList.size(); ++i)
+                    {
+                        if (state->results.find(shardList[i]) != state->results.end())
+                            continue;
+                        LOG(INFO) << "hedged search request for worker: " << (uint32_t)shardList[i];
+                        distSearchPool_.schedule(boost::bind(&requestWorkerSearchResult,
+                            ro_searchAggregator_, state, actionItem, distResultItem, request_index, shardList[i]));
+                    }
+                }
+                continue;
+            }
+
+            if (!state->cond.timed_wait(lock, deadline))
+                break;
+        }
+        state->isExpired = true;
+
+        for (std::map<workerid_t, KeywordSearchResult>::const_iterator it = state->results.begin();
+            it != state->results.end(); ++it)
+        {
+            workerResults.add(it->first, it->second);
+        }
+    }
+
+    if (workerResults.size() == 0)
+    {
+        LOG(ERROR) << "no worker responded before the deadline: " << bundleConfig_->distSearchDeadline_;
+        return false;
+    }
+
+    searchMerger_->getDistSearchResult(workerResults, distResultItem);
+    if (!distResultItem.error_.empty())
+        return false;
+
+    if (workerResults.size() < shardList.size())
+    {
+        LOG(WARNING) << "dist search deadline expired, " << workerResults.size()
+            << " of " << shardList.size() << " workers responded.";
+        distResultItem.distSearchInfo_.isPartial_ = true;
+    }
+    return true;
+}
+
 bool IndexSearchService::getDocumentsByIds(
     const GetDocumentsByIdsActionItem& actionItem,
     RawTextResultFromSIA& resultItem
@@ -7,6 +7,7 @@
 #include <common/sf1_serialization_types.h>
 #include <common/type_defs.h>
 #include <common/Status.h>
+#include <common/PropertyGenerations.h>
 
 #include <query-manager/SearchKeywordOperation.h>
 #include <query-manager/ActionItem.h>
@@ -14,12 +15,14 @@
 #include <util/osgi/IService.h>
 
 #include <boost/shared_ptr.hpp>
+#include <boost/threadpool.hpp>
 
 namespace sf1r
 {
 using namespace net::aggregator;
 
 class SearchCache;
+class DistTermStatsCache;
 class SearchMerger;
 class SearchWorker;
 class IndexSearchService : public ::izenelib::osgi::IService
@@ -35,6 +38,20 @@ public:
 
     void OnUpdateSearchCache();
 
+    void OnInvalidateSearchCache(const std::vector<std::string>& properties);
+
+    /**
+     * called when the index of any worker is updated,
+     * it invalidates the cached term statistics.
+     */
+    void OnUpdateTermStats();
+
+    /**
+     * get the statistics of the master search cache and
+     * the worker search cache.
+     */
+    void getSearchCacheStats(CacheStats& masterStats, CacheStats& workerStats) const;
+
 public:
     bool getSearchResult(KeywordSearchActionItem& actionItem, KeywordSearchResult& resultItem);
 
@@ -46,6 +63,17 @@ public:
 
     uint32_t getKeyCount(const std::string& collection, const std::string& property_name);
 
+private:
+    /**
+     * send the search request to each worker, and merge the results
+     * responded before the deadline, the result is partial if any worker
+     * is missing.
+     */
+    bool getDistSearchResultInDeadline_(
+        const KeywordSearchActionItem& actionItem,
+        uint32_t request_index,
+        KeywordSearchResult& distResultItem);
+
 private:
     IndexBundleConfiguration* bundleConfig_;
     boost::shared_ptr<SearchAggregator> searchAggregator_;
@@ -54,8 +82,14 @@ private:
     boost::shared_ptr<SearchWorker> searchWorker_;
 
     boost::scoped_ptr<SearchCache> searchCache_; // for Master Node
+    boost::scoped_ptr<DistTermStatsCache> termStatsCache_; // for Master Node
     boost::atomic<uint32_t> ro_index_;
 
+    // the pool sending dist search requests to workers under the deadline,
+    // it is declared last, so that it waits for the running requests
+    // before the other members are destroyed.
+    boost::threadpool::pool distSearchPool_;
+
     friend class SearchWorkerController;
     friend class IndexBundleActivator;
     friend class MiningBundleActivator;
@@ -1,11 +1,14 @@
 #include "MiningBundleActivator.h"
 
 #include <bundles/index/IndexSearchService.h>
+#include <aggregator-manager/SearchWorker.h>
+#include <common/SearchCache.h>
 
 #include <boost/shared_ptr.hpp>
 #include <boost/filesystem.hpp>
 
 #include <memory> // for auto_ptr
+#include <set>
 
 namespace bfs = boost::filesystem;
 
@@ -163,6 +166,17 @@ MiningBundleActivator::createMiningManager_(IndexSearchService* indexService) co
     if(!succ)
     {
         ret.reset();
+        return ret;
+    }
+
+    const ProductRankingConfig& rankConfig =
+        config_->mining_schema_.product_ranking_config;
+    if (rankConfig.isEnable)
+    {
+        std::set<std::string> rankProps;
+        rankConfig.getPropNames(rankProps);
+        indexService->searchWorker_->setProductRankProperties(rankProps);
+        indexService->searchCache_->setProductRankProperties(rankProps);
     }
     return ret;
 }
@@ -9,6 +9,7 @@
 #include <common/NumericRangePropertyTable.h>
 #include <common/RTypeStringPropTable.h>
 #include <common/ScdWriter.h>
+#include <common/ScdParallelParser.h>
 #include <document-manager/DocumentManager.h>
 #include <log-manager/LogServerRequest.h>
 #include <log-manager/LogServerConnection.h>
@@ -54,8 +55,16 @@ const std::string DOCID("DOCID");
 const std::string DATE("DATE");
 const size_t UPDATE_BUFFER_CAPACITY = 8192;
 //PropertyConfig tempPropertyConfig;
-const std::size_t INDEX_THREAD = 1;
-const std::size_t INDEX_THREAD_QUEUE = UPDATE_BUFFER_CAPACITY*10;
+/** the max number of threads to parse one scd file */
+const std::size_t SCD_PARSE_THREAD = 4;
+/** the max number of scd chunks parsed but not indexed yet */
+const std::size_t SCD_PARSE_WINDOW = SCD_PARSE_THREAD * 4;
+/** the number of threads to prepare docs */
+const std::size_t PREPARE_THREAD = 4;
+/** the number of consecutive docs prepared by one thread */
+const std::size_t DOC_BLOCK_SIZE = 256;
+/** the max number of blocks not indexed yet */
+const std::size_t PENDING_BLOCK = PREPARE_THREAD * 4;
 
 }
 
@@ -72,6 +81,9 @@ IndexWorker::IndexWorker(
     , numUpdatedDocs_(0)
     , totalSCDSizeSinceLastBackup_(0)
     , distribute_req_hooker_(DistributeRequestHooker::get())
+    , doc_preparer_(PREPARE_THREAD,
+                    boost::bind(&IndexWorker::prepareDocBlock_, this, _1),
+                    boost::bind(&IndexWorker::indexDocBlock_, this, _1))
 {
     bool hasDateInConfig = false;
     const IndexBundleSchema& indexSchema = bundleConfig_->indexSchema_;
@@ -104,15 +116,7 @@ IndexWorker::IndexWorker(
     scd_writer_->SetFlushLimit(500);
     scheduleOptimizeTask();
 
-    index_thread_status_ = new bool[INDEX_THREAD];
-    asynchronousTasks_.resize(INDEX_THREAD);
-    for(size_t i = 0; i < INDEX_THREAD; ++i)
-    {
-        asynchronousTasks_[i] = new izenelib::util::concurrent_queue<IndexDocInfo>(INDEX_THREAD_QUEUE);
-        boost::thread* worker_thread = new boost::thread(boost::bind(&IndexWorker::indexSCDDocFunc, this, i));
-        index_thread_workers_.push_back(worker_thread);
-    }
-    updateBuffer_.resize(INDEX_THREAD);
+    updateBuffer_.resize(1);
     is_real_time_ = false;
 }
 
@@ -121,17 +125,6 @@ IndexWorker::~IndexWorker()
     delete scd_writer_;
     if (!optimizeJobDesc_.empty())
         izenelib::util::Scheduler::removeJob(optimizeJobDesc_);
-
-    for(size_t i = 0; i < index_thread_workers_.size(); ++i)
-    {
-        index_thread_workers_[i]->interrupt();
-        asynchronousTasks_[i]->push(IndexDocInfo());
-        if (boost::this_thread::get_id() != index_thread_workers_[i]->get_id())
-            index_thread_workers_[i]->join();
-        delete index_thread_workers_[i];
-        delete asynchronousTasks_[i];
-    }
-    delete[] index_thread_status_;
 }
 
 void IndexWorker::HookDistributeRequestForIndex(int hooktype, const std::string& reqdata, bool& result)
@@ -383,7 +376,7 @@ bool IndexWorker::buildCollection(unsigned int numdoc, const std::vector<std::st
     is_real_time_ = inc_supported_index_manager_.isRealTime();
 
     if (is_real_time_)
-        LOG(INFO) << "indexing in single thread while in real time mode";
+        LOG(INFO) << "indexing in doc id order while in real time mode";
 
     {
         DirectoryGuard dirGuard(directoryRotator_.currentDirectory().get());
@@ -616,6 +609,7 @@ bool IndexWorker::rebuildCollection(boost::shared_ptr<DocumentManager>& document
 
         // interrupt when closing the process
         boost::this_thread::interruption_point();
+        JobScheduler::preemptionPoint();
     }
 
     //flushUpdateBuffer_(0);
@@ -666,6 +660,7 @@ bool IndexWorker::optimizeIndex()
     }
 
     inc_supported_index_manager_.optimize(false);
+    notifyMasterTermStats_();
 
     //flush();
 
@@ -724,6 +719,7 @@ void IndexWorker::lazyOptimizeIndex(int calltype)
 
         LOG(INFO) << "optimizeIndex cron job begin running: " << optimizeJobDesc_;
         inc_supported_index_manager_.optimize(false);
+        notifyMasterTermStats_();
 
         DISTRIBUTE_WRITE_FINISH(true);
     }
@@ -801,6 +797,7 @@ bool IndexWorker::createDocument(const Value& documentValue)
     bool ret = insertDoc_(0, document, timestamp, true);//not support filter, there is no rtype property in document;
     if (ret)
     {
+        notifyMasterTermStats_();
         doMining_(reqlog.timestamp);
     }
     //flush();
@@ -929,9 +926,17 @@ bool IndexWorker::updateDocument(const Value& documentValue)
     inc_supported_index_manager_.preProcessForAPI();
 
     bool ret = updateDoc_(0, oldId, document, old_rtype_doc, timestamp, updateType, true);
+    if (ret && (updateType == IndexWorker::RTYPE || updateType == IndexWorker::REPLACE))
+    {
+        ///the docid is not changed, so only the cache entries
+        ///depending on the updated properties are invalidated
+        std::vector<std::string> updatedProperties;
+        getUpdatedProperties_(scddoc, updatedProperties);
+        searchWorker_->invalidateCache(updatedProperties);
+    }
     if (ret && (updateType != IndexWorker::RTYPE))
     {
-        if (!bundleConfig_->enable_forceget_doc_)
+        if (!bundleConfig_->enable_forceget_doc_ && updateType != IndexWorker::REPLACE)
         {
             searchWorker_->clearSearchCache();
             ///clear filter cache because of * queries:
@@ -939,6 +944,10 @@ bool IndexWorker::updateDocument(const Value& documentValue)
             ///together with AllDocumentIterator
             searchWorker_->clearFilterCache();
         }
+        else
+        {
+            notifyMasterTermStats_();
+        }
         doMining_(reqlog.timestamp);
     }
 
@@ -1137,6 +1146,10 @@ bool IndexWorker::destroyDocument(const Value& documentValue)
             ///together with AllDocumentIterator
             searchWorker_->clearFilterCache();
         }
+        else
+        {
+            notifyMasterTermStats_();
+        }
         doMining_(reqlog.timestamp);
     }
 
@@ -1252,7 +1265,7 @@ bool IndexWorker::doBuildCollection_(
     }
     else
     {
-        if (!insertOrUpdateSCD_(parser, scdType, numdoc, timestamp_fromscd))
+        if (!insertOrUpdateSCD_(fileName, scdType, numdoc, timestamp_fromscd))
             return false;
     }
     searchWorker_->reset_all_property_cache();
@@ -1262,67 +1275,124 @@ bool IndexWorker::doBuildCollection_(
     return true;
 }
 
-static void setIndexThreadStatus(bool* status)
+void IndexWorker::prepareDocBlock_(IndexDocBlock& block)
 {
-    *status = true;
-}
+    const std::size_t docNum = block.docInfos.size();
+    block.documents.resize(docNum);
+    block.oldRTypeDocs.resize(docNum);
+    block.timestamps.resize(docNum);
+    block.isPrepared.resize(docNum);
 
-void IndexWorker::indexSCDDocFunc(int workerid)
-{
-    Document document;
-    Document old_rtype_doc;
-
-    try{
-
-    while (true)
+    for (std::size_t i = 0; i < docNum; ++i)
     {
-        IndexDocInfo workerdata;
-        index_thread_status_[workerid] = false;
-
-        asynchronousTasks_[workerid]->pop(workerdata,
-            boost::bind(&setIndexThreadStatus, index_thread_status_ + workerid));
+        const IndexDocInfo& docInfo = block.docInfos[i];
+        block.timestamps[i] = docInfo.timestamp;
 
-        if (!workerdata.docptr && (workerdata.scdType == NOT_SCD))
-        {
-            flushUpdateBuffer_(workerid);
-            index_thread_status_[workerid] = false;
-            boost::this_thread::interruption_point();
-            continue;
-        }
-        boost::this_thread::interruption_point();
+        block.isPrepared[i] = prepareDocument_(*docInfo.docptr,
+            block.documents[i], block.oldRTypeDocs[i],
+            docInfo.oldDocId, docInfo.newDocId, block.timestamps[i],
+            docInfo.updateType, docInfo.scdType);
+    }
+}
 
-        time_t new_timestamp = workerdata.timestamp;
-        document.clear();
-        old_rtype_doc.clear();
+void IndexWorker::indexDocBlock_(IndexDocBlock& block)
+{
+    for (std::size_t i = 0; i < block.docInfos.size(); ++i)
+    {
+        const IndexDocInfo& docInfo = block.docInfos[i];
+        pending_docids_.erase(docInfo.oldDocId);
+        pending_docids_.erase(docInfo.newDocId);
 
-        if (!prepareDocument_(*(workerdata.docptr), document, old_rtype_doc,
-                workerdata.oldDocId, workerdata.newDocId,
-                new_timestamp, workerdata.updateType, workerdata.scdType))
+        if (!block.isPrepared[i])
             continue;
 
-        if (workerdata.scdType == INSERT_SCD || workerdata.oldDocId == 0)
+        if (docInfo.scdType == INSERT_SCD || docInfo.oldDocId == 0)
         {
-            insertDoc_(workerid, document, new_timestamp);
+            insertDoc_(0, block.documents[i], block.timestamps[i], is_real_time_);
         }
         else
         {
-            if (!updateDoc_(workerid, workerdata.oldDocId, document, old_rtype_doc, new_timestamp, workerdata.updateType))
+            if (!updateDoc_(0, docInfo.oldDocId, block.documents[i], block.oldRTypeDocs[i],
+                    block.timestamps[i], docInfo.updateType, is_real_time_))
                 continue;
             ++numUpdatedDocs_;
         }
     }
+}
+
+void IndexWorker::addIndexDoc_(const IndexDocInfo& docInfo)
+{
+    // the doc depends on a previous doc not indexed yet, such as the same
+    // DOCID updated twice, so wait until all previous docs are indexed
+    if (pending_docids_.count(docInfo.oldDocId) ||
+        pending_docids_.count(docInfo.newDocId))
+    {
+        dispatchDocBlock_();
+        doc_preparer_.consume(0);
+    }
+
+    if (!doc_block_)
+    {
+        doc_block_.reset(new IndexDocBlock);
+        doc_block_->docInfos.reserve(DOC_BLOCK_SIZE);
+    }
+
+    doc_block_->docInfos.push_back(docInfo);
+    if (docInfo.oldDocId)
+    {
+        pending_docids_.insert(docInfo.oldDocId);
+    }
+    pending_docids_.insert(docInfo.newDocId);
+
+    if (doc_block_->docInfos.size() >= DOC_BLOCK_SIZE)
+    {
+        dispatchDocBlock_();
+        doc_preparer_.consume(PENDING_BLOCK);
+    }
+}
 
-    } catch (const boost::thread_interrupted& e)
+void IndexWorker::dispatchDocBlock_()
+{
+    if (!doc_block_)
+        return;
+
+    doc_preparer_.add(doc_block_);
+    doc_block_.reset();
+}
+
+void IndexWorker::finishDocBlocks_()
+{
+    // it is called in destructor, so the waiting below is not interrupted
+    boost::this_thread::disable_interruption di;
+
+    try
+    {
+        dispatchDocBlock_();
+        doc_preparer_.consume(0);
+    }
+    catch (const std::exception& e)
+    {
+        LOG(ERROR) << "exception in indexing scd docs: " << e.what()
+                   << ", the docs not indexed are dropped";
+    }
+
+    doc_preparer_.reset();
+    doc_block_.reset();
+    pending_docids_.clear();
+
+    // the docs indexed are flushed even if exception occurs
+    try
     {
-        index_thread_status_[workerid] = false;
-        asynchronousTasks_[workerid]->clear();
-        flushUpdateBuffer_(workerid);
-        LOG(INFO) << "index thread worker exited : " << workerid;
+        flushUpdateBuffer_(0);
+    }
+    catch (const std::exception& e)
+    {
+        LOG(ERROR) << "exception in flushing scd docs: " << e.what();
     }
 }
 
 bool IndexWorker::insertOrUpdateSCD_(
-        ScdParser& parser,
+        const std::string& fileName,
         SCD_TYPE scdType,
         uint32_t numdoc,
         time_t timestamp)
@@ -1333,24 +1403,35 @@ bool IndexWorker::insertOrUpdateSCD_(
     {
         return false;
     }
+
+    // the docs are parsed by multiple threads, and got here in file order,
+    // as the doc ids are assigned in this order
+    ScdParallelParser parser(bundleConfig_->encoding_, SCD_PARSE_THREAD, SCD_PARSE_WINDOW);
+    if (!parser.load(fileName))
+    {
+        LOG(ERROR) << "Could not Load Scd File. File " << fileName;
+        return false;
+    }
+
+    // the pending docs are indexed on any exit
+    DocBlockGuard docBlockGuard(*this);
+
     uint32_t n = 0;
     long lastOffset = 0;
-    Document document;
-    Document old_rtype_doc;
-    //IndexerDocument indexDocument, oldIndexDocument;
 
-    for (ScdParser::iterator doc_iter = parser.begin();
-            doc_iter != parser.end(); ++doc_iter, ++n)
+    SCDDocPtr docptr;
+    offset_type docOffset = 0;
+    for (; parser.next(docptr, docOffset); ++n)
     {
-        if (*doc_iter == NULL)
+        if (docptr == NULL)
         {
             LOG(WARNING) << "SCD File not valid.";
             return false;
         }
 
-        indexProgress_.currentFilePos_ += doc_iter.getOffset() - lastOffset;
-        indexProgress_.totalFilePos_ += doc_iter.getOffset() - lastOffset;
-        lastOffset = doc_iter.getOffset();
+        indexProgress_.currentFilePos_ += docOffset - lastOffset;
+        indexProgress_.totalFilePos_ += docOffset - lastOffset;
+        lastOffset = docOffset;
         if (0 < numdoc && numdoc <= n)
             break;
 
@@ -1362,7 +1443,6 @@ bool IndexWorker::insertOrUpdateSCD_(
             indexStatus_.leftTime_ =  boost::posix_time::seconds((int)indexProgress_.getLeft());
         }
 
-        SCDDocPtr docptr = *doc_iter;
         if (docptr->empty()) continue;
 
         //use sharding in sharding or not in sharding ...
@@ -1375,7 +1455,7 @@ bool IndexWorker::insertOrUpdateSCD_(
             }
         }
 
-        int workerid = -1;
+        bool hasDocId = false;
         docid_t docId;
         docid_t oldId = 0;
         UpdateType updateType = INSERT;
@@ -1392,7 +1472,7 @@ bool IndexWorker::insertOrUpdateSCD_(
                         oldId, docId, updateType))
                     break;
 
-                workerid = scdDocId % asynchronousTasks_.size();
+                hasDocId = true;
                 continue;
             }
             if (!bundleConfig_->productSourceField_.empty()
@@ -1402,37 +1482,14 @@ bool IndexWorker::insertOrUpdateSCD_(
             }
         }
 
-        if (workerid == -1)
+        if (!hasDocId)
             continue;
 
-        if (is_real_time_)
-        {
-            // real time can not using multi thread because of the inverted index in
-            // the real time can not handle the out-of-order docid list.
-            time_t new_timestamp = timestamp;
-            document.clear();
-            old_rtype_doc.clear();
-
-            if (!prepareDocument_(*(docptr), document, old_rtype_doc,
-                    oldId, docId, new_timestamp, updateType, scdType))
-                continue;
-
-            if (scdType == INSERT_SCD || oldId == 0)
-            {
-                insertDoc_(0, document, new_timestamp, true);
-            }
-            else
-            {
-                if (!updateDoc_(0, oldId, document, old_rtype_doc, new_timestamp, updateType, true))
-                    continue;
-                ++numUpdatedDocs_;
-            }
-        }
-        else // multi-index;
-        {
-            asynchronousTasks_[workerid]->push(IndexDocInfo(docptr, oldId, docId,
-                    scdType, updateType, timestamp));
-        }
+        // the docs are prepared by multiple threads, while they are
+        // still indexed in doc id order, as the inverted index
+        // can not handle the out-of-order docid list.
+        addIndexDoc_(IndexDocInfo(docptr, oldId, docId,
+                scdType, updateType, timestamp));
         if (!source.empty())
         {
             ++productSourceCount_[source];
@@ -1440,31 +1497,11 @@ bool IndexWorker::insertOrUpdateSCD_(
 
         // interrupt when closing the process
         boost::this_thread::interruption_point();
+        JobScheduler::preemptionPoint();
     } // end of for loop for all documents
 
-    if (is_real_time_)
-    {
-        //flushUpdateBuffer_(0);
-    }
-    else
-    {
-        for (size_t i = 0; i < asynchronousTasks_.size(); ++i)
-        {
-            asynchronousTasks_[i]->push(IndexDocInfo());
-        }
-        // wait flush finish.
-        for (size_t i = 0; i < asynchronousTasks_.size(); ++i)
-        {
-            while(!updateBuffer_[i].empty() || !asynchronousTasks_[i]->empty() ||
-                index_thread_status_[i])
-            {
-                sleep(2);
-                //LOG(INFO) << "index thread still buffering ... ";
-            }
-        }
-        sleep(1);
-        LOG(INFO) << "scd finished index for all thread.";
-    }
+    finishDocBlocks_();
+    LOG(INFO) << "scd finished index for all docs.";
     return true;
 }
 
@@ -2003,7 +2040,10 @@ bool IndexWorker::prepareDocument_(
                     document.property(fieldStr).swap(propData);
                 }
                 if (updateType == RTYPE)
+                {
+                    boost::mutex::scoped_lock lock(rtype_props_mutex_);
                     documentManager_->RtypeDocidPros_.insert(fieldStr);
+                }
                 break;
 
             case DATETIME_PROPERTY_TYPE:
@@ -2024,7 +2064,10 @@ bool IndexWorker::prepareDocument_(
                     document.property(fieldStr).swap(propData);
                 }
                 if (updateType == RTYPE)
+                {
+                    boost::mutex::scoped_lock lock(rtype_props_mutex_);
                     documentManager_->RtypeDocidPros_.insert(fieldStr);
+                }
                 break;
 
             default:
@@ -2213,6 +2256,19 @@ void IndexWorker::document2SCDDoc(const Document& document, SCDDoc& scddoc)
     }
 }
 
+void IndexWorker::getUpdatedProperties_(
+        const SCDDoc& scddoc,
+        std::vector<std::string>& properties) const
+{
+    for (SCDDoc::const_iterator it = scddoc.begin(); it != scddoc.end(); ++it)
+    {
+        if (!boost::iequals(it->first, DOCID))
+        {
+            properties.push_back(it->first);
+        }
+    }
+}
+
 void IndexWorker::clearMasterCache_()
 {
     LOG(INFO) << "notify master to clear cache.";
@@ -2225,6 +2281,17 @@ void IndexWorker::clearMasterCache_()
     }
 }
 
+void IndexWorker::notifyMasterTermStats_()
+{
+    if (bundleConfig_->isWorkerNode())
+    {
+        NotifyMSG msg;
+        msg.collection = bundleConfig_->collectionName_;
+        msg.method = "UPDATE_TERM_STATS";
+        MasterNotifier::get()->notify(msg);
+    }
+}
+
 bool IndexWorker::generateMigrateSCD(const std::map<shardid_t, std::vector<vnodeid_t> >& vnode_list,
     std::map<shardid_t, std::string>& generated_insert_scds,
     std::map<shardid_t, std::string>& generated_del_scds)
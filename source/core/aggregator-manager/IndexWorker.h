@@ -16,6 +16,7 @@
 #include <common/IndexingProgress.h>
 #include <common/ScdParser.h>
 #include <common/ScdWriterController.h>
+#include <common/OrderedBlockPreparer.h>
 #include <index-manager/IncSupportedIndexManager.h>
 #include <node-manager/sharding/ShardingStrategy.h>
 
@@ -28,7 +29,9 @@
 
 #include <boost/shared_ptr.hpp>
 #include <boost/tuple/tuple.hpp>
-#include <util/concurrent_queue.h>
+#include <boost/unordered_set.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
 //#include <boost/atomic.hpp>
 
 namespace sf1r
@@ -145,7 +148,7 @@ private:
         uint32_t numdoc, int64_t timestamp);
 
     bool insertOrUpdateSCD_(
-            ScdParser& parser,
+            const std::string& fileName,
             SCD_TYPE scdType,
             uint32_t numdoc,
             time_t timestamp);
@@ -239,9 +242,21 @@ private:
      */
     void clearMasterCache_();
 
+    /**
+     * notify master that the term statistics are changed,
+     * it is not needed if @c clearMasterCache_() is called.
+     */
+    void notifyMasterTermStats_();
+
+    /**
+     * get the property names in @p scddoc except DOCID.
+     */
+    void getUpdatedProperties_(
+            const SCDDoc& scddoc,
+            std::vector<std::string>& properties) const;
+
     void scheduleOptimizeTask();
     void lazyOptimizeIndex(int calltype);
-    void indexSCDDocFunc(int workerid);
 
 private:
     IndexBundleConfiguration* bundleConfig_;
@@ -304,9 +319,83 @@ private:
         }
     };
 
-    std::vector<izenelib::util::concurrent_queue<IndexDocInfo>* > asynchronousTasks_;
-    std::vector<boost::thread*> index_thread_workers_;
-    bool* index_thread_status_;
+    /**
+     * The docs are collected into blocks of consecutive doc ids, each block
+     * is prepared by one of the prepare threads, then the blocks are indexed
+     * in order by the thread iterating the SCD file, as the inverted index
+     * in real time mode requires the docs to be inserted in doc id order,
+     * and the later doc might depend on the earlier one of the same DOCID.
+     */
+    struct IndexDocBlock
+    {
+        std::vector<IndexDocInfo> docInfos;
+        std::vector<Document> documents;
+        std::vector<Document> oldRTypeDocs;
+        std::vector<time_t> timestamps;
+        std::vector<char> isPrepared;
+    };
+    typedef boost::shared_ptr<IndexDocBlock> IndexDocBlockPtr;
+
+    /**
+     * finish the doc blocks when @c insertOrUpdateSCD_() exits,
+     * including the exit by exception, such as thread interruption.
+     */
+    class DocBlockGuard
+    {
+    public:
+        explicit DocBlockGuard(IndexWorker& worker)
+            : worker_(worker)
+        {
+        }
+
+        ~DocBlockGuard()
+        {
+            worker_.finishDocBlocks_();
+        }
+
+    private:
+        IndexWorker& worker_;
+    };
+
+    /**
+     * append the doc to the block being collected.
+     */
+    void addIndexDoc_(const IndexDocInfo& docInfo);
+
+    /**
+     * send the block being collected to prepare threads.
+     */
+    void dispatchDocBlock_();
+
+    /**
+     * index all the blocks left, flush the update buffer, then clear the
+     * pending state, the blocks not indexed are dropped if exception occurs.
+     */
+    void finishDocBlocks_();
+
+    void prepareDocBlock_(IndexDocBlock& block);
+
+    /**
+     * in real time mode, the docs are indexed immediately,
+     * otherwise, they are put into the update buffer.
+     */
+    void indexDocBlock_(IndexDocBlock& block);
+
+    /** the block being collected */
+    IndexDocBlockPtr doc_block_;
+
+    /** the doc ids in the block being collected and the pending blocks */
+    boost::unordered_set<docid_t> pending_docids_;
+
+    /**
+     * prepare the blocks in multiple threads, which are started on the
+     * first SCD, then index them in doc id order.
+     */
+    OrderedBlockPreparer<IndexDocBlock> doc_preparer_;
+
+    /** guard RtypeDocidPros_ in DocumentManager while preparing docs */
+    boost::mutex rtype_props_mutex_;
+
     bool is_real_time_;
     boost::shared_ptr<ShardingStrategy> sharding_strategy_;
     boost::shared_ptr<ScdSharder> scdSharder_;
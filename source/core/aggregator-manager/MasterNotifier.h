@@ -27,7 +27,13 @@ struct NotifyMSG
 
     std::string error;
 
-    MSGPACK_DEFINE(method,collection,error);
+    /**
+     * the method is one of CLEAR_SEARCH_CACHE, INVALIDATE_SEARCH_CACHE and
+     * UPDATE_TERM_STATS, the updated properties for INVALIDATE_SEARCH_CACHE
+     */
+    std::vector<std::string> properties;
+
+    MSGPACK_DEFINE(method,collection,error,properties);
 };
 
 class MasterNotifier
@@ -185,14 +185,37 @@ void SearchMerger::getDistSearchResult(const net::aggregator::WorkerResults<Keyw
         return;
     }
 
+    // merge the results of the other workers if some workers failed,
+    // the merged result is marked as partial.
+    std::vector<size_t> okIndexList;
     for(size_t workerId = 0; workerId < workerNum; ++workerId)
     {
         if(!workerResults.result(workerId).error_.empty())
         {
-            mergeResult.error_ = workerResults.result(workerId).error_;
-            LOG(ERROR) << "!!! getDistSearchResult error for worker: " << workerId << ", error: " << mergeResult.error_;
-            return;
+            LOG(ERROR) << "!!! getDistSearchResult error for worker: " << workerResults.workerId(workerId)
+                << ", error: " << workerResults.result(workerId).error_;
+            continue;
+        }
+        okIndexList.push_back(workerId);
+    }
+
+    if (okIndexList.empty())
+    {
+        mergeResult.error_ = workerResults.result(0).error_;
+        return;
+    }
+
+    if (okIndexList.size() < workerNum)
+    {
+        net::aggregator::WorkerResults<KeywordSearchResult> okResults;
+        for (size_t i = 0; i < okIndexList.size(); ++i)
+        {
+            okResults.add(workerResults.workerId(okIndexList[i]), workerResults.result(okIndexList[i]));
         }
+        getDistSearchResult(okResults, mergeResult);
+        mergeResult.distSearchInfo_.isPartial_ = true;
+        LOG(WARNING) << "partial result merged from " << okIndexList.size() << " of " << workerNum << " workers.";
+        return;
     }
 
     const KeywordSearchResult& result0 = workerResults.result(0);
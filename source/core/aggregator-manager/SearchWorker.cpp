@@ -4,6 +4,7 @@
 #include <bundles/index/IndexBundleConfiguration.h>
 
 #include <common/SearchCache.h>
+#include <common/DistSearchResultCache.h>
 #include <common/Utilities.h>
 #include <common/QueryNormalizer.h>
 #include <index-manager/InvertedIndexManager.h>
@@ -14,6 +15,7 @@
 #include <search-manager/QueryPruneBase.h>
 #include <search-manager/QueryHelper.h>
 #include <document-manager/DocumentManager.h>
+#include <document-manager/highlighter/MultiTermMatcher.h>
 #include <mining-manager/MiningManager.h>
 #include <la-manager/LAManager.h>
 #include <node-manager/DistributeRequestHooker.h>
@@ -31,6 +33,8 @@ SearchWorker::SearchWorker(IndexBundleConfiguration* bundleConfig)
     , searchCache_(new SearchCache(bundleConfig_->searchCacheNum_,
                                     bundleConfig_->refreshCacheInterval_,
                                     bundleConfig_->refreshSearchCache_))
+    , distResultCache_(new DistSearchResultCache(bundleConfig_->searchCacheNum_,
+                                                 bundleConfig_->distSearchResultTTL_))
     , queryPruneFactory_(new QueryPruneFactory())
 {
     ///LA can only be got from a pool because it is not thread safe
@@ -67,16 +71,52 @@ void SearchWorker::getDistSearchResult(const KeywordSearchActionItem& actionItem
 {
     LOG(INFO) << "[SearchWorker::processGetSearchResult] " << actionItem.collectionName_ << endl;
 
-    getSearchResult_(actionItem, resultItem);
-    resultItem.rawQueryString_ = actionItem.env_.queryString_;
+    QueryIdentity identity;
+    uint32_t TOP_K_NUM = bundleConfig_->topKNum_;
+    uint32_t topKStart = actionItem.pageInfo_.topKStart(TOP_K_NUM, IsTopKComesFromConfig(actionItem));
+    makeQueryIdentity(identity, actionItem, resultItem.distSearchInfo_.option_, topKStart);
+
+    // in distributed search, each worker retrieves the top docs from 0,
+    // see getSearchResult_(), so topKStart is 0 in the key, and the kept
+    // result is reused only if it retrieved enough docs for the page.
+    const std::size_t searchLimit = TOP_K_NUM + actionItem.pageInfo_.start_;
+    const std::size_t pageEnd = actionItem.pageInfo_.start_ + actionItem.pageInfo_.count_;
+
+    // the next pages of a query reuse the result kept by its first page,
+    // only the page range set by master is different.
+    std::size_t start = resultItem.start_;
+    std::size_t count = resultItem.count_;
+    if (distResultCache_->get(identity, pageEnd, resultItem))
+    {
+        LOG(INFO) << "got the dist search result kept by the previous page.";
+        resultItem.start_ = start;
+        resultItem.count_ = count;
+    }
+    else
+    {
+        GenerationSnapshot snapshot;
+        distResultCache_->takeSnapshot(identity, snapshot);
 
-    if (!resultItem.topKDocs_.empty())
-        searchManager_->topKReranker_.rerank(actionItem, resultItem);
+        getSearchResult_(actionItem, resultItem, identity);
+        resultItem.rawQueryString_ = actionItem.env_.queryString_;
+
+        if (!resultItem.topKDocs_.empty())
+            searchManager_->topKReranker_.rerank(actionItem, resultItem);
+
+        if (resultItem.error_.empty())
+            distResultCache_->set(identity, searchLimit, resultItem, snapshot);
+    }
 
     if (!actionItem.disableGetDocs_)
     {
-        if( (resultItem.topKDocs_.size() > 20) &&
-            (actionItem.pageInfo_.start_ + actionItem.pageInfo_.count_) > 20 )
+        // a doc at rank r in this worker is at least at rank r after merged,
+        // so only the top (start + count) docs could be in the page.
+        // for the pages beyond the prefetch limit, no summary is attached,
+        // master gets it by "getSummaryResult" after merging.
+        const std::size_t prefetchNum = bundleConfig_->distSearchPrefetchSummaryNum_;
+        if (prefetchNum == 0 ||
+            ((resultItem.topKDocs_.size() > prefetchNum) &&
+            (actionItem.pageInfo_.start_ + actionItem.pageInfo_.count_) > prefetchNum))
         {
             return;
         }
@@ -206,6 +246,8 @@ bool SearchWorker::doLocalSearch(const KeywordSearchActionItem& actionItem, Keyw
 
     if (!searchCache_->get(identity, resultItem))
     {
+        GenerationSnapshot snapshot;
+        searchCache_->takeSnapshot(identity, snapshot);
         STOP_PROFILER( cacheoverhead )
 
         if (! getSearchResult_(actionItem, resultItem, identity, false))
@@ -225,7 +267,7 @@ bool SearchWorker::doLocalSearch(const KeywordSearchActionItem& actionItem, Keyw
 
         START_PROFILER( cacheoverhead )
         if (searchCache_)
-            searchCache_->set(identity, resultItem);
+            searchCache_->set(identity, resultItem, snapshot);
         STOP_PROFILER( cacheoverhead )
     }
     else
@@ -654,14 +696,10 @@ bool SearchWorker::getSummaryMiningResult_(
 
 void SearchWorker::analyze_(const std::string& qstr, std::vector<izenelib::util::UString>& results, bool isQA)
 {
-    la::LA* pLA = LAPool::getInstance()->popSearchLA( analysisInfo_);
-//    pLA->process_search(question, termList);
-    if (!pLA) return;
-    results.clear();
     izenelib::util::UString question(qstr, izenelib::util::UString::UTF_8);
     la::TermList termList;
-    pLA->process(question, termList);
-    LAPool::getInstance()->pushSearchLA( analysisInfo_, pLA );
+    if (!laManager_->getTermList(question, analysisInfo_, termList)) return;
+    results.clear();
 
     std::string str;
     for (la::TermList::iterator iter = termList.begin(); iter != termList.end(); ++iter)
@@ -783,6 +821,10 @@ bool  SearchWorker::getResultItem(
     if(isRequireHighlight)
         analyze_(actionItem.env_.queryString_, queryTerms, false);
 
+    ///the terms are matched in one pass over each text,
+    ///the matcher is shared by all the properties of all docs in page
+    const MultiTermMatcher termMatcher(queryTerms);
+
     ///get documents at first, so that those documents will all exist in cache.
     ///To be optimized !!!:
     ///summary/snipet/highlight should utlize the extracted documents object, instead of get once more
@@ -801,8 +843,13 @@ bool  SearchWorker::getResultItem(
     typedef std::vector<DisplayProperty>::size_type vec_size_type;
     vec_size_type indexSummary = 0;
     std::vector<Document> docs;
+    std::vector<std::string> displayPropertyNames;
+    for (vec_size_type i = 0; i < actionItem.displayPropertyList_.size(); ++i)
+    {
+        displayPropertyNames.push_back(actionItem.displayPropertyList_[i].propertyString_);
+    }
     bool forceget = (miningManager_&&miningManager_->HasDeletedDocDuringMining())||bundleConfig_->enable_forceget_doc_;
-    if(!documentManager_->getDocuments(ids, docs, forceget))
+    if(!documentManager_->getDocuments(ids, displayPropertyNames, docs, forceget))
     {
         ///Whenever any document could not be retrieved, return false
         resultItem.error_ = "Error : Cannot get document data";
@@ -847,7 +894,7 @@ bool  SearchWorker::getResultItem(
                     actionItem.displayPropertyList_[i].isSummaryOn_,
                     actionItem.displayPropertyList_[i].summarySentenceNum_,
                     propertyOption,
-                    queryTerms,
+                    termMatcher,
                     resultItem.snippetTextOfDocumentInPage_[i],
                     resultItem.rawTextOfSummaryInPage_[indexSummary],
                     resultItem.fullTextOfDocumentInPage_[i]
@@ -866,7 +913,7 @@ bool  SearchWorker::getResultItem(
                     docs[dit->second],
                     actionItem.displayPropertyList_[i].propertyString_,
                     propertyOption,
-                    queryTerms,
+                    termMatcher,
                     resultItem.snippetTextOfDocumentInPage_[i][dit->second],
                     resultItem.fullTextOfDocumentInPage_[i][dit->second]);
             }
@@ -893,6 +940,7 @@ void SearchWorker::reset_all_property_cache()
 void SearchWorker::clearSearchCache()
 {
     searchCache_->clear();
+    distResultCache_->clear();
     LOG(INFO) << "notify master to clear cache.";
     if (bundleConfig_->isWorkerNode())
     {
@@ -908,6 +956,35 @@ void SearchWorker::clearFilterCache()
     searchManager_->queryBuilder_->reset_cache();
 }
 
+void SearchWorker::invalidateCache(const std::vector<std::string>& properties)
+{
+    searchCache_->invalidate(properties);
+    distResultCache_->invalidate(properties);
+    searchManager_->queryBuilder_->invalidate_cache(properties);
+
+    LOG(INFO) << "notify master to invalidate cache on " << properties.size()
+              << " properties.";
+    if (bundleConfig_->isWorkerNode())
+    {
+        NotifyMSG msg;
+        msg.collection = bundleConfig_->collectionName_;
+        msg.method = "INVALIDATE_SEARCH_CACHE";
+        msg.properties = properties;
+        MasterNotifier::get()->notify(msg);
+    }
+}
+
+void SearchWorker::setProductRankProperties(const std::set<std::string>& properties)
+{
+    searchCache_->setProductRankProperties(properties);
+    distResultCache_->setProductRankProperties(properties);
+}
+
+CacheStats SearchWorker::getSearchCacheStats() const
+{
+    return searchCache_->getStats();
+}
+
 uint32_t SearchWorker::getDocNum()
 {
     return documentManager_->getNumDocs();
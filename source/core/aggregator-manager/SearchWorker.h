@@ -12,11 +12,13 @@
 #include <query-manager/SearchKeywordOperation.h>
 #include <la-manager/AnalysisInformation.h>
 #include <common/ResultType.h>
+#include <common/PropertyGenerations.h>
 
 #include <util/get.h>
 #include <net/aggregator/Typedef.h>
 
 #include <boost/shared_ptr.hpp>
+#include <set>
 
 namespace sf1r
 {
@@ -34,6 +36,7 @@ class SearchManager;
 class MiningManager;
 class QueryIdentity;
 class SearchCache;
+class DistSearchResultCache;
 class QueryPruneFactory;
 
 class SearchWorker : public net::aggregator::BindCallProxyBase<SearchWorker>
@@ -102,6 +105,21 @@ public:
 
     void clearFilterCache();
 
+    /**
+     * invalidate the search and filter cache entries depending on any of
+     * @p properties, it is called when the values of @p properties are
+     * updated without changing docids.
+     */
+    void invalidateCache(const std::vector<std::string>& properties);
+
+    /**
+     * set the properties used in product ranking, so that the cached results
+     * ranked by product ranking are invalidated when they are updated.
+     */
+    void setProductRankProperties(const std::set<std::string>& properties);
+
+    CacheStats getSearchCacheStats() const;
+
     uint32_t getDocNum();
     void  getDistDocNum(uint32_t& total_docs)
     {
@@ -161,6 +179,7 @@ private:
     boost::shared_ptr<SearchManager> searchManager_;
     boost::shared_ptr<MiningManager> miningManager_;
     boost::shared_ptr<SearchCache> searchCache_;
+    boost::shared_ptr<DistSearchResultCache> distResultCache_;
 
     AnalysisInfo analysisInfo_;
     boost::shared_ptr<QueryPruneFactory> queryPruneFactory_;
@@ -0,0 +1,188 @@
+#ifndef CORE_COMMON_DIST_SEARCH_RESULT_CACHE_H
+#define CORE_COMMON_DIST_SEARCH_RESULT_CACHE_H
+/**
+ * @file core/common/DistSearchResultCache.h
+ * @brief the search results of a worker kept for a short time, so that
+ *        the requests of the next pages of the same query from master
+ *        would not execute the search again.
+ */
+#include "ResultType.h" // KeywordSearchResult
+#include "PropertyGenerations.h"
+#include <query-manager/QueryIdentity.h>
+#include <cache/concurrent_cache.hpp>
+
+#include <ctime>
+#include <set>
+#include <boost/atomic.hpp>
+
+namespace sf1r
+{
+
+class DistSearchResultCache
+{
+public:
+    typedef QueryIdentity key_type;
+    typedef KeywordSearchResult value_type;
+
+    /** the cached result with the generations it depends on */
+    struct CacheEntry
+    {
+        value_type result;
+        GenerationSnapshot snapshot;
+
+        /** the max number of docs retrieved in searching */
+        std::size_t limit;
+
+        CacheEntry() : limit(0) {}
+    };
+
+    typedef izenelib::concurrent_cache::ConcurrentCache<key_type, CacheEntry> cache_type;
+
+    /**
+     * @param expireSeconds the seconds a result is kept, 0 means disabled
+     */
+    DistSearchResultCache(unsigned cacheSize, time_t expireSeconds)
+        : cache_(cacheSize, izenelib::cache::LRLFU)
+        , expireSeconds_(expireSeconds)
+        , hitNum_(0)
+        , missNum_(0)
+        , invalidationNum_(0)
+    {
+    }
+
+    bool isEnabled() const
+    {
+        return expireSeconds_ > 0;
+    }
+
+    /**
+     * @param docNum the number of top docs required, such as the end of
+     *        the page, as the key does not include the page range.
+     * @return true if found, not expired, not invalidated by index updates,
+     *         and it has the top @p docNum docs, which means either its
+     *         limit is not less than @p docNum, or all the matched docs
+     *         are retrieved.
+     */
+    bool get(const key_type& key, std::size_t docNum, value_type& result)
+    {
+        if (!isEnabled())
+            return false;
+
+        CacheEntry entry;
+        if (cache_.get(key, entry))
+        {
+            if (!generations_.isValid(entry.snapshot))
+            {
+                ++invalidationNum_;
+            }
+            else if (std::time(NULL) - entry.result.timeStamp_ <= expireSeconds_ &&
+                     (entry.limit >= docNum || entry.result.topKDocs_.size() < entry.limit))
+            {
+                result.swap(entry.result);
+                ++hitNum_;
+                return true;
+            }
+        }
+
+        ++missNum_;
+        return false;
+    }
+
+    /**
+     * take the current generations of the properties @p key depends on,
+     * it should be called before searching.
+     */
+    void takeSnapshot(const key_type& key, GenerationSnapshot& snapshot) const
+    {
+        std::set<std::string> dependentProps;
+        generations_.takeSnapshot(
+            key.getDependentProperties(productRankProps_, dependentProps) ?
+                &dependentProps : NULL,
+            snapshot);
+    }
+
+    /**
+     * the summary of the page in @p result is not cached,
+     * as the next page would have different documents.
+     * @param limit the max number of docs retrieved in searching
+     * @param snapshot the generations taken before searching
+     */
+    void set(const key_type& key,
+             std::size_t limit,
+             value_type& result,
+             const GenerationSnapshot& snapshot)
+    {
+        if (!isEnabled())
+            return;
+
+        result.timeStamp_ = std::time(NULL);
+
+        std::vector<std::vector<PropertyValue::PropertyValueStrType> > fullText, snippetText, rawText;
+        fullText.swap(result.fullTextOfDocumentInPage_);
+        snippetText.swap(result.snippetTextOfDocumentInPage_);
+        rawText.swap(result.rawTextOfSummaryInPage_);
+        bool includeSummary = result.distSearchInfo_.include_summary_data_;
+        result.distSearchInfo_.include_summary_data_ = false;
+
+        CacheEntry entry;
+        entry.snapshot = snapshot;
+        entry.limit = limit;
+
+        entry.result.swap(result);
+        cache_.insert(key, entry);
+        entry.result.swap(result);
+
+        fullText.swap(result.fullTextOfDocumentInPage_);
+        snippetText.swap(result.snippetTextOfDocumentInPage_);
+        rawText.swap(result.rawTextOfSummaryInPage_);
+        result.distSearchInfo_.include_summary_data_ = includeSummary;
+    }
+
+    void clear()
+    {
+        generations_.increaseDocGeneration();
+        cache_.clear();
+    }
+
+    /**
+     * invalidate the entries depending on any of @p properties.
+     */
+    void invalidate(const std::vector<std::string>& properties)
+    {
+        generations_.increasePropGeneration(properties);
+    }
+
+    /**
+     * set the properties used in product ranking,
+     * it should be called before searching.
+     */
+    void setProductRankProperties(const std::set<std::string>& properties)
+    {
+        productRankProps_ = properties;
+    }
+
+    CacheStats getStats() const
+    {
+        CacheStats stats;
+        stats.hitNum = hitNum_;
+        stats.missNum = missNum_;
+        stats.invalidationNum = invalidationNum_;
+        return stats;
+    }
+
+private:
+    cache_type cache_;
+    time_t expireSeconds_;
+
+    PropertyGenerations generations_;
+
+    std::set<std::string> productRankProps_;
+
+    boost::atomic<uint64_t> hitNum_;
+    boost::atomic<uint64_t> missNum_;
+    boost::atomic<uint64_t> invalidationNum_;
+};
+
+} // namespace sf1r
+
+#endif // CORE_COMMON_DIST_SEARCH_RESULT_CACHE_H
@@ -0,0 +1,152 @@
+#ifndef CORE_COMMON_DIST_TERM_STATS_CACHE_H
+#define CORE_COMMON_DIST_TERM_STATS_CACHE_H
+/**
+ * @file core/common/DistTermStatsCache.h
+ * @brief the global term statistics gathered from all workers, cached on
+ *        master, so that a WAND query could carry them to the workers
+ *        without the gather round trip.
+ */
+#include "ResultType.h" // DistKeywordSearchInfo
+#include "PropertyGenerations.h"
+#include <query-manager/QueryIdentity.h>
+#include <cache/concurrent_cache.hpp>
+
+#include <algorithm>
+#include <set>
+#include <boost/atomic.hpp>
+
+namespace sf1r
+{
+
+class DistTermStatsCache
+{
+public:
+    typedef QueryIdentity key_type;
+
+    /**
+     * the df, ctf and maxtf of the query terms in each property, with the
+     * generations (versions) of the index they are gathered from.
+     */
+    struct CacheEntry
+    {
+        DocumentFrequencyInProperties dfmap;
+        CollectionTermFrequencyInProperties ctfmap;
+        MaxTermFrequencyInProperties maxtfmap;
+        GenerationSnapshot snapshot;
+    };
+
+    typedef izenelib::concurrent_cache::ConcurrentCache<key_type, CacheEntry> cache_type;
+
+    explicit DistTermStatsCache(unsigned cacheSize)
+        : cache_(cacheSize, izenelib::cache::LRLFU)
+        , hitNum_(0)
+        , missNum_(0)
+        , invalidationNum_(0)
+    {
+    }
+
+    /**
+     * make the key from the fields of @p item which decide the query terms,
+     * the fields like filter, sort and page are ignored.
+     */
+    static void makeKey(const KeywordSearchActionItem& item, key_type& key)
+    {
+        key.query = item.env_.queryString_;
+        key.expandedQueryString = item.env_.expandedQueryString_;
+        key.searchingMode = item.searchingMode_;
+        key.laInfo = item.languageAnalyzerInfo_;
+        key.isSynonym = item.languageAnalyzerInfo_.synonymExtension_;
+        key.properties = item.searchPropertyList_;
+        std::sort(key.properties.begin(), key.properties.end());
+    }
+
+    /**
+     * take the current generations of the properties in @p key,
+     * it should be called before gathering the statistics from workers,
+     * so that the index updates during gathering would invalidate them.
+     */
+    void takeSnapshot(const key_type& key, GenerationSnapshot& snapshot) const
+    {
+        std::set<std::string> dependentProps(key.properties.begin(),
+                                             key.properties.end());
+        generations_.takeSnapshot(&dependentProps, snapshot);
+    }
+
+    /**
+     * get the statistics into @p distSearchInfo.
+     * @return true if found and not invalidated by index updates
+     */
+    bool get(const key_type& key, DistKeywordSearchInfo& distSearchInfo)
+    {
+        CacheEntry entry;
+        if (cache_.get(key, entry))
+        {
+            if (generations_.isValid(entry.snapshot))
+            {
+                distSearchInfo.dfmap_.swap(entry.dfmap);
+                distSearchInfo.ctfmap_.swap(entry.ctfmap);
+                distSearchInfo.maxtfmap_.swap(entry.maxtfmap);
+                ++hitNum_;
+                return true;
+            }
+            ++invalidationNum_;
+        }
+
+        ++missNum_;
+        return false;
+    }
+
+    /**
+     * @param snapshot the generations taken before gathering
+     */
+    void set(const key_type& key,
+             const DistKeywordSearchInfo& distSearchInfo,
+             const GenerationSnapshot& snapshot)
+    {
+        CacheEntry entry;
+        entry.dfmap = distSearchInfo.dfmap_;
+        entry.ctfmap = distSearchInfo.ctfmap_;
+        entry.maxtfmap = distSearchInfo.maxtfmap_;
+        entry.snapshot = snapshot;
+        cache_.insert(key, entry);
+    }
+
+    /**
+     * called when any worker has indexed or merged its index,
+     * it invalidates all the statistics.
+     */
+    void clear()
+    {
+        generations_.increaseDocGeneration();
+    }
+
+    /**
+     * invalidate the statistics of any of @p properties.
+     */
+    void invalidate(const std::vector<std::string>& properties)
+    {
+        generations_.increasePropGeneration(properties);
+    }
+
+    CacheStats getStats() const
+    {
+        CacheStats stats;
+        stats.hitNum = hitNum_;
+        stats.missNum = missNum_;
+        stats.invalidationNum = invalidationNum_;
+        return stats;
+    }
+
+private:
+    cache_type cache_;
+
+    PropertyGenerations generations_;
+
+    boost::atomic<uint64_t> hitNum_;
+    boost::atomic<uint64_t> missNum_;
+    boost::atomic<uint64_t> invalidationNum_;
+};
+
+} // namespace sf1r
+
+#endif // CORE_COMMON_DIST_TERM_STATS_CACHE_H
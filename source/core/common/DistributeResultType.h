@@ -18,6 +18,7 @@ public:
         , option_(OPTION_NONE)
         , nodeType_(NODE_MASTER)
         , majorTokenNum_(0)
+        , isPartial_(false)
     {
     }
 
@@ -57,6 +58,10 @@ public:
     /// the number of major tokens matched in fuzzy search
     int majorTokenNum_;
 
+    /// @brief true if the merged result misses the results of some workers,
+    ///        as they failed or did not respond before the deadline.
+    bool isPartial_;
+
     bool isOptionGatherInfo() const
     {
         return effective_ && option_ == OPTION_GATHER_INFO;
@@ -85,11 +90,12 @@ public:
         sortPropertyDoubleDataList_.swap(other.sortPropertyDoubleDataList_);
         sortPropertyStrDataList_.swap(other.sortPropertyStrDataList_);
         swap(majorTokenNum_, other.majorTokenNum_);
+        swap(isPartial_, other.isPartial_);
     }
 
     MSGPACK_DEFINE(isDistributed_, effective_, include_summary_data_, option_, nodeType_, dfmap_, ctfmap_, maxtfmap_, sortPropertyList_,
                    sortPropertyInt32DataList_, sortPropertyInt64DataList_, sortPropertyFloatDataList_, sortPropertyDoubleDataList_,
-                   sortPropertyStrDataList_, majorTokenNum_);
+                   sortPropertyStrDataList_, majorTokenNum_, isPartial_);
 };
 
 class DistSummaryMiningResult : public ErrorInfo
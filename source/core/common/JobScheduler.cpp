@@ -1,99 +1,522 @@
 #include "JobScheduler.h"
 
+#include <glog/logging.h>
+#include <algorithm> // max
+#include <limits>
+
+namespace bpt = boost::posix_time;
+
+namespace
+{
+/** by default, the tasks are run one by one as before, while the more urgent
+    task could still be run inline in @c preemptionPoint() */
+const std::size_t kDefaultWorkerNum = 1;
+
+double getSeconds(const bpt::time_duration& duration)
+{
+    return duration.total_microseconds() / 1000000.0;
+}
+}
+
 namespace sf1r
 {
 
+boost::thread_specific_ptr<JobScheduler::WorkerContext> JobScheduler::workerContext_;
+
+JobScheduler::QueueStatus::QueueStatus()
+    : pendingNum_(0)
+    , isRunning_(false)
+    , oldestWaitTime_(0)
+    , averageWaitTime_(0)
+    , maxWaitTime_(0)
+{
+}
+
+JobScheduler::CollectionQueue::CollectionQueue()
+    : isRunning_(false)
+    , isCancelled_(false)
+    , runningSeq_(0)
+    , workerId_(0)
+    , startNum_(0)
+    , totalWaitTime_(0)
+    , maxWaitTime_(0)
+{
+}
+
+JobScheduler::TaskPriority JobScheduler::CollectionQueue::urgentPriority() const
+{
+    TaskPriority priority = PRIORITY_NUM;
+
+    for (std::deque<Task>::const_iterator it = tasks_.begin();
+         it != tasks_.end(); ++it)
+    {
+        priority = std::min(priority, it->priority_);
+    }
+
+    return priority;
+}
+
 JobScheduler::JobScheduler()
+    : idleWorkerNum_(0)
+    , runningNum_(0)
+    , isSerialized_(false)
+    , pendingNum_(0)
+    , capacity_(std::numeric_limits<std::size_t>::max())
+    , nextSeq_(0)
+    , isClosed_(false)
 {
-    wait_event_id_ = 0;
-    asynchronousWorker_ = boost::thread(
-        &JobScheduler::runAsynchronousTasks_, this
-    );
+    for (int i = 0; i < PRIORITY_NUM; ++i)
+    {
+        priorityPendingNum_[i] = 0;
+    }
+
+    setWorkerNum(kDefaultWorkerNum);
 }
 
 JobScheduler::~JobScheduler()
 {
     close();
+
+    for (std::vector<boost::thread*>::iterator it = workers_.begin();
+         it != workers_.end(); ++it)
+    {
+        delete *it;
+    }
 }
 
 void JobScheduler::close()
 {
-    asynchronousWorker_.interrupt();
-    if (boost::this_thread::get_id() == asynchronousWorker_.get_id())
+    {
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        isClosed_ = true;
+
+        for (std::vector<boost::thread*>::iterator it = workers_.begin();
+             it != workers_.end(); ++it)
+        {
+            (*it)->interrupt();
+        }
+    }
+    taskCond_.notify_all();
+    capacityCond_.notify_all();
+
+    if (isWorkerThread_())
         return;
-    asynchronousWorker_.join();
+
+    for (std::vector<boost::thread*>::iterator it = workers_.begin();
+         it != workers_.end(); ++it)
+    {
+        if ((*it)->joinable())
+        {
+            (*it)->join();
+        }
+    }
 }
 
-void JobScheduler::notifyFinish(int waitid)
+void JobScheduler::setWorkerNum(std::size_t workerNum)
 {
-    boost::unique_lock<boost::mutex> lk(mutex_);
-    wait_finish_events_[waitid] = true;
-    cond_.notify_all();
+    boost::unique_lock<boost::mutex> lock(mutex_);
+
+    if (workerCollections_.size() < workerNum)
+    {
+        workerCollections_.resize(workerNum);
+    }
+
+    // the new worker would wait for the lock before reading workers_
+    for (std::size_t i = workers_.size(); i < workerNum; ++i)
+    {
+        workers_.push_back(new boost::thread(&JobScheduler::runWorker_, this, i));
+    }
 }
 
-void JobScheduler::waitCurrentFinish(const std::string& collection)
+void JobScheduler::setSerialized(bool isSerialized)
 {
-    if (boost::this_thread::get_id() == asynchronousWorker_.get_id())
-        return;
-    int current_id = 0;
     {
-        boost::unique_lock<boost::mutex> lk(mutex_);
-        current_id = ++wait_event_id_;
-        wait_finish_events_[current_id] = false;
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        isSerialized_ = isSerialized;
     }
-    asynchronousTasks_.push(task_collection_name_type(boost::bind(&JobScheduler::notifyFinish, this, current_id), collection));
+    taskCond_.notify_all();
+}
 
-    boost::unique_lock<boost::mutex> lk(mutex_);
-    while (!wait_finish_events_[current_id])
-        cond_.wait(lk);
+void JobScheduler::setCapacity(std::size_t capacity)
+{
+    {
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        capacity_ = capacity;
+    }
+    capacityCond_.notify_all();
+}
+
+void JobScheduler::addTask(
+    task_type task,
+    const std::string& collection,
+    TaskPriority priority)
+{
+    {
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        while (pendingNum_ >= capacity_ && !isClosed_)
+        {
+            capacityCond_.wait(lock);
+        }
+
+        Task newTask;
+        newTask.task_ = task;
+        newTask.collection_ = collection;
+        newTask.priority_ = priority;
+        newTask.seq_ = nextSeq_++;
+        newTask.addTime_ = bpt::microsec_clock::universal_time();
+
+        queues_[collection].tasks_.push_back(newTask);
+        ++pendingNum_;
+        ++priorityPendingNum_[priority];
+    }
+    taskCond_.notify_one();
 }
 
 void JobScheduler::removeTask(const std::string& collection)
 {
-    RemoveTaskPred removePred(collection);
-    IsOtherCollection isOtherCollection(currentTaskCollection_, collection);
+    boost::unique_lock<boost::mutex> lock(mutex_);
+
+    QueueMap::iterator it = queues_.find(collection);
+    if (it == queues_.end())
+        return;
 
-    if (!asynchronousTasks_.remove_if_when(removePred, isOtherCollection))
+    CollectionQueue& queue = it->second;
+    for (std::deque<Task>::const_iterator taskIt = queue.tasks_.begin();
+         taskIt != queue.tasks_.end(); ++taskIt)
+    {
+        --priorityPendingNum_[taskIt->priority_];
+    }
+    pendingNum_ -= queue.tasks_.size();
+    queue.tasks_.clear();
+    capacityCond_.notify_all();
+    finishCond_.notify_all();
+
+    const WorkerContext* context = workerContext_.get();
+    const bool isCurrentTask = context && context->collection_ == collection;
+
+    if (queue.isRunning_ && !isCurrentTask)
     {
         // as there is a running task of the same "collection",
         // it is necessary to wait for its completion.
-        close();
+        queue.isCancelled_ = true;
+
+        // if the worker is running a task of another collection inline,
+        // that task is not interrupted, while the cancelled task would be
+        // interrupted once that task returns in @c runUrgentTask_()
+        if (workerCollections_[queue.workerId_] == collection)
+        {
+            workers_[queue.workerId_]->interrupt();
+        }
 
-        asynchronousTasks_.remove_if(removePred);
-        asynchronousWorker_ = boost::thread(
-            &JobScheduler::runAsynchronousTasks_, this);
+        while (queue.isRunning_)
+        {
+            finishCond_.wait(lock);
+        }
+    }
+
+    if (!queue.isRunning_)
+    {
+        queues_.erase(it);
     }
 }
 
-void JobScheduler::addTask(task_type task, const std::string& collection)
+void JobScheduler::waitCurrentFinish(const std::string& collection)
 {
-    task_collection_name_type taskCollectionPair(task, collection);
-    asynchronousTasks_.push(taskCollectionPair);
+    if (isWorkerThread_())
+        return;
+
+    boost::unique_lock<boost::mutex> lock(mutex_);
+    const uint64_t seq = nextSeq_;
+
+    while (hasUnfinishedTask_(collection, seq))
+    {
+        finishCond_.wait(lock);
+    }
 }
 
-void JobScheduler::setCapacity(std::size_t capacity)
+bool JobScheduler::hasUnfinishedTask_(const std::string& collection, uint64_t seq) const
 {
-    asynchronousTasks_.resize(capacity);
+    if (!collection.empty())
+    {
+        QueueMap::const_iterator it = queues_.find(collection);
+        return it != queues_.end() && hasUnfinishedTask_(it->second, seq);
+    }
+
+    for (QueueMap::const_iterator it = queues_.begin();
+         it != queues_.end(); ++it)
+    {
+        if (hasUnfinishedTask_(it->second, seq))
+            return true;
+    }
+
+    return false;
 }
 
-void JobScheduler::runAsynchronousTasks_()
+bool JobScheduler::hasUnfinishedTask_(const CollectionQueue& queue, uint64_t seq) const
 {
-    try
+    if (queue.isRunning_ && queue.runningSeq_ < seq)
+        return true;
+
+    // the pending tasks are in the order of seq
+    return !queue.tasks_.empty() && queue.tasks_.front().seq_ < seq;
+}
+
+JobScheduler::CollectionQueue* JobScheduler::selectQueue_(int priority, bool isHeadOnly)
+{
+    CollectionQueue* result = NULL;
+    uint64_t resultSeq = 0;
+
+    for (QueueMap::iterator it = queues_.begin(); it != queues_.end(); ++it)
     {
-        while (true)
-        {
-            asynchronousTasks_.pop(currentTaskCollection_);
+        CollectionQueue& queue = it->second;
+        if (queue.isRunning_ || queue.tasks_.empty())
+            continue;
 
-            (currentTaskCollection_.first)();
+        const int queuePriority = isHeadOnly ?
+            queue.tasks_.front().priority_ : queue.urgentPriority();
+        const uint64_t queueSeq = queue.tasks_.front().seq_;
 
-            // terminate execution if interrupted
-            boost::this_thread::interruption_point();
+        if (queuePriority < priority ||
+            (queuePriority == priority && queueSeq < resultSeq))
+        {
+            result = &queue;
+            priority = queuePriority;
+            resultSeq = queueSeq;
         }
     }
+
+    return result;
+}
+
+void JobScheduler::startTask_(CollectionQueue& queue, std::size_t workerId, Task& task)
+{
+    task = queue.tasks_.front();
+    queue.tasks_.pop_front();
+    --pendingNum_;
+    --priorityPendingNum_[task.priority_];
+
+    ++runningNum_;
+    queue.isRunning_ = true;
+    queue.isCancelled_ = false;
+    queue.runningSeq_ = task.seq_;
+    queue.workerId_ = workerId;
+    workerCollections_[workerId] = task.collection_;
+
+    const double waitTime = getSeconds(
+        bpt::microsec_clock::universal_time() - task.addTime_);
+    ++queue.startNum_;
+    queue.totalWaitTime_ += waitTime;
+    queue.maxWaitTime_ = std::max(queue.maxWaitTime_, waitTime);
+
+    if (task.priority_ != REALTIME_UPDATE)
+    {
+        LOG(INFO) << "start task of collection: " << task.collection_
+                  << ", priority: " << task.priority_
+                  << ", wait time: " << waitTime << " seconds"
+                  << ", pending tasks: " << queue.tasks_.size();
+    }
+
+    capacityCond_.notify_all();
+}
+
+bool JobScheduler::runTask_(const Task& task)
+{
+    bool isInterrupted = false;
+
+    try
+    {
+        task.task_();
+    }
+    catch (boost::thread_interrupted&)
+    {
+        isInterrupted = true;
+    }
+    catch (std::exception& e)
+    {
+        LOG(ERROR) << "exception in task of collection: " << task.collection_
+                   << ", " << e.what();
+    }
+
+    finishTask_(task);
+
+    // the interruption might be requested when the task is finishing
+    try
+    {
+        boost::this_thread::interruption_point();
+    }
     catch (boost::thread_interrupted&)
     {
+        isInterrupted = true;
+    }
+
+    return isInterrupted;
+}
+
+void JobScheduler::finishTask_(const Task& task)
+{
+    {
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        CollectionQueue& queue = queues_[task.collection_];
+        queue.isRunning_ = false;
+        --runningNum_;
+    }
+
+    // the collection might have more tasks to run
+    taskCond_.notify_all();
+    finishCond_.notify_all();
+}
+
+void JobScheduler::runWorker_(std::size_t workerId)
+{
+    WorkerContext* context = new WorkerContext;
+    context->scheduler_ = this;
+    context->workerId_ = workerId;
+    context->priority_ = PRIORITY_NUM;
+    workerContext_.reset(context);
+
+    while (true)
+    {
+        Task task;
+        {
+            // it is only interrupted in running task
+            boost::this_thread::disable_interruption disabled;
+            boost::unique_lock<boost::mutex> lock(mutex_);
+
+            CollectionQueue* queue = NULL;
+            ++idleWorkerNum_;
+            while (!isClosed_ &&
+                   ((isSerialized_ && runningNum_ > 0) ||
+                    (queue = selectQueue_(PRIORITY_NUM, false)) == NULL))
+            {
+                taskCond_.wait(lock);
+            }
+            --idleWorkerNum_;
+
+            if (isClosed_)
+                return;
+
+            startTask_(*queue, workerId, task);
+        }
+
+        context->collection_ = task.collection_;
+        context->priority_ = task.priority_;
+
+        runTask_(task);
+
+        context->collection_.clear();
+        context->priority_ = PRIORITY_NUM;
+    }
+}
+
+void JobScheduler::preemptionPoint()
+{
+    WorkerContext* context = workerContext_.get();
+    if (!context)
         return;
+
+    JobScheduler* scheduler = context->scheduler_;
+    for (int i = 0; i < context->priority_; ++i)
+    {
+        if (scheduler->priorityPendingNum_[i] > 0)
+        {
+            scheduler->runUrgentTask_(*context);
+            return;
+        }
+    }
+}
+
+void JobScheduler::runUrgentTask_(WorkerContext& context)
+{
+    Task task;
+    {
+        boost::unique_lock<boost::mutex> lock(mutex_);
+
+        // the idle worker would run it,
+        // or it would run after the current task in serialized mode
+        if (isClosed_ || idleWorkerNum_ > 0 || isSerialized_)
+            return;
+
+        // it does not run a less urgent task before the urgent one inline
+        CollectionQueue* queue = selectQueue_(context.priority_, true);
+        if (!queue)
+            return;
+
+        startTask_(*queue, context.workerId_, task);
+    }
+
+    LOG(INFO) << "task of collection: " << context.collection_
+              << " is preempted by collection: " << task.collection_;
+
+    const std::string collection = context.collection_;
+    const TaskPriority priority = context.priority_;
+    context.collection_ = task.collection_;
+    context.priority_ = task.priority_;
+
+    runTask_(task);
+
+    context.collection_ = collection;
+    context.priority_ = priority;
+
+    // pass the interruption to the preempted task if it is requested for
+    // it, including the one deferred while the inline task is running
+    bool isCancelled = false;
+    {
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        workerCollections_[context.workerId_] = collection;
+        isCancelled = isClosed_ || queues_[collection].isCancelled_;
     }
+
+    if (isCancelled)
+        throw boost::thread_interrupted();
+}
+
+bool JobScheduler::isWorkerThread_() const
+{
+    const WorkerContext* context = workerContext_.get();
+    return context && context->scheduler_ == this;
+}
+
+void JobScheduler::getQueueStatus(std::vector<QueueStatus>& statusList)
+{
+    boost::unique_lock<boost::mutex> lock(mutex_);
+    const bpt::ptime now = bpt::microsec_clock::universal_time();
+
+    statusList.resize(queues_.size());
+    std::size_t i = 0;
+    for (QueueMap::const_iterator it = queues_.begin();
+         it != queues_.end(); ++it, ++i)
+    {
+        getQueueStatus_(it->first, it->second, now, statusList[i]);
+    }
+}
+
+bool JobScheduler::getQueueStatus(const std::string& collection, QueueStatus& status)
+{
+    boost::unique_lock<boost::mutex> lock(mutex_);
+
+    QueueMap::const_iterator it = queues_.find(collection);
+    if (it == queues_.end())
+        return false;
+
+    getQueueStatus_(it->first, it->second,
+                    bpt::microsec_clock::universal_time(), status);
+    return true;
+}
+
+void JobScheduler::getQueueStatus_(
+    const std::string& collection,
+    const CollectionQueue& queue,
+    const bpt::ptime& now,
+    QueueStatus& status) const
+{
+    status.collection_ = collection;
+    status.pendingNum_ = queue.tasks_.size();
+    status.isRunning_ = queue.isRunning_;
+    status.oldestWaitTime_ = queue.tasks_.empty() ? 0 :
+        getSeconds(now - queue.tasks_.front().addTime_);
+    status.averageWaitTime_ = queue.startNum_ == 0 ? 0 :
+        queue.totalWaitTime_ / queue.startNum_;
+    status.maxWaitTime_ = queue.maxWaitTime_;
 }
 
 }
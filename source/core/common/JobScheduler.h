@@ -1,25 +1,73 @@
 #ifndef PROCESS_JOB_SCHEDULER_H
 #define PROCESS_JOB_SCHEDULER_H
 
-#include <util/concurrent_queue.h>
 #include <util/singleton.h>
 
 #include <boost/thread.hpp>
 #include <boost/function.hpp>
+#include <boost/atomic.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/cstdint.hpp>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
 
 typedef boost::function0<void> task_type;
 
 namespace sf1r
 {
 
+/**
+ * It runs the index, optimize and mining tasks of all collections in a
+ * bounded worker pool.
+ *
+ * The tasks of the same collection are run one by one in the order they
+ * are added, while the tasks of different collections could run in
+ * parallel. When a worker is free, it selects the collection which has the
+ * most urgent pending task, so that a long rebuild of one collection does
+ * not block the real time updates of the other collections.
+ *
+ * A long task could call @c preemptionPoint() in its loop, so that when all
+ * workers are busy, a more urgent task of another collection is run inline
+ * on the same worker before the long task continues.
+ *
+ * In distributed mode, the write tasks share the state of the request
+ * hooker, so the scheduler should be serialized by @c setSerialized().
+ */
 class JobScheduler
 {
 public:
-    typedef std::pair<task_type, std::string> task_collection_name_type;
+    /// the priority classes, the smaller value is more urgent
+    enum TaskPriority
+    {
+        REALTIME_UPDATE = 0,
+        INCREMENTAL_INDEX,
+        OPTIMIZE_INDEX,
+        FULL_MINING,
+        PRIORITY_NUM
+    };
+
+    /// the queue status of one collection
+    struct QueueStatus
+    {
+        std::string collection_;
+
+        /// the number of tasks waiting in queue
+        std::size_t pendingNum_;
+
+        /// whether a task is running
+        bool isRunning_;
 
-    struct RemoveTaskPred;
+        /// the wait time of the oldest pending task, in seconds
+        double oldestWaitTime_;
 
-    struct IsOtherCollection;
+        /// the wait time of the started tasks, in seconds
+        double averageWaitTime_;
+        double maxWaitTime_;
+
+        QueueStatus();
+    };
 
     JobScheduler();
 
@@ -30,64 +78,175 @@ public:
         return ::izenelib::util::Singleton<JobScheduler>::get();
     }
 
-    void addTask(task_type task, const std::string& collection = "");
+    void addTask(
+        task_type task,
+        const std::string& collection = "",
+        TaskPriority priority = INCREMENTAL_INDEX);
 
     void close();
 
+    /**
+     * remove the pending tasks of @p collection, and interrupt its running
+     * task if any. If the worker is running a task of another collection
+     * inline, the interruption is deferred until that task returns.
+     */
     void removeTask(const std::string& collection);
 
+    /**
+     * @param capacity the max number of pending tasks, @c addTask() would
+     *        wait when the pending tasks reach it.
+     */
     void setCapacity(std::size_t capacity);
+
+    /**
+     * @param workerNum the max number of tasks running in parallel, it
+     *        could only be increased.
+     */
+    void setWorkerNum(std::size_t workerNum);
+
+    /**
+     * @param isSerialized if true, at most one task runs at a time among
+     *        all collections, and no task is run inline in
+     *        @c preemptionPoint(), the tasks are still selected by priority.
+     */
+    void setSerialized(bool isSerialized);
+
+    /**
+     * wait until the tasks added before are finished.
+     * @param collection if empty, wait for the tasks of all collections
+     */
     void waitCurrentFinish(const std::string& collection = "");
 
-private:
-    void runAsynchronousTasks_();
-    void notifyFinish(int waitid);
+    void getQueueStatus(std::vector<QueueStatus>& statusList);
 
-private:
-    ::izenelib::util::concurrent_queue<task_collection_name_type> asynchronousTasks_;
+    bool getQueueStatus(const std::string& collection, QueueStatus& status);
 
-    boost::thread asynchronousWorker_;
+    /**
+     * It is called by a long running task at its interruption points. If
+     * the task runs in the scheduler, and there is a more urgent task of
+     * another collection waiting for a free worker, that task would be run
+     * before return.
+     */
+    static void preemptionPoint();
 
-    task_collection_name_type currentTaskCollection_;
-    boost::mutex mutex_;
-    boost::condition_variable cond_;
-    std::map<int, bool>  wait_finish_events_;
-    int wait_event_id_;
-};
+private:
+    struct Task
+    {
+        task_type task_;
+        std::string collection_;
+        TaskPriority priority_;
 
-struct JobScheduler::RemoveTaskPred
-{
-    const std::string& collection_;
+        /// the order of adding task
+        uint64_t seq_;
 
-    RemoveTaskPred(const std::string& collection)
-        :collection_(collection)
-    {
-    }
+        boost::posix_time::ptime addTime_;
+    };
 
-    bool operator()(const task_collection_name_type& task_collection) const
+    struct CollectionQueue
     {
-        return collection_ == task_collection.second;
-    }
-};
+        std::deque<Task> tasks_;
 
-struct JobScheduler::IsOtherCollection
-{
-    const task_collection_name_type& current_task_collection_;
+        bool isRunning_;
+        bool isCancelled_;
+        uint64_t runningSeq_;
+        std::size_t workerId_;
 
-    const std::string& collection_;
+        /// statistics of the started tasks
+        std::size_t startNum_;
+        double totalWaitTime_;
+        double maxWaitTime_;
 
-    IsOtherCollection(
-        const task_collection_name_type& current_task_collection,
-        const std::string& collection)
-        :current_task_collection_(current_task_collection)
-        ,collection_(collection)
-    {
-    }
+        CollectionQueue();
 
-    bool operator()() const
+        /// the most urgent priority of the pending tasks
+        TaskPriority urgentPriority() const;
+    };
+
+    typedef std::map<std::string, CollectionQueue> QueueMap;
+
+    /// the task running on current thread
+    struct WorkerContext
     {
-        return collection_ != current_task_collection_.second;
-    }
+        JobScheduler* scheduler_;
+        std::size_t workerId_;
+        std::string collection_;
+        TaskPriority priority_;
+    };
+
+    void runWorker_(std::size_t workerId);
+
+    /**
+     * @param isHeadOnly if true, only the first pending task of each
+     *        queue is compared, otherwise, the queue is as urgent as its most
+     *        urgent pending task.
+     * @return the collection queue to run, which is not running and has a
+     *         pending task more urgent than @p priority, or NULL if not found
+     */
+    CollectionQueue* selectQueue_(int priority, bool isHeadOnly);
+
+    void startTask_(CollectionQueue& queue, std::size_t workerId, Task& task);
+
+    /**
+     * @return true if the task is interrupted
+     */
+    bool runTask_(const Task& task);
+
+    void finishTask_(const Task& task);
+
+    bool hasUnfinishedTask_(const std::string& collection, uint64_t seq) const;
+
+    bool hasUnfinishedTask_(const CollectionQueue& queue, uint64_t seq) const;
+
+    void runUrgentTask_(WorkerContext& context);
+
+    bool isWorkerThread_() const;
+
+    void getQueueStatus_(
+        const std::string& collection,
+        const CollectionQueue& queue,
+        const boost::posix_time::ptime& now,
+        QueueStatus& status) const;
+
+private:
+    boost::mutex mutex_;
+
+    /// notified when a task is added or finished
+    boost::condition_variable taskCond_;
+
+    /// notified when a task is finished
+    boost::condition_variable finishCond_;
+
+    /// notified when a pending task is started or removed
+    boost::condition_variable capacityCond_;
+
+    QueueMap queues_;
+
+    std::vector<boost::thread*> workers_;
+
+    /// the collection of the innermost task running on each worker,
+    /// it is changed when a task is run inline
+    std::vector<std::string> workerCollections_;
+
+    std::size_t idleWorkerNum_;
+
+    /// the number of running tasks, including the tasks run inline
+    std::size_t runningNum_;
+
+    bool isSerialized_;
+
+    std::size_t pendingNum_;
+
+    std::size_t capacity_;
+
+    uint64_t nextSeq_;
+
+    bool isClosed_;
+
+    /// the number of pending tasks in each priority, it is read without
+    /// lock in @c preemptionPoint()
+    boost::atomic<std::size_t> priorityPendingNum_[PRIORITY_NUM];
+
+    static boost::thread_specific_ptr<WorkerContext> workerContext_;
 };
 
 }
@@ -30,6 +30,7 @@
 (attr_value)\
 (attr_values)\
 (auto_select_limit)\
+(average_wait_time)\
 (boost_group_label)\
 (category)\
 (category_score)\
@@ -44,6 +45,7 @@
 (custom_rank)\
 (disable_sharding)\
 (document_count)\
+(dynamic_pruning)\
 (elapsed_time)\
 (errors)\
 (expression)\
@@ -58,9 +60,11 @@
 (group_property)\
 (grouptop)\
 (highlight)\
+(hit_count)\
 (in)\
 (index)\
 (index_scd_path)\
+(invalidation_count)\
 (is_random_rank)\
 (is_require_related)\
 (keywords)\
@@ -73,20 +77,26 @@
 (log_keywords)\
 (longitude)\
 (lucky)\
+(master_search_cache)\
 (max)\
+(max_wait_time)\
 (merchant)\
 (meta)\
 (min)\
 (mining)\
+(miss_count)\
 (mode)\
 (name)\
 (name_entity_item)\
 (name_entity_type)\
 (offset)\
+(oldest_wait_time)\
 (operator_)\
 (order)\
 (original_query)\
 (params)\
+(partial_result)\
+(pending_count)\
 (pos)\
 (privilege_Query)\
 (privilege_Weight)\
@@ -108,6 +118,7 @@
 (scope)\
 (score)\
 (search)\
+(search_cache)\
 (search_session)\
 (searching_mode)\
 (select)\
@@ -121,6 +132,7 @@
 (summary)\
 (summary_property_alias)\
 (summary_sentence_count)\
+(task_queue)\
 (taxonomy_label)\
 (threshold)\
 (tokens_threshold)\
@@ -149,10 +161,10 @@ DOCID
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/DocumentsGetHandler.cpp:222
 
 DistributeStatus
-  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:106
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:155
 
 MemoryStatus
-  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:107
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:156
 
 USERID
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/DocumentsController.cpp:674
@@ -227,6 +239,9 @@ attr_values
 auto_select_limit
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/parsers/SearchParser.cpp:570
 
+average_wait_time
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:136
+
 boost_group_label
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/parsers/SearchParser.cpp:650
 
@@ -279,7 +294,7 @@ count
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/parsers/SearchParser.cpp:183
 
 counter
-  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:87
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:106
 
 custom_rank
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/DocumentsSearchHandler.cpp:224
@@ -290,15 +305,19 @@ disable_sharding
 
 document_count
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/CommandsController.cpp:72
-  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:70
-  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:85
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:89
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:104
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/renderers/DocumentsRenderer.cpp:221
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/renderers/DocumentsRenderer.cpp:227
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/renderers/DocumentsRenderer.cpp:257
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/renderers/DocumentsRenderer.cpp:267
 
+dynamic_pruning
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/parsers/SearchParser.cpp:440
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/parsers/SearchParser.cpp:442
+
 elapsed_time
-  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:81
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:100
 
 errors
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/CollectionController.cpp:80
@@ -351,16 +370,24 @@ grouptop
 highlight
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/parsers/SelectParser.cpp:182
 
+hit_count
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:118
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:123
+
 in
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/parsers/SearchParser.cpp:455
 
 index
-  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:67
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:86
 
 index_scd_path
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/CollectionController.cpp:753
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/CommandsController.cpp:77
 
+invalidation_count
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:120
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:125
+
 is_random_rank
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/parsers/SearchParser.cpp:179
 
@@ -382,16 +409,16 @@ labels
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/renderers/DocumentsRenderer.cpp:259
 
 last_modified
-  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:69
-  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:86
-  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:93
-  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:100
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:88
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:105
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:142
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:149
 
 latitude
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/parsers/GeoLocationRankingParser.cpp:42
 
 left_time
-  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:82
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:101
 
 limit
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/core/common/parsers/PageInfoParser.cpp:20
@@ -410,21 +437,31 @@ lucky
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/parsers/SearchParser.cpp:412
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/parsers/SearchParser.cpp:414
 
+master_search_cache
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:122
+
 max
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/DocumentsSearchHandler.cpp:699
 
+max_wait_time
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:137
+
 merchant
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/core/mining-manager/merchant-score-manager/MerchantScoreParser.cpp:25
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/core/mining-manager/merchant-score-manager/MerchantScoreRenderer.cpp:20
 
 meta
-  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:83
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:102
 
 min
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/DocumentsSearchHandler.cpp:698
 
 mining
-  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:91
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:140
+
+miss_count
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:119
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:124
 
 mode
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/parsers/SearchParser.cpp:268
@@ -443,6 +480,9 @@ offset
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/core/common/parsers/PageInfoParser.cpp:15
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/core/common/parsers/PageInfoParser.cpp:17
 
+oldest_wait_time
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:135
+
 operator_
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/core/common/parsers/ConditionParser.cpp:70
 
@@ -457,6 +497,12 @@ params
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/parsers/CustomRankingParser.cpp:79
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/parsers/CustomRankingParser.cpp:80
 
+partial_result
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/DocumentsSearchHandler.cpp:124
+
+pending_count
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:134
+
 pos
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/DocumentsController.cpp:682
 
@@ -469,7 +515,7 @@ privilege_Weight
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/parsers/SearchParser.cpp:337
 
 progress
-  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:80
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:99
 
 property
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/core/common/parsers/ConditionParser.cpp:45
@@ -574,6 +620,9 @@ search
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/CollectionHandler.cpp:61
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/DocumentsSearchHandler.cpp:202
 
+search_cache
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:117
+
 search_session
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/DocumentsGetHandler.cpp:98
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/DocumentsGetHandler.cpp:101
@@ -599,10 +648,11 @@ split_property_value
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/parsers/SelectParser.cpp:184
 
 status
-  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:68
-  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:76
-  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:92
-  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:98
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:87
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:95
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:133
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:141
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:147
 
 sub_labels
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/renderers/DocumentsRenderer.cpp:228
@@ -619,6 +669,9 @@ summary_property_alias
 summary_sentence_count
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/parsers/SelectParser.cpp:189
 
+task_queue
+  /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/controllers/StatusController.cpp:132
+
 taxonomy_label
   /home/lscm/b5m/dev/codebase/sf1r-lite/source/process/parsers/SearchParser.cpp:161
 
@@ -160,6 +160,21 @@ public:
         value = static_cast<double>(data_[pos]);
         return true;
     }
+    void getDoubleValues(const docid_t* docids, std::size_t num,
+                         double* values, double defaultValue,
+                         bool isLock) const
+    {
+        ScopedReadBoolLock lock(mutex_, isLock);
+        const std::size_t dataSize = data_.size();
+        for (std::size_t i = 0; i < num; ++i)
+        {
+            const docid_t docid = docids[i];
+            if (docid < dataSize && data_[docid] != invalidValue_)
+                values[i] = static_cast<double>(data_[docid]);
+            else
+                values[i] = defaultValue;
+        }
+    }
     bool getStringValue(std::size_t pos, std::string& value, bool isLock) const
     {
         ScopedReadBoolLock lock(mutex_, isLock);
@@ -227,6 +242,11 @@ public:
         return true;
     }
 
+    const T& getInvalidValue() const
+    {
+        return invalidValue_;
+    }
+
     void* getValueList()
     {
         if (!data_.empty())
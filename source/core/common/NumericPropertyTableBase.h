@@ -29,11 +29,30 @@ public:
 
     virtual bool isValid(std::size_t pos, bool isLock = true) const { return false; }
 
+    /// whether each value is a range, which is compared by both its ends.
+    virtual bool isRange() const { return false; }
+
     virtual bool getInt32Value(std::size_t pos, int32_t& value, bool isLock = true) const = 0;
     virtual bool getFloatValue(std::size_t pos, float& value, bool isLock = true) const = 0;
     virtual bool getInt64Value(std::size_t pos, int64_t& value, bool isLock = true) const = 0;
     virtual bool getDoubleValue(std::size_t pos, double& value, bool isLock = true) const = 0;
 
+    /**
+     * get the double values of @p num docs under one lock,
+     * the doc without value gets @p defaultValue.
+     */
+    virtual void getDoubleValues(const docid_t* docids, std::size_t num,
+                                 double* values, double defaultValue,
+                                 bool isLock = true) const
+    {
+        ScopedReadBoolLock lock(mutex_, isLock);
+        for (std::size_t i = 0; i < num; ++i)
+        {
+            if (!getDoubleValue(docids[i], values[i], false))
+                values[i] = defaultValue;
+        }
+    }
+
     virtual bool getStringValue(std::size_t pos, std::string& value, bool isLock = true) const = 0;
     virtual bool getDoublePairValue(std::size_t pos, std::pair<double, double>& value, bool isLock = true) const = 0;
     virtual bool getInt64PairValue(std::size_t pos, std::pair<int64_t, int64_t>& value, bool isLock = true) const = 0;
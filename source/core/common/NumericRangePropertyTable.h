@@ -127,6 +127,11 @@ public:
         return data_.size();
     }
 
+    bool isRange() const
+    {
+        return true;
+    }
+
     void flush()
     {
         if (!dirty_) return;
@@ -0,0 +1,227 @@
+///
+/// @file OrderedBlockPreparer.h
+/// @brief prepare blocks by multiple threads, while the prepared blocks
+///        are consumed in the order they are added.
+///
+
+#ifndef SF1R_ORDERED_BLOCK_PREPARER_H
+#define SF1R_ORDERED_BLOCK_PREPARER_H
+
+#include <glog/logging.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <deque>
+#include <exception>
+#include <algorithm> // max
+
+namespace sf1r
+{
+
+/**
+ * The blocks are added and consumed by one thread, such as the thread
+ * iterating an SCD file, while they are prepared by the prepare threads.
+ * The prepare threads are not started until the first block is added.
+ */
+template <class BlockT>
+class OrderedBlockPreparer
+{
+public:
+    typedef boost::shared_ptr<BlockT> BlockPtr;
+    typedef boost::function<void(BlockT&)> BlockFunc;
+
+    /**
+     * @param threadNum the number of prepare threads
+     * @param prepareFunc it is called in prepare threads
+     * @param consumeFunc it is called in the thread calling @c consume()
+     */
+    OrderedBlockPreparer(
+        std::size_t threadNum,
+        const BlockFunc& prepareFunc,
+        const BlockFunc& consumeFunc)
+        : threadNum_(std::max<std::size_t>(threadNum, 1))
+        , prepareFunc_(prepareFunc)
+        , consumeFunc_(consumeFunc)
+        , isStop_(false)
+    {
+    }
+
+    ~OrderedBlockPreparer()
+    {
+        {
+            boost::unique_lock<boost::mutex> lock(mutex_);
+            isStop_ = true;
+            prepareCond_.notify_all();
+        }
+        threads_.join_all();
+    }
+
+    /**
+     * add the block to be prepared.
+     */
+    void add(const BlockPtr& block)
+    {
+        startThreads_();
+
+        TaskPtr task(new Task(block));
+        pendingTasks_.push_back(task);
+
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        prepareTasks_.push_back(task);
+        prepareCond_.notify_one();
+    }
+
+    /**
+     * consume the prepared blocks in the order they are added, until there
+     * are at most @p maxPendingNum blocks left, the front block is waited
+     * only if there are more than @p maxPendingNum blocks left.
+     */
+    void consume(std::size_t maxPendingNum)
+    {
+        while (!pendingTasks_.empty())
+        {
+            TaskPtr task = pendingTasks_.front();
+            {
+                boost::unique_lock<boost::mutex> lock(mutex_);
+
+                if (!task->isDone && pendingTasks_.size() <= maxPendingNum)
+                    break;
+
+                while (!task->isDone)
+                {
+                    doneCond_.wait(lock);
+                }
+            }
+
+            // popped before consumed, so that it would not be consumed
+            // twice if @c consumeFunc_ throws
+            pendingTasks_.pop_front();
+            consumeFunc_(*task->block);
+        }
+    }
+
+    /**
+     * drop the blocks not consumed yet, the blocks being prepared are
+     * waited, and the blocks not started are skipped.
+     */
+    void reset()
+    {
+        boost::unique_lock<boost::mutex> lock(mutex_);
+
+        for (typename std::deque<TaskPtr>::iterator it = prepareTasks_.begin();
+             it != prepareTasks_.end(); ++it)
+        {
+            (*it)->isDone = true;
+        }
+        prepareTasks_.clear();
+
+        for (typename std::deque<TaskPtr>::iterator it = pendingTasks_.begin();
+             it != pendingTasks_.end(); ++it)
+        {
+            while (!(*it)->isDone)
+            {
+                doneCond_.wait(lock);
+            }
+        }
+        pendingTasks_.clear();
+    }
+
+    /**
+     * @return the number of blocks not consumed yet
+     */
+    std::size_t pendingNum() const
+    {
+        return pendingTasks_.size();
+    }
+
+    /**
+     * @return the number of prepare threads started
+     */
+    std::size_t startedThreadNum() const
+    {
+        return threads_.size();
+    }
+
+private:
+    struct Task
+    {
+        BlockPtr block;
+
+        /** guarded by mutex_ */
+        bool isDone;
+
+        explicit Task(const BlockPtr& b) : block(b), isDone(false) {}
+    };
+    typedef boost::shared_ptr<Task> TaskPtr;
+
+    void startThreads_()
+    {
+        if (threads_.size() > 0)
+            return;
+
+        for (std::size_t i = 0; i < threadNum_; ++i)
+        {
+            threads_.create_thread(boost::bind(&OrderedBlockPreparer::prepareLoop_, this));
+        }
+    }
+
+    void prepareLoop_()
+    {
+        while (true)
+        {
+            TaskPtr task;
+            {
+                boost::unique_lock<boost::mutex> lock(mutex_);
+                while (!isStop_ && prepareTasks_.empty())
+                {
+                    prepareCond_.wait(lock);
+                }
+
+                if (isStop_)
+                    return;
+
+                task = prepareTasks_.front();
+                prepareTasks_.pop_front();
+            }
+
+            try
+            {
+                prepareFunc_(*task->block);
+            }
+            catch (const std::exception& e)
+            {
+                LOG(ERROR) << "exception in preparing block: " << e.what();
+            }
+
+            boost::unique_lock<boost::mutex> lock(mutex_);
+            task->isDone = true;
+            doneCond_.notify_all();
+        }
+    }
+
+private:
+    const std::size_t threadNum_;
+
+    const BlockFunc prepareFunc_;
+
+    const BlockFunc consumeFunc_;
+
+    /** the blocks not consumed, only accessed by the consuming thread */
+    std::deque<TaskPtr> pendingTasks_;
+
+    /** the blocks not started preparing, guarded by mutex_ */
+    std::deque<TaskPtr> prepareTasks_;
+
+    bool isStop_;
+
+    boost::mutex mutex_;
+    boost::condition_variable prepareCond_;
+    boost::condition_variable doneCond_;
+
+    boost::thread_group threads_;
+};
+
+} // namespace sf1r
+
+#endif // SF1R_ORDERED_BLOCK_PREPARER_H
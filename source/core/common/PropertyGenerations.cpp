@@ -0,0 +1,89 @@
+#include "PropertyGenerations.h"
+
+using namespace sf1r;
+
+PropertyGenerations::PropertyGenerations()
+    : docGeneration_(0)
+    , allPropGeneration_(0)
+{
+}
+
+void PropertyGenerations::increaseDocGeneration()
+{
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    ++docGeneration_;
+}
+
+void PropertyGenerations::increasePropGeneration(
+    const std::vector<std::string>& properties)
+{
+    if (properties.empty())
+        return;
+
+    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    ++allPropGeneration_;
+
+    for (std::vector<std::string>::const_iterator it = properties.begin();
+        it != properties.end(); ++it)
+    {
+        ++propGenerations_[*it];
+    }
+}
+
+void PropertyGenerations::takeSnapshot(
+    const std::set<std::string>* properties,
+    GenerationSnapshot& snapshot) const
+{
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+
+    snapshot.docGeneration = docGeneration_;
+    snapshot.isAllProps = (properties == NULL);
+    snapshot.allPropGeneration = allPropGeneration_;
+    snapshot.propGenerations.clear();
+
+    if (properties == NULL)
+        return;
+
+    snapshot.propGenerations.reserve(properties->size());
+    for (std::set<std::string>::const_iterator it = properties->begin();
+        it != properties->end(); ++it)
+    {
+        snapshot.propGenerations.push_back(
+            std::make_pair(*it, getPropGeneration_(*it)));
+    }
+}
+
+bool PropertyGenerations::isValid(const GenerationSnapshot& snapshot) const
+{
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+
+    if (snapshot.docGeneration != docGeneration_)
+        return false;
+
+    // no property has been changed at all
+    if (snapshot.allPropGeneration == allPropGeneration_)
+        return true;
+
+    if (snapshot.isAllProps)
+        return false;
+
+    for (std::vector<std::pair<std::string, generation_t> >::const_iterator
+        it = snapshot.propGenerations.begin();
+        it != snapshot.propGenerations.end(); ++it)
+    {
+        if (getPropGeneration_(it->first) != it->second)
+            return false;
+    }
+
+    return true;
+}
+
+PropertyGenerations::generation_t PropertyGenerations::getPropGeneration_(
+    const std::string& property) const
+{
+    PropGenerationMap::const_iterator it = propGenerations_.find(property);
+    if (it == propGenerations_.end())
+        return 0;
+
+    return it->second;
+}
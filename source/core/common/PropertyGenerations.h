@@ -0,0 +1,111 @@
+///
+/// @file PropertyGenerations.h
+/// @brief generation counters of document properties, used to invalidate
+///        only the cache entries depending on the changed properties.
+///
+
+#ifndef SF1R_PROPERTY_GENERATIONS_H
+#define SF1R_PROPERTY_GENERATIONS_H
+
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <utility> // pair
+#include <boost/thread/shared_mutex.hpp>
+#include <boost/cstdint.hpp>
+
+namespace sf1r
+{
+
+/**
+ * the generations a cache entry depends on, taken when the entry is cached.
+ */
+struct GenerationSnapshot
+{
+    /** the doc generation */
+    uint64_t docGeneration;
+
+    /** true if the entry depends on all properties */
+    bool isAllProps;
+
+    /** the generation increased on any property change */
+    uint64_t allPropGeneration;
+
+    /** the generation of each dependent property */
+    std::vector<std::pair<std::string, uint64_t> > propGenerations;
+
+    GenerationSnapshot()
+        : docGeneration(0)
+        , isAllProps(false)
+        , allPropGeneration(0)
+    {}
+};
+
+/**
+ * the hit/miss/invalidation counts of one cache.
+ */
+struct CacheStats
+{
+    uint64_t hitNum;
+    uint64_t missNum;
+
+    /** the number of entries found but dropped as stale */
+    uint64_t invalidationNum;
+
+    CacheStats()
+        : hitNum(0)
+        , missNum(0)
+        , invalidationNum(0)
+    {}
+};
+
+class PropertyGenerations
+{
+public:
+    typedef uint64_t generation_t;
+
+    PropertyGenerations();
+
+    /**
+     * called when docs are inserted or removed,
+     * it invalidates all cache entries.
+     */
+    void increaseDocGeneration();
+
+    /**
+     * called when the values of @p properties are updated in place,
+     * it invalidates the cache entries depending on any of @p properties.
+     */
+    void increasePropGeneration(const std::vector<std::string>& properties);
+
+    /**
+     * take the current generations of @p properties.
+     * @param properties if NULL, the snapshot depends on all properties
+     */
+    void takeSnapshot(
+        const std::set<std::string>* properties,
+        GenerationSnapshot& snapshot) const;
+
+    /**
+     * @return true if no generation in @p snapshot has been changed.
+     */
+    bool isValid(const GenerationSnapshot& snapshot) const;
+
+private:
+    generation_t getPropGeneration_(const std::string& property) const;
+
+private:
+    generation_t docGeneration_;
+
+    generation_t allPropGeneration_;
+
+    typedef std::map<std::string, generation_t> PropGenerationMap;
+    PropGenerationMap propGenerations_;
+
+    mutable boost::shared_mutex mutex_;
+};
+
+} // namespace sf1r
+
+#endif // SF1R_PROPERTY_GENERATIONS_H
@@ -16,15 +16,13 @@
 #include <glog/logging.h>
 
 #include "PropSharedLock.h"
-
-#include "PropSharedLock.h"
+#include "StringSortDict.h"
 
 namespace sf1r
 {
 
 class RTypeStringPropTable : public PropSharedLock
 {
-    typedef std::vector<std::string> RTypeVector;
 public:
     RTypeStringPropTable(PropertyDataType type)
         : type_(type)
@@ -61,7 +59,7 @@ public:
 
     void enableSort()
     {
-        ScopedWriteBoolLock(mutex_, true);
+        ScopedWriteBoolLock lock(mutex_, true);
         if (sortEnabled_)
             return;
         sortEnabled_ = true;
@@ -153,11 +151,7 @@ public:
             ScopedWriteBoolLock lock(mutex_, true);
             if (sortEnabled_)
             {
-                if (docId >= dataInMem_.size())
-                {
-                    dataInMem_.resize(docId+1, invalidValue_);
-                }
-                dataInMem_[docId]=rtype_value;
+                sortDict_.setValue(docId, rtype_value);
             }
             if (docId > maxDocId_)
             {
@@ -180,6 +174,8 @@ public:
         return false;
     }
 
+    /// compare the order-preserving codes of the values,
+    /// the doc without value is less than the others.
     int compareValues(std::size_t lhs, std::size_t rhs, bool isLock)
     {
         ScopedReadBoolLock lock(mutex_, isLock);
@@ -187,33 +183,33 @@ public:
         {
             return -1;
         }
-        const std::string lv = dataInMem_[lhs];
-        if (lv == invalidValue_) return -1;
-        const std::string rv = dataInMem_[rhs];
-        if (rv == invalidValue_) return 1;
-        if (lv < rv ) return -1;
-        if (lv > rv ) return 1;
-        return 0;
+        return sortDict_.compare(lhs, rhs);
+    }
+
+    /// the order-preserving code of the value, 0 if the doc has no value,
+    /// it is valid only after @c enableSort() is called.
+    StringSortDict::code_t getSortCode(std::size_t docId, bool isLock) const
+    {
+        ScopedReadBoolLock lock(mutex_, isLock);
+        return sortDict_.getCode(docId);
     }
 private:
     void load_()
     {
-        dataInMem_.clear();
-        dataInMem_.resize(maxDocId_+1, invalidValue_);
+        std::vector<std::string> docValues(maxDocId_+1, invalidValue_);
         for (unsigned int docId = 0; docId <= maxDocId_; ++docId)
         {
-            std::string value;
-            if (getRTypeString(docId, value))
-            {
-                dataInMem_[docId]=value;
-            }
+            getRTypeString(docId, docValues[docId]);
         }
+        sortDict_.build(docValues);
+        LOG(INFO) << "sort codes built for " << path_ << ", docs: " << sortDict_.docNum()
+            << ", values: " << sortDict_.valueNum();
     }
 protected:
     PropertyDataType type_;
     std::string path_;
     Lux::IO::Array* data_;
-    RTypeVector dataInMem_;
+    StringSortDict sortDict_;
     bool sortEnabled_;
     unsigned int maxDocId_;
     std::string invalidValue_;
@@ -0,0 +1,265 @@
+#include "ScdParallelParser.h"
+
+#include <glog/logging.h>
+#include <boost/bind.hpp>
+#include <fstream>
+#include <algorithm>
+#include <cstring>
+
+using namespace sf1r;
+
+const offset_type ScdParallelParser::DEFAULT_CHUNK_SIZE;
+
+namespace
+{
+/** the buffer size to find a doc boundary */
+const std::size_t kFindBufferSize = 64 * 1024;
+
+/** a doc starts at the beginning of the line with this tag */
+const char kDocBeginPattern[] = "\n<DOCID>";
+}
+
+ScdParallelParser::ScdParallelParser(
+    izenelib::util::UString::EncodingType encoding,
+    std::size_t threadNum,
+    std::size_t windowSize,
+    offset_type chunkSize)
+    : encoding_(encoding)
+    , threadNum_(std::max<std::size_t>(threadNum, 1))
+    , windowSize_(std::max<std::size_t>(windowSize, 1))
+    , chunkSize_(std::max<offset_type>(chunkSize, 1))
+    , currentChunk_(0)
+    , currentDoc_(0)
+    , nextParseChunk_(0)
+    , isStop_(false)
+{
+}
+
+ScdParallelParser::~ScdParallelParser()
+{
+    stop();
+}
+
+bool ScdParallelParser::load(const std::string& fileName)
+{
+    std::ifstream ifs(fileName.c_str(), std::ios::binary);
+    if (!ifs)
+    {
+        LOG(ERROR) << "failed to open SCD file " << fileName;
+        return false;
+    }
+
+    ifs.seekg(0, std::ios::end);
+    const offset_type fileSize = ifs.tellg();
+
+    std::vector<offset_type> bounds;
+    splitChunks_(ifs, fileSize, bounds);
+
+    fileName_ = fileName;
+    for (std::size_t i = 0; i + 1 < bounds.size(); ++i)
+    {
+        chunks_.push_back(ChunkPtr(new Chunk(bounds[i], bounds[i+1])));
+    }
+
+    const std::size_t threadNum = std::min(threadNum_, chunks_.size());
+    for (std::size_t i = 0; i < threadNum; ++i)
+    {
+        threads_.create_thread(boost::bind(&ScdParallelParser::parseChunks_, this));
+    }
+
+    LOG(INFO) << "parse SCD file " << fileName << " of size " << fileSize
+              << " in " << chunks_.size() << " chunks by " << threadNum << " threads";
+    return true;
+}
+
+bool ScdParallelParser::next(SCDDocPtr& doc, offset_type& offset)
+{
+    while (currentChunk_ < chunks_.size())
+    {
+        const Chunk& chunk = *chunks_[currentChunk_];
+
+        if (currentDoc_ == 0 && !waitParsed_(chunk))
+            return false;
+
+        if (currentDoc_ < chunk.docs.size())
+        {
+            const ParsedDoc& parsedDoc = chunk.docs[currentDoc_++];
+            doc = parsedDoc.doc;
+            offset = parsedDoc.offset;
+            return true;
+        }
+
+        releaseChunk_();
+    }
+
+    return false;
+}
+
+void ScdParallelParser::stop()
+{
+    {
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        isStop_ = true;
+        windowCond_.notify_all();
+        parsedCond_.notify_all();
+    }
+    threads_.join_all();
+}
+
+bool ScdParallelParser::waitParsed_(const Chunk& chunk)
+{
+    boost::unique_lock<boost::mutex> lock(mutex_);
+    while (!isStop_ && !chunk.isParsed)
+    {
+        parsedCond_.wait(lock);
+    }
+    return chunk.isParsed;
+}
+
+void ScdParallelParser::releaseChunk_()
+{
+    std::vector<ParsedDoc>().swap(chunks_[currentChunk_]->docs);
+    currentDoc_ = 0;
+
+    boost::unique_lock<boost::mutex> lock(mutex_);
+    ++currentChunk_;
+    windowCond_.notify_all();
+}
+
+void ScdParallelParser::splitChunks_(
+    std::ifstream& ifs,
+    offset_type fileSize,
+    std::vector<offset_type>& bounds) const
+{
+    bounds.push_back(0);
+
+    while (true)
+    {
+        const offset_type from = bounds.back() + chunkSize_;
+        if (from >= fileSize)
+            break;
+
+        const offset_type docBegin = findDocBegin_(ifs, from, fileSize);
+        if (docBegin >= fileSize)
+            break;
+
+        bounds.push_back(docBegin);
+    }
+
+    bounds.push_back(fileSize);
+}
+
+offset_type ScdParallelParser::findDocBegin_(
+    std::ifstream& ifs,
+    offset_type from,
+    offset_type fileSize) const
+{
+    const std::size_t patternLen = std::strlen(kDocBeginPattern);
+    std::vector<char> buffer(kFindBufferSize + patternLen);
+
+    ifs.clear();
+    ifs.seekg(from, std::ios::beg);
+
+    offset_type bufferBegin = from;
+    std::size_t keepLen = 0;
+
+    while (ifs)
+    {
+        ifs.read(&buffer[keepLen], kFindBufferSize);
+        const std::size_t dataLen = keepLen + ifs.gcount();
+
+        std::vector<char>::iterator found = std::search(
+            buffer.begin(), buffer.begin() + dataLen,
+            kDocBeginPattern, kDocBeginPattern + patternLen);
+
+        if (found != buffer.begin() + dataLen)
+        {
+            // skip the leading '\n'
+            return bufferBegin + (found - buffer.begin()) + 1;
+        }
+
+        // keep the tail in case the pattern is split between two reads
+        keepLen = std::min(dataLen, patternLen - 1);
+        std::copy(buffer.begin() + dataLen - keepLen,
+                  buffer.begin() + dataLen, buffer.begin());
+        bufferBegin += dataLen - keepLen;
+    }
+
+    return fileSize;
+}
+
+void ScdParallelParser::parseChunks_()
+{
+    // each thread loads the file once, and seeks to each chunk it takes
+    ScdParser parser(encoding_);
+    const bool isLoaded = parser.load(fileName_);
+    if (!isLoaded)
+    {
+        LOG(ERROR) << "failed to load SCD file " << fileName_;
+    }
+
+    while (true)
+    {
+        Chunk* chunk = NULL;
+        {
+            boost::unique_lock<boost::mutex> lock(mutex_);
+            while (!isStop_ && nextParseChunk_ < chunks_.size() &&
+                   nextParseChunk_ >= currentChunk_ + windowSize_)
+            {
+                windowCond_.wait(lock);
+            }
+
+            if (isStop_ || nextParseChunk_ >= chunks_.size())
+                return;
+
+            chunk = chunks_[nextParseChunk_++].get();
+        }
+
+        parseChunk_(parser, isLoaded, *chunk);
+
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        chunk->isParsed = true;
+        parsedCond_.notify_all();
+    }
+}
+
+void ScdParallelParser::parseChunk_(ScdParser& parser, bool isLoaded, Chunk& chunk)
+{
+    if (!isLoaded)
+    {
+        chunk.docs.push_back(ParsedDoc());
+        return;
+    }
+
+    // as the chunks are taken in order, the first chunk is always parsed
+    // by a parser not used before
+    ScdParser::iterator docIter = parser.begin();
+    if (chunk.begin > 0)
+    {
+        // as in ScdIndexIterator, the parser iterator starts at the
+        // current stream position
+        parser.fs().clear();
+        parser.fs().seekg(chunk.begin, std::ios::beg);
+        docIter = ScdParser::iterator(&parser, 0);
+    }
+
+    for (; docIter != parser.end(); ++docIter)
+    {
+        if (isStop_)
+            break;
+
+        SCDDocPtr doc = *docIter;
+
+        // the offset is where the current doc starts
+        const offset_type offset = docIter.getOffset();
+
+        if (doc && offset >= chunk.end)
+            break;
+
+        chunk.docs.push_back(ParsedDoc(doc, offset));
+
+        // the SCD file is not valid
+        if (!doc)
+            break;
+    }
+}
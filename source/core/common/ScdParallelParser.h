@@ -0,0 +1,166 @@
+///
+/// @file ScdParallelParser.h
+/// @brief parse one SCD file by multiple threads, while the docs are still
+///        output in file order.
+///
+
+#ifndef SF1R_SCD_PARALLEL_PARSER_H
+#define SF1R_SCD_PARALLEL_PARSER_H
+
+#include "ScdParser.h"
+
+#include <util/ustring/UString.h>
+
+#include <boost/atomic.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+#include <string>
+#include <vector>
+
+namespace sf1r
+{
+
+/**
+ * The file is split into many small chunks at doc boundaries, the chunks
+ * are parsed by a pool of threads, each thread takes the next chunk not
+ * parsed yet. The caller of @c next() consumes the chunks in file order,
+ * so that the docs are got in the same order as in the file.
+ *
+ * To bound the memory, only the chunks in a window starting from the
+ * chunk being consumed are parsed, the parsing threads wait for the window
+ * to move forward, and @c next() waits for the current chunk to be parsed.
+ */
+class ScdParallelParser
+{
+public:
+    /** the chunk smaller than this size is not split further */
+    static const offset_type DEFAULT_CHUNK_SIZE = 1024 * 1024;
+
+    /**
+     * @param encoding the encoding of the SCD file
+     * @param threadNum the max number of parsing threads
+     * @param windowSize the max number of chunks parsed but not consumed
+     * @param chunkSize the min size of each chunk
+     */
+    ScdParallelParser(
+        izenelib::util::UString::EncodingType encoding,
+        std::size_t threadNum,
+        std::size_t windowSize,
+        offset_type chunkSize = DEFAULT_CHUNK_SIZE);
+
+    ~ScdParallelParser();
+
+    /**
+     * split the file into chunks, and start parsing them.
+     * @return false if the file could not be read
+     */
+    bool load(const std::string& fileName);
+
+    /**
+     * get the next doc in file order.
+     * @param doc it is NULL if the SCD file is not valid
+     * @param offset the offset of @p doc in file
+     * @return false if all docs have been got
+     */
+    bool next(SCDDocPtr& doc, offset_type& offset);
+
+    /**
+     * stop the parsing threads, it is called in destructor,
+     * or it could be called to stop before all docs are got.
+     */
+    void stop();
+
+    std::size_t chunkNum() const { return chunks_.size(); }
+
+private:
+    struct ParsedDoc
+    {
+        SCDDocPtr doc;
+        offset_type offset;
+
+        ParsedDoc() : offset(0) {}
+        ParsedDoc(const SCDDocPtr& d, offset_type o) : doc(d), offset(o) {}
+    };
+
+    struct Chunk
+    {
+        /** the offset of the first doc */
+        offset_type begin;
+
+        /** the offset of the first doc in next chunk */
+        offset_type end;
+
+        /** written by the parsing thread before @c isParsed is set */
+        std::vector<ParsedDoc> docs;
+
+        /** guarded by mutex_ */
+        bool isParsed;
+
+        Chunk(offset_type b, offset_type e)
+            : begin(b), end(e), isParsed(false)
+        {}
+    };
+    typedef boost::shared_ptr<Chunk> ChunkPtr;
+
+    void splitChunks_(std::ifstream& ifs, offset_type fileSize,
+                      std::vector<offset_type>& bounds) const;
+
+    /**
+     * @return the offset of the first doc starting after @p from,
+     *         or @p fileSize if not found.
+     */
+    offset_type findDocBegin_(std::ifstream& ifs, offset_type from,
+                              offset_type fileSize) const;
+
+    /** the loop of each parsing thread */
+    void parseChunks_();
+
+    void parseChunk_(ScdParser& parser, bool isLoaded, Chunk& chunk);
+
+    /**
+     * wait until @p chunk is parsed.
+     * @return false if stopped
+     */
+    bool waitParsed_(const Chunk& chunk);
+
+    /** release the current chunk, and move the window forward */
+    void releaseChunk_();
+
+private:
+    const izenelib::util::UString::EncodingType encoding_;
+
+    const std::size_t threadNum_;
+
+    const std::size_t windowSize_;
+
+    const offset_type chunkSize_;
+
+    std::string fileName_;
+
+    std::vector<ChunkPtr> chunks_;
+
+    /** the chunk consumed in @c next(), guarded by mutex_ */
+    std::size_t currentChunk_;
+
+    /** the doc to get in the current chunk, only accessed in @c next() */
+    std::size_t currentDoc_;
+
+    /** the next chunk to parse, guarded by mutex_ */
+    std::size_t nextParseChunk_;
+
+    boost::atomic<bool> isStop_;
+
+    boost::mutex mutex_;
+
+    /** notified when the window moves forward */
+    boost::condition_variable windowCond_;
+
+    /** notified when a chunk is parsed */
+    boost::condition_variable parsedCond_;
+
+    boost::thread_group threads_;
+};
+
+} // namespace sf1r
+
+#endif // SF1R_SCD_PARALLEL_PARSER_H
@@ -7,6 +7,7 @@
  * @date Updated <2010-03-24 15:43:04>
  */
 #include "ResultType.h" // KeywordSearchResult
+#include "PropertyGenerations.h"
 #include <query-manager/QueryIdentity.h>
 #include <mining-manager/group-manager/ontology_rep.h>
 #include <cache/IzeneCache.h>
@@ -14,6 +15,8 @@
 
 #include <vector>
 #include <deque>
+#include <set>
+#include <boost/atomic.hpp>
 
 namespace sf1r
 {
@@ -30,12 +33,23 @@ public:
     //    izenelib::cache::RDE_HASH,
     //    izenelib::cache::LRLFU
     //> cache_type;
-    typedef izenelib::concurrent_cache::ConcurrentCache<key_type, value_type> cache_type;
+
+    /** the cached result with the generations it depends on */
+    struct CacheEntry
+    {
+        value_type result;
+        GenerationSnapshot snapshot;
+    };
+
+    typedef izenelib::concurrent_cache::ConcurrentCache<key_type, CacheEntry> cache_type;
 
     explicit SearchCache(unsigned cacheSize, time_t refreshInterval = 60*60, bool refreshAll = false)
         : cache_(cacheSize, izenelib::cache::LRLFU), special_cache_(cacheSize, izenelib::cache::LRLFU)
         , refreshInterval_(refreshInterval)
         , refreshAll_(refreshAll)
+        , hitNum_(0)
+        , missNum_(0)
+        , invalidationNum_(0)
     {
     }
 
@@ -48,26 +62,50 @@ public:
         if (result.distSearchInfo_.nodeType_ == DistKeywordSearchInfo::NODE_WORKER)
             return false;
 
-        value_type value;
+        CacheEntry entry;
         cache_type* pcache = &cache_;
         if (IsSpecialSearch(key))
         {
             pcache = &special_cache_;
         }
-        if ((*pcache).get(key, value))
+        if ((*pcache).get(key, entry))
         {
-            if (!needRefresh(key, value.timeStamp_))
+            if (!generations_.isValid(entry.snapshot))
+            {
+                ++invalidationNum_;
+            }
+            else if (!needRefresh(key, entry.result.timeStamp_))
             {
-                result.swap(value);
+                result.swap(entry.result);
+                ++hitNum_;
                 return true;
             }
         }
 
+        ++missNum_;
         return false;
     }
 
+    /**
+     * take the current generations of the properties @p key depends on,
+     * it should be called before searching, so that the index updates
+     * during searching would invalidate the result.
+     */
+    void takeSnapshot(const key_type& key, GenerationSnapshot& snapshot) const
+    {
+        std::set<std::string> dependentProps;
+        generations_.takeSnapshot(
+            key.getDependentProperties(productRankProps_, dependentProps) ?
+                &dependentProps : NULL,
+            snapshot);
+    }
+
+    /**
+     * @param snapshot the generations taken before searching
+     */
     void set(const key_type& key,
-             value_type& result)
+             value_type& result,
+             const GenerationSnapshot& snapshot)
     {
         if (result.distSearchInfo_.nodeType_ == DistKeywordSearchInfo::NODE_WORKER)
             return;
@@ -87,19 +125,55 @@ public:
             pcache = &special_cache_;
         }
 
-        (*pcache).insert(key, result);
+        CacheEntry entry;
+        entry.snapshot = snapshot;
+
+        entry.result.swap(result);
+        (*pcache).insert(key, entry);
+        entry.result.swap(result);
 
         fullText.swap(result.fullTextOfDocumentInPage_);
         snippetText.swap(result.snippetTextOfDocumentInPage_);
         rawText.swap(result.rawTextOfSummaryInPage_);
     }
 
+    /**
+     * the results being searched when it is called would not be cached.
+     */
     void clear()
     {
+        generations_.increaseDocGeneration();
         cache_.clear();
         special_cache_.clear();
     }
 
+    /**
+     * invalidate the entries depending on any of @p properties,
+     * the stale entries are dropped lazily when they are got.
+     */
+    void invalidate(const std::vector<std::string>& properties)
+    {
+        generations_.increasePropGeneration(properties);
+    }
+
+    /**
+     * set the properties used in product ranking,
+     * it should be called before searching.
+     */
+    void setProductRankProperties(const std::set<std::string>& properties)
+    {
+        productRankProps_ = properties;
+    }
+
+    CacheStats getStats() const
+    {
+        CacheStats stats;
+        stats.hitNum = hitNum_;
+        stats.missNum = missNum_;
+        stats.invalidationNum = invalidationNum_;
+        return stats;
+    }
+
 private:
     /**
      * For keys with static values, we need not to refresh cache;
@@ -128,6 +202,14 @@ private:
     cache_type special_cache_;
     time_t refreshInterval_; // seconds
     bool refreshAll_;
+
+    PropertyGenerations generations_;
+
+    std::set<std::string> productRankProps_;
+
+    boost::atomic<uint64_t> hitNum_;
+    boost::atomic<uint64_t> missNum_;
+    boost::atomic<uint64_t> invalidationNum_;
 };
 
 } // namespace sf1r
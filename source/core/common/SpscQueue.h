@@ -0,0 +1,102 @@
+///
+/// @file SpscQueue.h
+/// @brief a bounded lock-free queue for single producer and single consumer.
+///
+
+#ifndef SF1R_SPSC_QUEUE_H
+#define SF1R_SPSC_QUEUE_H
+
+#include <boost/atomic.hpp>
+#include <vector>
+
+namespace sf1r
+{
+
+/**
+ * A ring buffer, the producer only writes @c tail_, and the consumer only
+ * writes @c head_, so that no lock is needed. It is only safe when there
+ * is at most one thread calling @c tryPush() and at most one thread
+ * calling @c tryPop() at the same time.
+ */
+template <typename T>
+class SpscQueue
+{
+public:
+    /**
+     * @param capacity the max number of elements in queue
+     */
+    explicit SpscQueue(std::size_t capacity)
+        : buffer_(capacity + 1)
+        , head_(0)
+        , tail_(0)
+    {
+    }
+
+    /**
+     * @return false if the queue is full.
+     */
+    bool tryPush(const T& value)
+    {
+        const std::size_t tail = tail_.load(boost::memory_order_relaxed);
+        const std::size_t next = increase_(tail);
+
+        if (next == head_.load(boost::memory_order_acquire))
+            return false;
+
+        buffer_[tail] = value;
+        tail_.store(next, boost::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @return false if the queue is empty.
+     */
+    bool tryPop(T& value)
+    {
+        const std::size_t head = head_.load(boost::memory_order_relaxed);
+
+        if (head == tail_.load(boost::memory_order_acquire))
+            return false;
+
+        value = buffer_[head];
+        // release the resource held by the element, such as a shared_ptr
+        buffer_[head] = T();
+        head_.store(increase_(head), boost::memory_order_release);
+        return true;
+    }
+
+    bool empty() const
+    {
+        return head_.load(boost::memory_order_acquire) ==
+            tail_.load(boost::memory_order_acquire);
+    }
+
+    std::size_t capacity() const
+    {
+        return buffer_.size() - 1;
+    }
+
+private:
+    std::size_t increase_(std::size_t pos) const
+    {
+        return ++pos == buffer_.size() ? 0 : pos;
+    }
+
+private:
+    enum { CACHE_LINE_SIZE = 64 };
+
+    std::vector<T> buffer_;
+
+    /** the position to pop, written by the consumer */
+    boost::atomic<std::size_t> head_;
+
+    /** avoid false sharing between head_ and tail_ */
+    char padding_[CACHE_LINE_SIZE];
+
+    /** the position to push, written by the producer */
+    boost::atomic<std::size_t> tail_;
+};
+
+} // namespace sf1r
+
+#endif // SF1R_SPSC_QUEUE_H
@@ -0,0 +1,258 @@
+///
+/// @file StringSortDict.h
+/// @brief order-preserving dictionary of string property values, which
+///        maps each doc to an integer code, so that sorting by a string
+///        property compares integers instead of strings.
+///
+
+#ifndef SF1R_STRING_SORT_DICT_H
+#define SF1R_STRING_SORT_DICT_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <stdint.h>
+
+namespace sf1r
+{
+
+class StringSortDict
+{
+public:
+    typedef uint32_t code_t;
+    typedef std::map<std::string, code_t> ValueCodeMap;
+
+    /// the code of the doc without value, it is less than any other code
+    enum { INVALID_CODE = 0 };
+
+    StringSortDict()
+        : gap_(1)
+        , encodedNum_(0)
+        , reEncodeNum_(0)
+    {
+    }
+
+    void clear()
+    {
+        valueCodes_.clear();
+        docCodes_.clear();
+        gap_ = 1;
+        encodedNum_ = 0;
+    }
+
+    /// build the dictionary from the value of each doc,
+    /// the empty value means the doc has no value.
+    void build(const std::vector<std::string>& docValues)
+    {
+        clear();
+        for (std::size_t i = 0; i < docValues.size(); ++i)
+        {
+            if (!docValues[i].empty())
+            {
+                valueCodes_.insert(std::make_pair(docValues[i], code_t(INVALID_CODE)));
+            }
+        }
+        assignCodes_();
+
+        docCodes_.resize(docValues.size(), INVALID_CODE);
+        for (std::size_t i = 0; i < docValues.size(); ++i)
+        {
+            if (!docValues[i].empty())
+            {
+                docCodes_[i] = valueCodes_[docValues[i]];
+            }
+        }
+    }
+
+    /// set the value of a doc, a new value gets a code between its
+    /// neighbours, all codes are re-encoded when there is no gap left.
+    void setValue(std::size_t docId, const std::string& value)
+    {
+        if (docId >= docCodes_.size())
+        {
+            docCodes_.resize(docId + 1, INVALID_CODE);
+        }
+
+        if (value.empty())
+        {
+            docCodes_[docId] = INVALID_CODE;
+            return;
+        }
+
+        docCodes_[docId] = getCode_(value);
+
+        // the values no longer used are dropped in re-encoding
+        if (valueCodes_.size() > 2 * encodedNum_ + kMinStaleNum)
+        {
+            reEncode_();
+        }
+    }
+
+    code_t getCode(std::size_t docId) const
+    {
+        return docId < docCodes_.size() ? docCodes_[docId] : INVALID_CODE;
+    }
+
+    int compare(std::size_t lhs, std::size_t rhs) const
+    {
+        const code_t lc = getCode(lhs);
+        const code_t rc = getCode(rhs);
+        if (lc < rc) return -1;
+        if (lc > rc) return 1;
+        return 0;
+    }
+
+    std::size_t docNum() const
+    {
+        return docCodes_.size();
+    }
+
+    std::size_t valueNum() const
+    {
+        return valueCodes_.size();
+    }
+
+    std::size_t getReEncodeNum() const
+    {
+        return reEncodeNum_;
+    }
+
+private:
+    code_t getCode_(const std::string& value)
+    {
+        ValueCodeMap::iterator it = valueCodes_.lower_bound(value);
+        if (it != valueCodes_.end() && it->first == value)
+            return it->second;
+
+        code_t code = code_t(INVALID_CODE);
+        if (!findGap_(it, code))
+        {
+            reEncode_();
+            it = valueCodes_.lower_bound(value);
+            findGap_(it, code);
+        }
+        valueCodes_.insert(it, std::make_pair(value, code));
+        return code;
+    }
+
+    /// find the code between the neighbours of @p next,
+    /// the values appended in order are spaced by the encoding gap,
+    /// so that they would not use up the gap soon.
+    bool findGap_(ValueCodeMap::iterator next, code_t& code) const
+    {
+        const uint64_t upper = next == valueCodes_.end() ?
+            uint64_t(std::numeric_limits<code_t>::max()) + 1 : next->second;
+        uint64_t lower = INVALID_CODE;
+        if (next != valueCodes_.begin())
+        {
+            ValueCodeMap::iterator prev = next;
+            --prev;
+            lower = prev->second;
+        }
+
+        if (upper - lower < 2)
+            return false;
+
+        uint64_t step = (upper - lower) / 2;
+        if (next == valueCodes_.end())
+        {
+            step = std::min<uint64_t>(step, gap_);
+        }
+        code = lower + step;
+        return true;
+    }
+
+    /// assign the codes evenly spaced in the order of values,
+    /// the upper half of the codes is left for the appended values.
+    void assignCodes_()
+    {
+        const uint64_t maxCode = std::numeric_limits<code_t>::max();
+        gap_ = std::max<uint64_t>(maxCode / (2 * valueCodes_.size() + 1), 1);
+
+        uint64_t code = INVALID_CODE;
+        for (ValueCodeMap::iterator it = valueCodes_.begin();
+            it != valueCodes_.end(); ++it)
+        {
+            code = std::min(code + gap_, maxCode);
+            it->second = code;
+        }
+        encodedNum_ = valueCodes_.size();
+    }
+
+    void reEncode_()
+    {
+        ++reEncodeNum_;
+
+        // the codes in map are in ascending order, as the values are
+        std::vector<code_t> oldCodes;
+        oldCodes.reserve(valueCodes_.size());
+        for (ValueCodeMap::const_iterator it = valueCodes_.begin();
+            it != valueCodes_.end(); ++it)
+        {
+            oldCodes.push_back(it->second);
+        }
+
+        // replace each doc code by (1 + the rank of its value)
+        std::vector<bool> isUsed(oldCodes.size(), false);
+        for (std::size_t i = 0; i < docCodes_.size(); ++i)
+        {
+            if (docCodes_[i] == INVALID_CODE)
+                continue;
+            std::size_t rank = std::lower_bound(oldCodes.begin(), oldCodes.end(),
+                                                docCodes_[i]) - oldCodes.begin();
+            docCodes_[i] = rank + 1;
+            isUsed[rank] = true;
+        }
+
+        // drop the values not used by any doc
+        std::vector<std::size_t> newRanks(oldCodes.size(), 0);
+        std::size_t usedNum = 0;
+        ValueCodeMap::iterator it = valueCodes_.begin();
+        for (std::size_t rank = 0; rank < oldCodes.size(); ++rank)
+        {
+            if (isUsed[rank])
+            {
+                newRanks[rank] = usedNum++;
+                ++it;
+            }
+            else
+            {
+                valueCodes_.erase(it++);
+            }
+        }
+
+        assignCodes_();
+
+        std::vector<code_t> newCodes;
+        newCodes.reserve(valueCodes_.size());
+        for (it = valueCodes_.begin(); it != valueCodes_.end(); ++it)
+        {
+            newCodes.push_back(it->second);
+        }
+        for (std::size_t i = 0; i < docCodes_.size(); ++i)
+        {
+            if (docCodes_[i] != INVALID_CODE)
+            {
+                docCodes_[i] = newCodes[newRanks[docCodes_[i] - 1]];
+            }
+        }
+    }
+
+private:
+    enum { kMinStaleNum = 1024 };
+
+    ValueCodeMap valueCodes_;
+    std::vector<code_t> docCodes_;
+
+    /// the space between the codes when they are assigned
+    uint64_t gap_;
+    /// the number of values when the codes are assigned
+    std::size_t encodedNum_;
+    std::size_t reEncodeNum_;
+};
+
+}
+
+#endif
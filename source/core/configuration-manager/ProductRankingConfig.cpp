@@ -105,6 +105,22 @@ bool checkScoreConfig(
     }
 }
 
+void getScorePropNames(
+    const ProductScoreConfig& scoreConfig,
+    std::set<std::string>& propNames)
+{
+    if (!scoreConfig.propName.empty())
+    {
+        propNames.insert(scoreConfig.propName);
+    }
+
+    for (std::vector<ProductScoreConfig>::const_iterator it =
+             scoreConfig.factors.begin(); it != scoreConfig.factors.end(); ++it)
+    {
+        getScorePropNames(*it, propNames);
+    }
+}
+
 } // namespace
 
 const std::string ProductRankingConfig::kScoreTypeName[] =
@@ -161,6 +177,15 @@ bool ProductRankingConfig::checkConfig(
     return true;
 }
 
+void ProductRankingConfig::getPropNames(std::set<std::string>& propNames) const
+{
+    for (std::vector<ProductScoreConfig>::const_iterator it = scores.begin();
+         it != scores.end(); ++it)
+    {
+        getScorePropNames(*it, propNames);
+    }
+}
+
 std::string ProductRankingConfig::toStr() const
 {
     std::ostringstream oss;
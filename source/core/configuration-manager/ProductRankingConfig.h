@@ -4,6 +4,7 @@
 #include "ProductScoreConfig.h"
 #include <vector>
 #include <map>
+#include <set>
 #include <string>
 #include <boost/serialization/access.hpp>
 
@@ -41,6 +42,11 @@ public:
         const CollectionMeta& collectionMeta,
         std::string& error) const;
 
+    /**
+     * get the properties which the product scores depend on.
+     */
+    void getPropNames(std::set<std::string>& propNames) const;
+
     /**
      * @return a string which could be printed in debug.
      */
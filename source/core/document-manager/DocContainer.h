@@ -2,6 +2,7 @@
 #define SF1V5_DOCUMENT_MANAGER_DOC_CONTAINER_H
 
 #include "Document.h"
+#include <common/PropertyValue.h>
 
 #include <3rdparty/am/luxio/array.h>
 #include <util/izene_serialization.h>
@@ -13,28 +14,50 @@
 #include <boost/archive/xml_iarchive.hpp>
 #include <boost/archive/archive_exception.hpp>
 #include <boost/scoped_array.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/serialization/vector.hpp>
 
 #include <compression/compressor.h>
 
+#include <map>
+#include <vector>
+#include <algorithm> // max
+#include <cstring> // memcpy
+
 namespace sf1r
 {
 
+/**
+ * In the default row store mode, each document is serialized and compressed
+ * as a whole into one Lux array.
+ *
+ * In the column store mode, each property value is compressed into a
+ * separate Lux array (a column) of its own, so that getting a few properties
+ * only reads and decompresses these columns. The document array then only
+ * keeps an empty record for each docid, and the documents stored before in
+ * row format are still readable.
+ */
 class DocContainer
 {
     typedef Lux::IO::Array containerType;
+    typedef boost::shared_ptr<containerType> ColumnPtr;
 
 public:
-    DocContainer(const std::string&path)
+    DocContainer(const std::string&path, bool isColumnStore = false)
         : path_(path)
         , fileName_(path + "DocumentPropertyTable")
         , maxDocIdDb_(path + "MaxDocID.xml")
+        , columnNameDb_(path + "DocumentColumns.xml")
         , containerPtr_(NULL)
         , maxDocID_(0)
+        , isColumnStore_(isColumnStore)
     {
-        containerPtr_ = new containerType(Lux::IO::NONCLUSTER);
-        containerPtr_->set_noncluster_params(Lux::IO::Linked);
-        containerPtr_->set_lock_type(Lux::IO::LOCK_THREAD);
+        containerPtr_ = createContainer_();
         restoreMaxDocDb_();
+        if (isColumnStore_)
+        {
+            restoreColumnNameDb_();
+        }
     }
 
     ~DocContainer()
@@ -44,8 +67,17 @@ public:
             containerPtr_->close();
             delete containerPtr_;
         }
+        for (std::size_t i = 0; i < columns_.size(); ++i)
+        {
+            if (columns_[i])
+            {
+                columns_[i]->close();
+            }
+        }
     }
 
+    bool isColumnStore() const { return isColumnStore_; }
+
     bool open()
     {
         try
@@ -58,6 +90,14 @@ public:
             {
                 containerPtr_->open(fileName_.c_str(), Lux::IO::DB_RDWR);
             }
+
+            columns_.resize(columnNames_.size());
+            for (std::size_t i = 0; i < columnNames_.size(); ++i)
+            {
+                columnIdMap_[columnNames_[i]] = i;
+                columns_[i].reset(createContainer_());
+                openContainer_(*columns_[i], getColumnFileName_(i));
+            }
         }
         catch (...)
         {
@@ -75,6 +115,10 @@ public:
             boost::unique_lock<boost::shared_mutex> guard(shared_mutex_);
             maxDocID_ = docId>maxDocID_? docId:maxDocID_;
         }
+        if (isColumnStore_)
+        {
+            return putColumns_(docId, doc, false);
+        }
         izenelib::util::izene_serialization<Document> izs(doc);
         char* src;
         size_t srcLen;
@@ -124,7 +168,7 @@ public:
         if ( val_p->size - sizeof(uint32_t) == 0 )
         {
             containerPtr_->clean_data(val_p);
-            return false;
+            return isColumnStore_ && getColumns_(docId, getAllColumns_(), doc);
         }
 
         const uint32_t allocSize = *reinterpret_cast<const uint32_t*>(val_p->data);
@@ -148,6 +192,59 @@ public:
         return true;
     }
 
+    /**
+     * get the properties in @p propertyNames only, in column store mode,
+     * the other columns are not read at all.
+     * For the document stored in row format, all its properties are got.
+     */
+    bool get(
+        const unsigned int docId,
+        const std::vector<std::string>& propertyNames,
+        Document& doc)
+    {
+        if (!isColumnStore_)
+        {
+            return get(docId, doc);
+        }
+
+        {
+            boost::shared_lock<boost::shared_mutex> guard(shared_mutex_);
+            if (docId > maxDocID_ )
+            {
+                return false;
+            }
+        }
+        Lux::IO::data_t *val_p = NULL;
+        if (!containerPtr_->get(docId, &val_p, Lux::IO::SYSTEM))
+        {
+            containerPtr_->clean_data(val_p);
+            return false;
+        }
+        const bool isColumnRecord = val_p->size == sizeof(uint32_t);
+        containerPtr_->clean_data(val_p);
+
+        if (!isColumnRecord)
+        {
+            return get(docId, doc);
+        }
+
+        std::vector<std::pair<std::string, ColumnPtr> > columns;
+        {
+            boost::shared_lock<boost::shared_mutex> guard(column_mutex_);
+            for (std::vector<std::string>::const_iterator it = propertyNames.begin();
+                    it != propertyNames.end(); ++it)
+            {
+                std::map<std::string, std::size_t>::const_iterator findIt =
+                    columnIdMap_.find(*it);
+                if (findIt != columnIdMap_.end())
+                {
+                    columns.push_back(std::make_pair(*it, columns_[findIt->second]));
+                }
+            }
+        }
+        return getColumns_(docId, columns, doc);
+    }
+
     bool exist(const unsigned int docId)
     {
         {
@@ -168,6 +265,14 @@ public:
             if (docId > maxDocID_ )
                 return false;
         }
+        if (isColumnStore_)
+        {
+            std::vector<std::pair<std::string, ColumnPtr> > columns = getAllColumns_();
+            for (std::size_t i = 0; i < columns.size(); ++i)
+            {
+                columns[i].second->del(docId);
+            }
+        }
         return containerPtr_->del(docId);
     }
 
@@ -178,6 +283,10 @@ public:
             if (docId > maxDocID_)
                 return false;
         }
+        if (isColumnStore_)
+        {
+            return putColumns_(docId, doc, true);
+        }
 
         izenelib::util::izene_serialization<Document> izs(doc);
         char* src;
@@ -213,6 +322,257 @@ public:
     }
 
 private:
+    containerType* createContainer_() const
+    {
+        containerType* container = new containerType(Lux::IO::NONCLUSTER);
+        container->set_noncluster_params(Lux::IO::Linked);
+        container->set_lock_type(Lux::IO::LOCK_THREAD);
+        return container;
+    }
+
+    void openContainer_(containerType& container, const std::string& fileName) const
+    {
+        if ( !boost::filesystem::exists(fileName) )
+        {
+            container.open(fileName.c_str(), Lux::IO::DB_CREAT);
+        }
+        else
+        {
+            container.open(fileName.c_str(), Lux::IO::DB_RDWR);
+        }
+    }
+
+    std::string getColumnFileName_(std::size_t columnId) const
+    {
+        return fileName_ + "." + boost::lexical_cast<std::string>(columnId);
+    }
+
+    /**
+     * @return the column of @p propertyName, it would be created if not exists.
+     */
+    ColumnPtr getOrCreateColumn_(const std::string& propertyName)
+    {
+        {
+            boost::shared_lock<boost::shared_mutex> guard(column_mutex_);
+            std::map<std::string, std::size_t>::const_iterator it =
+                columnIdMap_.find(propertyName);
+            if (it != columnIdMap_.end())
+                return columns_[it->second];
+        }
+
+        boost::unique_lock<boost::shared_mutex> guard(column_mutex_);
+        std::map<std::string, std::size_t>::const_iterator it =
+            columnIdMap_.find(propertyName);
+        if (it != columnIdMap_.end())
+            return columns_[it->second];
+
+        const std::size_t columnId = columns_.size();
+        ColumnPtr column(createContainer_());
+        try
+        {
+            openContainer_(*column, getColumnFileName_(columnId));
+        }
+        catch (...)
+        {
+            return ColumnPtr();
+        }
+
+        columns_.push_back(column);
+        columnNames_.push_back(propertyName);
+        columnIdMap_[propertyName] = columnId;
+
+        // save the names at once, so that the new column could be found
+        // even if the process is killed before flush()
+        saveColumnNameDb_();
+        return column;
+    }
+
+    std::vector<std::pair<std::string, ColumnPtr> > getAllColumns_()
+    {
+        std::vector<std::pair<std::string, ColumnPtr> > columns;
+        boost::shared_lock<boost::shared_mutex> guard(column_mutex_);
+        columns.reserve(columns_.size());
+        for (std::size_t i = 0; i < columns_.size(); ++i)
+        {
+            columns.push_back(std::make_pair(columnNames_[i], columns_[i]));
+        }
+        return columns;
+    }
+
+    /**
+     * @param isUpdate if true, the values of the properties not in @p doc
+     *        would also be removed.
+     */
+    bool putColumns_(const unsigned int docId, const Document& doc, bool isUpdate)
+    {
+        typedef Document::property_const_iterator iterator;
+        for (iterator it = doc.propertyBegin(), itEnd = doc.propertyEnd();
+                it != itEnd; ++it)
+        {
+            ColumnPtr column = getOrCreateColumn_(it->first);
+            if (!column)
+                return false;
+
+            izenelib::util::izene_serialization<PropertyValue> izs(it->second);
+            char* src;
+            size_t srcLen;
+            izs.write_image(src, srcLen);
+
+            if (!putValue_(*column, docId, src, srcLen))
+                return false;
+        }
+
+        if (isUpdate)
+        {
+            std::vector<std::pair<std::string, ColumnPtr> > columns = getAllColumns_();
+            for (std::size_t i = 0; i < columns.size(); ++i)
+            {
+                if (!doc.hasProperty(columns[i].first))
+                {
+                    columns[i].second->del(docId);
+                }
+            }
+        }
+
+        const uint32_t emptyRecord = 0;
+        return containerPtr_->put(docId, &emptyRecord, sizeof(uint32_t), Lux::IO::OVERWRITE);
+    }
+
+    /**
+     * @return false if any column value could not be read,
+     *         the columns not stored for @p docId are just skipped.
+     */
+    bool getColumns_(
+        const unsigned int docId,
+        const std::vector<std::pair<std::string, ColumnPtr> >& columns,
+        Document& doc)
+    {
+        doc.setId(docId);
+        for (std::size_t i = 0; i < columns.size(); ++i)
+        {
+            PropertyValue value;
+            bool isFound = false;
+            if (!getValue_(*columns[i].second, docId, value, isFound))
+                return false;
+
+            if (isFound)
+            {
+                doc.property(columns[i].first) = value;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * The value is stored as its raw length followed by the compressed data,
+     * the short values which could not be compressed are kept raw, so the
+     * data length equal to the raw length means it is not compressed.
+     */
+    bool putValue_(containerType& column, const unsigned int docId, const char* src, size_t srcLen)
+    {
+        const size_t allocSize = std::max(compressor_.compressBound(srcLen), srcLen);
+        size_t destLen = 0;
+        boost::scoped_array<unsigned char> destPtr(new unsigned char[allocSize + sizeof(uint32_t)]);
+        *reinterpret_cast<uint32_t*>(destPtr.get()) = srcLen;
+
+        bool re = compressor_.compress((const unsigned char*)src, srcLen, destPtr.get() + sizeof(uint32_t), destLen);
+        if (!re || destLen >= srcLen)
+        {
+            std::memcpy(destPtr.get() + sizeof(uint32_t), src, srcLen);
+            destLen = srcLen;
+        }
+
+        return column.put(docId, destPtr.get(), destLen + sizeof(uint32_t), Lux::IO::OVERWRITE);
+    }
+
+    /**
+     * @param isFound set to false if no value is stored for @p docId
+     * @return false if the stored value is corrupted
+     */
+    bool getValue_(
+        containerType& column,
+        const unsigned int docId,
+        PropertyValue& value,
+        bool& isFound)
+    {
+        Lux::IO::data_t *val_p = NULL;
+        isFound = column.get(docId, &val_p, Lux::IO::SYSTEM);
+        if (!isFound)
+        {
+            column.clean_data(val_p);
+            return true;
+        }
+
+        if (val_p->size < sizeof(uint32_t))
+        {
+            column.clean_data(val_p);
+            return false;
+        }
+
+        const uint32_t srcLen = *reinterpret_cast<const uint32_t*>(val_p->data);
+        const unsigned char* data = (const unsigned char*)val_p->data + sizeof(uint32_t);
+        const size_t dataLen = val_p->size - sizeof(uint32_t);
+
+        boost::scoped_array<unsigned char> buffer;
+        if (dataLen < srcLen)
+        {
+            buffer.reset(new unsigned char[srcLen]);
+            if (!compressor_.decompress(data, dataLen, buffer.get(), srcLen))
+            {
+                column.clean_data(val_p);
+                return false;
+            }
+            data = buffer.get();
+        }
+
+        izenelib::util::izene_deserialization<PropertyValue> izd((char*)data, srcLen);
+        izd.read_image(value);
+        column.clean_data(val_p);
+        return true;
+    }
+
+    bool saveColumnNameDb_()
+    {
+        try
+        {
+            std::ofstream ofs(columnNameDb_.c_str());
+            if (ofs)
+            {
+                boost::archive::xml_oarchive oa(ofs);
+                oa << boost::serialization::make_nvp(
+                    "ColumnNames", columnNames_
+                );
+            }
+
+            return ofs;
+        }
+        catch (boost::archive::archive_exception& e)
+        {
+            return false;
+        }
+    }
+
+    bool restoreColumnNameDb_()
+    {
+        try
+        {
+            std::ifstream ifs(columnNameDb_.c_str());
+            if (ifs)
+            {
+                boost::archive::xml_iarchive ia(ifs);
+                ia >> boost::serialization::make_nvp(
+                    "ColumnNames", columnNames_
+                );
+            }
+            return ifs;
+        }
+        catch (boost::archive::archive_exception& e)
+        {
+            columnNames_.clear();
+            return false;
+        }
+    }
+
     bool saveMaxDocDb_()
     {
         boost::unique_lock<boost::shared_mutex> guard(shared_mutex_);
@@ -276,10 +636,19 @@ private:
     std::string path_;
     std::string fileName_;
     std::string maxDocIdDb_;
+    std::string columnNameDb_;
     containerType* containerPtr_;
     docid_t maxDocID_;
     DocumentCompressor compressor_;
     boost::shared_mutex shared_mutex_;
+
+    const bool isColumnStore_;
+
+    /** the property name of each column, in the order of column id */
+    std::vector<std::string> columnNames_;
+    std::vector<ColumnPtr> columns_;
+    std::map<std::string, std::size_t> columnIdMap_;
+    boost::shared_mutex column_mutex_;
 };
 
 }
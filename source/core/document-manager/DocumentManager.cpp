@@ -8,6 +8,7 @@
 #include "DocumentManager.h"
 #include "DocContainer.h"
 #include "highlighter/Highlighter.h"
+#include "highlighter/MultiTermMatcher.h"
 #include "snippet-generation-submanager/SnippetGeneratorSubManager.h"
 #include "text-summarization-submanager/TextSummarizationSubManager.h"
 
@@ -49,7 +50,8 @@ DocumentManager::DocumentManager(
         const std::string& path,
         const IndexBundleSchema& indexSchema,
         const izenelib::util::UString::EncodingType encodingType,
-        size_t documentCacheNum)
+        size_t documentCacheNum,
+        bool isColumnStore)
     : path_(path)
     , delfilter_count_(0)
     , documentCache_(100)
@@ -57,7 +59,7 @@ DocumentManager::DocumentManager(
     , encodingType_(encodingType)
     , maxSnippetLength_(200)
 {
-    propertyValueTable_ = new DocContainer(path);
+    propertyValueTable_ = new DocContainer(path, isColumnStore);
     propertyValueTable_->open();
     //buildPropertyIdMapper_();
     restorePropertyLengthDb_();
@@ -297,6 +299,15 @@ bool DocumentManager::getPropertyValue(
     {
         result = doc.property(*realPropertyName);
     }
+    else if (propertyValueTable_->isColumnStore())
+    {
+        // only read the column of this property,
+        // the partial document is not put into the cache
+        std::vector<std::string> propertyNames(1, *realPropertyName);
+        if (isDeleted(docId) || !propertyValueTable_->get(docId, propertyNames, doc))
+            return false;
+        result = doc.property(*realPropertyName);
+    }
     else
     {
         if (getDocument(docId, doc) == false)
@@ -333,6 +344,42 @@ void DocumentManager::getRTypePropertiesForDocument(docid_t docId, Document& doc
     }
 }
 
+bool DocumentManager::getDocument(
+        docid_t docId,
+        const std::vector<std::string>& propertyNames,
+        Document& document)
+{
+    return !isDeleted(docId) &&
+        propertyValueTable_->get(docId, propertyNames, document);
+}
+
+void DocumentManager::getRTypePropertiesForDocument(
+        docid_t docId,
+        const std::vector<std::string>& propertyNames,
+        Document& document)
+{
+    for (std::vector<std::string>::const_iterator it = propertyNames.begin();
+            it != propertyNames.end(); ++it)
+    {
+        std::string tempStr;
+
+        NumericPropertyTableMap::const_iterator numericIt = numericPropertyTables_.find(*it);
+        if (numericIt != numericPropertyTables_.end())
+        {
+            if (numericIt->second->getStringValue(docId, tempStr))
+                document.property(*it) = str_to_propstr(tempStr, encodingType_);
+            continue;
+        }
+
+        RTypeStringPropTableMap::const_iterator rtypeIt = rtype_string_proptable_.find(*it);
+        if (rtypeIt != rtype_string_proptable_.end() &&
+            rtypeIt->second->getRTypeString(docId, tempStr))
+        {
+            document.property(*it) = str_to_propstr(tempStr, encodingType_);
+        }
+    }
+}
+
 bool DocumentManager::existDocument(docid_t docId)
 {
     return propertyValueTable_->exist(docId);
@@ -369,6 +416,28 @@ bool DocumentManager::getDocuments(
     return ret;
 }
 
+bool DocumentManager::getDocuments(
+        const std::vector<unsigned int>& ids,
+        const std::vector<std::string>& propertyNames,
+        std::vector<Document>& docs,
+        bool forceget)
+{
+    if (!propertyValueTable_->isColumnStore())
+        return getDocuments(ids, docs, forceget);
+
+    docs.resize(ids.size());
+    bool ret = true;
+    for (size_t i=0; i<ids.size(); i++)
+    {
+        if (documentCache_.getValue(ids[i], docs[i]))
+            continue;
+
+        ret &= (forceget || !isDeleted(ids[i])) &&
+            propertyValueTable_->get(ids[i], propertyNames, docs[i]);
+    }
+    return ret;
+}
+
 docid_t DocumentManager::getMaxDocId() const
 {
     return propertyValueTable_->getMaxDocId();
@@ -555,6 +624,22 @@ bool DocumentManager::getRawTextOfDocuments(
         std::vector<Document::doc_prop_value_strtype>& outSnippetList,
         std::vector<Document::doc_prop_value_strtype>& outRawSummaryList,
         std::vector<Document::doc_prop_value_strtype>& outFullTextList)
+{
+    MultiTermMatcher termMatcher(queryTerms);
+
+    return getRawTextOfDocuments(docIdList, propertyName, summaryOn, summaryNum,
+                                 option, termMatcher, outSnippetList,
+                                 outRawSummaryList, outFullTextList);
+}
+
+bool DocumentManager::getRawTextOfDocuments(
+        const std::vector<docid_t>& docIdList, const string& propertyName,
+        const bool summaryOn, const unsigned int summaryNum,
+        const unsigned int option,
+        const MultiTermMatcher& termMatcher,
+        std::vector<Document::doc_prop_value_strtype>& outSnippetList,
+        std::vector<Document::doc_prop_value_strtype>& outRawSummaryList,
+        std::vector<Document::doc_prop_value_strtype>& outFullTextList)
 {
     try
     {
@@ -589,7 +674,7 @@ bool DocumentManager::getRawTextOfDocuments(
             ret = true;
 
             maxSnippetLength_ = getDisplayLength_(propertyName);
-            processOptionForRawText(option, queryTerms, rawUText,
+            processOptionForRawText(option, termMatcher, rawUText,
                                     sentenceOffsets, resultU);
 
             result = ustr_to_propstr(resultU);
@@ -604,7 +689,7 @@ bool DocumentManager::getRawTextOfDocuments(
             {
                 izenelib::util::UString summary;
                 getSummary(rawUText, sentenceOffsets, numSentences,
-                           option, queryTerms, summary);
+                           option, termMatcher, summary);
 
                 rawSummaryList[listId] = ustr_to_propstr(summary);
             }
@@ -627,7 +712,7 @@ bool DocumentManager::getRawTextOfOneDocument(
         Document& document,
         const string& propertyName,
         const unsigned int option,
-        const std::vector<izenelib::util::UString>& queryTerms,
+        const MultiTermMatcher& termMatcher,
         Document::doc_prop_value_strtype& outSnippet,
         Document::doc_prop_value_strtype& rawText)
 {
@@ -675,7 +760,7 @@ bool DocumentManager::getRawTextOfOneDocument(
 
     maxSnippetLength_ = getDisplayLength_(propertyName);
     izenelib::util::UString tempustr;
-    processOptionForRawText(option, queryTerms, propstr_to_ustr(rawText), sentenceOffsets,
+    processOptionForRawText(option, termMatcher, propstr_to_ustr(rawText), sentenceOffsets,
                             tempustr);
 
     outSnippet = ustr_to_propstr(tempustr);
@@ -689,7 +774,7 @@ bool DocumentManager::getRawTextOfOneDocument(
 
 bool DocumentManager::processOptionForRawText(
         const unsigned int option,
-        const std::vector<izenelib::util::UString>& queryTerms,
+        const MultiTermMatcher& termMatcher,
         const izenelib::util::UString& rawText,
         const std::vector<CharacterOffset>& sentenceOffsets,
         izenelib::util::UString& result)
@@ -701,16 +786,16 @@ bool DocumentManager::processOptionForRawText(
         break;
 
     case O_RAWTEXT:
-        highlighter_->getHighlightedText(rawText, queryTerms, encodingType_, result);
+        highlighter_->getHighlightedText(rawText, termMatcher, encodingType_, result);
         break;
 
     case X_SNIPPET:
-        snippetGenerator_->getSnippet(rawText, sentenceOffsets, queryTerms,
+        snippetGenerator_->getSnippet(rawText, sentenceOffsets, termMatcher,
                                       maxSnippetLength_, false, encodingType_, result);
         break;
 
     case O_SNIPPET:
-        snippetGenerator_->getSnippet(rawText, sentenceOffsets, queryTerms,
+        snippetGenerator_->getSnippet(rawText, sentenceOffsets, termMatcher,
                                       maxSnippetLength_, true, encodingType_, result);
         break;
     }
@@ -722,7 +807,7 @@ bool DocumentManager::getSummary(
         const std::vector<CharacterOffset>& sentenceOffsets,
         unsigned int numSentences,
         const unsigned int option,
-        const std::vector<izenelib::util::UString>& queryTerms,
+        const MultiTermMatcher& termMatcher,
         izenelib::util::UString& summary)
 {
     uint32_t offsetIndex = 1;
@@ -749,7 +834,7 @@ bool DocumentManager::getSummary(
             break;
         case O_RAWTEXT: //Do highlight
         case O_SNIPPET:
-            if (highlighter_->getHighlightedText(sentence, queryTerms,
+            if (highlighter_->getHighlightedText(sentence, termMatcher,
                                                 encodingType_, result) == false)
             {
                 result = sentence;
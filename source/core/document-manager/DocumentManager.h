@@ -58,6 +58,7 @@ enum DMOptionFlag
 
 class SnippetGeneratorSubManager;
 class Highlighter;
+class MultiTermMatcher;
 class DocContainer;
 class RTypeStringPropTable;
 
@@ -81,7 +82,8 @@ public:
             const std::string& path,
             const IndexBundleSchema& indexSchema,
             izenelib::util::UString::EncodingType encondingType,
-            size_t documentCacheNum = 20000);
+            size_t documentCacheNum = 20000,
+            bool isColumnStore = false);
 
     void setZambeziConfig(const ZambeziConfig& zambeziConfig);
     /**
@@ -159,8 +161,38 @@ public:
             vector<Document>& docs,
             bool forceget = false);
 
+    /**
+     * @brief gets documents with the properties in @p propertyNames only.
+     * In column store mode, only these properties are read and
+     * decompressed, the other properties may be missing in @p docs.
+     */
+    bool getDocuments(
+            const std::vector<unsigned int>& ids,
+            const std::vector<std::string>& propertyNames,
+            vector<Document>& docs,
+            bool forceget = false);
+
+    /**
+     * @brief gets the document with the properties in @p propertyNames only,
+     * it is used to scan documents, so the document cache is not touched.
+     * In column store mode, only these properties are read and
+     * decompressed, otherwise, all properties are got.
+     */
+    bool getDocument(
+            docid_t docId,
+            const std::vector<std::string>& propertyNames,
+            Document& document);
+
     void getRTypePropertiesForDocument(docid_t, Document& document);
 
+    /**
+     * @brief gets the rtype properties in @p propertyNames only.
+     */
+    void getRTypePropertiesForDocument(
+            docid_t docId,
+            const std::vector<std::string>& propertyNames,
+            Document& document);
+
     bool existDocument(docid_t docId);
 
     bool getDocumentByCache(docid_t docId, Document& document, bool forceget = false);
@@ -248,6 +280,21 @@ public:
             std::vector<Document::doc_prop_value_strtype>& outRawSummaryList,
             std::vector<Document::doc_prop_value_strtype>& outFullTextList);
 
+    /**
+     * @brief same as above, while the query terms are matched by @p termMatcher,
+     *        which could be shared by all the properties in the result page.
+     */
+    bool getRawTextOfDocuments(
+            const std::vector<docid_t>& docIdList,
+            const string& propertyName,
+            const bool summaryOn,
+            const unsigned int summaryNum,
+            const unsigned int option,
+            const MultiTermMatcher& termMatcher,
+            std::vector<Document::doc_prop_value_strtype>& outSnippetList,
+            std::vector<Document::doc_prop_value_strtype>& outRawSummaryList,
+            std::vector<Document::doc_prop_value_strtype>& outFullTextList);
+
     /**
      * @brief gets rawtext for a single doc id
      */
@@ -256,7 +303,7 @@ public:
             Document& document,
             const string& propertyName,
             const unsigned int option,
-            const std::vector<izenelib::util::UString>& queryTerms,
+            const MultiTermMatcher& termMatcher,
             Document::doc_prop_value_strtype& outSnippet,
             Document::doc_prop_value_strtype& outFullText);
 
@@ -322,8 +369,8 @@ private:
      * @brief process options for summary, snippet and highlight for getRawText
      *        interfaces defined above.
      * @param option option int for summary, snippet, rawText and hihglighting
-     * @param queryTerms contains original query, tokenized query terms of original
-     *                   query, analyzed query for highlighting and snippet.
+     * @param termMatcher matches original query, tokenized query terms of original
+     *                    query, analyzed query for highlighting and snippet.
      * @param rawText rawtext for which snippet and highlighting might needed to be
      *                done depending upon option
      * @param sentenceOffsets offset pairs corresponding to rawtext for generating
@@ -334,7 +381,7 @@ private:
      */
     bool processOptionForRawText(
             const unsigned int option,
-            const std::vector<izenelib::util::UString>& queryTerms,
+            const MultiTermMatcher& termMatcher,
             const izenelib::util::UString& rawText,
             const std::vector<CharacterOffset>& sentenceOffsets,
             izenelib::util::UString& result);
@@ -349,8 +396,8 @@ private:
      * @param numOfSentences  number of summary sentences as requested by getRaw
      *                        TextOfDocument
      * @param option option int for summary highlighting
-     * @param queryTerms contains original query, tokenized query terms of original
-     *                   query, analyzed query for highlighting and snippet.
+     * @param termMatcher matches original query, tokenized query terms of original
+     *                    query, analyzed query for highlighting and snippet.
      * @param[out] summary  holds summary sentences, either highlighted text or non
      *                      highlighted as stated by \c option
      * @return returns true when summary is generated.
@@ -360,7 +407,7 @@ private:
             const std::vector<CharacterOffset>& sentenceOffsets,
             unsigned int numSentences,
             const unsigned int option,
-            const std::vector<izenelib::util::UString>& queryTerms,
+            const MultiTermMatcher& termMatcher,
             izenelib::util::UString& summary);
 
     unsigned int getDisplayLength_(const string& propertyName);
@@ -12,6 +12,7 @@
  */
 
 #include "Highlighter.h"
+#include <algorithm>
 
 using namespace std;
 using namespace izenelib::util;
@@ -30,14 +31,25 @@ bool Highlighter::getHighlightedText(
     const izenelib::util::UString::EncodingType& encodingType,
     UString& highlightedText
 ) const
+{
+    MultiTermMatcher termMatcher(termStringList);
+
+    return getHighlightedText(textFragment, termMatcher, encodingType,
+                              highlightedText);
+}
+
+bool Highlighter::getHighlightedText(
+    const UString& textFragment,
+    const MultiTermMatcher& termMatcher,
+    const izenelib::util::UString::EncodingType& encodingType,
+    UString& highlightedText
+) const
 {
     //stores the offsets of the start and end offsets of all terms
     vector<pair<CharacterOffset, OffsetFlag> > highlightTagPositions;
 
     //gets the start and end tag postion for the terms
-    std::vector<UString>::const_iterator termIter =  termStringList.begin();;
-    for (; termIter !=  termStringList.end(); ++termIter )
-        getHighlightTagPositions( textFragment, *termIter, highlightTagPositions);
+    getHighlightTagPositions( textFragment, termMatcher, highlightTagPositions);
 
     if ( highlightTagPositions.size() > 0 )
     {
@@ -54,70 +66,32 @@ bool Highlighter::getHighlightedText(
 ///@brief returns higlightTagOffset list using string  matching approach
 void Highlighter::getHighlightTagPositions(
     const izenelib::util::UString& textFragment,
-    const UString& termString,
+    const MultiTermMatcher& termMatcher,
     std::vector<std::pair<CharacterOffset, OffsetFlag> >& highlightTagPositions
 ) const
 {
-    CharacterOffset offset = 0;
+    vector<MultiTermMatcher::Match> matches;
+    termMatcher.match(textFragment, matches);
 
-    bool numTerm = false;
-    bool isCJK= false;
-    for (unsigned int i=0; i < termString.length(); i++)
+    //for each term, the offset where its next occurrence could start,
+    //so that the occurrences of the same term do not overlap
+    vector<CharacterOffset> nextOffsets(termMatcher.termNum(), 0);
+
+    for (vector<MultiTermMatcher::Match>::const_iterator it = matches.begin();
+            it != matches.end(); ++it)
     {
-        if (termString.isChineseChar(i)||termString.isKoreanChar(i) || termString.isJapaneseChar(i))
-        {
-            isCJK = true;
-            break;
-        }
-        else if (termString.isNumericChar(i))
-        {
-            numTerm = true;
-        }
-    }
+        CharacterOffset offset = it->offset;
+        CharacterOffset& nextOffset = nextOffsets[it->termIndex];
 
-    unsigned int termLength = termString.length();
+        if (offset < nextOffset)
+            continue;
 
-    while ( ( (offset = textFragment.find( termString, offset, SM_IGNORE ) )
-              != izenelib::util::UString::NOT_FOUND)
-            && (offset+termLength <= textFragment.length() ) )
-    {
+        unsigned int termLength = termMatcher.termLength(it->termIndex);
 
-        //rule for numeric terms
-        if ( numTerm )
-        {
-            if ((offset>0) && (offset+termLength < textFragment.length()))
-            {
-                if  ( textFragment.isNumericChar(offset-1)
-                        || textFragment.isNumericChar(offset+termLength) )
-                {
-                    offset = termLength + offset;
-                    continue;
-                }
-            }
-            else
-            {
-                if (offset+termLength < textFragment.length())
-                {
-                    if  (textFragment.isNumericChar(offset+termLength))
-                    {
-                        offset = termLength + offset;
-                        continue;
-                    }
-                }
-            }
-        }
-        //rule out prefixes only if it is english terms
-        else if (!isCJK)
+        if (!isHighlightMatch(textFragment, termMatcher, *it))
         {
-            if ((offset>0) && (offset+termLength < textFragment.length()))
-            {
-                if ((textFragment.charType(offset-1) == UCS2_ALPHA)
-                        || (textFragment.charType(termLength+offset) == UCS2_ALPHA))
-                {
-                    offset = termLength + offset;
-                    continue;
-                }
-            }
+            nextOffset = termLength + offset;
+            continue;
         }
 
         //set <!HS> start flag
@@ -133,8 +107,49 @@ void Highlighter::getHighlightTagPositions(
             pair<CharacterOffset, OffsetFlag>(
                 static_cast<CharacterOffset>(offset), END_FLAG)
         );
-        offset++;
+        nextOffset = offset + 1;
+    }
+}
+
+bool Highlighter::isHighlightMatch(
+    const izenelib::util::UString& textFragment,
+    const MultiTermMatcher& termMatcher,
+    const MultiTermMatcher::Match& match
+) const
+{
+    CharacterOffset offset = match.offset;
+    unsigned int termLength = termMatcher.termLength(match.termIndex);
+
+    //rule for numeric terms
+    if ( termMatcher.isNumericTerm(match.termIndex) )
+    {
+        if ((offset>0) && (offset+termLength < textFragment.length()))
+        {
+            if  ( textFragment.isNumericChar(offset-1)
+                    || textFragment.isNumericChar(offset+termLength) )
+                return false;
+        }
+        else
+        {
+            if (offset+termLength < textFragment.length())
+            {
+                if  (textFragment.isNumericChar(offset+termLength))
+                    return false;
+            }
+        }
     }
+    //rule out prefixes only if it is english terms
+    else if (!termMatcher.isCJKTerm(match.termIndex))
+    {
+        if ((offset>0) && (offset+termLength < textFragment.length()))
+        {
+            if ((textFragment.charType(offset-1) == UCS2_ALPHA)
+                    || (textFragment.charType(termLength+offset) == UCS2_ALPHA))
+                return false;
+        }
+    }
+
+    return true;
 }
 
 void Highlighter::setHighlightTags(
@@ -13,6 +13,8 @@
  *  are no longer availed from document manager
  */
 
+#include "MultiTermMatcher.h"
+
 #include <common/type_defs.h>
 #include <util/ustring/UString.h>
 #include <vector>
@@ -46,22 +48,47 @@ public:
         izenelib::util::UString& highlightedText
     ) const;
 
+    /**
+     * @brief getHighlightedText() Gets the text with highlighting tags.
+     * @param textFragment      The actual text to be highlighted.
+     * @param termMatcher       The matcher built from the terms to be highlighted,
+     *                          it could be shared by all the texts of one query.
+     * @param encodingType      The encoding type used during indexing and querying
+     * @param highlightedText   The result of highlighting. The text fragment with
+     */
+    bool getHighlightedText(
+        const izenelib::util::UString& textFragment,
+        const MultiTermMatcher& termMatcher,
+        const izenelib::util::UString::EncodingType& encodingType,
+        izenelib::util::UString& highlightedText
+    ) const;
+
 private:
 
     /**
-     * @brief  getHighlightTagPositions() gets the start and end  positon of a term from
+     * @brief  getHighlightTagPositions() gets the start and end  positon of all terms from
      *         the query string. The positions are marked with START_FLAG and END_FLAG
      * @param textFragment  The actual text to be highlighted.
-     * @param termString    term from the query string that requires highlighting
+     * @param termMatcher   The matcher of terms from the query string that requires highlighting
      * @param highlightTagPositions   The character offset pairs including start and end tag
      *                                for a textFragment.
      */
     void getHighlightTagPositions(
         const izenelib::util::UString& textFragment,
-        const izenelib::util::UString& termString,
+        const MultiTermMatcher& termMatcher,
         std::vector<std::pair<CharacterOffset, OffsetFlag> >& highlightTagPositions
     ) const;
 
+    /**
+     * @brief  isHighlightMatch() checks the rules for the term occurrence, numeric term
+     *         is not matched inside a number, and english term is not matched inside a word.
+     */
+    bool isHighlightMatch(
+        const izenelib::util::UString& textFragment,
+        const MultiTermMatcher& termMatcher,
+        const MultiTermMatcher::Match& match
+    ) const;
+
     /**
      * @brief Inserts highlighting tags <!HS> and <!HE> around the terms in the text.
      * @param text  The text body to be highlighted with the query terms
@@ -0,0 +1,206 @@
+/**
+ * @file MultiTermMatcher.cpp
+ * @brief find the occurrences of all query terms in one pass over the text
+ */
+
+#include "MultiTermMatcher.h"
+#include <algorithm>
+#include <deque>
+#include <map>
+
+using namespace std;
+using namespace izenelib::util;
+
+namespace sf1r{
+
+const MultiTermMatcher::StateId MultiTermMatcher::ROOT = 0;
+
+MultiTermMatcher::MultiTermMatcher(const vector<UString>& termList)
+{
+    build_(termList);
+}
+
+void MultiTermMatcher::build_(const vector<UString>& termList)
+{
+    typedef map<CharT, StateId> EdgeMap;
+
+    // the trie of the case folded terms
+    vector<EdgeMap> trie(1);
+    vector<vector<uint32_t> > termOutputs(1);
+
+    terms_.resize(termList.size());
+    for (uint32_t termIndex = 0; termIndex < termList.size(); ++termIndex)
+    {
+        const UString& term = termList[termIndex];
+        TermInfo& info = terms_[termIndex];
+        info.length = term.length();
+        info.isNumeric = false;
+        info.isCJK = false;
+
+        for (CharacterOffset i = 0; i < term.length(); ++i)
+        {
+            if (term.isChineseChar(i) || term.isKoreanChar(i) || term.isJapaneseChar(i))
+            {
+                info.isCJK = true;
+                break;
+            }
+            else if (term.isNumericChar(i))
+            {
+                info.isNumeric = true;
+            }
+        }
+
+        if (term.empty())
+            continue;
+
+        StateId state = ROOT;
+        for (CharacterOffset i = 0; i < term.length(); ++i)
+        {
+            const CharT label = foldCase(term[i]);
+            EdgeMap::const_iterator it = trie[state].find(label);
+            if (it != trie[state].end())
+            {
+                state = it->second;
+                continue;
+            }
+
+            const StateId target = trie.size();
+            trie[state][label] = target;
+            trie.push_back(EdgeMap());
+            termOutputs.push_back(vector<uint32_t>());
+            state = target;
+        }
+        termOutputs[state].push_back(termIndex);
+    }
+
+    // flatten the edges, so that each state is looked up in a sorted range
+    states_.resize(trie.size());
+    edges_.clear();
+    for (StateId state = 0; state < trie.size(); ++state)
+    {
+        states_[state].edgeBegin = edges_.size();
+        for (EdgeMap::const_iterator it = trie[state].begin();
+             it != trie[state].end(); ++it)
+        {
+            Edge edge;
+            edge.label = it->first;
+            edge.target = it->second;
+            edges_.push_back(edge);
+        }
+        states_[state].edgeEnd = edges_.size();
+        states_[state].failure = ROOT;
+    }
+
+    rootTable_.assign(ROOT_TABLE_SIZE, ROOT);
+    for (EdgeMap::const_iterator it = trie[ROOT].begin();
+         it != trie[ROOT].end() && it->first < ROOT_TABLE_SIZE; ++it)
+    {
+        rootTable_[it->first] = it->second;
+    }
+
+    // in breadth first order, the failure state of each state is
+    // visited before the state itself, so its outputs are complete
+    vector<StateId> order;
+    deque<StateId> queue;
+    queue.push_back(ROOT);
+    while (!queue.empty())
+    {
+        const StateId state = queue.front();
+        queue.pop_front();
+        order.push_back(state);
+
+        for (EdgeMap::const_iterator it = trie[state].begin();
+             it != trie[state].end(); ++it)
+        {
+            const StateId target = it->second;
+            if (state != ROOT)
+            {
+                states_[target].failure = next_(states_[state].failure, it->first);
+            }
+            queue.push_back(target);
+        }
+    }
+
+    outputs_.clear();
+    vector<uint32_t> mergedOutputs;
+    for (vector<StateId>::const_iterator it = order.begin();
+         it != order.end(); ++it)
+    {
+        State& state = states_[*it];
+        mergedOutputs = termOutputs[*it];
+
+        if (*it != ROOT)
+        {
+            const State& failure = states_[state.failure];
+            mergedOutputs.insert(mergedOutputs.end(),
+                                 outputs_.begin() + failure.outputBegin,
+                                 outputs_.begin() + failure.outputEnd);
+        }
+
+        state.outputBegin = outputs_.size();
+        outputs_.insert(outputs_.end(), mergedOutputs.begin(), mergedOutputs.end());
+        state.outputEnd = outputs_.size();
+    }
+}
+
+MultiTermMatcher::StateId MultiTermMatcher::goTo_(StateId state, CharT label) const
+{
+    if (state == ROOT && label < ROOT_TABLE_SIZE)
+        return rootTable_[label];
+
+    const State& s = states_[state];
+    if (s.edgeBegin == s.edgeEnd)
+        return ROOT;
+
+    Edge key;
+    key.label = label;
+    vector<Edge>::const_iterator first = edges_.begin() + s.edgeBegin;
+    vector<Edge>::const_iterator last = edges_.begin() + s.edgeEnd;
+    vector<Edge>::const_iterator it = lower_bound(first, last, key);
+
+    if (it != last && it->label == label)
+        return it->target;
+
+    return ROOT;
+}
+
+MultiTermMatcher::StateId MultiTermMatcher::next_(StateId state, CharT label) const
+{
+    while (true)
+    {
+        const StateId target = goTo_(state, label);
+        if (target != ROOT || state == ROOT)
+            return target;
+
+        state = states_[state].failure;
+    }
+}
+
+void MultiTermMatcher::match(
+    const UString& text,
+    vector<Match>& matches
+) const
+{
+    matches.clear();
+    if (edges_.empty())
+        return;
+
+    const CharacterOffset length = text.length();
+    StateId state = ROOT;
+
+    for (CharacterOffset i = 0; i < length; ++i)
+    {
+        state = next_(state, foldCase(text[i]));
+
+        const State& s = states_[state];
+        for (uint32_t j = s.outputBegin; j < s.outputEnd; ++j)
+        {
+            const uint32_t termIndex = outputs_[j];
+            matches.push_back(Match(i + 1 - terms_[termIndex].length, termIndex));
+        }
+    }
+
+    sort(matches.begin(), matches.end());
+}
+
+}
@@ -0,0 +1,150 @@
+#ifndef _MULTI_TERM_MATCHER_H_
+#define _MULTI_TERM_MATCHER_H_
+
+/**
+ * @file MultiTermMatcher.h
+ * @brief find the occurrences of all query terms in one pass over the text
+ *
+ * History:
+ *  -the Aho-Corasick automaton is built once per query, and shared by
+ *  highlighting and snippet scoring for all the docs in the result page,
+ *  instead of calling UString::find() for each term.
+ */
+
+#include <util/ustring/UString.h>
+#include <boost/cstdint.hpp>
+#include <vector>
+
+namespace sf1r{
+
+class MultiTermMatcher
+{
+public:
+    typedef izenelib::util::UString::size_t CharacterOffset;
+    typedef izenelib::util::UString::CharT CharT;
+
+    /// @brief one occurrence of a term in text
+    struct Match
+    {
+        /// the offset of the first character in text
+        CharacterOffset offset;
+
+        /// the index of the term in the term list
+        uint32_t termIndex;
+
+        Match(CharacterOffset o, uint32_t t) : offset(o), termIndex(t) {}
+
+        bool operator<(const Match& other) const
+        {
+            return offset < other.offset ||
+                (offset == other.offset && termIndex < other.termIndex);
+        }
+    };
+
+    /**
+     * @brief build the automaton of @p termList, the empty terms are never matched.
+     * @param termList the raw, analyzed and tokenized query terms
+     */
+    explicit MultiTermMatcher(const std::vector<izenelib::util::UString>& termList);
+
+    std::size_t termNum() const { return terms_.size(); }
+
+    CharacterOffset termLength(uint32_t termIndex) const
+    {
+        return terms_[termIndex].length;
+    }
+
+    /// @brief whether the term has any numeric character before its first CJK character
+    bool isNumericTerm(uint32_t termIndex) const
+    {
+        return terms_[termIndex].isNumeric;
+    }
+
+    /// @brief whether the term contains any Chinese, Korean or Japanese character
+    bool isCJKTerm(uint32_t termIndex) const
+    {
+        return terms_[termIndex].isCJK;
+    }
+
+    /**
+     * @brief find all the occurrences of the terms in @p text, ignoring case.
+     *        The occurrences of different terms, or of the same term, might overlap.
+     * @param matches the result sorted by offset, then by term index
+     */
+    void match(
+        const izenelib::util::UString& text,
+        std::vector<Match>& matches
+    ) const;
+
+    /// @brief lower case of the latin letters, used as @c SM_IGNORE in @c UString::find()
+    static CharT foldCase(CharT c)
+    {
+        if ((c >= 'A' && c <= 'Z') ||
+            (c >= 0xC0 && c <= 0xDE && c != 0xD7))
+            return c + 0x20;
+
+        return c;
+    }
+
+private:
+    typedef uint32_t StateId;
+
+    struct TermInfo
+    {
+        CharacterOffset length;
+        bool isNumeric;
+        bool isCJK;
+    };
+
+    struct Edge
+    {
+        CharT label;
+        StateId target;
+
+        bool operator<(const Edge& other) const
+        {
+            return label < other.label;
+        }
+    };
+
+    struct State
+    {
+        /// the outgoing edges in edges_, sorted by label
+        uint32_t edgeBegin;
+        uint32_t edgeEnd;
+
+        /// the terms ending at this state in outputs_, including the
+        /// terms of the states on its failure chain
+        uint32_t outputBegin;
+        uint32_t outputEnd;
+
+        StateId failure;
+    };
+
+    /// @return the state after @p label from @p state, or 0 if not exists
+    StateId goTo_(StateId state, CharT label) const;
+
+    StateId next_(StateId state, CharT label) const;
+
+    void build_(const std::vector<izenelib::util::UString>& termList);
+
+private:
+    /// @brief the state of empty prefix
+    static const StateId ROOT;
+
+    /// the root edges for ASCII characters, which are looked up most often
+    enum { ROOT_TABLE_SIZE = 128 };
+
+    std::vector<TermInfo> terms_;
+
+    std::vector<State> states_;
+
+    std::vector<Edge> edges_;
+
+    std::vector<uint32_t> outputs_;
+
+    std::vector<StateId> rootTable_;
+};
+
+}
+#endif //_MULTI_TERM_MATCHER_H_
@@ -14,10 +14,13 @@
  * - 2009-11-20 Deepesh Shrestha
  *   computeInverseSentenceFrequency() for computing tf*ISF
  *   as a sentence metric for selecting snippet
+ * - getSnippet() finds the query terms of all sentences in one pass
+ *   by MultiTermMatcher
  */
 
 #include "SnippetGeneratorSubManager.h"
 #include <cmath>
+#include <algorithm>
 #include <util/profiler/ProfilerGroup.h>
 
 using namespace std;
@@ -34,7 +37,7 @@ const unsigned int SnippetGeneratorSubManager::MAX_TERM_FREQUENCY = 10;
 bool SnippetGeneratorSubManager::getSnippet(
     const UString &text,
     const vector<uint32_t>& offsetPairs,
-    const std::vector<UString>& queryTerms,
+    const MultiTermMatcher& termMatcher,
     const unsigned int maxSnippetLength, 
     const bool bHighlight,
     izenelib::util::UString::EncodingType& encodingType, 
@@ -60,6 +63,14 @@ bool SnippetGeneratorSubManager::getSnippet(
     std::vector<uint32_t> contained_term1;
     std::vector<uint32_t> contained_term2;
 
+    //all occurrences of query terms in text, found in one pass
+    std::vector<MultiTermMatcher::Match> matches;
+    termMatcher.match(text, matches);
+
+    const uint32_t termNum = termMatcher.termNum();
+    std::vector<std::vector<CharacterOffset> > termOffsets(termNum);
+    std::vector<CharacterOffset> nextOffsets(termNum);
+
     for (; i < offsetPairs.size()-1; i+=2)
     {
         CharacterOffset start = offsetPairs[i+1];
@@ -68,53 +79,58 @@ bool SnippetGeneratorSubManager::getSnippet(
         unsigned int tf = 0;
         double score = 0.0;
 
-        UString subText;
-        CharacterOffset length;
+        const CharacterOffset sentenceStart = offsetPairs[i];
+        const CharacterOffset sentenceEnd = offsetPairs[i+1];
 
-        if (offsetPairs[i+1] <= text.length())
-            text.substr(subText, offsetPairs[i], offsetPairs[i+1]
-                        - offsetPairs[i]);
-        else
+        if (sentenceEnd > text.length() || sentenceStart >= sentenceEnd)
             continue;
 
-        if (subText.empty())
-            continue;
+        //fetches character offsets of each query term string in sentence,
+        //the occurrences of the same term do not overlap
+        for (uint32_t termIndex = 0; termIndex < termNum; ++termIndex)
+        {
+            termOffsets[termIndex].clear();
+            nextOffsets[termIndex] = sentenceStart;
+        }
+
+        for (vector<MultiTermMatcher::Match>::const_iterator it = lower_bound(
+                    matches.begin(), matches.end(), MultiTermMatcher::Match(sentenceStart, 0));
+                it != matches.end() && it->offset < sentenceEnd; ++it)
+        {
+            const CharacterOffset termEnd = it->offset + termMatcher.termLength(it->termIndex);
+            if (termEnd > sentenceEnd || it->offset < nextOffsets[it->termIndex])
+                continue;
 
-        length = subText.length();
+            termOffsets[it->termIndex].push_back(it->offset);
+            nextOffsets[it->termIndex] = termEnd;
+        }
 
         std::vector<uint32_t> contained_term;
-        uint32_t termIndex=0;
         bool has_first_term = false;
 
-        for (vector<UString>::const_iterator it = queryTerms.begin(); it
-                != queryTerms.end(); it++, termIndex++)
+        for (uint32_t termIndex = 0; termIndex < termNum; ++termIndex)
         {
-            CharacterOffset offset = 0;
+            const std::vector<CharacterOffset>& offsets = termOffsets[termIndex];
             CharacterOffset s=-1, e=-1;
             bool first = true;
-            //fetches character offset of query term string in text
-            while ( ( (offset = subText.find(*it, offset, SM_IGNORE))
-                      != izenelib::util::UString::NOT_FOUND ) && (offset < length)
-                    && (tf < MAX_TERM_FREQUENCY))
+            for (std::size_t k = 0; k < offsets.size() && tf < MAX_TERM_FREQUENCY; ++k)
             {
                 if (termIndex == 0)
                 {
                     has_first_term = true;
                 }
-                string str;
                 if (contained_term.size()==0||contained_term[contained_term.size()-1]!=termIndex)
                     contained_term.push_back(termIndex);
 
                 tf += 1;
                 if (first)
                 {
-                    s = offset+ offsetPairs[i];
+                    s = offsets[k];
                     first = false;
 
                 }
-                e = offset + offsetPairs[i];
-                offset += static_cast<CharacterOffset>(it->length());
-            } //end while
+                e = offsets[k];
+            } //end for
             if ( s != (CharacterOffset)-1 && (start == 0 || s < start) )
                 start = s;
             if ( start < start_off )
@@ -122,10 +138,10 @@ bool SnippetGeneratorSubManager::getSnippet(
             if ( e > end )
                 end = e;
         }
-        if (queryTerms.size()>1&&contained_term1.size()==1&&contained_term.size()==1
+        if (termNum>1&&contained_term1.size()==1&&contained_term.size()==1
                 &&contained_term[0]==contained_term1[0])
             continue;
-        if (queryTerms.size()>1&&contained_term2.size()==1&&contained_term.size()==1
+        if (termNum>1&&contained_term2.size()==1&&contained_term.size()==1
                 &&contained_term[0]==contained_term2[0])
             continue;
         score = computeScore_(tf, start, end);
@@ -168,7 +184,7 @@ bool SnippetGeneratorSubManager::getSnippet(
     {
         if ( text.isChineseChar(start_off1) )
             start_off1 = (start_off1-sen_off1 < (int)maxSnippetLength/2)? sen_off1+1:start_off1 - maxSnippetLength/2;
-        if (getSnippetText_(text, queryTerms, start_off1, start_off1 < start_off2 ? start_off2 : text.length()-1, maxSnippetLength,
+        if (getSnippetText_(text, termMatcher, start_off1, start_off1 < start_off2 ? start_off2 : text.length()-1, maxSnippetLength,
                             bHighlight, encodingType, snippetText) == false)
             return false;
     }
@@ -176,7 +192,7 @@ bool SnippetGeneratorSubManager::getSnippet(
     {
         if ( text.isChineseChar(start_off2) )
             start_off2 = (start_off2-sen_off2 < (int)maxSnippetLength/2)? sen_off2+1:start_off2-maxSnippetLength/2;
-        if (getSnippetText_(text, queryTerms, start_off2, start_off1 < start_off2 ? text.length()-1 : start_off1 , maxSnippetLength,
+        if (getSnippetText_(text, termMatcher, start_off2, start_off1 < start_off2 ? text.length()-1 : start_off1 , maxSnippetLength,
                             bHighlight, encodingType, snippetText) == false)
             return false;
     }
@@ -186,7 +202,7 @@ bool SnippetGeneratorSubManager::getSnippet(
 ///@brief generateSnippetText_() for cropping snippet text from sentence
 bool SnippetGeneratorSubManager::getSnippetText_(
     const UString& text,
-    const std::vector<UString>& queryTerms, 
+    const MultiTermMatcher& termMatcher,
     int snippetStarts,
     int nextSnippetStarts,
     const unsigned int maxSnippetLength, 
@@ -245,7 +261,7 @@ bool SnippetGeneratorSubManager::getSnippetText_(
     if (bHighlight)
     {
         UString highlightedText;
-        highlighter_.getHighlightedText(textFragment, queryTerms, encodingType,
+        highlighter_.getHighlightedText(textFragment, termMatcher, encodingType,
                                         highlightedText);
         snippetText += ellipse;
 
@@ -18,11 +18,14 @@
  * - 2009-11-20 Deepesh Shrestha
  *   computeInverseSentenceFrequency() for computing tf*ISF
  *   as a sentence metric for selecting snippet
+ * - getSnippet() finds the query terms of all sentences in one pass
+ *   by MultiTermMatcher
  *
  */
 
 #include <common/type_defs.h>
 #include <document-manager/highlighter/Highlighter.h>
+#include <document-manager/highlighter/MultiTermMatcher.h>
 
 #include <util/ustring/UString.h>
 #include <vector>
@@ -62,7 +65,8 @@ public:
      * @param text              The text body that is subjected to snippet generation
      * @param offsetPairs       The offfset lists of starting and ending offset pair of sentences
      *                          (computed in TextSummarization.cpp in summarization module)
-     * @param queryTerms    The is the query term string list (Analyzed + origianal query term string)
+     * @param termMatcher       The matcher of query term string list (Analyzed + origianal query term string),
+     *                          it is built once and shared by all the texts of one query
      * @param maxSnippetLength  The length of the snippet to be generated (set in config.xml)
      * @param bHighlight        If want to highlight resut snippet, true. (set in display property)
      * @param encodingType      common encoding type used while indexing and querying (set in config.xml)
@@ -72,7 +76,7 @@ public:
     bool getSnippet(
         const izenelib::util::UString& text,
         const std::vector<uint32_t>& offsetPairs,
-        const std::vector<izenelib::util::UString>& queryTerms,
+        const MultiTermMatcher& termMatcher,
         const unsigned int maxSnippetLength,
         const bool bHighlight,
         izenelib::util::UString::EncodingType& encodingType,
@@ -85,7 +89,7 @@ private:
      * @brief getSnippetText_() method for cropping snippet text from snippet sentence.
      *
      * @param text              The text body that is subjected to snippet generation
-     * @param queryTerms        The is the query term string list (Analyzed + origianal query term string)
+     * @param termMatcher       The matcher of query term string list (Analyzed + origianal query term string)
      * @param maxSnippetLength  The length of the snippet to be generated (set in config.xml)
      * @param bHighlight        If want to highlight resut snippet, true. (set in display property)
      * @param encodingType      common encoding type used while indexing and querying (set in config.xml)
@@ -94,7 +98,7 @@ private:
 
     bool getSnippetText_(
         const izenelib::util::UString& text,
-        const std::vector<izenelib::util::UString>& queryTerms,
+        const MultiTermMatcher& termMatcher,
         int snippetStarts,
         int nextSnippetStarts,
         const unsigned int maxSnippetLength,
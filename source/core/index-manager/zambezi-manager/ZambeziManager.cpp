@@ -1,7 +1,10 @@
 #include "ZambeziManager.h"
+#include "ZambeziMerger.h"
 #include <common/PropSharedLock.h>
 #include "../zambezi-tokenizer/ZambeziTokenizer.h"
 #include <boost/utility.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
 #include <boost/filesystem.hpp>
 #include <fstream>
 #include <math.h>
@@ -14,6 +17,7 @@ ZambeziManager::ZambeziManager(
         const ZambeziConfig& config)
     : config_(config)
     , zambeziTokenizer_(NULL)
+    , threadpool_(std::max(boost::thread::hardware_concurrency(), 1U))
 {
     init();
 
@@ -170,18 +174,45 @@ void ZambeziManager::search(
     if (searchPropertyList.empty())
         searchPropertyList = propertyList_;
 
-    std::vector<std::vector<docid_t> > docidsList;
-    docidsList.resize(searchPropertyList.size());
-    std::vector<std::vector<float> > scoresList;
-    scoresList.resize(searchPropertyList.size());
-
+    std::vector<ZambeziIndexBase*> indexList;
     std::vector<float> weightList;
     for (unsigned int i = 0; i < searchPropertyList.size(); ++i)
     {
-        property_index_map_[searchPropertyList[i]]->retrieve(algorithm, tokens, filter, limit, docidsList[i], scoresList[i]);
+        std::map<std::string, ZambeziIndexBase*>::const_iterator it =
+            property_index_map_.find(searchPropertyList[i]);
+        if (it == property_index_map_.end() || it->second == NULL)
+        {
+            LOG(WARNING) << "no zambezi index for property: " << searchPropertyList[i];
+            continue;
+        }
+        indexList.push_back(it->second);
         weightList.push_back(config_.getWeight(searchPropertyList[i]));
     }
 
+    std::vector<std::vector<docid_t> > docidsList(indexList.size());
+    std::vector<std::vector<float> > scoresList(indexList.size());
+
+    // the other properties are retrieved in pool,
+    // while the first one is retrieved in current thread
+    boost::detail::atomic_count finishedJobs(0);
+    for (std::size_t i = 1; i < indexList.size(); ++i)
+    {
+        threadpool_.schedule(
+            boost::bind(&ZambeziManager::retrieveJob_, this,
+                        algorithm, boost::cref(tokens), indexList[i], filter, limit,
+                        &docidsList[i], &scoresList[i], &finishedJobs));
+    }
+
+    if (!indexList.empty())
+    {
+        retrieveJob_(algorithm, tokens, indexList[0], filter, limit,
+                     &docidsList[0], &scoresList[0], &finishedJobs);
+        threadpool_.wait(finishedJobs, indexList.size());
+    }
+
+    LOG(INFO) << "zambezi retrieves " << indexList.size()
+              << " properties, costs :" << timer.elapsed() << " seconds";
+
     izenelib::util::ClockTimer timer_merge;
 
     for (unsigned int i = 0; i < docidsList.size(); ++i)
@@ -196,8 +227,11 @@ void ZambeziManager::search(
         }
     }
 
-    //set weightList of preproty;
-    merge_(docidsList, scoresList, weightList, docids, scores);
+    // only SVS and BWAND_AND retrieve the docs in docid order
+    const bool isPrefix = algorithm == izenelib::ir::Zambezi::SVS ||
+                          algorithm == izenelib::ir::Zambezi::BWAND_AND;
+    mergeZambeziResults(docidsList, scoresList, weightList,
+                        config_.reverse, isPrefix, limit, docids, scores);
 
     LOG(INFO) << "zambezi merge " << docidsList.size()
               << " properties, costs :" << timer_merge.elapsed() << " seconds";
@@ -206,78 +240,25 @@ void ZambeziManager::search(
               << ", costs :" << timer.elapsed() << " seconds";
 }
 
-// to do, add weight to each posting
-void ZambeziManager::merge_(
-        const std::vector<std::vector<docid_t> >& docidsList,
-        const std::vector<std::vector<float> >& scoresList,
-        const std::vector<float>& weightList,
-        std::vector<docid_t>& docids,
-        std::vector<float>& scores)
+void ZambeziManager::retrieveJob_(
+        izenelib::ir::Zambezi::Algorithm algorithm,
+        const std::vector<std::pair<std::string, int> >& tokens,
+        ZambeziIndexBase* index,
+        const ZambeziFilterBase* filter,
+        uint32_t limit,
+        std::vector<docid_t>* docids,
+        std::vector<float>* scores,
+        boost::detail::atomic_count* finishedJobs)
 {
-    // init
-    unsigned int docidsListSize = docidsList.size();
-    int totalCount = 0;
-    int docCount = 0;
-
-    std::list<pair<int, unsigned int> > existingList;
-    for (unsigned int i = 0; i < docidsListSize; ++i)
+    try
     {
-        if (docidsList[i].size() != 0)
-        {
-            totalCount += docidsList[i].size();
-            existingList.push_back(std::make_pair(i, 0));
-        }
+        index->retrieve(algorithm, tokens, filter, limit, *docids, *scores);
     }
-    docids.resize(totalCount);
-    scores.resize(totalCount);
-
-    // count
-    std::vector<std::list<pair<int, unsigned int> >::iterator> minDocList;
-
-    unsigned int min = -1;
-    while(existingList.size() > 1)
+    catch (const std::exception& e)
     {
-        if (config_.reverse)
-            min = 0;
-        else
-            min = -1;
-
-        for (std::list<pair<int, unsigned int> >::iterator i = existingList.begin(); i != existingList.end(); ++i)
-        {
-            if ((config_.reverse && min < docidsList[i->first][i->second]) ||
-                (!config_.reverse && min > docidsList[i->first][i->second]))
-            {
-                min = docidsList[i->first][i->second];
-                minDocList.clear();
-                minDocList.push_back(i);
-                continue;
-            }
-            if (min == docidsList[i->first][i->second])
-                minDocList.push_back(i);
-        }
-
-        for (unsigned int i = 0; i < minDocList.size(); ++i)
-        {
-            int k = minDocList[i]->first;
-            int j = minDocList[i]->second++;
-            if (minDocList[i]->second == docidsList[k].size())
-                existingList.erase(minDocList[i]);
-
-            docids[docCount] = docidsList[k][j];
-            scores[docCount] += scoresList[k][j]*weightList[k];
-        }
-        docCount++;
-    }
-
-    if (existingList.size() == 1)
-    {
-        int k = existingList.begin()->first;
-        for (unsigned int i = existingList.begin()->second; i < docidsList[k].size(); ++i)
-        {
-            docids[docCount] = docidsList[k][i];
-            scores[docCount++] = scoresList[k][i]*weightList[k];
-        }
+        LOG(ERROR) << "exception in zambezi retrieve: " << e.what();
+        docids->clear();
+        scores->clear();
     }
-    docids.resize(docCount);
-    scores.resize(docCount);
+    ++(*finishedJobs);
 }
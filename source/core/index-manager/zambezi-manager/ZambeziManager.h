@@ -15,6 +15,8 @@
 #include <common/PropSharedLockSet.h>
 #include <util/ClockTimer.h>
 #include <glog/logging.h>
+#include <boost/threadpool.hpp>
+#include <boost/detail/atomic_count.hpp>
 #include <string>
 #include <vector>
 
@@ -45,6 +47,10 @@ public:
 
     bool open();
 
+    /**
+     * For multiple properties, each property is retrieved in parallel, so
+     * @p filter would be tested concurrently.
+     */
     void search(
         izenelib::ir::Zambezi::Algorithm algorithm,
         const std::vector<std::pair<std::string, int> >& tokens,
@@ -74,12 +80,15 @@ public:
     ZambeziTokenizer* getTokenizer();
 
 private:
-    void merge_(
-        const std::vector<std::vector<docid_t> >& docidsList,
-        const std::vector<std::vector<float> >& scoresList,
-        const std::vector<float>& weightList,
-        std::vector<docid_t>& docids,
-        std::vector<float>& scores);
+    void retrieveJob_(
+        izenelib::ir::Zambezi::Algorithm algorithm,
+        const std::vector<std::pair<std::string, int> >& tokens,
+        ZambeziIndexBase* index,
+        const ZambeziFilterBase* filter,
+        uint32_t limit,
+        std::vector<docid_t>* docids,
+        std::vector<float>* scores,
+        boost::detail::atomic_count* finishedJobs);
 
     void createZambeziIndex_(ZambeziIndexBase* &zambeziIndex, uint32_t poolSize);
 
@@ -91,6 +100,9 @@ private:
     std::vector<std::string> propertyList_;
 
     std::map<std::string, ZambeziIndexBase*> property_index_map_;
+
+    /// shared by all searches to retrieve the properties in parallel
+    boost::threadpool::pool threadpool_;
 };
 
 } // namespace sf1r
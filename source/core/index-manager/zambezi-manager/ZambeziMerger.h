@@ -0,0 +1,108 @@
+/**
+ * @file ZambeziMerger.h
+ * @brief k-way merge of the docids retrieved from multiple zambezi indexes.
+ *
+ * Each input list is sorted by docid, in ascending order, or in descending
+ * order if reverse. The merged docids are output in the same order, the
+ * score of each doc is the weighted sum of its scores in all lists.
+ */
+
+#ifndef SF1R_ZAMBEZI_MERGER_H
+#define SF1R_ZAMBEZI_MERGER_H
+
+#include <common/inttypes.h>
+#include <vector>
+#include <limits>
+#include <algorithm> // min
+
+namespace sf1r
+{
+
+/**
+ * merge @p docidsList and @p scoresList into @p docids and @p scores.
+ *
+ * If @p isPrefix is true, each list is the first @p limit matched docids
+ * in docid order, such as the lists retrieved by SVS and BWAND_AND, then
+ * the first @p limit merged docids are not beyond the last docid of any
+ * list, so their scores are complete, and the merge stops there.
+ *
+ * Otherwise, each list is the top docs by score, such as the lists
+ * retrieved by WAND, MBWAND and BWAND_OR, a doc missing in one list
+ * might still be matched, so all docs are merged.
+ */
+inline void mergeZambeziResults(
+    const std::vector<std::vector<docid_t> >& docidsList,
+    const std::vector<std::vector<float> >& scoresList,
+    const std::vector<float>& weightList,
+    bool reverse,
+    bool isPrefix,
+    std::size_t limit,
+    std::vector<docid_t>& docids,
+    std::vector<float>& scores)
+{
+    const std::size_t listNum = docidsList.size();
+
+    std::size_t totalNum = 0;
+    for (std::size_t i = 0; i < listNum; ++i)
+    {
+        totalNum += docidsList[i].size();
+    }
+
+    const std::size_t maxNum = isPrefix ? std::min(totalNum, limit) : totalNum;
+    docids.clear();
+    scores.clear();
+    docids.reserve(maxNum);
+    scores.reserve(maxNum);
+
+    // the docids are compared by key in ascending order, in reverse
+    // order, the key is the complement of docid, and the end key of
+    // each list matches docid 0, which is never retrieved.
+    const uint32_t endKey = std::numeric_limits<uint32_t>::max();
+    const uint32_t keyMask = reverse ? endKey : 0;
+
+    // the key of the current docid in each list
+    std::vector<uint32_t> heads(listNum, endKey);
+    std::vector<std::size_t> positions(listNum, 0);
+
+    for (std::size_t i = 0; i < listNum; ++i)
+    {
+        if (!docidsList[i].empty())
+        {
+            heads[i] = docidsList[i][0] ^ keyMask;
+        }
+    }
+
+    while (docids.size() < maxNum)
+    {
+        // a min reduction over a small array, without branches
+        uint32_t minKey = endKey;
+        for (std::size_t i = 0; i < listNum; ++i)
+        {
+            minKey = std::min(minKey, heads[i]);
+        }
+
+        if (minKey == endKey)
+            break;
+
+        float score = 0;
+        for (std::size_t i = 0; i < listNum; ++i)
+        {
+            if (heads[i] != minKey)
+                continue;
+
+            std::size_t& pos = positions[i];
+            score += scoresList[i][pos] * weightList[i];
+
+            ++pos;
+            heads[i] = pos < docidsList[i].size() ?
+                docidsList[i][pos] ^ keyMask : endKey;
+        }
+
+        docids.push_back(minKey ^ keyMask);
+        scores.push_back(score);
+    }
+}
+
+} // namespace sf1r
+
+#endif // SF1R_ZAMBEZI_MERGER_H
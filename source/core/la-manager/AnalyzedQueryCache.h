@@ -0,0 +1,171 @@
+/**
+ * @file AnalyzedQueryCache.h
+ * @brief cache the terms of the analyzed queries, so that the same popular
+ *        query is not tokenized again in search, highlight and summary.
+ */
+
+#ifndef SF1R_ANALYZED_QUERY_CACHE_H
+#define SF1R_ANALYZED_QUERY_CACHE_H
+
+#include "AnalysisInformation.h"
+
+#include <la/LA.h>
+#include <la/dict/UpdatableDict.h>
+#include <util/ustring/UString.h>
+#include <util/singleton.h>
+#include <cache/IzeneCache.h>
+
+#include <boost/atomic.hpp>
+#include <string>
+#include <set>
+
+namespace sf1r
+{
+
+class AnalyzedQueryCache
+{
+public:
+    /// the max number of queries in cache
+    static const unsigned int DEFAULT_CACHE_SIZE = 10000;
+
+    explicit AnalyzedQueryCache(unsigned int cacheSize = DEFAULT_CACHE_SIZE)
+        : cache_(cacheSize)
+        , generation_(0)
+    {
+    }
+
+    static AnalyzedQueryCache* get()
+    {
+        return ::izenelib::util::Singleton<AnalyzedQueryCache>::get();
+    }
+
+    bool get(
+        const izenelib::util::UString& text,
+        const AnalysisInfo& analysisInfo,
+        la::TermList& termList)
+    {
+        CacheEntry entry;
+        if (!cache_.getValueNoInsert(makeKey_(text, analysisInfo), entry) ||
+            entry.generation != generation_.load(boost::memory_order_acquire))
+            return false;
+
+        termList.swap(entry.termList);
+        return true;
+    }
+
+    /**
+     * @param generation the value of @c generation() before @p termList
+     *        is analyzed, so that the terms analyzed by the dictionaries
+     *        before reload are not cached as valid.
+     */
+    void set(
+        const izenelib::util::UString& text,
+        const AnalysisInfo& analysisInfo,
+        const la::TermList& termList,
+        unsigned int generation)
+    {
+        CacheEntry entry;
+        entry.termList = termList;
+        entry.generation = generation;
+
+        cache_.insertValue(makeKey_(text, analysisInfo), entry);
+    }
+
+    unsigned int generation() const
+    {
+        return generation_.load(boost::memory_order_acquire);
+    }
+
+    /**
+     * invalidate all the cached terms, it is called when the dictionaries
+     * are reloaded.
+     */
+    void invalidate()
+    {
+        generation_.fetch_add(1, boost::memory_order_acq_rel);
+    }
+
+private:
+    static std::string makeKey_(
+        const izenelib::util::UString& text,
+        const AnalysisInfo& analysisInfo)
+    {
+        std::string key(analysisInfo.analyzerId_);
+
+        for (std::set<std::string>::const_iterator it =
+                 analysisInfo.tokenizerNameList_.begin();
+             it != analysisInfo.tokenizerNameList_.end(); ++it)
+        {
+            key += '\t';
+            key += *it;
+        }
+        key += '\n';
+
+        std::string str;
+        text.convertString(str, izenelib::util::UString::UTF_8);
+        key += str;
+
+        return key;
+    }
+
+private:
+    struct CacheEntry
+    {
+        la::TermList termList;
+
+        /// the generation when the terms are analyzed
+        unsigned int generation;
+    };
+
+    typedef izenelib::cache::IzeneCache<
+        std::string,
+        CacheEntry,
+        izenelib::util::ReadWriteLock,
+        izenelib::cache::RDE_HASH,
+        izenelib::cache::LRLFU
+    > cache_type;
+
+    cache_type cache_;
+
+    boost::atomic<unsigned int> generation_;
+};
+
+/**
+ * It is registered to @c la::UpdateDictThread after the analyzers, so that
+ * when a dictionary is reloaded by the thread, the cached terms are
+ * invalidated after the analyzers have reloaded it.
+ */
+class AnalyzedQueryCacheInvalidator : public la::UpdatableDict
+{
+public:
+    explicit AnalyzedQueryCacheInvalidator(AnalyzedQueryCache& cache)
+        : cache_(cache)
+        , lastModifiedTime_(0)
+    {
+    }
+
+    /**
+     * @param path the dictionary path
+     * @param lastModifiedTime last modified time
+     * @return 0 indicates success and others indicates fails
+     */
+    virtual int update(const char* path, unsigned int lastModifiedTime)
+    {
+        if (lastModifiedTime_ != lastModifiedTime)
+        {
+            cache_.invalidate();
+            lastModifiedTime_ = lastModifiedTime;
+        }
+        return 0;
+    }
+
+private:
+    AnalyzedQueryCache& cache_;
+
+    /** current modified time */
+    unsigned int lastModifiedTime_;
+};
+
+} // namespace sf1r
+
+#endif // SF1R_ANALYZED_QUERY_CACHE_H
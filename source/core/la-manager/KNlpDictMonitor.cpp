@@ -1,4 +1,5 @@
 #include "KNlpDictMonitor.h"
+#include "AnalyzedQueryCache.h"
 #include <common/ResourceManager.h>
 #include <util/singleton.h>
 #include <sys/inotify.h>
@@ -30,6 +31,7 @@ bool KNlpDictMonitor::handle(const std::string& fileName, uint32_t mask)
             return false;
 
         KNlpResourceManager::setResource(knlpWrapper);
+        AnalyzedQueryCache::get()->invalidate();
     }
 
     return true;
@@ -7,6 +7,7 @@
 ///     - 2009.07.09 Merged some interfaces into one by dohyun Yun.
 
 #include "LAManager.h"
+#include "AnalyzedQueryCache.h"
 
 #include <la/dict/PlainDictionary.h>
 #include <util/profiler/ProfilerGroup.h>
@@ -40,15 +41,23 @@ void LAManager::loadStopDict(const std::string & path)
     stopDict_->reloadDict(path.c_str());
 }
 
+la::LA* LAManager::getSearchLA_(const AnalysisInfo& analysisInfo)
+{
+    return isMultiThreadEnv_ ? laPool_->getThreadSearchLA(analysisInfo) :
+           laPool_->topSearchLA(analysisInfo);
+}
+
 bool LAManager::getTermList(
         const izenelib::util::UString & text,
         const AnalysisInfo& analysisInfo,
         la::TermList& termList)
 {
-    LA * pLA = NULL;
+    AnalyzedQueryCache* cache = AnalyzedQueryCache::get();
+    if (cache->get(text, analysisInfo, termList))
+        return true;
 
-    pLA = isMultiThreadEnv_ ? laPool_->popSearchLA(analysisInfo) :
-          laPool_->topSearchLA(analysisInfo);
+    const unsigned int cacheGeneration = cache->generation();
+    LA * pLA = getSearchLA_(analysisInfo);
 
     if (!pLA)
     {
@@ -65,8 +74,7 @@ bool LAManager::getTermList(
 
     pLA->process(text, termList);
 
-    if (isMultiThreadEnv_)
-        laPool_->pushSearchLA(analysisInfo, pLA);
+    cache->set(text, analysisInfo, termList, cacheGeneration);
 
     return true;
 }
@@ -78,9 +86,7 @@ bool LAManager::getExpandedQuery(
         bool isSynonymInclude,
         izenelib::util::UString& expQuery)
 {
-    LA * pLA = NULL;
-    pLA = isMultiThreadEnv_ ? laPool_->popSearchLA(analysisInfo) :
-          laPool_->topSearchLA(analysisInfo);
+    LA * pLA = getSearchLA_(analysisInfo);
 
     if (!pLA)
     {
@@ -125,10 +131,6 @@ bool LAManager::getExpandedQuery(
 	//debug wang,lele
     cout << "##########################" << la::to_utf8(expQuery) << endl;
 
-
-    if (isMultiThreadEnv_)
-        laPool_->pushSearchLA(analysisInfo, pLA);
-
     return true;
 }
 
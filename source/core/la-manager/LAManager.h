@@ -53,15 +53,10 @@ public:
             TermIdList& termIdList,
             la::MultilangGranularity indexingLevel = la::FIELD_LEVEL)
     {
-        la::LA * pLA = NULL;
-        if (laPool_)
-        {
-            pLA = isMultiThreadEnv_ ? laPool_->popSearchLA(analysisInfo) :
-                laPool_->topSearchLA(analysisInfo);
-        }
-        else
+        if (!laPool_)
             return false;
-        
+
+        la::LA * pLA = getSearchLA_(analysisInfo);
 
         if (!pLA)
         {
@@ -78,12 +73,10 @@ public:
         }
 
         pLA->process(idm, text, termIdList, indexingLevel);
-
-        if (isMultiThreadEnv_)
-            laPool_->pushSearchLA(analysisInfo, pLA);
         return true;
     }
 
+    /// @brief Gets the terms of @p text, the result is cached by @c AnalyzedQueryCache.
     bool getTermList(
             const izenelib::util::UString & text,
             const AnalysisInfo& analysisInfo,
@@ -107,6 +100,9 @@ public:
     la::LA* get_la(const AnalysisInfo& analysisInfo);
 
 private:
+    /// @brief Gets the LA of current thread in multi-thread environment,
+    /// it should not be pushed back to @c laPool_.
+    la::LA* getSearchLA_(const AnalysisInfo& analysisInfo);
 
     bool isMultiThreadEnv_; ///< Whether the Entire running environment is single-thread
 
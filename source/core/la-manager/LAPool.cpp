@@ -1,6 +1,7 @@
 #include <common/SFLogger.h>
 #include "LAPool.h"
 #include "AnalysisInformation.h"
+#include "AnalyzedQueryCache.h"
 #include <query-manager/QMCommonFunc.h>
 
 #include <boost/tokenizer.hpp>
@@ -393,6 +394,9 @@ namespace sf1r
 
     LAPool::~LAPool()
     {
+        // push back the LAs of current thread, so that they are deleted below
+        threadSearchLAs_.reset();
+
         unordered_map<AnalysisInfo, deque<LA*> >::iterator it;
         deque<LA*>::iterator la_it;
 
@@ -522,6 +526,21 @@ namespace sf1r
             }
         }
 
+        // the cached query terms are invalidated on dictionary reload,
+        // it is added after the analyzers to be updated after them
+        std::set<std::string> dictPaths;
+        for (LaConfigUnitMap::const_iterator configIt = laConfigUnitMap_.begin();
+                configIt != laConfigUnitMap_.end(); ++configIt)
+        {
+            const std::string dictPath = configIt->second.getDictionaryPath();
+            if (dictPath.empty() || !dictPaths.insert(dictPath).second)
+                continue;
+
+            boost::shared_ptr<la::UpdatableDict> invalidator(
+                new AnalyzedQueryCacheInvalidator(*AnalyzedQueryCache::get()));
+            la::UpdateDictThread::staticUDT.addRelatedDict(dictPath.c_str(), invalidator);
+        }
+
         //start dynamic update
         la::UpdateDictThread::staticUDT.setCheckInterval(laManagerConfig.updateDictInterval_);
         la::UpdateDictThread::staticUDT.start();
@@ -1139,6 +1158,42 @@ namespace sf1r
     } // end  - pushSearchLA(const AnalysisInfo & analysisInfo, LA * laThread )
 
 
+    LA * LAPool::getThreadSearchLA(const AnalysisInfo & analysisInfo )
+    {
+        ThreadSearchLAs * threadLAs = threadSearchLAs_.get();
+        if( threadLAs == NULL )
+        {
+            threadLAs = new ThreadSearchLAs;
+            threadLAs->pool_ = this;
+            threadSearchLAs_.reset( threadLAs );
+        }
+
+        unordered_map<AnalysisInfo, LA*>::const_iterator it = threadLAs->laMap_.find(analysisInfo);
+        if( it != threadLAs->laMap_.end() )
+        {
+            return it->second;
+        }
+
+        LA * la = popSearchLA( analysisInfo );
+        if( la != NULL )
+        {
+            threadLAs->laMap_[analysisInfo] = la;
+        }
+
+        return la;
+    } //end - getThreadSearchLA(const AnalysisInfo & analysisInfo )
+
+
+    LAPool::ThreadSearchLAs::~ThreadSearchLAs()
+    {
+        unordered_map<AnalysisInfo, LA*>::const_iterator it;
+        for( it = laMap_.begin(); it != laMap_.end(); it++ )
+        {
+            pool_->pushSearchLA( it->first, it->second );
+        }
+    }
+
+
     LA * LAPool::topSearchLA(const AnalysisInfo & analysisInfo )
     {
         unordered_map<AnalysisInfo, deque<LA*> >::iterator it = laSearchPool_.find(analysisInfo);
@@ -10,6 +10,7 @@
 #include <util/singleton.h>
 
 #include <boost/unordered_map.hpp>
+#include <boost/thread/tss.hpp>
 
 #include <deque>
 #include <map>
@@ -109,6 +110,13 @@ namespace sf1r
 
             void pushSearchLA(const AnalysisInfo & analysisInfo, la::LA * laThread );
 
+            ///
+            /// @brief Get the search LA owned by current thread, so that the pool is not
+            /// locked for each query. The LA is pushed back to the pool when the thread exits,
+            /// the caller should not push it.
+            ///
+            la::LA * getThreadSearchLA(const AnalysisInfo& analysisInfo );
+
             ///
             /// @brief Don't remove the LA pointer in the Pool, Ensure the entire running environment
             /// is single-thread before use this function
@@ -149,6 +157,18 @@ namespace sf1r
 
         private:
 
+            ///
+            /// @brief The search LAs popped by one thread
+            ///
+            struct ThreadSearchLAs
+            {
+                LAPool * pool_;
+
+                boost::unordered_map<AnalysisInfo, la::LA*> laMap_;
+
+                ~ThreadSearchLAs();
+            };
+
             ///
             /// @brief Holds the map of LAs for indexing, which is not multi-threaded
             ///
@@ -167,6 +187,8 @@ namespace sf1r
 
             izenelib::util::ReadWriteLock lock_;
 
+            boost::thread_specific_ptr<ThreadSearchLAs> threadSearchLAs_;
+
             std::map<std::string, AnalysisInfo> innerAnalysisInfos_;
 
             /// @brief resource path for KMA
@@ -0,0 +1,170 @@
+#include "MiningDocReader.h"
+#include "MiningTask.h"
+#include <document-manager/DocumentManager.h>
+#include <boost/bind.hpp>
+#include <algorithm>
+#include <set>
+
+using namespace sf1r;
+
+const std::size_t MiningDocReader::MAX_QUEUE_SIZE;
+
+MiningDocReader::MiningDocReader(
+    DocumentManager& documentManager,
+    bool isAllProperties,
+    const std::vector<std::string>& propertyNames,
+    docid_t startDocId,
+    docid_t endDocId,
+    std::size_t batchSize)
+    : documentManager_(documentManager)
+    , isAllProperties_(isAllProperties)
+    , propertyNames_(propertyNames)
+    , batchSize_(std::max<std::size_t>(batchSize, 1))
+    , startDocId_(startDocId)
+    , endDocId_(endDocId)
+    , isReadEnd_(false)
+    , readAheadThread_(boost::bind(&MiningDocReader::readAhead_, this))
+{
+}
+
+MiningDocReader::~MiningDocReader()
+{
+    readAheadThread_.interrupt();
+    readAheadThread_.join();
+}
+
+bool MiningDocReader::nextBatch(docid_t& startDocId, std::vector<Document>& docs)
+{
+    BatchPtr batch;
+    {
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        while (queue_.empty() && !isReadEnd_)
+        {
+            pushCond_.wait(lock);
+        }
+
+        if (queue_.empty())
+            return false;
+
+        batch = queue_.front();
+        queue_.pop_front();
+        popCond_.notify_all();
+    }
+
+    if (batch->error)
+        std::rethrow_exception(batch->error);
+
+    startDocId = batch->startDocId;
+    docs.swap(batch->docs);
+    return true;
+}
+
+bool MiningDocReader::getPropertyNames(
+    const std::vector<MiningTask*>& taskList,
+    const std::vector<bool>& taskFlag,
+    std::vector<std::string>& propertyNames)
+{
+    std::set<std::string> nameSet;
+
+    for (std::size_t i = 0; i < taskList.size(); ++i)
+    {
+        if (!taskFlag[i])
+            continue;
+
+        std::vector<std::string> taskPropNames;
+        if (!taskList[i]->getPropertyNames(taskPropNames))
+            return false;
+
+        nameSet.insert(taskPropNames.begin(), taskPropNames.end());
+    }
+
+    propertyNames.assign(nameSet.begin(), nameSet.end());
+    return true;
+}
+
+void MiningDocReader::readAhead_()
+{
+    try
+    {
+        docid_t nextDocId = startDocId_;
+        while (nextDocId <= endDocId_)
+        {
+            const std::size_t docNum = std::min<std::size_t>(
+                batchSize_, endDocId_ - nextDocId + 1);
+
+            BatchPtr batch(new Batch);
+            batch->startDocId = nextDocId;
+            batch->docs.resize(docNum);
+            nextDocId += docNum;
+
+            try
+            {
+                readBatch_(batch->startDocId, batch->docs);
+            }
+            catch (const boost::thread_interrupted&)
+            {
+                throw;
+            }
+            catch (...)
+            {
+                // hand the exception to the consumer, and stop reading
+                batch->docs.clear();
+                batch->error = std::current_exception();
+                pushBatch_(batch);
+                break;
+            }
+
+            pushBatch_(batch);
+        }
+    }
+    catch (const boost::thread_interrupted&)
+    {
+    }
+
+    boost::unique_lock<boost::mutex> lock(mutex_);
+    isReadEnd_ = true;
+    pushCond_.notify_all();
+}
+
+void MiningDocReader::pushBatch_(const BatchPtr& batch)
+{
+    boost::unique_lock<boost::mutex> lock(mutex_);
+    while (queue_.size() >= MAX_QUEUE_SIZE)
+    {
+        popCond_.wait(lock);
+    }
+
+    queue_.push_back(batch);
+    pushCond_.notify_all();
+}
+
+void MiningDocReader::readBatch_(docid_t startDocId, std::vector<Document>& docs)
+{
+    for (std::size_t i = 0; i < docs.size(); ++i)
+    {
+        boost::this_thread::interruption_point();
+
+        const docid_t docId = startDocId + i;
+        Document& doc = docs[i];
+        doc = Document();
+
+        if (isAllProperties_)
+        {
+            if (!documentManager_.getDocument(docId, doc))
+            {
+                doc = Document();
+                continue;
+            }
+            documentManager_.getRTypePropertiesForDocument(docId, doc);
+        }
+        else
+        {
+            if (!documentManager_.getDocument(docId, propertyNames_, doc))
+            {
+                doc = Document();
+                continue;
+            }
+            documentManager_.getRTypePropertiesForDocument(docId, propertyNames_, doc);
+        }
+    }
+}
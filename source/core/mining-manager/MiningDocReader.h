@@ -0,0 +1,126 @@
+/**
+ * @file MiningDocReader.h
+ * @brief read the documents of a docid range in batches for mining tasks.
+ */
+
+#ifndef SF1R_MINING_DOC_READER_H
+#define SF1R_MINING_DOC_READER_H
+
+#include <document-manager/Document.h>
+#include <common/inttypes.h>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <deque>
+#include <exception>
+#include <string>
+#include <vector>
+
+namespace sf1r
+{
+class DocumentManager;
+class MiningTask;
+
+/**
+ * It reads the documents in [startDocId, endDocId] in docid order, while
+ * the current batch is built, the next batches are read ahead in another
+ * thread, so that the document store is scanned sequentially.
+ *
+ * The read-ahead thread runs through the whole range, it puts each batch
+ * into a queue of at most @c MAX_QUEUE_SIZE batches, and waits when the
+ * queue is full.
+ */
+class MiningDocReader
+{
+public:
+    /// the number of documents in each batch
+    static const std::size_t DEFAULT_BATCH_SIZE = 1000;
+
+    /// the max number of batches read ahead
+    static const std::size_t MAX_QUEUE_SIZE = 2;
+
+    /**
+     * @param isAllProperties if false, only the properties in
+     *        @p propertyNames are read
+     */
+    MiningDocReader(
+        DocumentManager& documentManager,
+        bool isAllProperties,
+        const std::vector<std::string>& propertyNames,
+        docid_t startDocId,
+        docid_t endDocId,
+        std::size_t batchSize = DEFAULT_BATCH_SIZE);
+
+    ~MiningDocReader();
+
+    /**
+     * get the next batch of documents.
+     * @param startDocId the docid of the first document in @p docs
+     * @param docs the document not existed is empty, whose id is 0
+     * @return false if all documents are read
+     * @exception the exception thrown in reading the batch is rethrown here
+     */
+    bool nextBatch(docid_t& startDocId, std::vector<Document>& docs);
+
+    /**
+     * get the union of the properties needed by the tasks in @p taskList.
+     * @param taskFlag only the task whose flag is true is checked
+     * @return false if any task needs all the properties
+     */
+    static bool getPropertyNames(
+        const std::vector<MiningTask*>& taskList,
+        const std::vector<bool>& taskFlag,
+        std::vector<std::string>& propertyNames);
+
+private:
+    struct Batch
+    {
+        docid_t startDocId;
+        std::vector<Document> docs;
+
+        /// the exception thrown in reading this batch
+        std::exception_ptr error;
+    };
+    typedef boost::shared_ptr<Batch> BatchPtr;
+
+    /** the loop of the read-ahead thread */
+    void readAhead_();
+
+    void readBatch_(docid_t startDocId, std::vector<Document>& docs);
+
+    /** wait until the queue is not full, and push @p batch */
+    void pushBatch_(const BatchPtr& batch);
+
+private:
+    DocumentManager& documentManager_;
+
+    const bool isAllProperties_;
+
+    const std::vector<std::string> propertyNames_;
+
+    const std::size_t batchSize_;
+
+    const docid_t startDocId_;
+    const docid_t endDocId_;
+
+    /// the batches read ahead, guarded by mutex_
+    std::deque<BatchPtr> queue_;
+
+    /// whether all batches are pushed into queue_, guarded by mutex_
+    bool isReadEnd_;
+
+    boost::mutex mutex_;
+
+    /// notified when a batch is pushed
+    boost::condition_variable pushCond_;
+
+    /// notified when a batch is popped
+    boost::condition_variable popCond_;
+
+    boost::thread readAheadThread_;
+};
+
+} // namespace sf1r
+
+#endif // SF1R_MINING_DOC_READER_H
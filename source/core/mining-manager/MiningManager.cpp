@@ -1174,12 +1174,8 @@ bool MiningManager::GetSuffixMatch(
 
     if (!totalCount ||res_list.empty()) return false;
 
-    //We do not use this post delete filtering because deleted documents should never be searched from
-    //suffix index in normal cases, while if there are deleted documents before mining finished, these documents
-    //should be abled to searched as well.
-    //We ignore the exception case that SF1 quit before mining finished
-    //if (!hasDeletedDocDuringMining_)
-    //    res_list.erase(std::remove_if (res_list.begin(), res_list.end(), IsDeleted(document_manager_)), res_list.end());
+    //The deleted documents are filtered out in SuffixMatchManager, as they are kept in the
+    //fm-index until it is rebuilt.
     res_list.resize(std::min(orig_max_docs, res_list.size()));
 
     docIdList.resize(res_list.size());
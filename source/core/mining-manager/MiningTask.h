@@ -8,6 +8,8 @@
 
 #include <document-manager/Document.h>
 #include <common/inttypes.h>
+#include <string>
+#include <vector>
 
 //this is for each proprety....
 namespace sf1r
@@ -26,6 +28,16 @@ public:
 
     virtual docid_t getLastDocId() = 0;
 
+    /**
+     * append the names of the properties read in @c buildDocument(),
+     * so that the builder only fetches these properties of each document.
+     * @return false if all the properties are needed
+     */
+    virtual bool getPropertyNames(std::vector<std::string>& propertyNames)
+    {
+        return false;
+    }
+
 };
 }
 
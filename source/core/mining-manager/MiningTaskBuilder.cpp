@@ -1,4 +1,5 @@
 #include "MiningTaskBuilder.h"
+#include "MiningDocReader.h"
 #include <document-manager/DocumentManager.h>
 #include <glog/logging.h>
 #include <vector>
@@ -49,25 +50,32 @@ bool MiningTaskBuilder::buildCollection(int64_t timestamp)
     LOG(INFO) << "begin build Collection, from docid " << min_last_docid
               << " to " << MaxDocid;
 
-    for (uint32_t docid = min_last_docid; docid <= MaxDocid; ++docid)
-    {
-        Document doc;
-        if (docid % 10000 == 0)
-        {
-            std::cout << "\rinserting doc id: " << docid << "\t" << std::flush;
-        }
+    std::vector<std::string> propertyNames;
+    bool isAllProperties = !MiningDocReader::getPropertyNames(taskList_, taskFlag, propertyNames);
 
-        if (document_manager_->getDocument(docid, doc))
-        {
-            document_manager_->getRTypePropertiesForDocument(docid, doc);
-        }
+    MiningDocReader docReader(*document_manager_, isAllProperties, propertyNames,
+                              min_last_docid, MaxDocid);
+    docid_t batchDocid = 0;
+    std::vector<Document> docs;
 
-        for (size_t i = 0; i < taskList_.size(); ++i)
+    while (docReader.nextBatch(batchDocid, docs))
+    {
+        for (size_t j = 0; j < docs.size(); ++j)
         {
-            if (taskFlag[i])
+            uint32_t docid = batchDocid + j;
+            const Document& doc = docs[j];
+            if (docid % 10000 == 0)
+            {
+                std::cout << "\rinserting doc id: " << docid << "\t" << std::flush;
+            }
+
+            for (size_t i = 0; i < taskList_.size(); ++i)
             {
-                if (docid < taskList_[i]->getLastDocId()) continue;
-                taskList_[i]->buildDocument(docid, doc);
+                if (taskFlag[i])
+                {
+                    if (docid < taskList_[i]->getLastDocId()) continue;
+                    taskList_[i]->buildDocument(docid, doc);
+                }
             }
         }
     }
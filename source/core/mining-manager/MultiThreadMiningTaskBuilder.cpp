@@ -1,9 +1,11 @@
 #include "MultiThreadMiningTaskBuilder.h"
 #include "MiningTask.h"
+#include "MiningDocReader.h"
 #include <document-manager/DocumentManager.h>
 #include <glog/logging.h>
 #include <boost/thread/thread.hpp>
 #include <boost/bind.hpp>
+#include <algorithm>
 
 using namespace sf1r;
 
@@ -12,6 +14,7 @@ MultiThreadMiningTaskBuilder::MultiThreadMiningTaskBuilder(
     std::size_t threadNum)
     : documentManager_(documentManager)
     , threadNum_(threadNum)
+    , isAllProperties_(true)
 {
 }
 
@@ -63,12 +66,26 @@ bool MultiThreadMiningTaskBuilder::buildCollection(int64_t timestamp)
     LOG(INFO) << "start to build " << buildNum << " mining tasks in "
               << threadNum_ << " threads...";
 
+    isAllProperties_ = !MiningDocReader::getPropertyNames(
+        taskList_, taskFlag_, propertyNames_);
+
+    // each thread builds a contiguous docid range,
+    // so that the documents are read sequentially
+    const docid_t docNum = endDocId - startDocId + 1;
+    const std::size_t threadNum = std::max<std::size_t>(threadNum_, 1);
+    const docid_t rangeSize = (docNum + threadNum - 1) / threadNum;
+
     boost::thread_group threads;
-    for (std::size_t threadId = 0; threadId < threadNum_; ++threadId)
+    for (docid_t rangeStart = startDocId; rangeStart <= endDocId;
+         rangeStart += rangeSize)
     {
+        docid_t rangeEnd = std::min(endDocId, rangeStart + rangeSize - 1);
         threads.create_thread(
             boost::bind(&MultiThreadMiningTaskBuilder::buildDocs_, this,
-                        startDocId, endDocId, threadId));
+                        rangeStart, rangeEnd));
+
+        if (rangeEnd == endDocId)
+            break;
     }
     threads.join_all();
 
@@ -88,30 +105,31 @@ bool MultiThreadMiningTaskBuilder::buildCollection(int64_t timestamp)
 
 void MultiThreadMiningTaskBuilder::buildDocs_(
     docid_t startDocId,
-    docid_t endDocId,
-    std::size_t threadId)
+    docid_t endDocId)
 {
-    for (docid_t docId = startDocId; docId <= endDocId; ++docId)
-    {
-        if (docId % threadNum_ != threadId)
-            continue;
+    MiningDocReader docReader(*documentManager_, isAllProperties_,
+                              propertyNames_, startDocId, endDocId);
+    docid_t batchDocId = 0;
+    std::vector<Document> docs;
 
-        if (docId % 10000 == 0)
+    while (docReader.nextBatch(batchDocId, docs))
+    {
+        for (std::size_t j = 0; j < docs.size(); ++j)
         {
-            std::cout << "\rbuilding doc id: " << docId << "\t" << std::flush;
-        }
+            const docid_t docId = batchDocId + j;
+            const Document& doc = docs[j];
 
-        Document doc;
-        if (documentManager_->getDocument(docId, doc))
-        {
-            documentManager_->getRTypePropertiesForDocument(docId, doc);
-        }
+            if (docId % 10000 == 0)
+            {
+                std::cout << "\rbuilding doc id: " << docId << "\t" << std::flush;
+            }
 
-        for (std::size_t i = 0; i < taskList_.size(); ++i)
-        {
-            if (taskFlag_[i] && docId >= taskList_[i]->getLastDocId())
+            for (std::size_t i = 0; i < taskList_.size(); ++i)
             {
-                taskList_[i]->buildDocument(docId, doc);
+                if (taskFlag_[i] && docId >= taskList_[i]->getLastDocId())
+                {
+                    taskList_[i]->buildDocument(docId, doc);
+                }
             }
         }
     }
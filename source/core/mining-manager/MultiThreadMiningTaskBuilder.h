@@ -7,6 +7,7 @@
 #define SF1R_MULTI_THREAD_MINING_TASK_BUILDER_H
 
 #include <common/inttypes.h>
+#include <string>
 #include <vector>
 #include <boost/shared_ptr.hpp>
 
@@ -29,10 +30,12 @@ public:
     bool buildCollection(int64_t timestamp);
 
 private:
+    /**
+     * build the documents in [startDocId, endDocId].
+     */
     void buildDocs_(
         docid_t startDocId,
-        docid_t endDocId,
-        std::size_t threadId);
+        docid_t endDocId);
 
 private:
     boost::shared_ptr<DocumentManager> documentManager_;
@@ -42,6 +45,10 @@ private:
     std::vector<MiningTask*> taskList_;
 
     std::vector<bool> taskFlag_; // true for build, false for not build
+
+    /// the union of the properties needed by the tasks to build
+    bool isAllProperties_;
+    std::vector<std::string> propertyNames_;
 };
 
 } // namespace sf1r
@@ -51,6 +51,15 @@ bool AdMiningTask::buildDocument(docid_t docID, const Document& doc)
     return true;
 }
 
+bool AdMiningTask::getPropertyNames(std::vector<std::string>& propertyNames)
+{
+    propertyNames.push_back("DNF");
+    propertyNames.push_back("Width");
+    propertyNames.push_back("Height");
+    propertyNames.push_back("CreativeType");
+    return true;
+}
+
 bool AdMiningTask::preProcess(int64_t timestamp)
 {
     incrementalAdIndex_.reset(new AdDNFIndexType(*ad_dnf_index_));
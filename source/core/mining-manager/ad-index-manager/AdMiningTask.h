@@ -48,6 +48,8 @@ public:
         return startDocId_;
     }
 
+    bool getPropertyNames(std::vector<std::string>& propertyNames);
+
     void retrieve(
             const std::vector<std::pair<std::string, std::string> >& info,
             boost::unordered_set<uint32_t>& dnfIDs)
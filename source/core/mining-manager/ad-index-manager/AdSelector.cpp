@@ -44,10 +44,11 @@ static inline void getValueStrFromPropId(faceted::PropValueTable* pvt,
 
 
 AdSelector::AdSelector()
-    :history_ctr_data_(MAX_HISTORY_CTR_NUM/1024)
+    :history_ctr_table_(MAX_HISTORY_CTR_NUM/1024)
      , random_eng_(std::time(NULL))
      , random_gen_(random_eng_, DistributionT())
      , need_refresh_(true)
+     , need_compute_pending_(false)
      , ad_segid_str_data_(Lux::IO::NONCLUSTER)
 {
 }
@@ -434,6 +435,12 @@ void AdSelector::updateFunc()
                 boost::this_thread::interruption_point();
                 if (need_refresh_)
                     break;
+                // only the missing history ctr is computed.
+                if (need_compute_pending_)
+                {
+                    need_compute_pending_ = false;
+                    updatePendingHistoryCTRData();
+                }
                 nanosleep(&ts, NULL);
             }
         }
@@ -548,9 +555,12 @@ void AdSelector::computeHistoryCTR()
         std::string history_ctr_file = segments_data_path_ + "/history_ctr.txt";
         std::ofstream ofs_history(history_ctr_file.c_str());
 
+        std::vector<std::pair<SegIdT, double> > ad_segid_ctr_list;
         for (AllSegKeyListT::const_iterator user_it = all_fullkey[UserSeg].begin();
             user_it != all_fullkey[UserSeg].end(); ++user_it)
         {
+            const std::string& key = user_it->first;
+            ad_segid_ctr_list.clear();
             for (AllSegKeyListT::const_iterator ad_it = all_fullkey[AdSeg].begin();
                 ad_it != all_fullkey[AdSeg].end(); ++ad_it)
             {
@@ -562,18 +572,14 @@ void AdSelector::computeHistoryCTR()
                     //ad_seg_str = boost::lexical_cast<std::string>(segid);
                 }
                 double ctr_res = ad_click_predictor_->predict(user_it->second, ad_it->second);
-                const std::string& key = user_it->first;
-                if (segid >= history_ctr_data_[key].size())
-                {
-                    history_ctr_data_[key].resize(segid + 1);
-                }
-                history_ctr_data_[key][segid] = ctr_res;
+                ad_segid_ctr_list.push_back(std::make_pair(segid, ctr_res));
                 ofs_history << key << "-" << segid << " : " << ctr_res << std::endl;
             }
+            updateHistoryCTR(key, ad_segid_ctr_list);
         }
         ofs_history.flush();
     }
-    LOG(INFO) << "update history ctr finished. total : " << history_ctr_data_.size();
+    LOG(INFO) << "update history ctr finished. total : " << history_ctr_table_.size();
 }
 
 void AdSelector::updatePendingHistoryCTRData()
@@ -596,6 +602,7 @@ void AdSelector::updatePendingHistoryCTRData()
 
     std::vector<std::string> value_list;
     std::vector<std::string> ad_segstr_list;
+    std::vector<std::pair<SegIdT, double> > ad_segid_ctr_list;
     for(size_t i = 0; i < tmp_pending_list.size(); ++i)
     {
         const FeatureT& user_info = tmp_pending_list[i].first;
@@ -603,39 +610,44 @@ void AdSelector::updatePendingHistoryCTRData()
         std::vector<std::string> user_seg_str;
         getUserSegmentStr(user_seg_str, user_info);
 
+        // the ctr only depends on the ad segment, so it is the same
+        // for all user segments of this user.
+        ad_segid_ctr_list.clear();
         for (size_t j = 0; j < docid_list.size(); ++j)
         {
             docid_t docid = docid_list[j];
-            
+
             ad_segstr_list.clear();
             getAdSegmentStrList(docid, ad_segstr_list);
 
-            for (size_t l = 0; l < user_seg_str.size(); ++l)
+            for (size_t k = 0; k < ad_segstr_list.size(); ++k)
             {
-                for (size_t k = 0; k < ad_segstr_list.size(); ++k)
+                const std::string& ad_segstr = ad_segstr_list[k];
+                SegIdT segid = 0;
+                if(!ad_segid_mgr_->getDocIdByDocName(ad_segstr, segid, false))
                 {
-                    const std::string& ad_segstr = ad_segstr_list[k];
-                    const std::string& key = user_seg_str[l];
-                    SegIdT segid = 0;
-                    if(!ad_segid_mgr_->getDocIdByDocName(ad_segstr, segid, false))
-                    {
-                        LOG(INFO) << "ad segstr not found: " << ad_segstr;
-                        continue;
-                    }
-
-                    double result = ad_click_predictor_->predict(user_info, ad_features[ad_segstr]);
-                    if (segid >= history_ctr_data_[key].size())
-                    {
-                        history_ctr_data_[key].resize(segid + 1);
-                    }
-                    history_ctr_data_[key][segid] = result;
-                    ofs_history << key << "-" << segid << " : " << result << std::endl;
+                    LOG(INFO) << "ad segstr not found: " << ad_segstr;
+                    continue;
                 }
+
+                double result = ad_click_predictor_->predict(user_info, ad_features[ad_segstr]);
+                ad_segid_ctr_list.push_back(std::make_pair(segid, result));
+            }
+        }
+
+        for (size_t l = 0; l < user_seg_str.size(); ++l)
+        {
+            const std::string& key = user_seg_str[l];
+            updateHistoryCTR(key, ad_segid_ctr_list);
+            for (size_t k = 0; k < ad_segid_ctr_list.size(); ++k)
+            {
+                ofs_history << key << "-" << ad_segid_ctr_list[k].first << " : "
+                    << ad_segid_ctr_list[k].second << std::endl;
             }
         }
     }
     ofs_history.flush();
-    LOG(INFO) << "pending history ctr compute finished. " << history_ctr_data_.size();
+    LOG(INFO) << "pending history ctr compute finished. " << history_ctr_table_.size();
 }
 
 void AdSelector::updateSegments(const std::string& segment_name, const std::set<std::string>& segments, SegType type)
@@ -740,8 +752,35 @@ void AdSelector::getUserSegmentStr(std::vector<std::string>& user_seg_str_list,
     expandSegmentStr(user_seg_str_list, user_feature_list);
 }
 
-bool AdSelector::getHistoryCTR(const std::vector<std::string>& user_seg_key, 
-    const std::vector<SegIdT>& ad_segid_list, double& max_ctr)
+void AdSelector::updateHistoryCTR(const std::string& user_seg_str,
+    const std::vector<std::pair<SegIdT, double> >& ad_segid_ctr_list)
+{
+    boost::unique_lock<boost::shared_mutex> lock(history_ctr_mutex_);
+    std::pair<UserSegIdMapT::iterator, bool> inserted_it = user_segid_map_.insert(
+        std::make_pair(user_seg_str, static_cast<UserSegIdT>(user_segid_map_.size())));
+    UserSegIdT user_segid = inserted_it.first->second;
+
+    for (size_t i = 0; i < ad_segid_ctr_list.size(); ++i)
+    {
+        history_ctr_table_.insert(HistoryCTRTable::makeKey(user_segid, ad_segid_ctr_list[i].first),
+            ad_segid_ctr_list[i].second);
+    }
+}
+
+void AdSelector::getUserSegIdList(const std::vector<std::string>& user_seg_str,
+    std::vector<UserSegIdT>& user_segid_list) const
+{
+    user_segid_list.clear();
+    for (size_t i = 0; i < user_seg_str.size(); ++i)
+    {
+        UserSegIdMapT::const_iterator it = user_segid_map_.find(user_seg_str[i]);
+        if (it != user_segid_map_.end())
+            user_segid_list.push_back(it->second);
+    }
+}
+
+bool AdSelector::getHistoryCTR(const std::vector<UserSegIdT>& user_segid_list,
+    const std::vector<SegIdT>& ad_segid_list, double& max_ctr) const
 {
     max_ctr = 0;
     bool ret = false;
@@ -752,16 +791,14 @@ bool AdSelector::getHistoryCTR(const std::vector<std::string>& user_seg_key,
     else
     {
         // for multi feature values we just get the highest ctr.
-        for(size_t i = 0; i < user_seg_key.size(); ++i)
+        double ctr = 0;
+        for(size_t i = 0; i < user_segid_list.size(); ++i)
         {
-            HistoryCTRDataT::const_iterator it = history_ctr_data_.find(user_seg_key[i]);
-            if (it == history_ctr_data_.end())
-                continue;
             for(size_t j = 0; j < ad_segid_list.size(); ++j)
             {
-                if (ad_segid_list[j] >= it->second.size())
+                if (!history_ctr_table_.find(HistoryCTRTable::makeKey(user_segid_list[i], ad_segid_list[j]), ctr))
                     continue;
-                max_ctr = std::max(it->second[ad_segid_list[j]], max_ctr);
+                max_ctr = std::max(ctr, max_ctr);
                 ret = true;
             }
         }
@@ -870,6 +907,12 @@ bool AdSelector::select(const FeatureT& user_info,
 
     std::vector<docid_t> pending_compute_doclist;
 
+    // the user segments are looked up once for all ads,
+    // and the lock is held for the whole batch.
+    boost::shared_lock<boost::shared_mutex> ctr_lock(history_ctr_mutex_);
+    std::vector<UserSegIdT> user_segid_list;
+    getUserSegIdList(user_seg_str, user_segid_list);
+
     bool random_select = true;
     for(size_t i = 0; i < ad_doclist.size(); ++i)
     {
@@ -884,7 +927,7 @@ bool AdSelector::select(const FeatureT& user_info,
             {
                 //all_fullkey = user_seg_str;
                 //expandSegmentStr(all_fullkey, ad_segid_data_[docid]);
-                if(!getHistoryCTR(user_seg_str, ad_segid_data_[docid], score))
+                if(!getHistoryCTR(user_segid_list, ad_segid_data_[docid], score))
                 {
                     // history not found. pending to compute
                     // put it to unclicked this time to select by random.
@@ -898,7 +941,7 @@ bool AdSelector::select(const FeatureT& user_info,
         }
         else
         {
-            if(!random_select && getHistoryCTR(user_seg_str, ad_segid_data_[docid], score))
+            if(!random_select && getHistoryCTR(user_segid_list, ad_segid_data_[docid], score))
             {
                 ScoreDoc item(docid, score);
                 tmp_unclicked_scorelist.insert(item);
@@ -907,6 +950,7 @@ bool AdSelector::select(const FeatureT& user_info,
                 unclicked_doclist.push_back(docid);
         }
     }
+    ctr_lock.unlock();
 
     if (!pending_compute_doclist.empty())
     {
@@ -914,7 +958,7 @@ bool AdSelector::select(const FeatureT& user_info,
         LOG(INFO) << "pending compute doclist : " << pending_compute_doclist.size();
         pending_compute_doclist_.push_back(std::make_pair(user_info, std::vector<docid_t>()));
         pending_compute_doclist_.back().second.swap(pending_compute_doclist);
-        need_refresh_ = true;
+        need_compute_pending_ = true;
     }
 
     std::size_t scoresize = tmp_clicked_scorelist.size();
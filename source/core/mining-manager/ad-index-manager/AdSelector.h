@@ -2,6 +2,7 @@
 #define SF1_AD_SELECTOR_H_
 
 #include "AdClickPredictor.h"
+#include "HistoryCTRTable.h"
 #include <util/singleton.h>
 #include <boost/lexical_cast.hpp>
 #include <common/PropSharedLockSet.h>
@@ -45,6 +46,7 @@ public:
     typedef std::vector<std::pair<std::string, std::string> > FeatureT;
     typedef std::map<std::string, FeatureValueT > FeatureMapT;
     typedef uint16_t  SegIdT;
+    typedef uint32_t  UserSegIdT;
     AdSelector();
     ~AdSelector();
 
@@ -97,8 +99,16 @@ private:
     void selectByRandSelectPolicy(std::size_t max_unclicked_retnum, std::vector<docid_t>& unclicked_doclist);
     void computeHistoryCTR();
     //bool getHistoryCTR(const std::vector<std::string>& all_fullkey, double& max_ctr);
-    bool getHistoryCTR(const std::vector<std::string>& user_seg_key, 
-        const std::vector<SegIdT>& ad_segid_list, double& max_ctr);
+    // the caller should hold the lock of history_ctr_mutex_.
+    bool getHistoryCTR(const std::vector<UserSegIdT>& user_segid_list,
+        const std::vector<SegIdT>& ad_segid_list, double& max_ctr) const;
+    // the user segment not in history is ignored,
+    // the caller should hold the lock of history_ctr_mutex_.
+    void getUserSegIdList(const std::vector<std::string>& user_seg_str,
+        std::vector<UserSegIdT>& user_segid_list) const;
+    // set the history ctr of one user segment for a batch of ad segments.
+    void updateHistoryCTR(const std::string& user_seg_str,
+        const std::vector<std::pair<SegIdT, double> >& ad_segid_ctr_list);
 
     void expandSegmentStr(std::vector<std::string>& seg_str_list, const std::vector<SegIdT>& ad_segid_list);
     void expandSegmentStr(std::vector<std::string>& seg_str_list, const FeatureMapT& feature_list);
@@ -117,14 +127,18 @@ private:
             izenelib::ir::idmanager::UniqueIDGenerator<std::string, SegIdT, izenelib::util::ReadWriteLock>,
             izenelib::ir::idmanager::EmptyIDStorage<std::string, SegIdT> > AdSegIDManager;
 
-    typedef boost::unordered_map<std::string, std::vector<double> > HistoryCTRDataT;
+    typedef boost::unordered_map<std::string, UserSegIdT> UserSegIdMapT;
     faceted::GroupManager* groupManager_;
     DocumentManager* doc_mgr_;
     std::string res_path_;
     std::string segments_data_path_;
     std::string rec_data_path_;
     AdClickPredictor* ad_click_predictor_;
-    HistoryCTRDataT history_ctr_data_;
+    // the user segment string --> user segment id, interned while
+    // computing history ctr.
+    UserSegIdMapT user_segid_map_;
+    HistoryCTRTable history_ctr_table_;
+    boost::shared_mutex history_ctr_mutex_;
     std::vector<std::pair<FeatureT, std::vector<docid_t> > >  pending_compute_doclist_;
     boost::mutex pending_list_lock_;
 
@@ -140,6 +154,7 @@ private:
     EngineT random_eng_;
     boost::random::variate_generator<EngineT&, DistributionT>  random_gen_;
     bool need_refresh_;
+    bool need_compute_pending_;
     // store the multi segment ids for each ad document
     std::vector< std::vector<SegIdT> >  ad_segid_data_;
     // the segment string --> segment id relationship
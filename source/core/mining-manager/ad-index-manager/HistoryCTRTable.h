@@ -0,0 +1,133 @@
+#ifndef SF1_HISTORY_CTR_TABLE_H_
+#define SF1_HISTORY_CTR_TABLE_H_
+
+#include <boost/cstdint.hpp>
+#include <vector>
+#include <algorithm> // swap
+
+namespace sf1r
+{
+
+// The history ctr of each (user segment id, ad segment id) pair.
+// The two ids are combined into one integer key, and stored in an
+// open-addressing table with linear probing, so that the lookup
+// does not allocate memory and mostly touches one cache line.
+class HistoryCTRTable
+{
+public:
+    typedef uint64_t KeyT;
+
+    explicit HistoryCTRTable(std::size_t capacity = 1024)
+        : size_(0)
+    {
+        std::size_t slot_num = MIN_SLOT_NUM;
+        while (slot_num < capacity * 2)
+            slot_num <<= 1;
+        slots_.resize(slot_num);
+    }
+
+    static KeyT makeKey(uint32_t user_segid, uint32_t ad_segid)
+    {
+        return (static_cast<KeyT>(user_segid) << 32) | ad_segid;
+    }
+
+    bool find(KeyT key, double& ctr) const
+    {
+        const std::size_t mask = slots_.size() - 1;
+        for (std::size_t pos = hash(key) & mask; ; pos = (pos + 1) & mask)
+        {
+            const Slot& slot = slots_[pos];
+            if (slot.key == key)
+            {
+                ctr = slot.ctr;
+                return true;
+            }
+            if (slot.key == EMPTY_KEY)
+                return false;
+        }
+    }
+
+    // overwrite the ctr if the key exists.
+    void insert(KeyT key, double ctr)
+    {
+        if ((size_ + 1) * 2 > slots_.size())
+            rehash(slots_.size() * 2);
+
+        if (insertSlot(slots_, key, ctr))
+            ++size_;
+    }
+
+    void swap(HistoryCTRTable& other)
+    {
+        slots_.swap(other.slots_);
+        std::swap(size_, other.size_);
+    }
+
+    std::size_t size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+private:
+    static const KeyT EMPTY_KEY = ~static_cast<KeyT>(0);
+    static const std::size_t MIN_SLOT_NUM = 16;
+
+    struct Slot
+    {
+        KeyT key;
+        double ctr;
+
+        Slot() : key(EMPTY_KEY), ctr(0) {}
+    };
+
+    // the finalizer of MurmurHash3, the low bits of the key would
+    // be clustered for the consecutive segment ids.
+    static std::size_t hash(KeyT key)
+    {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        key *= 0xc4ceb9fe1a85ec53ULL;
+        key ^= key >> 33;
+        return static_cast<std::size_t>(key);
+    }
+
+    // @return true if the key is new.
+    static bool insertSlot(std::vector<Slot>& slots, KeyT key, double ctr)
+    {
+        const std::size_t mask = slots.size() - 1;
+        for (std::size_t pos = hash(key) & mask; ; pos = (pos + 1) & mask)
+        {
+            Slot& slot = slots[pos];
+            if (slot.key == key)
+            {
+                slot.ctr = ctr;
+                return false;
+            }
+            if (slot.key == EMPTY_KEY)
+            {
+                slot.key = key;
+                slot.ctr = ctr;
+                return true;
+            }
+        }
+    }
+
+    void rehash(std::size_t slot_num)
+    {
+        std::vector<Slot> new_slots(slot_num);
+        for (std::size_t i = 0; i < slots_.size(); ++i)
+        {
+            if (slots_[i].key != EMPTY_KEY)
+                insertSlot(new_slots, slots_[i].key, slots_[i].ctr);
+        }
+        slots_.swap(new_slots);
+    }
+
+private:
+    std::vector<Slot> slots_;
+    std::size_t size_;
+};
+
+} //namespace sf1r
+
+#endif
@@ -35,6 +35,12 @@ docid_t AttrMiningTask::getLastDocId()
     return swapper_.reader.docIdNum();
 }
 
+bool AttrMiningTask::getPropertyNames(std::vector<std::string>& propertyNames)
+{
+    propertyNames.push_back(propName_);
+    return true;
+}
+
 bool AttrMiningTask::postProcess()
 {
     if (!swapper_.writer.flush())
@@ -32,6 +32,8 @@ public:
     bool buildDocument(docid_t docID, const Document& doc);
     docid_t getLastDocId();
 
+    bool getPropertyNames(std::vector<std::string>& propertyNames);
+
 private:
     sf1r::DocumentManager& documentManager_;
     const std::string propName_;
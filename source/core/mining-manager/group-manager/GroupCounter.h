@@ -22,6 +22,18 @@ public:
 
     virtual void addDoc(docid_t doc) = 0;
 
+    /**
+     * add a block of docs, it has the same result as calling @c addDoc()
+     * for each doc in @p docs.
+     */
+    virtual void addDocs(const docid_t* docs, std::size_t num)
+    {
+        for (std::size_t i = 0; i < num; ++i)
+        {
+            addDoc(docs[i]);
+        }
+    }
+
     virtual void getGroupRep(GroupRep& groupRep) = 0;
 
     virtual void getStringRep(GroupRep::StringGroupRep& strRep, int level) {}
@@ -16,12 +16,19 @@
 
 #include <glog/logging.h>
 
+namespace
+{
+/** the number of docs in a block to count in batch */
+const std::size_t kDocBlockSize = 256;
+}
+
 NS_FACETED_BEGIN
 
 GroupFilter::GroupFilter(const GroupParam& groupParam)
     : groupParam_(groupParam)
     , attrCounter_(NULL)
 {
+    docBlock_.reserve(kDocBlockSize);
 }
 
 GroupFilter::~GroupFilter()
@@ -103,6 +110,7 @@ bool GroupFilter::initGroup(
         }
     }
 
+    labelDocBlocks_.resize(groupLabels_.size());
     return true;
 }
 
@@ -181,10 +189,9 @@ bool GroupFilter::test(docid_t doc)
 
     if (result)
     {
-        for (std::vector<GroupCounter*>::iterator it = groupCounters_.begin();
-            it != groupCounters_.end(); ++it)
+        if (!groupCounters_.empty())
         {
-            (*it)->addDoc(doc);
+            addToBlock_(docBlock_, NULL, doc);
         }
 
         if (attrCounter_)
@@ -209,7 +216,7 @@ bool GroupFilter::test(docid_t doc)
             GroupCounter* counter = groupLabels_[failIndex]->getCounter();
             if (counter)
             {
-                counter->addDoc(doc);
+                addToBlock_(labelDocBlocks_[failIndex], counter, doc);
             }
         }
     }
@@ -224,6 +231,8 @@ void GroupFilter::getGroupRep(
 {
     izenelib::util::ClockTimer timer;
 
+    flushAllBlocks_();
+
     for (std::vector<GroupCounter*>::iterator it = groupCounters_.begin();
         it != groupCounters_.end(); ++it)
     {
@@ -249,4 +258,46 @@ void GroupFilter::getGroupRep(
     LOG(INFO) << "GroupFilter::getGroupRep() costs " << timer.elapsed() << " seconds";
 }
 
+void GroupFilter::addToBlock_(DocBlock& block, GroupCounter* counter, docid_t doc)
+{
+    block.push_back(doc);
+
+    if (block.size() >= kDocBlockSize)
+    {
+        flushBlock_(block, counter);
+    }
+}
+
+void GroupFilter::flushBlock_(DocBlock& block, GroupCounter* counter)
+{
+    if (block.empty())
+        return;
+
+    if (counter)
+    {
+        counter->addDocs(&block[0], block.size());
+    }
+    else
+    {
+        // NULL counter means all group counters
+        for (std::vector<GroupCounter*>::iterator it = groupCounters_.begin();
+            it != groupCounters_.end(); ++it)
+        {
+            (*it)->addDocs(&block[0], block.size());
+        }
+    }
+
+    block.clear();
+}
+
+void GroupFilter::flushAllBlocks_()
+{
+    flushBlock_(docBlock_, NULL);
+
+    for (std::size_t i = 0; i < labelDocBlocks_.size(); ++i)
+    {
+        flushBlock_(labelDocBlocks_[i], groupLabels_[i]->getCounter());
+    }
+}
+
 NS_FACETED_END
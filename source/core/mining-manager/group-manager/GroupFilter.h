@@ -9,6 +9,7 @@
 #define SF1R_GROUP_FILTER_H
 
 #include "faceted_types.h"
+#include <vector>
 
 namespace sf1r { class PropSharedLockSet; }
 
@@ -59,6 +60,9 @@ public:
     /**
      * Get doc counts for property values and attribute values,
      * it counts the param @p doc in previous calls of @c test().
+     * The docs are buffered in blocks in @c test(), and counted by
+     * @c GroupCounter in batch when a block is full, the remaining docs
+     * are counted here.
      * @param groupRep doc counts for property values
      * @param attrRep doc counts for attribute values
      */
@@ -67,6 +71,15 @@ public:
         OntologyRep& attrRep
     );
 
+private:
+    typedef std::vector<docid_t> DocBlock;
+
+    void addToBlock_(DocBlock& block, GroupCounter* counter, docid_t doc);
+
+    void flushBlock_(DocBlock& block, GroupCounter* counter);
+
+    void flushAllBlocks_();
+
 private:
     const GroupParam& groupParam_;
 
@@ -81,6 +94,15 @@ private:
 
     /** attr counter instance */
     AttrCounter* attrCounter_;
+
+    /** the docs belonging to all labels, to count by @c groupCounters_ */
+    DocBlock docBlock_;
+
+    /**
+     * each block contains the docs which only fail in the label of the
+     * same index in @c groupLabels_, to count by the counter of that label
+     */
+    std::vector<DocBlock> labelDocBlocks_;
 };
 
 NS_FACETED_END
@@ -103,6 +103,12 @@ public:
         return startDocId_;
     }
 
+    bool getPropertyNames(std::vector<std::string>& propertyNames)
+    {
+        propertyNames.push_back(propName_);
+        return true;
+    }
+
 private:
     bool isRebuildProp_(const std::string& propName) const
     {
@@ -35,6 +35,15 @@ struct PropIdTable
     void getIdList(docid_t docId, PropIdList& propIdList) const;
     size_t getIdCount(docid_t docId) const;
 
+    /// for each doc in @p docIds, increase the count of each of its value ids
+    /// in @p countTable, which is indexed by value id.
+    /// @return the number of docs which have any value id
+    template <typename CounterType>
+    std::size_t countIdList(
+        const docid_t* docIds,
+        std::size_t docNum,
+        CounterType* countTable) const;
+
     template <class IdContainer>
     void setIdList(docid_t docId, const IdContainer& idContainer);
 
@@ -54,7 +63,27 @@ struct PropIdTable
     /// the mask to get the following bits for index type
     static const index_t INDEX_MASK = ~INDEX_MSB;
 
+    /// in @c countIdList(), the doc ahead by this distance has its
+    /// @c indexTable_ entry prefetched
+    static const std::size_t INDEX_PREFETCH_DISTANCE = 16;
+
+    /// in @c countIdList(), the doc ahead by this distance has its
+    /// count entry prefetched
+    static const std::size_t COUNT_PREFETCH_DISTANCE = 8;
+
 private:
+    template <typename CounterType>
+    std::size_t countSingleIdList_(
+        const docid_t* docIds,
+        std::size_t docNum,
+        CounterType* countTable) const;
+
+    template <typename CounterType>
+    std::size_t countMultiIdList_(
+        const docid_t* docIds,
+        std::size_t docNum,
+        CounterType* countTable) const;
+
     /// @see the requirement on parameter type size by #indexTable_
     BOOST_STATIC_ASSERT(sizeof(valueid_t) <= sizeof(index_t));
 };
@@ -172,6 +201,114 @@ size_t PropIdTable<valueid_t, index_t>::getIdCount(docid_t docId) const
     }
 }
 
+template <typename valueid_t, typename index_t>
+template <typename CounterType>
+std::size_t PropIdTable<valueid_t, index_t>::countIdList(
+    const docid_t* docIds,
+    std::size_t docNum,
+    CounterType* countTable) const
+{
+    if (multiValueTable_.empty())
+        return countSingleIdList_(docIds, docNum, countTable);
+
+    return countMultiIdList_(docIds, docNum, countTable);
+}
+
+template <typename valueid_t, typename index_t>
+template <typename CounterType>
+std::size_t PropIdTable<valueid_t, index_t>::countSingleIdList_(
+    const docid_t* docIds,
+    std::size_t docNum,
+    CounterType* countTable) const
+{
+    const index_t* indexTable = &indexTable_[0];
+    const std::size_t tableSize = indexTable_.size();
+    std::size_t emptyNum = 0;
+
+    for (std::size_t i = 0; i < docNum; ++i)
+    {
+        if (i + INDEX_PREFETCH_DISTANCE < docNum)
+        {
+            const docid_t aheadId = docIds[i + INDEX_PREFETCH_DISTANCE];
+            if (aheadId < tableSize)
+                __builtin_prefetch(indexTable + aheadId);
+        }
+
+        if (i + COUNT_PREFETCH_DISTANCE < docNum)
+        {
+            const docid_t aheadId = docIds[i + COUNT_PREFETCH_DISTANCE];
+            if (aheadId < tableSize)
+                __builtin_prefetch(countTable + indexTable[aheadId], 1);
+        }
+
+        // no branch on the value id, the doc without value is counted in
+        // id 0, which is subtracted after the loop
+        const docid_t docId = docIds[i];
+        const index_t index = docId < tableSize ? indexTable[docId] : 0;
+
+        ++countTable[index];
+        emptyNum += (index == 0);
+    }
+
+    countTable[0] -= emptyNum;
+    return docNum - emptyNum;
+}
+
+template <typename valueid_t, typename index_t>
+template <typename CounterType>
+std::size_t PropIdTable<valueid_t, index_t>::countMultiIdList_(
+    const docid_t* docIds,
+    std::size_t docNum,
+    CounterType* countTable) const
+{
+    const index_t* indexTable = &indexTable_[0];
+    const valueid_t* multiValueTable = &multiValueTable_[0];
+    const std::size_t tableSize = indexTable_.size();
+    std::size_t valueDocNum = 0;
+
+    for (std::size_t i = 0; i < docNum; ++i)
+    {
+        if (i + INDEX_PREFETCH_DISTANCE < docNum)
+        {
+            const docid_t aheadId = docIds[i + INDEX_PREFETCH_DISTANCE];
+            if (aheadId < tableSize)
+                __builtin_prefetch(indexTable + aheadId);
+        }
+
+        if (i + COUNT_PREFETCH_DISTANCE < docNum)
+        {
+            const docid_t aheadId = docIds[i + COUNT_PREFETCH_DISTANCE];
+            if (aheadId < tableSize && (indexTable[aheadId] & INDEX_MSB))
+                __builtin_prefetch(multiValueTable + (indexTable[aheadId] & INDEX_MASK));
+        }
+
+        const docid_t docId = docIds[i];
+        if (docId >= tableSize)
+            continue;
+
+        const index_t index = indexTable[docId];
+
+        if (index & INDEX_MSB)
+        {
+            const valueid_t* ids = multiValueTable + (index & INDEX_MASK);
+            const valueid_t idNum = *ids++;
+
+            for (valueid_t j = 0; j < idNum; ++j)
+            {
+                ++countTable[ids[j]];
+            }
+            ++valueDocNum;
+        }
+        else if (index)
+        {
+            ++countTable[index];
+            ++valueDocNum;
+        }
+    }
+
+    return valueDocNum;
+}
+
 template <typename valueid_t, typename index_t>
 template <class IdContainer>
 void PropIdTable<valueid_t, index_t>::setIdList(docid_t docId, const IdContainer& idContainer)
@@ -127,6 +127,20 @@ public:
         valueIdTable_.getIdList(docId, propIdList);
     }
 
+    /**
+     * For each doc in @p docIds, increase the count of its value ids.
+     * @param countTable mapping from value id to doc count
+     * @return the number of docs which have any value id
+     */
+    template <typename CounterType>
+    std::size_t countPropIdList(
+        const docid_t* docIds,
+        std::size_t docNum,
+        CounterType* countTable) const
+    {
+        return valueIdTable_.countIdList(docIds, docNum, countTable);
+    }
+
     const ChildMapTable& childMapTable() const { return childMapTable_; }
 
     const ParentIdTable& parentIdTable() const { return parentIdVec_; }
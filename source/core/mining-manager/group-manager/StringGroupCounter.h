@@ -28,6 +28,7 @@ public:
 
     virtual StringGroupCounter* clone() const;
     virtual void addDoc(docid_t doc);
+    virtual void addDocs(const docid_t* docs, std::size_t num);
     virtual void getGroupRep(GroupRep& groupRep);
     virtual void getStringRep(GroupRep::StringGroupRep& strRep, int level);
 
@@ -126,6 +127,25 @@ void StringGroupCounter<SubGroupCounter>::addDoc(docid_t doc)
     ++countTable_[0].count_;
 }
 
+template<typename CounterType>
+void StringGroupCounter<CounterType>::addDocs(const docid_t* docs, std::size_t num)
+{
+    if (countTable_.empty())
+        return;
+
+    // total doc count for this property
+    countTable_[0] += propValueTable_.countPropIdList(docs, num, &countTable_[0]);
+}
+
+template<>
+void StringGroupCounter<SubGroupCounter>::addDocs(const docid_t* docs, std::size_t num)
+{
+    for (std::size_t i = 0; i < num; ++i)
+    {
+        addDoc(docs[i]);
+    }
+}
+
 template<typename CounterType>
 void StringGroupCounter<CounterType>::appendGroupRep(
     const PropValueTable::ChildMapTable& childMapTable,
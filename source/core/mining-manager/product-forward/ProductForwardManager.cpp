@@ -84,8 +84,10 @@ bool ProductForwardManager::load()
     }
     if (tmp_index.size() != lastDocid_ + 1)
         return false;
+    PackedFeaturesPtr packed = packFeatures_(tmp_index);
     WriteLock lockK(mutex_);
     tmp_index.swap(forward_index_);
+    packed_features_ = packed;
 
     return true;
 }
@@ -95,6 +97,7 @@ void ProductForwardManager::clear()
     {
         WriteLock lock(mutex_);
         std::vector<std::string>().swap(forward_index_);
+        packed_features_.reset();
     }
     std::string documentScorePath = dirPath_ + "/forward.dict";
     std::string documentNumPath = dirPath_ + "/forward.size";
@@ -120,8 +123,10 @@ void ProductForwardManager::resize(unsigned int size)
 
 bool ProductForwardManager::insert(std::vector<std::string>& index)
 {
+    PackedFeaturesPtr packed = packFeatures_(index);
     WriteLock lock(mutex_);
     forward_index_.swap(index);
+    packed_features_ = packed;
     LOG(INFO)<<"old index size = "<<index.size()<<" new = "<<forward_index_.size();
     return true;
 }
@@ -155,18 +160,33 @@ void ProductForwardManager::forwardSearch(const std::string& src,
     //res = docs;return;
     if (docs.empty() || src.empty())
         return ;
+
+    PackedFeaturesPtr packed;
+    docid_t lastDocid = 0;
+    {
+        ReadLock lock(mutex_);
+        packed = packed_features_;
+        lastDocid = lastDocid_;
+    }
+    if (!packed)
+        return;
+
     std::vector<std::pair<double, docid_t> > score;
     score.reserve(docs.size());
 
     std::vector<uint32_t > q_res;
     uint32_t q_brand, q_model;
     featureParser_.getFeatureIds(src, q_brand, q_model, q_res);
-    double q_score = 0;
-    for (size_t i = 0; i < q_res.size(); ++i)
-        q_score += (i+1)*(i+1);
+
+    std::vector<uint32_t> q_set(q_res);
+    if(q_brand>0)q_set.push_back(q_brand);
+    if(q_model>0)q_set.push_back(q_model);
+    std::sort(q_set.begin(), q_set.end());
+    q_set.erase(std::unique(q_set.begin(), q_set.end()), q_set.end());
+
     for (size_t i = 0; i < docs.size(); ++i)
     {
-        double sc = ProductForwardManager::compare_(q_brand, q_model, q_res, q_score, docs[i].second);
+        double sc = compare_(*packed, q_set, lastDocid, docs[i].second);
         score.push_back(std::make_pair(sc, docs[i].second));
     }
     for (size_t i = 0; i < score.size(); ++i)
@@ -177,29 +197,94 @@ void ProductForwardManager::forwardSearch(const std::string& src,
     //if (res.size() == 0)res = docs;
 }
 
-double ProductForwardManager::compare_(const uint32_t q_brand, const uint32_t q_model, 
-  const std::vector<uint32_t>& q_res, const double q_score, const docid_t docid)
+ProductForwardManager::PackedFeaturesPtr ProductForwardManager::packFeatures_(
+  const std::vector<std::string>& index)
 {
-    std::string title_string(getIndex(docid));
+    boost::shared_ptr<PackedFeatures> packed(new PackedFeatures);
+    const std::size_t docNum = index.size();
+    packed->brands.resize(docNum);
+    packed->models.resize(docNum);
+    packed->offsets.reserve(docNum + 1);
+    packed->offsets.push_back(0);
+
     std::vector<uint32_t> t_res;
+    for (std::size_t i = 0; i < docNum; ++i)
+    {
+        uint32_t t_brand = 0;
+        uint32_t t_model = 0;
+        t_res.clear();
+        featureParser_.convertStrToIds(index[i], t_brand, t_model, t_res);
+
+        if (t_model == t_brand)
+            t_model = 0;
+
+        std::sort(t_res.begin(), t_res.end());
+        t_res.erase(std::unique(t_res.begin(), t_res.end()), t_res.end());
+        if (t_brand > 0)
+            t_res.erase(std::remove(t_res.begin(), t_res.end(), t_brand), t_res.end());
+        if (t_model > 0)
+            t_res.erase(std::remove(t_res.begin(), t_res.end(), t_model), t_res.end());
+
+        packed->brands[i] = t_brand;
+        packed->models[i] = t_model;
+        packed->features.insert(packed->features.end(), t_res.begin(), t_res.end());
+        packed->offsets.push_back(packed->features.size());
+    }
+
+    LOG(INFO) << "packed features of " << docNum << " docs, feature num: "
+              << packed->features.size();
+    return packed;
+}
+
+double ProductForwardManager::compare_(const PackedFeatures& packed,
+  const std::vector<uint32_t>& q_set, const docid_t lastDocid, const docid_t docid) const
+{
+    std::vector<uint32_t>::const_iterator t_it = packed.features.begin();
+    std::vector<uint32_t>::const_iterator t_end = t_it;
     uint32_t t_brand = 0;
     uint32_t t_model = 0;
-    featureParser_.convertStrToIds(title_string, t_brand, t_model, t_res);
 
-    std::set<uint32_t> qset(q_res.begin(), q_res.end());
-    if(q_brand>0)qset.insert(q_brand);
-    if(q_model>0)qset.insert(q_model);
-
-    std::set<uint32_t> tset(t_res.begin(), t_res.end());
-    if(t_brand>0)tset.insert(t_brand);
-    if(t_model>0)tset.insert(t_model);
+    if (docid < lastDocid && docid < packed.docNum())
+    {
+        t_it += packed.offsets[docid];
+        t_end += packed.offsets[docid + 1];
+        t_brand = packed.brands[docid];
+        t_model = packed.models[docid];
+    }
 
+    std::size_t t_size = t_end - t_it;
     double common = 0;
-    for (std::set<uint32_t>::iterator it=qset.begin();it!=qset.end();it++)
-        if (tset.find(*it)!=tset.end())
+
+    // merge intersection of the two sorted arrays
+    std::vector<uint32_t>::const_iterator q_it = q_set.begin();
+    while (q_it != q_set.end() && t_it != t_end)
+    {
+        if (*q_it < *t_it)
+            ++q_it;
+        else if (*t_it < *q_it)
+            ++t_it;
+        else
+        {
             common++;
+            ++q_it;
+            ++t_it;
+        }
+    }
+
+    if (t_brand > 0)
+    {
+        ++t_size;
+        if (std::binary_search(q_set.begin(), q_set.end(), t_brand))
+            common++;
+    }
+    if (t_model > 0)
+    {
+        ++t_size;
+        if (std::binary_search(q_set.begin(), q_set.end(), t_model))
+            common++;
+    }
 
-    return common/(qset.size()+tset.size()-common);
+    return common/(q_set.size()+t_size-common);
 }
 /*
 double ProductForwardManager::compare_(const uint32_t q_brand, const uint32_t q_model, 
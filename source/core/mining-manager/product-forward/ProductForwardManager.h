@@ -9,6 +9,7 @@
 #include "ProductFeatureParser.h"
 #include <common/inttypes.h>
 #include <common/type_defs.h>
+#include <boost/shared_ptr.hpp>
 #include <string>
 #include <vector>
 
@@ -40,7 +41,32 @@ public:
     void forwardSearch(const std::string& src, const std::vector<std::pair<double, docid_t> >& docs, std::vector<std::pair<double, docid_t> >& res);
 
 private:
-    double compare_(const uint32_t q_brand, const uint32_t q_model, const std::vector<uint32_t>& q_res, const double q_score, const docid_t docid);
+    /**
+     * the features parsed from forward_index_, stored in columns.
+     * the feature ids of doc i are features[offsets[i], offsets[i+1]),
+     * they are sorted and unique, and never equal to its brand or model id.
+     * the model id is zero if it equals to the brand id.
+     */
+    struct PackedFeatures
+    {
+        std::vector<uint32_t> brands;
+        std::vector<uint32_t> models;
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> features;
+
+        std::size_t docNum() const { return brands.size(); }
+    };
+
+    typedef boost::shared_ptr<const PackedFeatures> PackedFeaturesPtr;
+
+    PackedFeaturesPtr packFeatures_(const std::vector<std::string>& index);
+
+    /**
+     * @param q_set the sorted and unique ids of query features, brand and model
+     * @return the jaccard similarity between @p q_set and the features of @p docid
+     */
+    double compare_(const PackedFeatures& packed, const std::vector<uint32_t>& q_set,
+                    const docid_t lastDocid, const docid_t docid) const;
     static bool cmp_(const std::pair<double, docid_t>& x, const std::pair<double, docid_t>& y);
 
     const std::string dirPath_;
@@ -49,6 +75,8 @@ private:
 
     std::vector<std::string> forward_index_;
 
+    PackedFeaturesPtr packed_features_;
+
     docid_t lastDocid_;
 
     bool isDebug_;
@@ -60,6 +88,8 @@ private:
     typedef boost::unique_lock<MutexType> WriteLock;
 
     mutable MutexType mutex_;
+
+    friend class ProductForwardManagerTest;
 };
 
 } // namespace sf1r
@@ -46,6 +46,12 @@ docid_t ProductForwardMiningTask::getLastDocId()
     return forward_index_->getLastDocId() + 1;
 }
 
+bool ProductForwardMiningTask::getPropertyNames(std::vector<std::string>& propertyNames)
+{
+    propertyNames.push_back("Title");
+    return true;
+}
+
 bool ProductForwardMiningTask::preProcess(int64_t timestamp)
 {
     if (forward_index_->getLastDocId() == 0)
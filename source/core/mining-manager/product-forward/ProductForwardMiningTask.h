@@ -28,6 +28,8 @@ public:
 
     docid_t getLastDocId();
 
+    bool getPropertyNames(std::vector<std::string>& propertyNames);
+
 private:
     boost::shared_ptr<DocumentManager> document_manager_;
 
@@ -355,6 +355,7 @@ void CorrectionEngine::buildEngine(const std::string& path)
         }
     }
     
+    prefix_->buildIndex();
     filter_->buildFilter(path + "/filter/");
     udef_->build(path + "/user-define/");
     timestamp_ = time(NULL);
@@ -3,6 +3,7 @@
 #include <fstream>
 #include <boost/filesystem.hpp>
 #include <limits>
+#include <algorithm>
 #include <util/ustring/UString.h>
 
 namespace sf1r
@@ -11,10 +12,65 @@ namespace Recommend
 {
 
 static std::string uuid = "PrefixTable";
+static std::string indexUuid = "PrefixTable.index";
+static const uint32_t INDEX_MAGIC = 0x50544931; // "PTI1"
 std::size_t PrefixTable::PREFIX_SIZE = 2;
 
+namespace
+{
+const uint32_t FNV_OFFSET = 2166136261U;
+const uint32_t FNV_PRIME = 16777619U;
+
+inline uint32_t hashChar(uint32_t h, uint32_t c)
+{
+    h = (h ^ (c & 0xff)) * FNV_PRIME;
+    h = (h ^ (c >> 8)) * FNV_PRIME;
+    return h;
+}
+
+// the FNV-1a hash of the string, skipping the character at @p skip
+uint32_t hashUString(const izenelib::util::UString& ustr, std::size_t skip)
+{
+    uint32_t h = FNV_OFFSET;
+    for (std::size_t i = 0; i < ustr.length(); i++)
+    {
+        if (i != skip)
+            h = hashChar(h, ustr[i]);
+    }
+    return h;
+}
+
+// same as StringUtil::editDistance(a, b) <= 1, without the DP matrix
+bool isEditDistanceWithinOne(const izenelib::util::UString& a, const izenelib::util::UString& b)
+{
+    if (a.length() > b.length())
+        return isEditDistanceWithinOne(b, a);
+
+    const std::size_t m = a.length();
+    const std::size_t n = b.length();
+    if (n - m > 1)
+        return false;
+
+    std::size_t i = 0;
+    while (i < m && a[i] == b[i])
+        i++;
+    if (i == m)
+        return true;
+
+    // substitution if the same length, otherwise insertion into a
+    const std::size_t shift = n - m;
+    for (std::size_t j = i + 1 - shift; j < m; j++)
+    {
+        if (a[j] != b[j + shift])
+            return false;
+    }
+    return true;
+}
+}
+
 PrefixTable::PrefixTable(const std::string& workdir)
-    : workdir_(workdir)
+    : isIndexValid_(true)
+    , workdir_(workdir)
 {
     std::string path = workdir_;
     path += "/";
@@ -26,6 +82,9 @@ PrefixTable::PrefixTable(const std::string& workdir)
     in.open(path.c_str(), std::ifstream::in);
     in>>*this;
     //std::cout<<"PrefixTable::"<<table_.size()<<"\n";
+
+    if (!loadIndex_())
+        buildIndex();
 }
 
 PrefixTable::~PrefixTable()
@@ -102,36 +161,25 @@ void PrefixTable::insert(const std::string& userQuery, uint32_t freq)
     std::string prefix;
     uPrefix.convertString(prefix, izenelib::util::UString::UTF_8);
     
-    UserQuery uq(userQuery, freq);
-    boost::unordered_map<std::string, LeveledUQL>::iterator it = table_.find(prefix);
-    if (table_.end() == it) // new item
-    {
-        LeveledUQL luqList(size + 1);
-        luqList[size].push_back(uq);
-        table_.insert(make_pair(prefix, luqList));
-        return;
-    }
-    
-    LeveledUQL& luqList = it->second;
-    if (size >= luqList.size()) // new size level
-    {
-        luqList.resize(size + 1);
-        luqList[size].push_back(uq);
-    }
-    else
+    LeveledQueryIds& lqIds = table_[prefix];
+    if (size >= lqIds.size()) // new size level
+        lqIds.resize(size + 1);
+
+    QueryIdList& qIds = lqIds[size];
+    QueryIdList::iterator it = qIds.begin();
+    for (; it != qIds.end(); it++)
     {
-        UserQueryList& uqList = luqList[size];
-        UserQueryList::iterator it = uqList.begin();
-        for (; it != uqList.end(); it++)
+        UserQuery& uq = queries_[*it];
+        if (uq.userQuery() == userQuery)
         {
-            if (it->userQuery() == uq.userQuery())
-                break;
+            uq.setFreq(uq.freq() + freq);
+            return;
         }
-        if (it != uqList.end())
-            it->setFreq(it->freq() + freq);
-        else
-            luqList[size].push_back(uq);
     }
+
+    qIds.push_back(queries_.size());
+    queries_.push_back(UserQuery(userQuery, freq));
+    isIndexValid_ = false;
 }
 
 void PrefixTable::search(const std::string& userQuery, UserQueryList& results) const
@@ -142,58 +190,225 @@ void PrefixTable::search(const std::string& userQuery, UserQueryList& results) c
     izenelib::util::UString uPrefix;
     PrefixTable::prefix(ustr,uPrefix);
     size -= uPrefix.length();
+
+    if (isIndexValid_)
+    {
+        searchByIndex_(ustr, uPrefix, size, results);
+        return;
+    }
+
     std::string prefix;
     uPrefix.convertString(prefix, izenelib::util::UString::UTF_8);
-    
-    boost::unordered_map<std::string, LeveledUQL>::const_iterator it = table_.find(prefix);
+    searchByScan_(ustr, prefix, size, results);
+}
+
+void PrefixTable::searchByScan_(const izenelib::util::UString& ustr,
+    const std::string& prefix,
+    std::size_t size,
+    UserQueryList& results) const
+{
+    boost::unordered_map<std::string, LeveledQueryIds>::const_iterator it = table_.find(prefix);
     if (table_.end() == it)
         return;
-    const LeveledUQL& luqList = it->second;
-    const std::size_t lsize = luqList.size();
-    if (luqList.empty() || ((size > 0) && (lsize < size - 1)))
+    const LeveledQueryIds& lqIds = it->second;
+    const std::size_t lsize = lqIds.size();
+    if (lqIds.empty() || ((size > 0) && (lsize < size - 1)))
         return;
-    if ((size > 1) && (lsize > size -1))
+
+    // levels size - 1, size and size + 1
+    std::size_t level = (size > 1) ? size - 1 : size;
+    for (; level <= size + 1 && level < lsize; level++)
     {
-        const UserQueryList& uqList = luqList[size - 1];
-        UserQueryList::const_iterator it = uqList.begin();
-        for (; it != uqList.end(); it++)
+        const QueryIdList& qIds = lqIds[level];
+        QueryIdList::const_iterator it = qIds.begin();
+        for (; it != qIds.end(); it++)
         {
-            int d = StringUtil::editDistance(it->userQuery(), userQuery);
-            if (d > 1)
+            const UserQuery& uq = queries_[*it];
+            izenelib::util::UString uquery(uq.userQuery(), izenelib::util::UString::UTF_8);
+            if (!isEditDistanceWithinOne(uquery, ustr))
                 continue;
-            results.push_back(*it);
+            results.push_back(uq);
         }
+    }
+}
+
+void PrefixTable::searchByIndex_(const izenelib::util::UString& ustr,
+    const izenelib::util::UString& uPrefix,
+    std::size_t size,
+    UserQueryList& results) const
+{
+    std::vector<uint32_t> keys;
+    deletionKeys(ustr, uPrefix.length(), keys);
 
+    std::vector<uint32_t> candidates;
+    for (std::size_t i = 0; i < keys.size(); i++)
+    {
+        std::vector<DeletionKey>::const_iterator it = std::lower_bound(
+            deletionIndex_.begin(), deletionIndex_.end(), DeletionKey(keys[i], 0));
+        for (; it != deletionIndex_.end() && it->key == keys[i]; it++)
+            candidates.push_back(it->queryId);
     }
-    if (lsize > size)
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // verify each candidate, and output them in the same order as
+    // searchByScan_(), that is, by level, then by query id
+    std::vector<std::pair<std::size_t, uint32_t> > matches;
+    for (std::size_t i = 0; i < candidates.size(); i++)
     {
-        const UserQueryList& uqList = luqList[size];
-        UserQueryList::const_iterator it = uqList.begin();
-        for (; it != uqList.end(); it++)
-        {
-            int d = StringUtil::editDistance(it->userQuery(), userQuery);
-            if (d > 1)
-                continue;
-            results.push_back(*it);
-        }
+        const uint32_t id = candidates[i];
+        izenelib::util::UString uquery(queries_[id].userQuery(), izenelib::util::UString::UTF_8);
+        if (!isEditDistanceWithinOne(uquery, ustr))
+            continue;
+
+        izenelib::util::UString uqPrefix;
+        PrefixTable::prefix(uquery, uqPrefix);
+        if (!(uqPrefix == uPrefix))
+            continue;
+
+        const std::size_t level = uquery.length() - uqPrefix.length();
+        if (level == size || level == size + 1 || (size > 1 && level == size - 1))
+            matches.push_back(std::make_pair(level, id));
     }
-    if (lsize > size + 1)
+    std::sort(matches.begin(), matches.end());
+
+    for (std::size_t i = 0; i < matches.size(); i++)
+        results.push_back(queries_[matches[i].second]);
+}
+
+void PrefixTable::deletionKeys(const izenelib::util::UString& userQuery,
+    std::size_t prefixLength,
+    std::vector<uint32_t>& keys)
+{
+    keys.push_back(hashUString(userQuery, userQuery.length()));
+    for (std::size_t i = prefixLength; i < userQuery.length(); i++)
     {
-        const UserQueryList& uqList = luqList[size + 1];
-        UserQueryList::const_iterator it = uqList.begin();
-        for (; it != uqList.end(); it++)
+        // deleting any character in a run gives the same string
+        if (i > prefixLength && userQuery[i] == userQuery[i - 1])
+            continue;
+        keys.push_back(hashUString(userQuery, i));
+    }
+}
+
+void PrefixTable::buildIndex()
+{
+    // renumber the queries bucket by bucket, level by level,
+    // which is the same order as they are written in flush()
+    std::vector<UserQuery> queries;
+    queries.reserve(queries_.size());
+    boost::unordered_map<std::string, LeveledQueryIds>::iterator it = table_.begin();
+    for (; it != table_.end(); it++)
+    {
+        LeveledQueryIds::iterator lq_it = it->second.begin();
+        for (; lq_it != it->second.end(); lq_it++)
         {
-            int d = StringUtil::editDistance(it->userQuery(), userQuery);
-            if (d > 1)
-                continue;
-            results.push_back(*it);
+            QueryIdList::iterator q_it = lq_it->begin();
+            for (; q_it != lq_it->end(); q_it++)
+            {
+                queries.push_back(queries_[*q_it]);
+                *q_it = queries.size() - 1;
+            }
         }
     }
+    queries_.swap(queries);
+
+    std::vector<DeletionKey> deletionIndex;
+    std::vector<uint32_t> keys;
+    for (uint32_t id = 0; id < queries_.size(); id++)
+    {
+        izenelib::util::UString ustr(queries_[id].userQuery(), izenelib::util::UString::UTF_8);
+        izenelib::util::UString uPrefix;
+        PrefixTable::prefix(ustr, uPrefix);
+
+        keys.clear();
+        deletionKeys(ustr, uPrefix.length(), keys);
+        for (std::size_t i = 0; i < keys.size(); i++)
+            deletionIndex.push_back(DeletionKey(keys[i], id));
+    }
+    std::sort(deletionIndex.begin(), deletionIndex.end());
+    deletionIndex_.swap(deletionIndex);
+    isIndexValid_ = true;
+}
+
+uint32_t PrefixTable::checksum_() const
+{
+    uint32_t h = FNV_OFFSET;
+    std::vector<UserQuery>::const_iterator it = queries_.begin();
+    for (; it != queries_.end(); it++)
+    {
+        const std::string& str = it->userQuery();
+        for (std::size_t i = 0; i < str.size(); i++)
+            h = (h ^ static_cast<unsigned char>(str[i])) * FNV_PRIME;
+        h = (h ^ '\n') * FNV_PRIME;
+    }
+    return h;
+}
+
+bool PrefixTable::loadIndex_()
+{
+    std::string path = workdir_;
+    path += "/";
+    path += indexUuid;
+
+    std::ifstream in(path.c_str(), std::ifstream::in | std::ifstream::binary);
+    if (!in)
+        return false;
+
+    uint32_t magic = 0;
+    uint32_t queryNum = 0;
+    uint32_t checksum = 0;
+    uint64_t keyNum = 0;
+    in.read((char*)&magic, sizeof(magic));
+    in.read((char*)&queryNum, sizeof(queryNum));
+    in.read((char*)&checksum, sizeof(checksum));
+    in.read((char*)&keyNum, sizeof(keyNum));
+    if (!in || INDEX_MAGIC != magic || queries_.size() != queryNum || checksum_() != checksum)
+        return false;
+
+    std::vector<DeletionKey> deletionIndex(keyNum);
+    if (keyNum > 0)
+        in.read((char*)&deletionIndex[0], keyNum * sizeof(DeletionKey));
+    if (!in)
+        return false;
+
+    deletionIndex_.swap(deletionIndex);
+    isIndexValid_ = true;
+    return true;
+}
+
+void PrefixTable::saveIndex_() const
+{
+    std::string path = workdir_;
+    path += "/";
+    path += indexUuid;
+
+    if (!isIndexValid_)
+    {
+        boost::filesystem::remove(path);
+        return;
+    }
+
+    std::ofstream out;
+    out.open(path.c_str(), std::ofstream::out | std::ofstream::trunc | std::ofstream::binary);
+
+    const uint32_t magic = INDEX_MAGIC;
+    const uint32_t queryNum = queries_.size();
+    const uint32_t checksum = checksum_();
+    const uint64_t keyNum = deletionIndex_.size();
+    out.write((const char*)&magic, sizeof(magic));
+    out.write((const char*)&queryNum, sizeof(queryNum));
+    out.write((const char*)&checksum, sizeof(checksum));
+    out.write((const char*)&keyNum, sizeof(keyNum));
+    if (keyNum > 0)
+        out.write((const char*)&deletionIndex_[0], keyNum * sizeof(DeletionKey));
 }
 
 void PrefixTable::clear()
 {
     table_.clear();
+    queries_.clear();
+    deletionIndex_.clear();
+    isIndexValid_ = true;
 }
 
 void PrefixTable::flush() const
@@ -206,23 +421,46 @@ void PrefixTable::flush() const
     out.open(path.c_str(), std::ofstream::out | std::ofstream::trunc);
     out<<*this;
     //std::cout<<"PinyinTable::"<<table_.size()<<"\n";
+
+    saveIndex_();
 }
 
 std::ostream& operator<<(std::ostream& out, const PrefixTable& table)
 {
-    boost::unordered_map<std::string, PrefixTable::LeveledUQL>::const_iterator it = table.table_.begin();
+    // write the buckets in the order of query ids, so that the ids
+    // are the same after the queries are read back
+    typedef boost::unordered_map<std::string, PrefixTable::LeveledQueryIds>::const_iterator BucketIter;
+    std::vector<BucketIter> buckets;
+    std::vector<std::pair<uint32_t, std::size_t> > order;
+    BucketIter it = table.table_.begin();
     for(; it != table.table_.end(); it++)
     {
+        uint32_t minId = std::numeric_limits<uint32_t>::max();
+        PrefixTable::LeveledQueryIds::const_iterator lq_it = it->second.begin();
+        for (; lq_it != it->second.end(); lq_it++)
+        {
+            if (!lq_it->empty())
+                minId = std::min(minId, lq_it->front());
+        }
+        order.push_back(std::make_pair(minId, buckets.size()));
+        buckets.push_back(it);
+    }
+    std::sort(order.begin(), order.end());
+
+    for (std::size_t i = 0; i < order.size(); i++)
+    {
+        it = buckets[order[i].second];
         out<<it->first<<"::";
-        PrefixTable::LeveledUQL::const_iterator luq_it = it->second.begin();
+        PrefixTable::LeveledQueryIds::const_iterator lq_it = it->second.begin();
         int level = 0;
-        for (; luq_it != it->second.end(); luq_it++, level++)
+        for (; lq_it != it->second.end(); lq_it++, level++)
         {
             out<<level<<">";
-            UserQueryList::const_iterator uq_it = luq_it->begin();
-            for (; uq_it != luq_it->end(); uq_it++)
+            PrefixTable::QueryIdList::const_iterator q_it = lq_it->begin();
+            for (; q_it != lq_it->end(); q_it++)
             {
-                out<<uq_it->userQuery()<<":"<<uq_it->freq()<<";";
+                const UserQuery& uq = table.queries_[*q_it];
+                out<<uq.userQuery()<<":"<<uq.freq()<<";";
             }
             out<<"--"; // level
         }
@@ -252,7 +490,7 @@ std::istream& operator>>(std::istream& in,  PrefixTable& table)
         std::string prefix = sLine.substr(0, pos);
         pos += 2;
 
-        PrefixTable::LeveledUQL luqList;
+        PrefixTable::LeveledQueryIds lqIds;
         while (true)
         {
             std::size_t found = sLine.find("--", pos);
@@ -260,7 +498,7 @@ std::istream& operator>>(std::istream& in,  PrefixTable& table)
                 break;
 
             
-            UserQueryList uqList;
+            PrefixTable::QueryIdList qIds;
             std::size_t level = std::numeric_limits<std::size_t>::max();
             std::string sLevel = sLine.substr(pos, found - pos);
             
@@ -286,19 +524,21 @@ std::istream& operator>>(std::istream& in,  PrefixTable& table)
                     continue;
                 
                 //std::cout<<pair.substr(0, seq)<<" : "<<atoi(pair.substr(seq+1).c_str())<<"\n";
-                uqList.push_back(UserQuery(pair.substr(0, seq).c_str(), atoi(pair.substr(seq+1).c_str())));
+                qIds.push_back(table.queries_.size());
+                table.queries_.push_back(UserQuery(pair.substr(0, seq).c_str(), atoi(pair.substr(seq+1).c_str())));
             }
             if (std::numeric_limits<std::size_t>::max() == level)
                 continue;
-            if (luqList.size() <= level)
-                luqList.resize(level + 1);
-            if (!uqList.empty())
-                luqList[level] = uqList;
-            //std::cout<<level<<" : "<<luqList[level].size()<<"\n";
+            if (lqIds.size() <= level)
+                lqIds.resize(level + 1);
+            if (!qIds.empty())
+                lqIds[level] = qIds;
+            //std::cout<<level<<" : "<<lqIds[level].size()<<"\n";
             
         }
         //std::cout<<prefix<<"\n";
-        table.table_.insert(std::make_pair(prefix, luqList));
+        table.table_.insert(std::make_pair(prefix, lqIds));
+        table.isIndexValid_ = false;
     }
     return in;
 }
@@ -12,7 +12,8 @@ namespace Recommend
 {
 class PrefixTable
 {
-typedef std::vector<UserQueryList> LeveledUQL;
+typedef std::vector<uint32_t> QueryIdList;
+typedef std::vector<QueryIdList> LeveledQueryIds;
 
 public:
     PrefixTable(const std::string& workdir);
@@ -21,6 +22,12 @@ public:
 public:
     void insert(const std::string& userQuery, uint32_t freq);
     void search(const std::string& userQuery, UserQueryList& uqlist) const;
+
+    /**
+     * build the deletion index of all queries, it should be called after
+     * insertion, otherwise search() compares each query of the same prefix.
+     */
+    void buildIndex();
     
     void flush() const;
     void clear();
@@ -32,8 +39,57 @@ public:
 
 private:
     static void prefix(const izenelib::util::UString& userQuery, izenelib::util::UString& pref);
+
+    /**
+     * get the hash keys of @p userQuery itself, and of its variants with
+     * one character deleted after the prefix. Two queries of the same prefix
+     * within edit distance 1 always share at least one key.
+     */
+    static void deletionKeys(const izenelib::util::UString& userQuery,
+                             std::size_t prefixLength,
+                             std::vector<uint32_t>& keys);
+
+    void searchByScan_(const izenelib::util::UString& userQuery,
+                       const std::string& prefix,
+                       std::size_t size,
+                       UserQueryList& results) const;
+
+    void searchByIndex_(const izenelib::util::UString& userQuery,
+                        const izenelib::util::UString& uPrefix,
+                        std::size_t size,
+                        UserQueryList& results) const;
+
+    bool loadIndex_();
+    void saveIndex_() const;
+
+    uint32_t checksum_() const;
+
 private:
-    boost::unordered_map<std::string, LeveledUQL> table_;
+    struct DeletionKey
+    {
+        uint32_t key;
+        uint32_t queryId;
+
+        DeletionKey(uint32_t k = 0, uint32_t id = 0) : key(k), queryId(id) {}
+
+        bool operator<(const DeletionKey& other) const
+        {
+            return key < other.key || (key == other.key && queryId < other.queryId);
+        }
+    };
+
+    /** the query id is its index */
+    std::vector<UserQuery> queries_;
+
+    /** prefix => the ids of queries in each level of suffix length */
+    boost::unordered_map<std::string, LeveledQueryIds> table_;
+
+    /** sorted array of the deletion keys, it is saved as a flat file */
+    std::vector<DeletionKey> deletionIndex_;
+
+    /** false if any query is inserted after the index is built */
+    bool isIndexValid_;
+
     static std::size_t PREFIX_SIZE;
     std::string workdir_;
 };
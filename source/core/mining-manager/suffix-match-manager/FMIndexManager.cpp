@@ -74,6 +74,8 @@ void FMIndexManager::clearFMIData()
     }
     docarray_mgr_.clear();
     doc_count_ = 0;
+    delta_.reset();
+    building_delta_.reset();
     LOG(INFO) << "fmi data cleared!";
 }
 
@@ -142,6 +144,8 @@ bool FMIndexManager::loadAll()
         clearFMIData();
         return false;
     }
+
+    loadDeltaIndex();
     return true;
 }
 
@@ -321,6 +325,7 @@ void FMIndexManager::swapCommonProperties(FMIndexManager* old_fmi_manager)
     std::swap(doc_count_, old_fmi_manager->doc_count_);
     LOG(INFO) << "swap common fmindex data, doc count: " << doc_count_;
     docarray_mgr_.swapMainDocArray(old_fmi_manager->docarray_mgr_);
+    delta_.swap(old_fmi_manager->delta_);
 
     FMIndexIter it_start = all_fmi_.begin();
     FMIndexIter it_end = all_fmi_.end();
@@ -377,59 +382,250 @@ void FMIndexManager::appendDocsAfter(bool failed, const Document& doc)
     {
         if (it->second.type == COMMON)
         {
-            if (failed)
+            UString totalText;
+            if (failed || !getIndexText(it->first, doc, totalText))
             {
                 it->second.fmi->addDoc(NULL, 0);
             }
             else
             {
-                const std::string& prop_name = it->first;
-                Document::property_const_iterator dit = doc.findProperty(prop_name);
-                if (prop_name != virtualProperty_.virtualName && dit == doc.propertyEnd() ) 
-                {
-                    it->second.fmi->addDoc(NULL, 0);
-                }
-                else
-                {
-                    UString totalText;
-                    UString space(" ", izenelib::util::UString::UTF_8);
-                    if (prop_name == virtualProperty_.virtualName)
-                    {
-                        for (std::vector<std::string>::iterator i = virtualProperty_.virtual_properties.begin();
-                             i != virtualProperty_.virtual_properties.end(); ++i)
-                        {
-                            Document::property_const_iterator vdit = doc.findProperty(*i);
-                            if (vdit != doc.propertyEnd())
-                            {
-                                UString text = propstr_to_ustr(vdit->second.getPropertyStrValue());
-                                totalText += text;
-                                totalText += space;
-                            }
-                        }
-                    }
-                    else
-                        totalText = propstr_to_ustr(dit->second.getPropertyStrValue());
-
-                    Algorithm<UString>::to_lower(totalText);
-                    fuzzyNormalizer_->normalizeText(totalText);
-
-                    for(size_t c_i = 0; c_i < totalText.length(); ++c_i)
-                    {
-                        if(totalText[c_i] == succinct::fm_index::DOC_DELIM)
-                        {
-                            LOG(WARNING) << "find a DOC_DELIM char in the document data.";
-                            totalText[c_i] = ' ';
-                        }
-                    }
-
-                    it->second.fmi->addDoc(totalText.data(), totalText.length());
-                }
+                it->second.fmi->addDoc(totalText.data(), totalText.length());
             }
         }
     }
     //LOG(INFO) << "inserted docs: " << document_manager_->getMaxDocId();
 }
 
+bool FMIndexManager::getIndexText(
+        const std::string& prop_name,
+        const Document& doc,
+        UString& text) const
+{
+    UString space(" ", izenelib::util::UString::UTF_8);
+    if (prop_name == virtualProperty_.virtualName)
+    {
+        for (std::vector<std::string>::const_iterator i = virtualProperty_.virtual_properties.begin();
+             i != virtualProperty_.virtual_properties.end(); ++i)
+        {
+            Document::property_const_iterator vdit = doc.findProperty(*i);
+            if (vdit != doc.propertyEnd())
+            {
+                text += propstr_to_ustr(vdit->second.getPropertyStrValue());
+                text += space;
+            }
+        }
+    }
+    else
+    {
+        Document::property_const_iterator dit = doc.findProperty(prop_name);
+        if (dit == doc.propertyEnd())
+            return false;
+        text = propstr_to_ustr(dit->second.getPropertyStrValue());
+    }
+
+    Algorithm<UString>::to_lower(text);
+    fuzzyNormalizer_->normalizeText(text);
+
+    for(size_t c_i = 0; c_i < text.length(); ++c_i)
+    {
+        if(text[c_i] == succinct::fm_index::DOC_DELIM)
+        {
+            LOG(WARNING) << "find a DOC_DELIM char in the document data.";
+            text[c_i] = ' ';
+        }
+    }
+    return true;
+}
+
+void FMIndexManager::initDeltaIndex()
+{
+    building_delta_.reset(new DeltaIndex);
+    building_delta_->start_docid = doc_count_ + 1;
+    for (FMIndexConstIter it = all_fmi_.begin(); it != all_fmi_.end(); ++it)
+    {
+        if (it->second.type == COMMON)
+        {
+            building_delta_->all_fmi[it->first].reset(new FMIndexType);
+        }
+    }
+}
+
+void FMIndexManager::appendDeltaDoc(bool failed, const Document& doc)
+{
+    if (!building_delta_)
+        return;
+
+    for (std::map<std::string, boost::shared_ptr<FMIndexType> >::iterator it =
+            building_delta_->all_fmi.begin(); it != building_delta_->all_fmi.end(); ++it)
+    {
+        UString text;
+        if (failed || !getIndexText(it->first, doc, text))
+        {
+            it->second->addDoc(NULL, 0);
+        }
+        else
+        {
+            it->second->addDoc(text.data(), text.length());
+        }
+    }
+    ++building_delta_->doc_count;
+}
+
+bool FMIndexManager::buildDeltaIndex()
+{
+    if (!building_delta_)
+        return false;
+
+    for (std::map<std::string, boost::shared_ptr<FMIndexType> >::iterator it =
+            building_delta_->all_fmi.begin(); it != building_delta_->all_fmi.end(); ++it)
+    {
+        LOG(INFO) << "building delta fm-index for property: " << it->first << " ....";
+        it->second->build();
+        if (it->second->docCount() != building_delta_->doc_count)
+        {
+            LOG(ERROR) << "docCount is different in delta fm-index of property: " << it->first
+                       << ", expect: " << building_delta_->doc_count
+                       << ", actual: " << it->second->docCount();
+            building_delta_.reset();
+            return false;
+        }
+    }
+    LOG(INFO) << "building delta fm-index finished, start docid: " << building_delta_->start_docid
+              << ", docCount: " << building_delta_->doc_count;
+    return true;
+}
+
+void FMIndexManager::swapDeltaIndex()
+{
+    delta_.swap(building_delta_);
+    building_delta_.reset();
+}
+
+size_t FMIndexManager::deltaDocCount() const
+{
+    return delta_ ? delta_->doc_count : 0;
+}
+
+FMIndexManager::FMIndexType* FMIndexManager::getDeltaFMIndex(const std::string& property) const
+{
+    if (!delta_ || delta_->doc_count == 0)
+        return NULL;
+
+    DeltaFMIndexConstIter cit = delta_->all_fmi.find(property);
+    if (cit == delta_->all_fmi.end())
+        return NULL;
+
+    return cit->second.get();
+}
+
+size_t FMIndexManager::deltaLongestSuffixMatch(
+        const std::string& property,
+        const UString& pattern,
+        RangeListT& raw_range_list) const
+{
+    FMIndexType* fmi = getDeltaFMIndex(property);
+    if (!fmi)
+        return 0;
+    return fmi->longestSuffixMatch(pattern.data(), pattern.length(), raw_range_list);
+}
+
+size_t FMIndexManager::deltaBackwardSearch(const std::string& prop, const UString& pattern, RangeT& match_range) const
+{
+    FMIndexType* fmi = getDeltaFMIndex(prop);
+    if (!fmi)
+        return 0;
+    return fmi->backwardSearch(pattern.data(), pattern.length(), match_range);
+}
+
+void FMIndexManager::getDeltaMatchedDocIdList(
+        const std::string& property,
+        const RangeT& match_range,
+        size_t max_docs,
+        std::vector<uint32_t>& docid_list,
+        std::vector<size_t>& doclen_list) const
+{
+    FMIndexType* fmi = getDeltaFMIndex(property);
+    if (!fmi)
+        return;
+
+    size_t old_size = docid_list.size();
+    fmi->getMatchedDocIdList(match_range, max_docs, docid_list, doclen_list);
+    // the docid in delta fm-index starts from 1
+    for (size_t i = old_size; i < docid_list.size(); ++i)
+    {
+        docid_list[i] += delta_->start_docid - 1;
+    }
+}
+
+void FMIndexManager::saveDeltaIndex() const
+{
+    for (FMIndexConstIter it = all_fmi_.begin(); it != all_fmi_.end(); ++it)
+    {
+        if (it->second.type != COMMON)
+            continue;
+
+        const std::string path = data_root_path_ + "/" + it->first + ".delta_fm_idx";
+        FMIndexType* fmi = getDeltaFMIndex(it->first);
+        if (!fmi)
+        {
+            boost::filesystem::remove(path);
+            continue;
+        }
+
+        std::ofstream ofs(path.c_str());
+        ofs.write((const char*)&delta_->start_docid, sizeof(delta_->start_docid));
+        fmi->save(ofs);
+    }
+}
+
+void FMIndexManager::loadDeltaIndex()
+{
+    delta_.reset();
+    if (doc_count_ == 0)
+        return;
+
+    boost::shared_ptr<DeltaIndex> delta(new DeltaIndex);
+    delta->start_docid = doc_count_ + 1;
+    for (FMIndexConstIter it = all_fmi_.begin(); it != all_fmi_.end(); ++it)
+    {
+        if (it->second.type != COMMON)
+            continue;
+
+        std::ifstream ifs((data_root_path_ + "/" + it->first + ".delta_fm_idx").c_str());
+        if (!ifs)
+            return;
+
+        size_t start_docid = 0;
+        ifs.read((char*)&start_docid, sizeof(start_docid));
+        if (start_docid != delta->start_docid)
+        {
+            LOG(INFO) << "the delta fm-index is out of date for property: " << it->first;
+            return;
+        }
+
+        boost::shared_ptr<FMIndexType>& fmi = delta->all_fmi[it->first];
+        fmi.reset(new FMIndexType);
+        fmi->load(ifs);
+
+        if (delta->all_fmi.size() == 1)
+        {
+            delta->doc_count = fmi->docCount();
+        }
+        else if (fmi->docCount() != delta->doc_count)
+        {
+            LOG(ERROR) << "docCount is different in delta fm-index of property: " << it->first;
+            return;
+        }
+    }
+
+    if (delta->doc_count > 0)
+    {
+        delta_.swap(delta);
+        LOG(INFO) << "loading delta fm-index, start docid: " << delta_->start_docid
+                  << ", docCount: " << delta_->doc_count;
+    }
+}
+
 bool FMIndexManager::buildCollectionAfter()
 {
     size_t new_doc_cnt = 0;
@@ -788,6 +984,7 @@ void FMIndexManager::saveAll()
             fmit->second.fmi->save(ofs);
         ++fmit;
     }
+    saveDeltaIndex();
     try
     {
         std::ofstream ofs;
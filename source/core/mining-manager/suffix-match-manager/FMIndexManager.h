@@ -75,6 +75,40 @@ public:
     bool buildCollectionAfter();
     void swapUnchangedFilter(FMIndexManager* old_fmi_manager);
 
+    /**
+     * The documents appended after the main fm-index is built are indexed in
+     * the small delta fm-indexes, which are searched together with the main
+     * fm-index, until all documents are rebuilt into the main one.
+     * The delta is built from the docid @c docCount() + 1 in a separate
+     * copy, and then replaced by @c swapDeltaIndex().
+     */
+    void initDeltaIndex();
+    void appendDeltaDoc(bool failed, const Document& doc);
+    bool buildDeltaIndex();
+    void swapDeltaIndex();
+    void saveDeltaIndex() const;
+
+    /// the number of documents in the delta fm-index
+    size_t deltaDocCount() const;
+
+    size_t deltaLongestSuffixMatch(
+            const std::string& property,
+            const izenelib::util::UString& pattern,
+            RangeListT& raw_range_list) const;
+
+    size_t deltaBackwardSearch(const std::string& prop, const izenelib::util::UString& pattern, RangeT& match_range) const;
+
+    /**
+     * @param docid_list the docids in @p match_range of the delta fm-index,
+     *        they are converted to the docids in the collection.
+     */
+    void getDeltaMatchedDocIdList(
+            const std::string& property,
+            const RangeT& match_range,
+            size_t max_docs,
+            std::vector<uint32_t>& docid_list,
+            std::vector<size_t>& doclen_list) const;
+
     void setFilterList(std::vector<std::vector<FMDocArrayMgrType::FilterItemT> > &filter_list);
     bool getFilterRange(size_t prop_id, const RangeT &filter_id_range, RangeT &match_range) const;
 
@@ -147,6 +181,35 @@ private:
             const std::vector<uint32_t>& del_docid_list,
             std::vector<uint16_t>& orig_text) const;
 
+    /**
+     * get the normalized text of @p prop_name in @p doc for fm-index.
+     * @return false if the property does not exist in @p doc
+     */
+    bool getIndexText(
+            const std::string& prop_name,
+            const Document& doc,
+            izenelib::util::UString& text) const;
+
+    struct DeltaIndex
+    {
+        DeltaIndex()
+            : start_docid(0), doc_count(0)
+        {
+        }
+
+        /// the docid of the first document in delta
+        size_t start_docid;
+        size_t doc_count;
+
+        /// the fm-index of each COMMON property
+        std::map<std::string, boost::shared_ptr<FMIndexType> > all_fmi;
+    };
+    typedef std::map<std::string, boost::shared_ptr<FMIndexType> >::const_iterator DeltaFMIndexConstIter;
+
+    FMIndexType* getDeltaFMIndex(const std::string& property) const;
+
+    void loadDeltaIndex();
+
     struct PropertyFMIndex
     {
         PropertyFMIndex()
@@ -170,6 +233,10 @@ private:
     typedef std::map<std::string, PropertyFMIndex>::const_iterator FMIndexConstIter;
     FMDocArrayMgrType docarray_mgr_;
 
+    /// the delta being searched, and the one being built
+    boost::shared_ptr<DeltaIndex> delta_;
+    boost::shared_ptr<DeltaIndex> building_delta_;
+
     FuzzyNormalizer* fuzzyNormalizer_;
 };
 
@@ -16,6 +16,7 @@
 #include <util/ustring/algo.hpp>
 #include <glog/logging.h>
 #include <math.h>
+#include <algorithm>
 
 using namespace cma;
 using namespace izenelib::util;
@@ -97,13 +98,23 @@ size_t SuffixMatchManager::longestSuffixMatch(
         {
             const std::string& property = search_in_properties[i];
             FMIndexManager::RangeListT match_ranges;
-            max_match = 0;
+            max_match = fmi_manager_->longestSuffixMatch(property, pattern, match_ranges);
+
+            // the appended docs in delta fm-index are searched even if
+            // nothing is matched in the main fm-index
+            FMIndexManager::RangeListT delta_match_ranges;
+            const size_t delta_max_match = fmi_manager_->deltaLongestSuffixMatch(property, pattern, delta_match_ranges);
+
+            // only the docs with the longest match are ranked
+            const size_t longest_match = std::max(max_match, delta_max_match);
+            if (longest_match == 0)
+                continue;
+
+            LOG(INFO) << "longestSuffixMatch on property: " << property <<
+                ", length: " << max_match << ", delta length: " << delta_max_match;
+
+            if (max_match == longest_match)
             {
-                max_match = fmi_manager_->longestSuffixMatch(property, pattern, match_ranges);
-                if (max_match == 0)
-                    continue;
-                LOG(INFO) << "longestSuffixMatch on property: " << property <<
-                    ", length: " << max_match;
                 for (size_t i = 0; i < match_ranges.size(); ++i)
                 {
                     LOG(INFO) << "range " << i << ": " << match_ranges[i].first << "-" << match_ranges[i].second;
@@ -111,18 +122,35 @@ size_t SuffixMatchManager::longestSuffixMatch(
                 std::vector<double> max_match_list(match_ranges.size(), max_match);
                 fmi_manager_->convertMatchRanges(property, max_docs, match_ranges, max_match_list);
                 fmi_manager_->getMatchedDocIdList(property, match_ranges, max_docs, docid_list, doclen_list);
-            }
 
-            for (size_t j = 0; j < docid_list.size(); ++j)
-            {
-                assert(doclen_list[j] > 0);
-                res_list_map[docid_list[j]] += double(max_match) / double(doclen_list[j]);
+                for (size_t j = 0; j < docid_list.size(); ++j)
+                {
+                    assert(doclen_list[j] > 0);
+                    res_list_map[docid_list[j]] += double(max_match) / double(doclen_list[j]);
+                }
+                docid_list.clear();
+                doclen_list.clear();
+
+                for (size_t j = 0; j < match_ranges.size(); ++j)
+                {
+                    total_match += match_ranges[j].second - match_ranges[j].first;
+                }
             }
 
-            for (size_t j = 0; j < match_ranges.size(); ++j)
+            if (delta_max_match == longest_match)
             {
-                total_match += match_ranges[j].second - match_ranges[j].first;
+                for (size_t j = 0; j < delta_match_ranges.size(); ++j)
+                {
+                    fmi_manager_->getDeltaMatchedDocIdList(property, delta_match_ranges[j], max_docs, docid_list, doclen_list);
+                    total_match += delta_match_ranges[j].second - delta_match_ranges[j].first;
+                }
+                for (size_t j = 0; j < docid_list.size(); ++j)
+                {
+                    if (doclen_list[j] > 0)
+                        res_list_map[docid_list[j]] += double(delta_max_match) / double(doclen_list[j]);
+                }
             }
+
             docid_list.clear();
             doclen_list.clear();
         }
@@ -132,6 +160,9 @@ size_t SuffixMatchManager::longestSuffixMatch(
     for (btree::btree_map<uint32_t, double>::const_iterator cit = res_list_map.begin();
             cit != res_list_map.end(); ++cit)
     {
+        // the deleted docs are kept in fm-index until it is rebuilt
+        if (document_manager_->isDeleted(cit->first))
+            continue;
         res_list.push_back(std::make_pair(cit->second, cit->first));
     }
     std::sort(res_list.begin(), res_list.end(), std::greater<std::pair<double, uint32_t> >());
@@ -287,6 +318,10 @@ size_t SuffixMatchManager::AllPossibleSuffixMatch(
         }
 
         std::pair<size_t, size_t> sub_match_range;
+
+        // the delta fm-index could not be filtered by the filter ranges,
+        // which are built on the docs in main fm-index only
+        const bool use_delta = prop_id_list.empty() && fmi_manager_->deltaDocCount() > 0;
         
         for (size_t prop_i = 0; prop_i < search_in_properties.size(); ++prop_i)
         {
@@ -295,6 +330,8 @@ size_t SuffixMatchManager::AllPossibleSuffixMatch(
             range_list.reserve(major_tokens.size() + minor_tokens.size());
             score_list.reserve(range_list.size());
             std::vector<std::vector<boost::tuple<size_t, size_t, double> > > synonym_range_list;             
+            std::vector<DeltaRangeList> delta_range_list;
+            size_t delta_thres = 0;
             if (use_synonym)
             {            
 
@@ -302,6 +339,7 @@ size_t SuffixMatchManager::AllPossibleSuffixMatch(
                 for (size_t i = 0; i < synonym_tokens.size(); ++i)
                 {
                     std::vector<boost::tuple<size_t, size_t, double> > synonym_match_range;
+                    DeltaRangeList delta_match_range;
                     for (size_t j = 0; j < synonym_tokens[i].size(); ++j)
                     {    
                         fuzzyNormalizer_->normalizeToken(synonym_tokens[i][j].first);
@@ -312,12 +350,21 @@ size_t SuffixMatchManager::AllPossibleSuffixMatch(
                             tmp_tuple.get<2>() = synonym_tokens[i][j].second;                        
                             synonym_match_range.push_back(tmp_tuple);
                         }
+                        if (use_delta && fmi_manager_->deltaBackwardSearch(search_property, synonym_tokens[i][j].first, sub_match_range) == synonym_tokens[i][j].first.length())
+                        {
+                            delta_match_range.push_back(std::make_pair(sub_match_range, synonym_tokens[i][j].second));
+                        }
                     }
                     if (!synonym_match_range.empty())
                     {
                         if (i < major_size) ++thres;
                         synonym_range_list.push_back(synonym_match_range);
                     }
+                    if (!delta_match_range.empty())
+                    {
+                        if (i < major_size) ++delta_thres;
+                        delta_range_list.push_back(delta_match_range);
+                    }
                 }
 
             }
@@ -336,9 +383,14 @@ size_t SuffixMatchManager::AllPossibleSuffixMatch(
                         range_list.push_back(sub_match_range);
                         score_list.push_back(pit->second);
                     }
+                    if (use_delta && fmi_manager_->deltaBackwardSearch(search_property, token, sub_match_range) == token.length())
+                    {
+                        delta_range_list.push_back(DeltaRangeList(1, std::make_pair(sub_match_range, pit->second)));
+                    }
                 }
 
                 thres = range_list.size();
+                delta_thres = delta_range_list.size();
     
                 for (std::list<std::pair<UString, double> >::const_iterator pit = minor_tokens.begin();
                         pit != minor_tokens.end(); ++pit)
@@ -353,6 +405,10 @@ size_t SuffixMatchManager::AllPossibleSuffixMatch(
                         range_list.push_back(sub_match_range);
                         score_list.push_back(pit->second);
                     }
+                    if (use_delta && fmi_manager_->deltaBackwardSearch(search_property, token, sub_match_range) == token.length())
+                    {
+                        delta_range_list.push_back(DeltaRangeList(1, std::make_pair(sub_match_range, pit->second)));
+                    }
                 }
                 fmi_manager_->convertMatchRanges(search_property, max_docs, range_list, score_list);
             }
@@ -392,6 +448,21 @@ size_t SuffixMatchManager::AllPossibleSuffixMatch(
             }
             single_res_list.clear();
 
+            if (!delta_range_list.empty())
+            {
+                getDeltaTopKDocIdList_(search_property, delta_range_list, delta_thres, max_docs, single_res_list);
+                LOG(INFO) << "topk in delta fm-index: " << single_res_list.size();
+                for (size_t i = 0; i < single_res_list.size(); ++i)
+                {
+                    res_list_map[single_res_list[i].second] += single_res_list[i].first;
+                }
+                single_res_list.clear();
+
+                for (size_t i = 0; i < delta_range_list.size(); ++i)
+                    for (size_t j = 0; j < delta_range_list[i].size(); ++j)
+                        total_match += delta_range_list[i][j].first.second - delta_range_list[i][j].first.first;
+            }
+
             if (use_synonym)  
             {
                 for (size_t i = 0; i < synonym_range_list.size(); ++i)
@@ -414,7 +485,7 @@ size_t SuffixMatchManager::AllPossibleSuffixMatch(
     for (btree::btree_map<uint32_t, double>::const_iterator cit = res_list_map.begin();
             cit != res_list_map.end(); ++cit)
     {
-        if (cit->second > rank_boundary)
+        if (cit->second > rank_boundary && !document_manager_->isDeleted(cit->first))
         {
             res_list.push_back(std::make_pair(cit->second, cit->first));
         }
@@ -431,6 +502,60 @@ size_t SuffixMatchManager::AllPossibleSuffixMatch(
     return total_match;
 }
 
+void SuffixMatchManager::getDeltaTopKDocIdList_(
+        const std::string& property,
+        const std::vector<DeltaRangeList>& range_list,
+        size_t thres,
+        size_t max_docs,
+        std::vector<std::pair<double, uint32_t> >& res_list) const
+{
+    // docid => (score, the number of matched ranges)
+    typedef btree::btree_map<uint32_t, std::pair<double, size_t> > DocScoreMap;
+    DocScoreMap doc_score_map;
+
+    std::vector<uint32_t> docid_list;
+    std::vector<size_t> doclen_list;
+    for (size_t i = 0; i < range_list.size(); ++i)
+    {
+        // the max score of the synonyms each doc matches
+        btree::btree_map<uint32_t, double> synonym_score_map;
+        for (size_t j = 0; j < range_list[i].size(); ++j)
+        {
+            const RangeT& range = range_list[i][j].first;
+            fmi_manager_->getDeltaMatchedDocIdList(property, range, range.second - range.first,
+                                                   docid_list, doclen_list);
+            for (size_t k = 0; k < docid_list.size(); ++k)
+            {
+                double& score = synonym_score_map[docid_list[k]];
+                score = std::max(score, range_list[i][j].second);
+            }
+            docid_list.clear();
+            doclen_list.clear();
+        }
+
+        for (btree::btree_map<uint32_t, double>::const_iterator cit = synonym_score_map.begin();
+                cit != synonym_score_map.end(); ++cit)
+        {
+            std::pair<double, size_t>& doc_score = doc_score_map[cit->first];
+            doc_score.first += cit->second;
+            ++doc_score.second;
+        }
+    }
+
+    for (DocScoreMap::const_iterator cit = doc_score_map.begin();
+            cit != doc_score_map.end(); ++cit)
+    {
+        if (cit->second.second >= thres)
+        {
+            res_list.push_back(std::make_pair(cit->second.first, cit->first));
+        }
+    }
+
+    std::sort(res_list.begin(), res_list.end(), std::greater<std::pair<double, uint32_t> >());
+    if (res_list.size() > max_docs)
+        res_list.erase(res_list.begin() + max_docs, res_list.end());
+}
+
 bool SuffixMatchManager::getAllFilterRangeFromAttrLable_(
         const GroupParam& group_param,
         std::vector<size_t>& prop_id_list,
@@ -77,6 +77,23 @@ public:
 private:
     typedef izenelib::am::succinct::fm_index::FMIndex<uint16_t> FMIndexType;
     typedef FMIndexType::MatchRangeListT RangeListT;
+    typedef FMIndexType::MatchRangeT RangeT;
+
+    /// the ranges of the synonyms matched in delta fm-index, with their scores
+    typedef std::vector<std::pair<RangeT, double> > DeltaRangeList;
+
+    /**
+     * get the topk docs in delta fm-index.
+     * @param range_list each doc is scored by the sum of the max score of
+     *        each @c DeltaRangeList it matches
+     * @param thres the min number of @c DeltaRangeList each doc matches
+     */
+    void getDeltaTopKDocIdList_(
+            const std::string& property,
+            const std::vector<DeltaRangeList>& range_list,
+            size_t thres,
+            size_t max_docs,
+            std::vector<std::pair<double, uint32_t> >& res_list) const;
     bool GetSynonymSet_(const UString& pattern, std::vector<UString>& synonym_set, int& setid);
     bool GetSynonymId_(const UString& pattern, int& setid);
     void ExpandSynonym_(const std::vector<std::pair<UString, double> >& tokens, std::vector<std::vector<std::pair<UString, double> > >& refine_tokens, size_t& major_size);
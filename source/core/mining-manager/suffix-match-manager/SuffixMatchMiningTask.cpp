@@ -14,6 +14,21 @@
 namespace sf1r
 {
 
+namespace
+{
+/**
+ * the max ratio of the docs in delta fm-index to the docs in main
+ * fm-index, when it is exceeded, all docs are rebuilt into main fm-index.
+ */
+const double kMaxDeltaDocRatio = 0.1;
+
+/**
+ * the max ratio of the deleted docs in main fm-index, as they are only
+ * filtered out in searching, when it is exceeded, main fm-index is rebuilt.
+ */
+const double kMaxDeletedDocRatio = 0.1;
+}
+
 SuffixMatchMiningTask::SuffixMatchMiningTask(
         boost::shared_ptr<DocumentManager>& document_manager,
         boost::shared_ptr<FMIndexManager>& fmi_manager,
@@ -26,6 +41,8 @@ SuffixMatchMiningTask::SuffixMatchMiningTask(
     , filter_manager_(filter_manager)
     , data_root_path_(data_root_path)
     , is_incrememtalTask_(false)
+    , need_rebuild(false)
+    , need_build_delta(false)
     , mutex_(mutex)
 {
 }
@@ -39,6 +56,16 @@ bool SuffixMatchMiningTask::preProcess(int64_t timestamp)
 {
     if (!is_incrememtalTask_)
     {
+        need_build_delta = false;
+        if (canBuildDelta_())
+        {
+            LOG(INFO) << "only the appended docs are built into delta fm-index, from docid "
+                      << fmi_manager_->docCount() + 1;
+            fmi_manager_->initDeltaIndex();
+            need_build_delta = true;
+            return true;
+        }
+
         new_filter_manager.reset(new FilterManager(document_manager_, filter_manager_->getGroupManager(), data_root_path_,
                     filter_manager_->getAttrManager(), filter_manager_->getNumericTableBuilder()));
         new_filter_manager->copyPropertyInfo(filter_manager_);
@@ -68,16 +95,13 @@ bool SuffixMatchMiningTask::preProcess(int64_t timestamp)
 
         if (last_docid == document_manager_->getMaxDocId()) 
         {
-            // check if there is any new deleted doc.
-            std::vector<size_t> doclen_list(del_docid_list.size(), 0);
-            fmi_manager_->getDocLenList(del_docid_list, doclen_list);
-            for (size_t i = 0; i < doclen_list.size(); ++i)
+            // the deleted docs are filtered out in searching,
+            // the fm-index is rebuilt only if there are too many of them.
+            size_t del_num = getIndexedDeletedDocNum_(del_docid_list);
+            if (del_num > last_docid * kMaxDeletedDocRatio)
             {
-                if (doclen_list[i] > 0)
-                {
-                    need_rebuild = true;
-                    break;
-                }
+                LOG(INFO) << "deleted docs in fm-index: " << del_num;
+                need_rebuild = true;
             }
 
             if (!need_rebuild)
@@ -141,6 +165,20 @@ bool SuffixMatchMiningTask::preProcess(int64_t timestamp)
 
 bool SuffixMatchMiningTask::postProcess()
 {
+    if (!is_incrememtalTask_ && need_build_delta)
+    {
+        if (!fmi_manager_->buildDeltaIndex())
+            return false;
+
+        {
+            WriteLock lock(mutex_);
+            fmi_manager_->swapDeltaIndex();
+        }
+        LOG(INFO) << "saving delta fm-index data";
+        fmi_manager_->saveDeltaIndex();
+        return true;
+    }
+
     if (!is_incrememtalTask_)
     {   
         if (need_rebuild && !new_fmi_manager->buildCollectionAfter())
@@ -192,6 +230,12 @@ bool SuffixMatchMiningTask::buildDocument(docid_t docID, const Document& doc)
     if (!is_incrememtalTask_ && !isRtypeIncremental_)
     {
         bool failed = (doc.getId() == 0);
+        if (need_build_delta)
+        {
+            fmi_manager_->appendDeltaDoc(failed, doc);
+            return true;
+        }
+
         new_fmi_manager->appendDocsAfter(failed, doc);
         if (!failed)
         {
@@ -206,6 +250,48 @@ docid_t SuffixMatchMiningTask::getLastDocId()
     return fmi_manager_ ? fmi_manager_->docCount() + 1 : 1;
 }
 
+bool SuffixMatchMiningTask::canBuildDelta_() const
+{
+    if (!fmi_manager_ || fmi_manager_->docCount() == 0)
+        return false;
+
+    const size_t last_docid = fmi_manager_->docCount();
+    const size_t max_docid = document_manager_->getMaxDocId();
+    if (max_docid <= last_docid)
+        return false;
+
+    if (max_docid - last_docid > last_docid * kMaxDeltaDocRatio)
+    {
+        LOG(INFO) << "too many appended docs for delta fm-index: " << max_docid - last_docid;
+        return false;
+    }
+
+    // the filters of the updated R-type properties need rebuilding
+    if (document_manager_->isThereRtypePro())
+        return false;
+
+    std::vector<uint32_t> del_docid_list;
+    document_manager_->getDeletedDocIdList(del_docid_list);
+    return getIndexedDeletedDocNum_(del_docid_list) <= last_docid * kMaxDeletedDocRatio;
+}
+
+size_t SuffixMatchMiningTask::getIndexedDeletedDocNum_(
+        const std::vector<uint32_t>& del_docid_list) const
+{
+    std::vector<size_t> doclen_list(del_docid_list.size(), 0);
+    fmi_manager_->getDocLenList(del_docid_list, doclen_list);
+
+    size_t del_num = 0;
+    for (size_t i = 0; i < doclen_list.size(); ++i)
+    {
+        if (doclen_list[i] > 0)
+        {
+            ++del_num;
+        }
+    }
+    return del_num;
+}
+
 void SuffixMatchMiningTask::setTaskStatus(bool is_incrememtalTask)
 {
     is_incrememtalTask_ = is_incrememtalTask;
@@ -56,6 +56,19 @@ public:
 
     bool isRtypeIncremental_;
 
+private:
+    /**
+     * @return true if only the appended docs need building into the delta
+     *         fm-index, instead of rebuilding all docs.
+     */
+    bool canBuildDelta_() const;
+
+    /**
+     * @return the number of docs in @p del_docid_list which are still in
+     *         the main fm-index.
+     */
+    size_t getIndexedDeletedDocNum_(const std::vector<uint32_t>& del_docid_list) const;
+
 private:
     DISALLOW_COPY_AND_ASSIGN(SuffixMatchMiningTask);
     boost::shared_ptr<DocumentManager> document_manager_;
@@ -70,6 +83,7 @@ private:
     boost::shared_ptr<FMIndexManager> new_fmi_manager;
     boost::shared_ptr<FilterManager> new_filter_manager;
     bool need_rebuild;
+    bool need_build_delta;
 
     typedef boost::shared_mutex MutexType;
     MutexType& mutex_;
@@ -0,0 +1,224 @@
+#include "BackupSnapshot.h"
+
+#include <glog/logging.h>
+#include <fstream>
+#include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#ifdef __linux__
+#include <linux/fs.h>
+#endif
+
+namespace sf1r
+{
+
+bool BackupManifest::load(const bfs::path& snapshot_path)
+{
+    file_info_map_.clear();
+    snapshot_time_ = 0;
+
+    bfs::path manifest_file = snapshot_path/getManifestFileName();
+    std::ifstream ifs(manifest_file.c_str());
+    if (!ifs.good())
+        return false;
+
+    std::string line;
+    if (!std::getline(ifs, line))
+        return false;
+    std::istringstream head(line);
+    std::string head_key;
+    if (!(head >> head_key >> snapshot_time_) || head_key != "time")
+    {
+        LOG(WARNING) << "invalid backup manifest head: " << manifest_file;
+        return false;
+    }
+
+    while (std::getline(ifs, line))
+    {
+        if (line.empty())
+            continue;
+        // each line: size mtime linked path
+        std::istringstream iss(line);
+        FileInfo info;
+        if (!(iss >> info.size >> info.mtime >> info.linked))
+        {
+            LOG(WARNING) << "invalid backup manifest line: " << line;
+            file_info_map_.clear();
+            return false;
+        }
+        iss.get();
+        std::string rel_path;
+        std::getline(iss, rel_path);
+        file_info_map_[rel_path] = info;
+    }
+    return true;
+}
+
+bool BackupManifest::save(const bfs::path& snapshot_path) const
+{
+    bfs::path manifest_file = snapshot_path/getManifestFileName();
+    bfs::path tmp_file = manifest_file.string() + ".tmp";
+    {
+        std::ofstream ofs(tmp_file.c_str());
+        if (!ofs.good())
+            return false;
+        ofs << "time " << snapshot_time_ << std::endl;
+        for (FileInfoMapT::const_iterator it = file_info_map_.begin();
+            it != file_info_map_.end(); ++it)
+        {
+            ofs << it->second.size << " " << it->second.mtime << " "
+                << it->second.linked << " " << it->first << std::endl;
+        }
+        ofs.flush();
+        if (!ofs.good())
+            return false;
+    }
+    bfs::rename(tmp_file, manifest_file);
+    return true;
+}
+
+const BackupManifest::FileInfo* BackupManifest::getFileInfo(const std::string& rel_path) const
+{
+    FileInfoMapT::const_iterator it = file_info_map_.find(rel_path);
+    if (it == file_info_map_.end())
+        return NULL;
+    return &it->second;
+}
+
+bool BackupManifest::isUnchanged(const std::string& rel_path, uint64_t size, std::time_t mtime) const
+{
+    const FileInfo* info = getFileInfo(rel_path);
+    if (!info)
+        return false;
+    return info->size == size && info->mtime == mtime && mtime < snapshot_time_;
+}
+
+bool BackupManifest::verify(const bfs::path& snapshot_path) const
+{
+    for (FileInfoMapT::const_iterator it = file_info_map_.begin();
+        it != file_info_map_.end(); ++it)
+    {
+        if (it->second.linked)
+            continue;
+        bfs::path file = snapshot_path/it->first;
+        boost::system::error_code ec;
+        uint64_t size = bfs::file_size(file, ec);
+        if (ec || size != it->second.size)
+        {
+            LOG(WARNING) << "backup file missing or size mismatch: " << file;
+            return false;
+        }
+    }
+    return true;
+}
+
+BackupSnapshot::BackupSnapshot(const bfs::path& snapshot_path, const bfs::path& base_snapshot_path)
+    : snapshot_path_(snapshot_path)
+    , base_snapshot_path_(base_snapshot_path)
+    , linked_num_(0)
+    , copied_num_(0)
+{
+    // the files modified from now on are not trusted as unchanged by the next snapshot.
+    manifest_.setSnapshotTime(std::time(NULL));
+    if (!base_snapshot_path_.empty() && !base_manifest_.load(base_snapshot_path_))
+    {
+        LOG(INFO) << "no manifest in the base snapshot, all files will be copied: " << base_snapshot_path_;
+    }
+}
+
+void BackupSnapshot::addDir(const bfs::path& src, const bfs::path& rel_dest)
+{
+    if (!bfs::exists(src) || !bfs::is_directory(src))
+    {
+        throw std::runtime_error("Source directory " + src.string() +
+            " does not exist or is not a directory.");
+    }
+    bfs::create_directories(snapshot_path_/rel_dest);
+
+    static const bfs::directory_iterator end_it = bfs::directory_iterator();
+    for (bfs::directory_iterator file(src); file != end_it; ++file)
+    {
+        bfs::path current(file->path());
+        if (!bfs::exists(current))
+        {
+            LOG(WARNING) << "the file disappeared while coping: " << current;
+            continue;
+        }
+        if (bfs::is_directory(current))
+        {
+            addDir(current, rel_dest/current.filename());
+        }
+        else
+        {
+            if (current.filename().string().find("_removed.rollback") != std::string::npos)
+                continue;
+            addFile(current, rel_dest/current.filename());
+        }
+    }
+}
+
+void BackupSnapshot::addFile(const bfs::path& src, const bfs::path& rel_dest)
+{
+    const std::string rel_path = rel_dest.string();
+    BackupManifest::FileInfo info;
+    info.size = bfs::file_size(src);
+    info.mtime = bfs::last_write_time(src);
+
+    bfs::path dest = snapshot_path_/rel_dest;
+    bfs::create_directories(dest.parent_path());
+
+    if (base_manifest_.isUnchanged(rel_path, info.size, info.mtime))
+    {
+        // the files in a snapshot are never modified, so it is safe to share them.
+        boost::system::error_code ec;
+        bfs::create_hard_link(base_snapshot_path_/rel_dest, dest, ec);
+        if (!ec)
+        {
+            info.linked = true;
+            ++linked_num_;
+            manifest_.addFile(rel_path, info);
+            return;
+        }
+        LOG(INFO) << "hard link failed, copy instead: " << dest << ", " << ec.message();
+    }
+
+    copyFile(src, dest);
+    ++copied_num_;
+    manifest_.addFile(rel_path, info);
+}
+
+bool BackupSnapshot::finish()
+{
+    LOG(INFO) << "backup snapshot " << snapshot_path_ << " finished, linked files: "
+        << linked_num_ << ", copied files: " << copied_num_;
+    return manifest_.save(snapshot_path_);
+}
+
+void BackupSnapshot::copyFile(const bfs::path& from, const bfs::path& to)
+{
+    bool cloned = false;
+#ifdef FICLONE
+    int from_fd = open(from.c_str(), O_RDONLY);
+    if (from_fd >= 0)
+    {
+        int to_fd = open(to.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (to_fd >= 0)
+        {
+            cloned = ioctl(to_fd, FICLONE, from_fd) == 0;
+            close(to_fd);
+        }
+        close(from_fd);
+    }
+#endif
+    if (!cloned)
+    {
+        bfs::copy_file(from, to, bfs::copy_option::overwrite_if_exists);
+    }
+    try
+    {
+        bfs::last_write_time(to, bfs::last_write_time(from));
+    }catch(const std::exception& e){}
+}
+
+}
@@ -0,0 +1,113 @@
+#ifndef SF1R_NODEMANAGER_BACKUP_SNAPSHOT_H
+#define SF1R_NODEMANAGER_BACKUP_SNAPSHOT_H
+
+#include <boost/filesystem.hpp>
+#include <ctime>
+#include <map>
+#include <string>
+
+namespace bfs = boost::filesystem;
+
+namespace sf1r
+{
+
+// the manifest of the files in a backup snapshot, the path of each file is
+// relative to the snapshot directory.
+class BackupManifest
+{
+public:
+    struct FileInfo
+    {
+        FileInfo() : size(0), mtime(0), linked(false) {}
+
+        uint64_t size;
+        std::time_t mtime;
+        // true if hard linked from the base snapshot, false if copied.
+        bool linked;
+    };
+    typedef std::map<std::string, FileInfo> FileInfoMapT;
+
+    BackupManifest() : snapshot_time_(0) {}
+
+    static std::string getManifestFileName()
+    {
+        static std::string manifest_file("backup_manifest");
+        return manifest_file;
+    }
+
+    bool load(const bfs::path& snapshot_path);
+    bool save(const bfs::path& snapshot_path) const;
+
+    // whether the file is not changed since it was saved in the snapshot.
+    // A file modified in the same second as the snapshot was taken
+    // may have the same size and modification time, it is taken as changed.
+    bool isUnchanged(const std::string& rel_path, uint64_t size, std::time_t mtime) const;
+
+    // check the size of the files copied in the snapshot, the linked files
+    // have been checked in the base snapshot.
+    bool verify(const bfs::path& snapshot_path) const;
+
+    void setSnapshotTime(std::time_t t)
+    {
+        snapshot_time_ = t;
+    }
+    std::time_t getSnapshotTime() const
+    {
+        return snapshot_time_;
+    }
+    const FileInfoMapT& getFileInfoMap() const
+    {
+        return file_info_map_;
+    }
+    const FileInfo* getFileInfo(const std::string& rel_path) const;
+    void addFile(const std::string& rel_path, const FileInfo& info)
+    {
+        file_info_map_[rel_path] = info;
+    }
+
+private:
+    std::time_t snapshot_time_;
+    FileInfoMapT file_info_map_;
+};
+
+// build an incremental backup snapshot. The file not changed since the base
+// snapshot is hard linked from it, the others are copied (or reflinked if
+// the file system supports). So the unchanged index files share the same
+// disk blocks among all the snapshots.
+class BackupSnapshot
+{
+public:
+    // if base_snapshot_path is empty or has no manifest, all files are copied.
+    BackupSnapshot(const bfs::path& snapshot_path, const bfs::path& base_snapshot_path);
+
+    // snapshot the files under src to rel_dest which is relative to the snapshot directory.
+    void addDir(const bfs::path& src, const bfs::path& rel_dest);
+    void addFile(const bfs::path& src, const bfs::path& rel_dest);
+
+    // save the manifest, should be called after all files added.
+    bool finish();
+
+    size_t getLinkedFileNum() const
+    {
+        return linked_num_;
+    }
+    size_t getCopiedFileNum() const
+    {
+        return copied_num_;
+    }
+
+    // copy or reflink the file, and keep the modification time.
+    static void copyFile(const bfs::path& from, const bfs::path& to);
+
+private:
+    bfs::path snapshot_path_;
+    bfs::path base_snapshot_path_;
+    BackupManifest base_manifest_;
+    BackupManifest manifest_;
+    size_t linked_num_;
+    size_t copied_num_;
+};
+
+}
+
+#endif
@@ -1,4 +1,5 @@
 #include "RecoveryChecker.h"
+#include "BackupSnapshot.h"
 #include "DistributeFileSyncMgr.h"
 #include "DistributeFileSys.h"
 #include "DistributeDriver.h"
@@ -47,7 +48,13 @@ public:
     }
     static bool isDirCopyOK(const std::string& dir)
     {
-        return !bfs::exists(dir + "/" + getGuardFileName());
+        if (bfs::exists(dir + "/" + getGuardFileName()))
+            return false;
+        // the backup without manifest is created by old version.
+        if (!bfs::exists(bfs::path(dir)/BackupManifest::getManifestFileName()))
+            return true;
+        BackupManifest manifest;
+        return manifest.load(dir) && manifest.verify(dir);
     }
     static void safe_remove_all(const std::string& dir)
     {
@@ -176,14 +183,13 @@ static bool getLastBackup(const bfs::path& backup_basepath, uint32_t less_than,
 
 static void copy_file_keep_modification(const bfs::path& from, const bfs::path& to)
 {
-    bfs::copy_file(from, to, bfs::copy_option::overwrite_if_exists);
-    try
-    {
-        bfs::last_write_time(to, bfs::last_write_time(from));
-    }catch(const std::exception& e){}
+    BackupSnapshot::copyFile(from, to);
 }
 
-static void copyDir(bfs::path src, bfs::path dest)
+// if manifest is given, src is the directory rel_src in the backup snapshot,
+// and the file in dest not changed since the snapshot will not be copied.
+static void copyDir(bfs::path src, bfs::path dest,
+    const BackupManifest* manifest = NULL, const bfs::path& rel_src = bfs::path())
 {
     if( !bfs::exists(src) ||
         !bfs::is_directory(src) )
@@ -208,13 +214,20 @@ static void copyDir(bfs::path src, bfs::path dest)
         if(bfs::is_directory(current))
         {
             // copy recursion
-            copyDir(current, dest / current.filename());
+            copyDir(current, dest / current.filename(), manifest, rel_src / current.filename());
         }
         else
         {
             if (current.filename().string().find("_removed.rollback") != std::string::npos)
                 continue;
 
+            bfs::path dest_file = dest / current.filename();
+            if (manifest && bfs::exists(dest_file) &&
+                manifest->isUnchanged((rel_src / current.filename()).string(),
+                    bfs::file_size(dest_file), bfs::last_write_time(dest_file)))
+            {
+                continue;
+            }
             DistributeTestSuit::testFail(Fail_At_CopyRemove_File);
             // Found file: Copy
             copy_file_keep_modification(current, dest / current.filename());
@@ -240,7 +253,8 @@ static void copyDir(bfs::path src, bfs::path dest)
 // with keep_full_path = false copy xxx/xxx/src_name to dest/src_name
 // if dest = xxx/xxx/xxx/src_name
 // then copy src to dest
-static void copy_dir(const bfs::path& src, const bfs::path& dest, bool keep_full_path = true)
+static void copy_dir(const bfs::path& src, const bfs::path& dest, bool keep_full_path = true,
+    const BackupManifest* manifest = NULL, const bfs::path& rel_src = bfs::path())
 {
     bfs::path dest_path = dest;
     if (src.filename() == dest_path.filename())
@@ -255,7 +269,7 @@ static void copy_dir(const bfs::path& src, const bfs::path& dest, bool keep_full
         dest_path /= src;
     }
     bfs::create_directories(dest_path);
-    copyDir(src, dest_path);
+    copyDir(src, dest_path, manifest, rel_src);
 }
 
 void RecoveryChecker::getCollList(std::vector<std::string>& coll_list)
@@ -346,12 +360,20 @@ bool RecoveryChecker::backup(bool force_remove)
         }
         CopyGuard::safe_remove_all(dest_path.string());
     }
+
+    // the unchanged files will be hard linked from the last backup.
+    std::string base_backup_path;
+    uint32_t base_backup_id = 0;
+    if (!getLastBackup(backup_basepath_, 0, base_backup_path, base_backup_id))
+        base_backup_path.clear();
+
     bfs::create_directories(dest_path);
 
     {
         CopyGuard dir_guard(dest_path.string());
 
         bfs::create_directories(dest_coldata_backup);
+        BackupSnapshot snapshot(dest_path, base_backup_path);
 
         // set invalide flag before do copy and
         // clear invalide flag after copy. So we can
@@ -365,7 +387,7 @@ bool RecoveryChecker::backup(bool force_remove)
                 flush_col_(cit->first);
 
             LOG(INFO) << "flush the collection finished.";
-            if(!backupColl(cit->second.first, dest_path))
+            if(!backupColl(cit->second.first, snapshot))
             {
                 return false;
             }
@@ -373,8 +395,8 @@ bool RecoveryChecker::backup(bool force_remove)
         }
         try
         {
-            copy_dir(request_log_basepath_, dest_path, false);
-            copy_file_keep_modification(last_conf_file_, dest_path/bfs::path(last_conf_file_).filename());
+            snapshot.addDir(request_log_basepath_, bfs::path(request_log_basepath_).filename());
+            snapshot.addFile(last_conf_file_, bfs::path(last_conf_file_).filename());
         }
         catch(const std::exception& e)
         {
@@ -382,6 +404,11 @@ bool RecoveryChecker::backup(bool force_remove)
             LOG(ERROR) << "backup request log failed. " << e.what() << std::endl;
             return false;
         }
+        if (!snapshot.finish())
+        {
+            LOG(ERROR) << "save backup manifest failed.";
+            return false;
+        }
         dir_guard.setOK();
     }
 
@@ -584,24 +611,15 @@ bool RecoveryChecker::redoLog(ReqLogMgr* redolog, uint32_t start_id, uint32_t en
     return ret;
 }
 
-bool RecoveryChecker::backupColl(const CollectionPath& colpath, const bfs::path& dest_path)
+bool RecoveryChecker::backupColl(const CollectionPath& colpath, BackupSnapshot& snapshot)
 {
-    // find all collection and backup.
-    bfs::path dest_coldata_backup = dest_path/bfs::path("backup_data");
-
-    if (!bfs::exists(dest_path))
-    {
-        bfs::create_directories(dest_path);
-        bfs::create_directories(dest_coldata_backup);
-    }
-
     bfs::path coldata_path(colpath.getCollectionDataPath());
     //bfs::path querydata_path(colpath.getQueryDataPath());
 
     try
     {
-        copy_dir(coldata_path, dest_coldata_backup);
-        //copy_dir(querydata_path, dest_coldata_backup);
+        snapshot.addDir(coldata_path, bfs::path("backup_data")/coldata_path);
+        //snapshot.addDir(querydata_path, bfs::path("backup_data")/querydata_path);
     }
     catch(const std::exception& e)
     {
@@ -676,7 +694,11 @@ bool RecoveryChecker::checkAndRestoreBackupFile(const CollectionPath& colpath)
             bfs::path coldata_path(colpath.getCollectionDataPath());
             //bfs::path querydata_path(colpath.getQueryDataPath());
 
-            copy_dir(dest_coldata_backup/coldata_path, coldata_path);
+            // only the files changed since the backup are restored.
+            BackupManifest manifest;
+            const BackupManifest* manifest_ptr = manifest.load(last_backup_path) ? &manifest : NULL;
+            copy_dir(dest_coldata_backup/coldata_path, coldata_path, true,
+                manifest_ptr, bfs::path("backup_data")/coldata_path);
             //copy_dir(dest_coldata_backup/querydata_path, querydata_path);
         }
         catch(const std::exception& e)
@@ -747,8 +769,10 @@ bool RecoveryChecker::rollbackLastFail(bool starting_up)
     if (has_backup)
     {
         // copy backup log to current .
+        BackupManifest manifest;
+        const BackupManifest* manifest_ptr = manifest.load(last_backup_path) ? &manifest : NULL;
         copy_dir(last_backup_path + bfs::path(request_log_basepath_).filename().c_str(),
-            request_log_basepath_, false);
+            request_log_basepath_, false, manifest_ptr, bfs::path(request_log_basepath_).filename());
     }
     if (has_backup && !starting_up)
     {
@@ -13,6 +13,7 @@ namespace sf1r
 
 class ReqLogMgr;
 class SF1Config;
+class BackupSnapshot;
 class RecoveryChecker
 {
 public:
@@ -79,7 +80,7 @@ private:
     typedef std::map<std::string, std::pair<CollectionPath, std::string> > CollInfoMapT;
     static void setForceExitFlag();
     bool isNeedRollback(bool starting_up);
-    bool backupColl(const CollectionPath& colpath, const bfs::path& dest_path);
+    bool backupColl(const CollectionPath& colpath, BackupSnapshot& snapshot);
     void syncToNewestReqLog();
     void syncSCDFiles();
     bool redoLog(ReqLogMgr* redolog, uint32_t start_id, uint32_t end_id);
@@ -40,7 +40,8 @@ SearchingModeInfo::SearchingModeInfo(void):
     useQueryPrune_(true),
     algorithm_(0),
     usePivilegeQuery_(false),
-    privilegeWeight_(0.1F)
+    privilegeWeight_(0.1F),
+    useDynamicPruning_(false)
 {
 }
 
@@ -53,6 +54,7 @@ void SearchingModeInfo::clear(void)
     usefuzzy_ = false;
     filtermode_ = SearchingMode::DefaultFilterMode;
     useQueryPrune_ = true;
+    useDynamicPruning_ = false;
 }
 
 } // end - namespace sf1r
@@ -170,6 +170,12 @@ public:
     std::string privilegeQuery_;
     float privilegeWeight_;
 
+    ///
+    /// @brief whether to skip documents which could not beat the current
+    /// top-k heap minimum, it only takes effect in WAND mode.
+    ///
+    bool useDynamicPruning_;
+
     /// @brief a constructor
     SearchingModeInfo(void);
 
@@ -177,10 +183,11 @@ public:
     void clear(void);
 
     DATA_IO_LOAD_SAVE(SearchingModeInfo, & mode_ & threshold_ & useFuzzyThreshold_ & fuzzyThreshold_ & tokensThreshold_
-                     & lucky_ & useOriginalQuery_ & usefuzzy_ & filtermode_ & useQueryPrune_ & algorithm_ & usePivilegeQuery_ & privilegeQuery_ & privilegeWeight_);
+                     & lucky_ & useOriginalQuery_ & usefuzzy_ & filtermode_ & useQueryPrune_ & algorithm_ & usePivilegeQuery_ & privilegeQuery_ & privilegeWeight_ & useDynamicPruning_);
 
     MSGPACK_DEFINE(mode_, threshold_, useFuzzyThreshold_, fuzzyThreshold_, tokensThreshold_, lucky_, useOriginalQuery_,
-                 usefuzzy_, filtermode_, useQueryPrune_, algorithm_, usePivilegeQuery_, privilegeQuery_, privilegeWeight_);
+                 usefuzzy_, filtermode_, useQueryPrune_, algorithm_, usePivilegeQuery_, privilegeQuery_, privilegeWeight_,
+                 useDynamicPruning_);
 
 private:
     // Log : 2009.09.08
@@ -203,6 +210,7 @@ private:
         ar & usePivilegeQuery_;
         ar & privilegeQuery_;
         ar & privilegeWeight_;
+        ar & useDynamicPruning_;
     }
 };
 
@@ -222,7 +230,8 @@ inline bool operator==(const SearchingModeInfo& a,
         && a.algorithm_ == b.algorithm_ 
         && a.usePivilegeQuery_ == b.usePivilegeQuery_
         && a.privilegeQuery_ == b.privilegeQuery_
-        && a.privilegeWeight_ == b.privilegeWeight_;
+        && a.privilegeWeight_ == b.privilegeWeight_
+        && a.useDynamicPruning_ == b.useDynamicPruning_;
 }
 
 } // end - namespace sf1r
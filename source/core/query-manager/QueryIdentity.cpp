@@ -0,0 +1,106 @@
+#include "QueryIdentity.h"
+#include <boost/algorithm/string/case_conv.hpp>
+
+namespace sf1r
+{
+
+namespace
+{
+
+const std::string kRankPropName("_rank");
+
+/**
+ * @return true if the query might be scored or reranked by product ranking,
+ *         see SearchManagerPreProcessor::createProductScorer().
+ */
+bool isProductRankQuery(const QueryIdentity& identity)
+{
+    const SearchingMode::SearchingModeType mode = identity.searchingMode.mode_;
+    if (mode == SearchingMode::SUFFIX_MATCH || mode == SearchingMode::ZAMBEZI)
+        return true;
+
+    for (std::vector<std::pair<std::string, bool> >::const_iterator it =
+            identity.sortInfo.begin(); it != identity.sortInfo.end(); ++it)
+    {
+        if (boost::to_lower_copy(it->first) == kRankPropName)
+            return true;
+    }
+
+    return false;
+}
+
+void getFilterProperties(
+    const ConditionsNode& filterTree,
+    std::set<std::string>& properties)
+{
+    for (std::vector<QueryFiltering::FilteringType>::const_iterator it =
+            filterTree.conditionLeafList_.begin();
+        it != filterTree.conditionLeafList_.end(); ++it)
+    {
+        properties.insert(it->property_);
+    }
+
+    for (std::vector<ConditionsNode>::const_iterator it =
+            filterTree.conditionsNodeList_.begin();
+        it != filterTree.conditionsNodeList_.end(); ++it)
+    {
+        getFilterProperties(*it, properties);
+    }
+}
+
+}
+
+bool QueryIdentity::getDependentProperties(
+    const std::set<std::string>& productRankProps,
+    std::set<std::string>& dependentProps) const
+{
+    if (groupParam.isAttrGroup_ || !groupParam.attrLabels_.empty() ||
+        !groupParam.boostGroupLabels_.empty() ||
+        !geohash.empty() || !querySource.empty() || !strExp.empty())
+    {
+        return false;
+    }
+
+    dependentProps.insert(properties.begin(), properties.end());
+    dependentProps.insert(counterList.begin(), counterList.end());
+
+    for (std::vector<std::pair<std::string, bool> >::const_iterator it =
+            sortInfo.begin(); it != sortInfo.end(); ++it)
+    {
+        dependentProps.insert(it->first);
+    }
+
+    getFilterProperties(filterTree, dependentProps);
+
+    for (std::vector<faceted::GroupPropParam>::const_iterator it =
+            groupParam.groupProps_.begin();
+        it != groupParam.groupProps_.end(); ++it)
+    {
+        dependentProps.insert(it->property_);
+        if (!it->subProperty_.empty())
+        {
+            dependentProps.insert(it->subProperty_);
+        }
+    }
+
+    for (faceted::GroupParam::GroupLabelMap::const_iterator it =
+            groupParam.groupLabels_.begin();
+        it != groupParam.groupLabels_.end(); ++it)
+    {
+        dependentProps.insert(it->first);
+    }
+
+    if (!rangeProperty.empty())
+    {
+        dependentProps.insert(rangeProperty);
+    }
+
+    if (isProductRankQuery(*this))
+    {
+        dependentProps.insert(productRankProps.begin(), productRankProps.end());
+    }
+
+    return true;
+}
+
+} // namespace sf1r
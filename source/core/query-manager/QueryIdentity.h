@@ -10,6 +10,7 @@
 
 #include "ActionItem.h"
 #include <glog/logging.h>
+#include <set>
 namespace sf1r {
 
 struct QueryIdentity
@@ -93,6 +94,20 @@ struct QueryIdentity
     ///        the categories to boost in product ranking.
     std::string querySource;
 
+    /**
+     * @brief get the properties the search result depends on, that is, the
+     *        properties used in search, filter, sort, group and ranking.
+     * @param productRankProps the properties used in product ranking, they
+     *        are added if the query might be ranked by product ranking.
+     * @return false if the dependent properties are unknown, such as the
+     *         properties used in attribute group, custom ranking and geo
+     *         ranking, in this case, it should be assumed to depend on all
+     *         properties.
+     */
+    bool getDependentProperties(
+        const std::set<std::string>& productRankProps,
+        std::set<std::string>& dependentProps) const;
+
     inline bool operator==(const QueryIdentity& other) const
     {
         return rankingType == other.rankingType
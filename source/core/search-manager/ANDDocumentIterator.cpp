@@ -87,6 +87,17 @@ float ANDDocumentIterator::getUB()
     return sumUB / (1 - missRate_);
 }
 
+count_t ANDDocumentIterator::getPrunedDocCount()
+{
+    count_t prunedCount = 0;
+    std::list<DocumentIterator*>::iterator it = docIterList_.begin();
+    for (; it != docIterList_.end(); it++)
+    {
+        prunedCount += (*it)->getPrunedDocCount();
+    }
+    return prunedCount;
+}
+
 count_t ANDDocumentIterator::tf()
 {
     DocumentIterator* pEntry;
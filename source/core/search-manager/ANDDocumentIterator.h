@@ -91,6 +91,8 @@ public:
     
     float getUB();
 
+    count_t getPrunedDocCount();
+
     const char* getProperty()
     {
         if (docIterList_.begin() == docIterList_.end())
@@ -25,6 +25,17 @@ public:
         return ANDDocumentIterator::next();
     }
 
+    // the filter members make no contribution to score,
+    // so the threshold is passed to each member unchanged
+    void setThreshold(float threshold)
+    {
+        std::list<DocumentIterator*>::iterator it = docIterList_.begin();
+        for (; it != docIterList_.end(); ++it)
+        {
+            (*it)->setThreshold(threshold);
+        }
+    }
+
 };
 
 }
@@ -0,0 +1,294 @@
+#include "CustomRankProgram.h"
+#include <cmath>
+#include <algorithm> // min, max, copy
+
+using namespace sf1r;
+
+namespace
+{
+/** the stack not deeper than this is allocated on the thread stack */
+const std::size_t kMaxLocalDepth = 16;
+
+inline double applyOperator(CustomRankProgram::OpCode op, double x, double y)
+{
+    switch (op)
+    {
+    case CustomRankProgram::SUM:
+        return x + y;
+    case CustomRankProgram::SUB:
+        return x - y;
+    case CustomRankProgram::PRODUCT:
+        return x * y;
+    case CustomRankProgram::DIV:
+        return x / y;
+    case CustomRankProgram::LOG:
+        return std::log(x);
+    case CustomRankProgram::POW:
+        return std::pow(x, y);
+    case CustomRankProgram::SQRT:
+        return std::sqrt(x);
+    default:
+        return 0;
+    }
+}
+
+std::size_t getOperandNum(CustomRankProgram::OpCode op)
+{
+    switch (op)
+    {
+    case CustomRankProgram::PUSH_CONST:
+    case CustomRankProgram::PUSH_PROP:
+        return 0;
+    case CustomRankProgram::LOG:
+    case CustomRankProgram::SQRT:
+        return 1;
+    default:
+        return 2;
+    }
+}
+}
+
+bool CustomRankProgram::compile(const ExpSyntaxTree& root)
+{
+    instructions_.clear();
+    maxDepth_ = 0;
+
+    if (root.children_.empty() || !root.children_[0])
+        return false;
+
+    if (!compileNode_(*root.children_[0]))
+    {
+        instructions_.clear();
+        return false;
+    }
+
+    std::size_t depth = 0;
+    for (std::vector<Instruction>::const_iterator it = instructions_.begin();
+         it != instructions_.end(); ++it)
+    {
+        const std::size_t operandNum = getOperandNum(it->op_);
+        depth = depth - operandNum + 1;
+        maxDepth_ = std::max(maxDepth_, depth);
+    }
+
+    return true;
+}
+
+bool CustomRankProgram::compileNode_(const ExpSyntaxTree& node)
+{
+    OpCode op = PUSH_CONST;
+
+    switch (node.type_)
+    {
+    case ExpSyntaxTree::CONSTANT:
+        instructions_.push_back(Instruction(PUSH_CONST, node.value_));
+        return true;
+
+    case ExpSyntaxTree::PARAMETER:
+        if (node.propertyData_)
+            instructions_.push_back(Instruction(PUSH_PROP, 0, node.propertyData_.get()));
+        else
+            instructions_.push_back(Instruction(PUSH_CONST, 0));
+        return true;
+
+    case ExpSyntaxTree::SUM:
+        op = SUM;
+        break;
+    case ExpSyntaxTree::SUB:
+        op = SUB;
+        break;
+    case ExpSyntaxTree::PRODUCT:
+        op = PRODUCT;
+        break;
+    case ExpSyntaxTree::DIV:
+        op = DIV;
+        break;
+    case ExpSyntaxTree::LOG:
+        op = LOG;
+        break;
+    case ExpSyntaxTree::POW:
+        op = POW;
+        break;
+    case ExpSyntaxTree::SQRT:
+        op = SQRT;
+        break;
+
+    default:
+        return false;
+    }
+
+    const std::size_t operandNum = getOperandNum(op);
+    if (node.children_.size() < operandNum)
+        return false;
+
+    for (std::size_t i = 0; i < operandNum; ++i)
+    {
+        if (!node.children_[i] || !compileNode_(*node.children_[i]))
+            return false;
+    }
+
+    appendOperator_(op, operandNum);
+    return true;
+}
+
+void CustomRankProgram::appendOperator_(OpCode op, std::size_t operandNum)
+{
+    const std::size_t size = instructions_.size();
+
+    // as each constant operand has been folded into one instruction,
+    // the operands are all constant if the last instructions are constant
+    for (std::size_t i = size - operandNum; i < size; ++i)
+    {
+        if (instructions_[i].op_ != PUSH_CONST)
+        {
+            instructions_.push_back(Instruction(op));
+            return;
+        }
+    }
+
+    const double x = instructions_[size - operandNum].value_;
+    const double y = operandNum > 1 ? instructions_[size - 1].value_ : 0;
+
+    instructions_.resize(size - operandNum, Instruction(PUSH_CONST));
+    instructions_.push_back(Instruction(PUSH_CONST, applyOperator(op, x, y)));
+}
+
+double CustomRankProgram::evaluate(docid_t docid) const
+{
+    if (instructions_.empty())
+        return 0;
+
+    double localStack[kMaxLocalDepth];
+    std::vector<double> heapStack;
+    double* stack = localStack;
+
+    if (maxDepth_ > kMaxLocalDepth)
+    {
+        heapStack.resize(maxDepth_);
+        stack = &heapStack[0];
+    }
+
+    std::size_t top = 0;
+    for (std::vector<Instruction>::const_iterator it = instructions_.begin();
+         it != instructions_.end(); ++it)
+    {
+        switch (it->op_)
+        {
+        case PUSH_CONST:
+            stack[top++] = it->value_;
+            break;
+
+        case PUSH_PROP:
+            if (!it->table_->getDoubleValue(docid, stack[top]))
+                stack[top] = 0;
+            ++top;
+            break;
+
+        case LOG:
+        case SQRT:
+            stack[top-1] = applyOperator(it->op_, stack[top-1], 0);
+            break;
+
+        default:
+            --top;
+            stack[top-1] = applyOperator(it->op_, stack[top-1], stack[top]);
+            break;
+        }
+    }
+
+    return stack[0];
+}
+
+void CustomRankProgram::evaluate(
+    const docid_t* docids,
+    std::size_t num,
+    double* scores) const
+{
+    if (instructions_.empty())
+    {
+        std::fill(scores, scores + num, 0);
+        return;
+    }
+
+    double localStack[kMaxLocalDepth * kBlockSize];
+    std::vector<double> heapStack;
+    double* stack = localStack;
+
+    if (maxDepth_ > kMaxLocalDepth)
+    {
+        heapStack.resize(maxDepth_ * kBlockSize);
+        stack = &heapStack[0];
+    }
+
+    for (std::size_t i = 0; i < num; i += kBlockSize)
+    {
+        const std::size_t blockNum = std::min<std::size_t>(kBlockSize, num - i);
+        evaluateBlock_(docids + i, blockNum, stack, scores + i);
+    }
+}
+
+void CustomRankProgram::evaluateBlock_(
+    const docid_t* docids,
+    std::size_t num,
+    double* stack,
+    double* scores) const
+{
+    std::size_t top = 0;
+
+    for (std::vector<Instruction>::const_iterator it = instructions_.begin();
+         it != instructions_.end(); ++it)
+    {
+        double* x = stack + (top - getOperandNum(it->op_)) * kBlockSize;
+        double* y = x + kBlockSize;
+
+        switch (it->op_)
+        {
+        case PUSH_CONST:
+            std::fill(x, x + num, it->value_);
+            break;
+
+        case PUSH_PROP:
+            it->table_->getDoubleValues(docids, num, x, 0);
+            break;
+
+        case SUM:
+            for (std::size_t i = 0; i < num; ++i)
+                x[i] += y[i];
+            break;
+
+        case SUB:
+            for (std::size_t i = 0; i < num; ++i)
+                x[i] -= y[i];
+            break;
+
+        case PRODUCT:
+            for (std::size_t i = 0; i < num; ++i)
+                x[i] *= y[i];
+            break;
+
+        case DIV:
+            for (std::size_t i = 0; i < num; ++i)
+                x[i] /= y[i];
+            break;
+
+        case LOG:
+            for (std::size_t i = 0; i < num; ++i)
+                x[i] = std::log(x[i]);
+            break;
+
+        case POW:
+            for (std::size_t i = 0; i < num; ++i)
+                x[i] = std::pow(x[i], y[i]);
+            break;
+
+        case SQRT:
+            for (std::size_t i = 0; i < num; ++i)
+                x[i] = std::sqrt(x[i]);
+            break;
+        }
+
+        top = top - getOperandNum(it->op_) + 1;
+    }
+
+    std::copy(stack, stack + num, scores);
+}
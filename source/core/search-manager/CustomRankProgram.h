@@ -0,0 +1,104 @@
+/**
+ * @file CustomRankProgram.h
+ * @brief the custom ranking expression compiled into a flat stack program.
+ *
+ * The expression syntax tree is compiled once per query, the constant
+ * sub-expressions are folded, and the property parameters are resolved
+ * to the property tables. The program could be run for one doc, or for
+ * a block of docs, where each instruction is a tight loop over the block.
+ */
+
+#ifndef SF1R_CUSTOM_RANK_PROGRAM_H
+#define SF1R_CUSTOM_RANK_PROGRAM_H
+
+#include "CustomRankTreeParser.h"
+#include <common/inttypes.h>
+#include <vector>
+
+namespace sf1r
+{
+
+class CustomRankProgram
+{
+public:
+    enum OpCode
+    {
+        PUSH_CONST,  // push value_
+        PUSH_PROP,   // push the value in table_
+        SUM,
+        SUB,
+        PRODUCT,
+        DIV,
+        LOG,
+        POW,
+        SQRT
+    };
+
+    struct Instruction
+    {
+        OpCode op_;
+        double value_;
+        const NumericPropertyTableBase* table_;
+
+        Instruction(OpCode op, double value = 0,
+                    const NumericPropertyTableBase* table = NULL)
+            : op_(op), value_(value), table_(table)
+        {}
+    };
+
+    /** the max number of docs evaluated in one block */
+    enum { kBlockSize = 64 };
+
+    CustomRankProgram() : maxDepth_(0) {}
+
+    /**
+     * compile the expression tree.
+     * @param root the ROOT node of expression tree, the PARAMETER node
+     *        without property data is evaluated as zero
+     * @return false if the tree is not valid
+     */
+    bool compile(const ExpSyntaxTree& root);
+
+    bool empty() const { return instructions_.empty(); }
+
+    const std::vector<Instruction>& getInstructions() const
+    {
+        return instructions_;
+    }
+
+    /**
+     * evaluate the score of one doc.
+     */
+    double evaluate(docid_t docid) const;
+
+    /**
+     * evaluate the scores of @p num docs.
+     */
+    void evaluate(const docid_t* docids, std::size_t num, double* scores) const;
+
+private:
+    /**
+     * append the instructions of @p node.
+     * @return false if the node is not valid
+     */
+    bool compileNode_(const ExpSyntaxTree& node);
+
+    /**
+     * the instructions are appended for the operator node, if its
+     * operands are all constant, they are replaced by the result.
+     */
+    void appendOperator_(OpCode op, std::size_t operandNum);
+
+    void evaluateBlock_(const docid_t* docids, std::size_t num,
+                        double* stack, double* scores) const;
+
+private:
+    std::vector<Instruction> instructions_;
+
+    /** the max stack depth while running the program */
+    std::size_t maxDepth_;
+};
+
+} // namespace sf1r
+
+#endif // SF1R_CUSTOM_RANK_PROGRAM_H
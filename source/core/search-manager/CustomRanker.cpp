@@ -34,7 +34,16 @@ bool CustomRanker::parse(std::string& strExp)
     }
 
     ESTree_->children_.clear();
-    return buildExpSyntaxTree(info.trees, ESTree_);
+    if (!buildExpSyntaxTree(info.trees, ESTree_))
+        return false;
+
+    // the parameters are evaluated as zero until property data is set
+    if (!program_.compile(*ESTree_))
+    {
+        errorInfo_ = "Failed to compile custom_rank[expression] \"" + strExp + "\"";
+        return false;
+    }
+    return true;
 }
 
 /// private ////////////////////////////////////////////////////////////////////
@@ -126,7 +135,15 @@ bool CustomRanker::setPropertyData(NumericPropertyTableBuilder* numericTableBuil
         return false;
     }
 
-    return setInnerPropertyData(ESTree_, *numericTableBuilder);
+    if (!setInnerPropertyData(ESTree_, *numericTableBuilder))
+        return false;
+
+    if (!program_.compile(*ESTree_))
+    {
+        errorInfo_ = "Failed to compile custom_rank[expression] \"" + strExp_ + "\"";
+        return false;
+    }
+    return true;
 }
 
 bool CustomRanker::setInnerPropertyData(
@@ -158,96 +175,6 @@ bool CustomRanker::setInnerPropertyData(
     return true;
 }
 
-bool CustomRanker::sub_evaluate(ExpSyntaxTreePtr& estree, docid_t& docid)
-{
-    ExpSyntaxTree::NodeType type = estree->type_;
-
-    switch (type)
-    {
-    case ExpSyntaxTree::ROOT:
-    {
-        sub_evaluate(estree->children_[0], docid);
-        estree->value_ = estree->children_[0]->value_;
-        break;
-    }
-    case ExpSyntaxTree::CONSTANT:
-    {
-        // constant value has been set already
-        return true;
-    }
-    case ExpSyntaxTree::PARAMETER:
-    {
-        if (! estree->propertyData_)
-            break;
-
-        estree->propertyData_->getDoubleValue(docid, estree->value_);
-        //cout << "CustomRanker::sub_evaluate docid(" << docid << ") get property \"" << estree->name_ << "\" data value: " << estree->value_ <<endl;
-        break;
-    }
-    case ExpSyntaxTree::SUM:
-    {
-        sub_evaluate(estree->children_[0], docid);
-        estree->value_ = estree->children_[0]->value_;
-        sub_evaluate(estree->children_[1], docid);
-        estree->value_ += estree->children_[1]->value_;
-        break;
-    }
-    case ExpSyntaxTree::SUB:
-    {
-        sub_evaluate(estree->children_[0], docid);
-        estree->value_ = estree->children_[0]->value_;
-        sub_evaluate(estree->children_[1], docid);
-        estree->value_ -= estree->children_[1]->value_;
-        break;
-    }
-    case ExpSyntaxTree::PRODUCT:
-    {
-        sub_evaluate(estree->children_[0], docid);
-        estree->value_ = estree->children_[0]->value_;
-        sub_evaluate(estree->children_[1], docid);
-        estree->value_ *= estree->children_[1]->value_;
-        break;
-    }
-    case ExpSyntaxTree::DIV:
-    {
-        sub_evaluate(estree->children_[0], docid);
-        estree->value_ = estree->children_[0]->value_;
-        sub_evaluate(estree->children_[1], docid);
-        if (estree->children_[1]->value_ < 1e-8 && estree->children_[1]->value_ > -1e-8)
-        {
-            errorInfo_ = "*Waring: division by zero, got zero from \"" + estree->children_[1]->name_ + "\"";
-            cout << errorInfo_ << endl;
-        }
-        estree->value_ /= estree->children_[1]->value_;
-        break;
-    }
-    case ExpSyntaxTree::LOG:
-    {
-        sub_evaluate(estree->children_[0], docid);
-        estree->value_ = std::log(estree->children_[0]->value_);
-        break;
-    }
-    case ExpSyntaxTree::POW:
-    {
-        sub_evaluate(estree->children_[0], docid);
-        sub_evaluate(estree->children_[1], docid);
-        estree->value_ = std::pow(estree->children_[0]->value_, estree->children_[1]->value_);
-        break;
-    }
-    case ExpSyntaxTree::SQRT:
-    {
-        sub_evaluate(estree->children_[0], docid);
-        estree->value_ = std::sqrt(estree->children_[0]->value_);
-        break;
-    }
-    default:
-        break;
-    }
-
-    return true;
-}
-
-
 void CustomRanker::showBoostAST(const ast_info_trees& trees, int level)
 {
     if (level == 0)
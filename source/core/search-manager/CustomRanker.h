@@ -11,6 +11,7 @@
 #include <boost/lexical_cast.hpp>
 
 #include <search-manager/CustomRankTreeParser.h>
+#include <search-manager/CustomRankProgram.h>
 
 #include <common/inttypes.h>
 #include <util/ustring/UString.h>
@@ -46,6 +47,9 @@ private:
     CustomRankTreeParser customRankTreeParser_;
     ExpSyntaxTreePtr ESTree_;
 
+    // the expression compiled from ESTree_
+    CustomRankProgram program_;
+
     // error info
     std::string errorInfo_;
 
@@ -176,11 +180,20 @@ public:
      * @param docid the id of document to be evaluated
      * @return score
      */
-    double evaluate(docid_t& docid)
+    double evaluate(docid_t& docid) const
     {
-        sub_evaluate(ESTree_, docid);
-        //cout << "CustomRanker::evaluate(" << docid << ") = " <<  ESTree_->value_ <<endl; //test
-        return ESTree_->value_;
+        return program_.evaluate(docid);
+    }
+
+    /**
+     * @brief Evaluate the custom ranking scores for a block of documents
+     * @param docids the ids of documents to be evaluated
+     * @param num the number of documents
+     * @param scores the scores output
+     */
+    void evaluate(const docid_t* docids, std::size_t num, double* scores) const
+    {
+        program_.evaluate(docids, num, scores);
     }
 
 private:
@@ -196,12 +209,6 @@ private:
         ExpSyntaxTreePtr& estree,
         NumericPropertyTableBuilder& numericTableBuilder);
 
-    /**
-     * @brief evaluate custom ranking score recursively from EST
-     * the return value may be meaningless currently.
-     */
-    bool sub_evaluate(ExpSyntaxTreePtr& estree, docid_t& docid);
-
     /**
      * @brief remove front and trailing space
      */
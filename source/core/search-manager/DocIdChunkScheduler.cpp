@@ -0,0 +1,186 @@
+#include "DocIdChunkScheduler.h"
+
+#include <algorithm>
+
+using namespace sf1r;
+
+namespace
+{
+/** each thread claims about this number of batches */
+const std::size_t kBatchNumPerThread = 4;
+}
+
+void DocIdChunkStats::merge(const DocIdChunkStats& other)
+{
+    chunkNum += other.chunkNum;
+    stealNum += other.stealNum;
+    totalChunkTime += other.totalChunkTime;
+    maxChunkTime = std::max(maxChunkTime, other.maxChunkTime);
+}
+
+DocIdChunkScheduler::DocIdChunkScheduler(
+    docid_t docNum,
+    std::size_t threadNum,
+    std::size_t chunkNum)
+    : docNum_(docNum)
+    , chunkNum_(std::max<std::size_t>(std::min<std::size_t>(
+                    std::max(chunkNum, threadNum), docNum), 1))
+    , batchSize_(std::max<std::size_t>(chunkNum_ /
+                    (std::max<std::size_t>(threadNum, 1) * kBatchNumPerThread), 1))
+    , nextBatchChunk_(0)
+{
+    threadNum = std::max<std::size_t>(threadNum, 1);
+    threads_.resize(threadNum);
+
+    for (std::size_t i = 0; i < threadNum; ++i)
+    {
+        threads_[i].reset(new ThreadState);
+    }
+}
+
+bool DocIdChunkScheduler::nextChunk(
+    std::size_t threadId,
+    docid_t& docIdBegin,
+    docid_t& docIdEnd)
+{
+    ThreadState& state = *threads_[threadId];
+    finishChunk_(state);
+
+    std::size_t chunk = 0;
+    if (!popFront_(state, chunk) &&
+        !claimBatch_(state, chunk) &&
+        !steal_(threadId, chunk))
+        return false;
+
+    state.positionChunk = chunk + 1;
+    state.isChunkRunning = true;
+    state.chunkTimer.restart();
+
+    getChunkRange_(chunk, docIdBegin, docIdEnd);
+    return true;
+}
+
+void DocIdChunkScheduler::finishChunk(std::size_t threadId)
+{
+    finishChunk_(*threads_[threadId]);
+}
+
+void DocIdChunkScheduler::finishChunk_(ThreadState& state)
+{
+    if (!state.isChunkRunning)
+        return;
+
+    double elapsed = state.chunkTimer.elapsed();
+    DocIdChunkStats& stats = state.stats;
+
+    ++stats.chunkNum;
+    stats.totalChunkTime += elapsed;
+    stats.maxChunkTime = std::max(stats.maxChunkTime, elapsed);
+
+    state.isChunkRunning = false;
+}
+
+bool DocIdChunkScheduler::popFront_(ThreadState& state, std::size_t& chunk)
+{
+    boost::mutex::scoped_lock lock(state.mutex);
+
+    if (state.frontChunk >= state.backChunk)
+        return false;
+
+    chunk = state.frontChunk++;
+    return true;
+}
+
+bool DocIdChunkScheduler::claimBatch_(ThreadState& state, std::size_t& chunk)
+{
+    // once all batches are claimed, the value only grows beyond chunkNum_
+    if (nextBatchChunk_.load() >= chunkNum_)
+        return false;
+
+    const std::size_t batchBegin = nextBatchChunk_.fetch_add(batchSize_);
+    if (batchBegin >= chunkNum_)
+        return false;
+
+    boost::mutex::scoped_lock lock(state.mutex);
+    chunk = batchBegin;
+    state.frontChunk = batchBegin + 1;
+    state.backChunk = std::min(batchBegin + batchSize_, chunkNum_);
+    return true;
+}
+
+bool DocIdChunkScheduler::steal_(std::size_t threadId, std::size_t& chunk)
+{
+    ThreadState& thief = *threads_[threadId];
+    const std::size_t threadNum = threads_.size();
+
+    while (true)
+    {
+        std::size_t victimId = threadNum;
+        std::size_t maxStealNum = 0;
+
+        for (std::size_t i = 0; i < threadNum; ++i)
+        {
+            if (i == threadId)
+                continue;
+
+            ThreadState& victim = *threads_[i];
+            boost::mutex::scoped_lock lock(victim.mutex);
+
+            std::size_t stealBegin = getStealBegin_(victim, thief.positionChunk);
+            if (stealBegin < victim.backChunk &&
+                victim.backChunk - stealBegin > maxStealNum)
+            {
+                maxStealNum = victim.backChunk - stealBegin;
+                victimId = i;
+            }
+        }
+
+        if (victimId == threadNum)
+            return false;
+
+        std::size_t stealBegin = 0;
+        std::size_t stealEnd = 0;
+        {
+            ThreadState& victim = *threads_[victimId];
+            boost::mutex::scoped_lock lock(victim.mutex);
+
+            stealBegin = getStealBegin_(victim, thief.positionChunk);
+            stealEnd = victim.backChunk;
+
+            // the victim has been changed by other threads, try again
+            if (stealBegin >= stealEnd)
+                continue;
+
+            victim.backChunk = stealBegin;
+        }
+
+        boost::mutex::scoped_lock lock(thief.mutex);
+        chunk = stealBegin;
+        thief.frontChunk = stealBegin + 1;
+        thief.backChunk = stealEnd;
+        ++thief.stats.stealNum;
+        return true;
+    }
+}
+
+std::size_t DocIdChunkScheduler::getStealBegin_(
+    const ThreadState& victim,
+    std::size_t positionChunk) const
+{
+    if (victim.frontChunk >= victim.backChunk)
+        return victim.backChunk;
+
+    std::size_t halfBegin = victim.frontChunk +
+        (victim.backChunk - victim.frontChunk) / 2;
+
+    return std::max(halfBegin, positionChunk);
+}
+
+void DocIdChunkScheduler::getChunkRange_(
+    std::size_t chunk,
+    docid_t& docIdBegin,
+    docid_t& docIdEnd) const
+{
+    docIdBegin = static_cast<uint64_t>(docNum_) * chunk / chunkNum_;
+    docIdEnd = static_cast<uint64_t>(docNum_) * (chunk+1) / chunkNum_;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file DocIdChunkScheduler.h
+ * @brief schedule the docid chunks among search threads by work stealing.
+ *
+ * The docid range [0, maxDocId] is split into many small chunks, which are
+ * claimed by the threads in batches of contiguous chunks in docid order.
+ * Each thread consumes its batch from the front. Once a thread runs out of
+ * its batch and no batch is left to claim, it steals the back half of the
+ * remaining chunks from the busiest thread.
+ *
+ * As a DocumentIterator could only move forward, the chunks assigned to one
+ * thread are always in ascending docid order, that is, a thread only steals
+ * the chunks after the ones it has searched. As the batches are claimed in
+ * docid order, no thread is fixed to the tail of the docid range, so that
+ * every thread could steal from the threads ahead of it.
+ */
+
+#ifndef SF1R_DOCID_CHUNK_SCHEDULER_H
+#define SF1R_DOCID_CHUNK_SCHEDULER_H
+
+#include <common/inttypes.h>
+#include <util/ClockTimer.h>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/atomic.hpp>
+
+namespace sf1r
+{
+
+/**
+ * the statistics of one search thread.
+ */
+struct DocIdChunkStats
+{
+    /** the number of chunks searched */
+    std::size_t chunkNum;
+
+    /** the number of steals from other threads */
+    std::size_t stealNum;
+
+    /** the total seconds spent on all chunks */
+    double totalChunkTime;
+
+    /** the maximum seconds spent on one chunk */
+    double maxChunkTime;
+
+    DocIdChunkStats()
+        : chunkNum(0)
+        , stealNum(0)
+        , totalChunkTime(0)
+        , maxChunkTime(0)
+    {}
+
+    void merge(const DocIdChunkStats& other);
+};
+
+class DocIdChunkScheduler
+{
+public:
+    /**
+     * @param docNum the docid range is [0, @p docNum)
+     * @param threadNum the number of search threads
+     * @param chunkNum the number of chunks, it would be no less than
+     *        @p threadNum
+     */
+    DocIdChunkScheduler(
+        docid_t docNum,
+        std::size_t threadNum,
+        std::size_t chunkNum);
+
+    /**
+     * get the next chunk for thread @p threadId, it also means the
+     * previous chunk of this thread is finished.
+     * @param threadId the thread id in [0, threadNum)
+     * @param docIdBegin [OUT] the begin docid of the chunk
+     * @param docIdEnd [OUT] the end docid of the chunk (not included)
+     * @return true for success, false for no chunk is available.
+     */
+    bool nextChunk(
+        std::size_t threadId,
+        docid_t& docIdBegin,
+        docid_t& docIdEnd);
+
+    /**
+     * only record the current chunk of thread @p threadId is finished,
+     * it is called when the thread stops searching.
+     */
+    void finishChunk(std::size_t threadId);
+
+    const DocIdChunkStats& getStats(std::size_t threadId) const
+    {
+        return threads_[threadId]->stats;
+    }
+
+    std::size_t getChunkNum() const { return chunkNum_; }
+
+    std::size_t getBatchSize() const { return batchSize_; }
+
+private:
+    struct ThreadState
+    {
+        boost::mutex mutex;
+
+        /** the owned chunks are [frontChunk, backChunk) */
+        std::size_t frontChunk;
+        std::size_t backChunk;
+
+        /** the chunks before this one have been searched by this thread */
+        std::size_t positionChunk;
+
+        bool isChunkRunning;
+        izenelib::util::ClockTimer chunkTimer;
+
+        DocIdChunkStats stats;
+
+        ThreadState()
+            : frontChunk(0)
+            , backChunk(0)
+            , positionChunk(0)
+            , isChunkRunning(false)
+        {}
+    };
+
+    typedef boost::shared_ptr<ThreadState> ThreadStatePtr;
+
+    void finishChunk_(ThreadState& state);
+
+    bool popFront_(ThreadState& state, std::size_t& chunk);
+
+    /**
+     * claim the next batch of chunks in docid order.
+     */
+    bool claimBatch_(ThreadState& state, std::size_t& chunk);
+
+    bool steal_(std::size_t threadId, std::size_t& chunk);
+
+    /**
+     * @return the chunk range could be stolen from @p victim by a thread
+     *         whose position is @p positionChunk.
+     */
+    std::size_t getStealBegin_(
+        const ThreadState& victim,
+        std::size_t positionChunk) const;
+
+    void getChunkRange_(
+        std::size_t chunk,
+        docid_t& docIdBegin,
+        docid_t& docIdEnd) const;
+
+private:
+    const docid_t docNum_;
+
+    const std::size_t chunkNum_;
+
+    const std::size_t batchSize_;
+
+    /** the first chunk not claimed yet */
+    boost::atomic<std::size_t> nextBatchChunk_;
+
+    std::vector<ThreadStatePtr> threads_;
+};
+
+} // namespace sf1r
+
+#endif // SF1R_DOCID_CHUNK_SCHEDULER_H
@@ -110,6 +110,15 @@ public:
         return;
     }
 
+    /**
+     * @return the number of candidate postings passed over without being
+     *         scored, because their upper bound could not exceed the threshold.
+     */
+    virtual count_t getPrunedDocCount()
+    {
+        return 0;
+    }
+
     void setMissRate(float missRate)
     {
         missRate_ = missRate;
@@ -8,6 +8,7 @@
 
 #include <query-manager/ActionItem.h>
 #include <index-manager/InvertedIndexManager.h>
+#include <common/PropertyGenerations.h>
 #include <cache/IzeneCache.h>
 
 #include <boost/shared_ptr.hpp>
@@ -32,29 +33,73 @@ public:
 
     bool get(const key_type& key, value_type& value)
     {
-        return cache_.getValueNoInsert(key, value);
+        CacheEntry entry;
+        if (!cache_.getValueNoInsert(key, entry) ||
+            !generations_.isValid(entry.snapshot))
+            return false;
+
+        value = entry.value;
+        return true;
+    }
+
+    /**
+     * take the current generation of the property in @p key,
+     * it should be called before making the filter bitmap.
+     */
+    void takeSnapshot(const key_type& key, GenerationSnapshot& snapshot) const
+    {
+        std::set<std::string> dependentProps;
+        dependentProps.insert(key.property_);
+        generations_.takeSnapshot(&dependentProps, snapshot);
     }
 
-    void set(const key_type& key, value_type value)
+    /**
+     * @param snapshot the generation taken before making @p value
+     */
+    void set(const key_type& key, value_type value, const GenerationSnapshot& snapshot)
     {
-        cache_.insertValue(key, value);
+        CacheEntry entry;
+        entry.value = value;
+        entry.snapshot = snapshot;
+
+        cache_.insertValue(key, entry);
     }
 
+    /**
+     * the filter bitmaps being made when it is called would not be cached.
+     */
     void clear()
     {
+        generations_.increaseDocGeneration();
         cache_.clear();
     }
 
+    /**
+     * invalidate the filter bitmaps on any of @p properties.
+     */
+    void invalidate(const std::vector<std::string>& properties)
+    {
+        generations_.increasePropGeneration(properties);
+    }
+
 private:
+    struct CacheEntry
+    {
+        value_type value;
+        GenerationSnapshot snapshot;
+    };
+
     typedef izenelib::cache::IzeneCache<
         key_type,
-        value_type,
+        CacheEntry,
         izenelib::util::ReadWriteLock,
         izenelib::cache::RDE_HASH,
         izenelib::cache::LRLFU
     > cache_type;
 
     cache_type cache_;
+
+    PropertyGenerations generations_;
 };
 
 } // namespace sf1r
@@ -13,6 +13,9 @@
 #include "Sorter.h"
 #include <util/PriorityQueue.h>
 
+#include <vector>
+#include <boost/scoped_ptr.hpp>
+
 
 namespace sf1r
 {
@@ -28,6 +31,51 @@ public:
     virtual ScoreDoc getAt(size_t pos) = 0;
     virtual size_t size() = 0;
     virtual void clear() = 0;
+
+    /**
+     * pop all docs into @p docs, which are sorted from the top to the bottom.
+     */
+    void popSorted(std::vector<ScoreDoc>& docs)
+    {
+        const size_t count = size();
+        docs.resize(count);
+
+        // pop() always gets the doc with current lowest score
+        for (size_t i = count; i > 0; --i)
+        {
+            docs[i-1] = pop();
+        }
+    }
+};
+
+/**
+ * the order used in @c ScoreSortedHitQueue.
+ */
+struct ScoreLessThan
+{
+    bool operator()(const ScoreDoc& o1, const ScoreDoc& o2) const
+    {
+        if (std::fabs(o1.score - o2.score) < std::numeric_limits<score_t>::epsilon())
+        {
+            return o1.docId < o2.docId;
+        }
+        return (o1.score < o2.score);
+    }
+};
+
+/**
+ * the order used in @c PropertySortedHitQueue.
+ */
+struct SorterLessThan
+{
+    explicit SorterLessThan(Sorter* sorter) : pSorter_(sorter) {}
+
+    bool operator()(const ScoreDoc& o1, const ScoreDoc& o2) const
+    {
+        return pSorter_->lessThan(o1, o2);
+    }
+
+    Sorter* pSorter_;
 };
 
 class ScoreSortedHitQueue : public HitQueue
@@ -42,11 +90,7 @@ class ScoreSortedHitQueue : public HitQueue
     protected:
         bool lessThan(const ScoreDoc& o1, const ScoreDoc& o2) const
         {
-            if (std::fabs(o1.score - o2.score) < std::numeric_limits<score_t>::epsilon())
-            {
-                return o1.docId < o2.docId;
-            }
-            return (o1.score < o2.score);
+            return ScoreLessThan()(o1, o2);
         }
     };
 
@@ -95,14 +139,9 @@ class PropertySortedHitQueue : public HitQueue
     class Queue_ : public izenelib::util::PriorityQueue<ScoreDoc>
     {
     public:
-        Queue_(
-            boost::shared_ptr<Sorter>& pSorter,
-            size_t size,
-            PropSharedLockSet& propSharedLockSet)
+        Queue_(boost::shared_ptr<Sorter>& pSorter, size_t size)
             : pSorter_(pSorter)
         {
-            if(pSorter)
-                pSorter->createComparators(propSharedLockSet);
             initialize(size);
         }
     protected:
@@ -114,46 +153,93 @@ class PropertySortedHitQueue : public HitQueue
         boost::shared_ptr<Sorter> pSorter_;
     };
 
+    /**
+     * the queue of docs with their sort keys encoded on insert,
+     * it is used when all sort properties could be encoded.
+     */
+    class KeyQueue_ : public izenelib::util::PriorityQueue<SortKeyDoc>
+    {
+    public:
+        KeyQueue_(boost::shared_ptr<Sorter>& pSorter, size_t size)
+            : pSorter_(pSorter)
+        {
+            initialize(size);
+        }
+
+        bool insertDoc(const ScoreDoc& doc)
+        {
+            SortKeyDoc keyDoc;
+            pSorter_->encodeKeys(doc, keyDoc);
+            return insert(keyDoc);
+        }
+    protected:
+        bool lessThan(const SortKeyDoc& o1, const SortKeyDoc& o2) const
+        {
+            return pSorter_->lessThan(o1, o2);
+        }
+    private:
+        boost::shared_ptr<Sorter> pSorter_;
+    };
+
 public:
     PropertySortedHitQueue(
         boost::shared_ptr<Sorter>& pSorter,
         size_t size,
         PropSharedLockSet& propSharedLockSet)
-        : queue_(pSorter, size, propSharedLockSet)
     {
+        if(pSorter)
+            pSorter->createComparators(propSharedLockSet);
+
+        if (pSorter && pSorter->canEncodeKeys())
+            keyQueue_.reset(new KeyQueue_(pSorter, size));
+        else
+            queue_.reset(new Queue_(pSorter, size));
     }
 
     ~PropertySortedHitQueue() {}
 
     bool insert(ScoreDoc doc)
     {
-        return queue_.insert(doc);
+        if (keyQueue_)
+            return keyQueue_->insertDoc(doc);
+        return queue_->insert(doc);
     }
 
     ScoreDoc pop()
     {
-        return queue_.pop();
+        if (keyQueue_)
+            return keyQueue_->pop().doc;
+        return queue_->pop();
     }
     ScoreDoc top()
     {
-        return queue_.top();
+        if (keyQueue_)
+            return keyQueue_->top().doc;
+        return queue_->top();
     }
     ScoreDoc operator[](size_t pos)
     {
-        return queue_[pos];
+        if (keyQueue_)
+            return (*keyQueue_)[pos].doc;
+        return (*queue_)[pos];
     }
     ScoreDoc getAt(size_t pos)
     {
-        return queue_.getAt(pos);
+        if (keyQueue_)
+            return keyQueue_->getAt(pos).doc;
+        return queue_->getAt(pos);
     }
     size_t size()
     {
-        return queue_.size();
+        if (keyQueue_)
+            return keyQueue_->size();
+        return queue_->size();
     }
     void clear() {}
 
 private:
-    Queue_ queue_;
+    boost::scoped_ptr<Queue_> queue_;
+    boost::scoped_ptr<KeyQueue_> keyQueue_;
 };
 
 }
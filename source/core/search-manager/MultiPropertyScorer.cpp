@@ -1,6 +1,8 @@
 #include "MultiPropertyScorer.h"
 #include <util/profiler/ProfilerGroup.h>
 
+#include <algorithm>
+
 using namespace std;
 using namespace sf1r;
 
@@ -96,3 +98,31 @@ void MultiPropertyScorer::initThreshold(float threshold)
     }
 
 }
+
+void MultiPropertyScorer::setThreshold(float threshold)
+{
+    const size_t numProperties = docIteratorList_.size();
+    std::vector<double> weightedUBs(numProperties, 0.0F);
+    double sumUB = 0.0F;
+
+    for (size_t i = 0; i < numProperties; ++i)
+    {
+        DocumentIterator* pEntry = docIteratorList_[i];
+        if (pEntry)
+        {
+            weightedUBs[i] = propertyWeightList_[i] * pEntry->getUB();
+            sumUB += weightedUBs[i];
+        }
+    }
+
+    for (size_t i = 0; i < numProperties; ++i)
+    {
+        DocumentIterator* pEntry = docIteratorList_[i];
+        double weight = propertyWeightList_[i];
+        if (pEntry && weight > 0.0F)
+        {
+            double residual = (threshold - (sumUB - weightedUBs[i])) / weight;
+            pEntry->setThreshold(std::max(residual, 0.0));
+        }
+    }
+}
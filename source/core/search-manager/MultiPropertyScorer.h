@@ -84,6 +84,13 @@ public:
 
     void initThreshold(float threshold);
 
+    /**
+     * split the overall @p threshold into each property, each property
+     * iterator gets the part which could not be covered by the weighted
+     * upper bounds of the other properties.
+     */
+    void setThreshold(float threshold);
+
     /**
      * @warn not thread-safe, use multiple instances in multiple threads.
      */
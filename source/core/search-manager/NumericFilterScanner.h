@@ -0,0 +1,412 @@
+/**
+ * @file NumericFilterScanner.h
+ * @brief evaluate a numeric filter condition by scanning the values of
+ *        NumericPropertyTable, instead of walking the BTree index.
+ *
+ * The values are tested block by block, each block of 64 docs is reduced
+ * to one bitmap word by a branchless loop, which is vectorized by the
+ * compiler. The words are appended to a compressed bitmap directly,
+ * so that no uncompressed bitset of all docs is allocated.
+ */
+
+#ifndef SF1R_NUMERIC_FILTER_SCANNER_H
+#define SF1R_NUMERIC_FILTER_SCANNER_H
+
+#include <query-manager/QueryTypeDef.h>
+#include <boost/cstdint.hpp>
+#include <boost/type_traits/integral_constant.hpp>
+#include <boost/type_traits/is_integral.hpp>
+#include <vector>
+#include <limits>
+#include <algorithm> // min
+#include <cmath> // floor, ceil
+
+namespace sf1r
+{
+
+template <typename T>
+class NumericFilterScanner
+{
+public:
+    typedef uint64_t WordT;
+
+    enum { kWordBitNum = sizeof(WordT) << 3 };
+
+    /**
+     * @param invalidValue the value of the docs without property value,
+     *        these docs never match any condition.
+     */
+    explicit NumericFilterScanner(const T& invalidValue)
+        : invalidValue_(invalidValue)
+        , operation_(QueryFiltering::NULL_OPERATOR)
+    {
+    }
+
+    /**
+     * @return true if @p operation could be evaluated by scan.
+     */
+    static bool isSupported(QueryFiltering::FilteringOperation operation)
+    {
+        switch (operation)
+        {
+        case QueryFiltering::EQUAL:
+        case QueryFiltering::NOT_EQUAL:
+        case QueryFiltering::INCLUDE:
+        case QueryFiltering::EXCLUDE:
+        case QueryFiltering::GREATER_THAN:
+        case QueryFiltering::GREATER_THAN_EQUAL:
+        case QueryFiltering::LESS_THAN:
+        case QueryFiltering::LESS_THAN_EQUAL:
+        case QueryFiltering::RANGE:
+            return true;
+
+        default:
+            return false;
+        }
+    }
+
+    /**
+     * convert the filter value to @c T. For an integer @c T, a fractional
+     * bound is rounded to the integer giving the same condition, such as
+     * "x > 2.5" to "x > 2", and "x < 2.5" to "x < 3".
+     * @param index the index of @p value in the filter values,
+     *        for RANGE, 0 is the lower bound and 1 is the upper bound
+     * @return false if @p value could not be converted without changing
+     *         the condition, such as "x == 2.5" or out of the range of @c T
+     */
+    template <typename V>
+    static bool convertValue(
+        QueryFiltering::FilteringOperation operation,
+        std::size_t index,
+        const V& value,
+        T& out)
+    {
+        if (!std::numeric_limits<T>::is_integer)
+        {
+            out = static_cast<T>(value);
+            return true;
+        }
+
+        return convertToInteger_(operation, index, value, out,
+                                 boost::is_integral<V>());
+    }
+
+    /**
+     * set the filter condition.
+     * @return false if @p operation is not supported,
+     *         or @p values are not enough for @p operation.
+     */
+    bool init(
+        QueryFiltering::FilteringOperation operation,
+        const std::vector<T>& values)
+    {
+        if (!isSupported(operation) || values.empty())
+            return false;
+
+        if (operation == QueryFiltering::RANGE && values.size() < 2)
+            return false;
+
+        operation_ = operation;
+        values_ = values;
+        return true;
+    }
+
+    /**
+     * scan the values of docs in [0, @p bitsNum), the bit of each matched
+     * doc is set in the words appended to @p bitmap.
+     * @param data the values indexed by docid
+     * @param dataSize the number of values in @p data, the docs not less
+     *        than @p dataSize are treated as no value
+     * @param bitmap it could be any compressed bitmap which has method
+     *        @c add(word) to append a word of 64 docs
+     */
+    template <class BitmapT>
+    void scan(
+        const T* data,
+        std::size_t dataSize,
+        std::size_t bitsNum,
+        BitmapT& bitmap) const
+    {
+        switch (operation_)
+        {
+        case QueryFiltering::EQUAL:
+            scanBy_(Between(values_[0], values_[0]), data, dataSize, bitsNum, bitmap);
+            break;
+
+        case QueryFiltering::NOT_EQUAL:
+            scanBy_(NotEqual(values_[0]), data, dataSize, bitsNum, bitmap);
+            break;
+
+        case QueryFiltering::INCLUDE:
+            scanBy_(In(values_, false), data, dataSize, bitsNum, bitmap);
+            break;
+
+        case QueryFiltering::EXCLUDE:
+            scanBy_(In(values_, true), data, dataSize, bitsNum, bitmap);
+            break;
+
+        case QueryFiltering::GREATER_THAN:
+            scanBy_(GreaterThan(values_[0]), data, dataSize, bitsNum, bitmap);
+            break;
+
+        case QueryFiltering::GREATER_THAN_EQUAL:
+            scanBy_(GreaterEqual(values_[0]), data, dataSize, bitsNum, bitmap);
+            break;
+
+        case QueryFiltering::LESS_THAN:
+            scanBy_(LessThan(values_[0]), data, dataSize, bitsNum, bitmap);
+            break;
+
+        case QueryFiltering::LESS_THAN_EQUAL:
+            scanBy_(LessEqual(values_[0]), data, dataSize, bitsNum, bitmap);
+            break;
+
+        case QueryFiltering::RANGE:
+            scanBy_(Between(values_[0], values_[1]), data, dataSize, bitsNum, bitmap);
+            break;
+
+        default:
+            scanBy_(Never(), data, dataSize, bitsNum, bitmap);
+            break;
+        }
+    }
+
+private:
+    template <typename V>
+    static bool convertToInteger_(
+        QueryFiltering::FilteringOperation operation,
+        std::size_t index,
+        const V& value,
+        T& out,
+        boost::true_type)
+    {
+        out = static_cast<T>(value);
+
+        // the value is not truncated, and its sign is not changed
+        return static_cast<V>(out) == value && (out < 0) == (value < 0);
+    }
+
+    template <typename V>
+    static bool convertToInteger_(
+        QueryFiltering::FilteringOperation operation,
+        std::size_t index,
+        const V& value,
+        T& out,
+        boost::false_type)
+    {
+        double rounded = value;
+
+        switch (operation)
+        {
+        case QueryFiltering::GREATER_THAN:
+        case QueryFiltering::LESS_THAN_EQUAL:
+            rounded = std::floor(rounded);
+            break;
+
+        case QueryFiltering::GREATER_THAN_EQUAL:
+        case QueryFiltering::LESS_THAN:
+            rounded = std::ceil(rounded);
+            break;
+
+        case QueryFiltering::RANGE:
+            rounded = index == 0 ? std::ceil(rounded) : std::floor(rounded);
+            break;
+
+        default:
+            // an integer never equals a fractional value
+            if (std::floor(rounded) != rounded)
+                return false;
+            break;
+        }
+
+        // as @c T is a signed integer, the max value plus one is
+        // exactly -min in double, it is also false for NaN
+        const double minValue = std::numeric_limits<T>::min();
+        if (!(rounded >= minValue && rounded < -minValue))
+            return false;
+
+        out = static_cast<T>(rounded);
+        return true;
+    }
+
+    struct GreaterThan
+    {
+        T v_;
+        explicit GreaterThan(const T& v) : v_(v) {}
+        bool operator()(const T& x) const { return x > v_; }
+    };
+
+    struct GreaterEqual
+    {
+        T v_;
+        explicit GreaterEqual(const T& v) : v_(v) {}
+        bool operator()(const T& x) const { return x >= v_; }
+    };
+
+    struct LessThan
+    {
+        T v_;
+        explicit LessThan(const T& v) : v_(v) {}
+        bool operator()(const T& x) const { return x < v_; }
+    };
+
+    struct LessEqual
+    {
+        T v_;
+        explicit LessEqual(const T& v) : v_(v) {}
+        bool operator()(const T& x) const { return x <= v_; }
+    };
+
+    struct Between
+    {
+        T low_;
+        T high_;
+        Between(const T& low, const T& high) : low_(low), high_(high) {}
+        bool operator()(const T& x) const { return (x >= low_) & (x <= high_); }
+    };
+
+    struct NotEqual
+    {
+        T v_;
+        explicit NotEqual(const T& v) : v_(v) {}
+        bool operator()(const T& x) const { return x != v_; }
+    };
+
+    struct In
+    {
+        const std::vector<T>& values_;
+        bool isNot_;
+        In(const std::vector<T>& values, bool isNot) : values_(values), isNot_(isNot) {}
+        bool operator()(const T& x) const
+        {
+            bool found = false;
+            for (std::size_t i = 0; i < values_.size(); ++i)
+            {
+                found |= (x == values_[i]);
+            }
+            return found != isNot_;
+        }
+    };
+
+    struct Never
+    {
+        bool operator()(const T& x) const { return false; }
+    };
+
+    template <class Predicate, class BitmapT>
+    void scanBy_(
+        const Predicate& predicate,
+        const T* data,
+        std::size_t dataSize,
+        std::size_t bitsNum,
+        BitmapT& bitmap) const
+    {
+        const std::size_t wordsNum = (bitsNum + kWordBitNum - 1) / kWordBitNum;
+        const std::size_t scanNum = std::min(dataSize, bitsNum);
+        const std::size_t fullWordsNum = scanNum / kWordBitNum;
+
+        std::size_t w = 0;
+        for (; w < fullWordsNum; ++w)
+        {
+            bitmap.add(scanWord_(predicate, data + w * kWordBitNum, kWordBitNum));
+        }
+
+        if (w < wordsNum && scanNum > w * kWordBitNum)
+        {
+            const std::size_t tailNum = scanNum - w * kWordBitNum;
+            bitmap.add(scanWord_(predicate, data + w * kWordBitNum, tailNum));
+            ++w;
+        }
+
+        for (; w < wordsNum; ++w)
+        {
+            bitmap.add(0);
+        }
+    }
+
+    /**
+     * the hot loop, it has no branch on the values,
+     * so that it could be vectorized.
+     */
+    template <class Predicate>
+    WordT scanWord_(
+        const Predicate& predicate,
+        const T* block,
+        std::size_t num) const
+    {
+        const T invalidValue = invalidValue_;
+        WordT word = 0;
+
+        for (std::size_t i = 0; i < num; ++i)
+        {
+            const T& x = block[i];
+            const WordT bit = predicate(x) & (x != invalidValue);
+            word |= bit << i;
+        }
+
+        return word;
+    }
+
+private:
+    const T invalidValue_;
+
+    QueryFiltering::FilteringOperation operation_;
+
+    std::vector<T> values_;
+};
+
+/**
+ * a bitmap adaptor which clears the bits of the excluded docs, such as the
+ * deleted docs, in each word before it is appended to the underlying bitmap.
+ */
+template <class BitmapT, typename DocIdT>
+class ExcludedDocsBitmap
+{
+public:
+    typedef uint64_t WordT;
+
+    enum { kWordBitNum = sizeof(WordT) << 3 };
+
+    /**
+     * @param excludedDocs the docs in ascending order
+     */
+    ExcludedDocsBitmap(BitmapT& bitmap, const std::vector<DocIdT>& excludedDocs)
+        : bitmap_(bitmap)
+        , excludedDocs_(excludedDocs)
+        , excludedPos_(0)
+        , wordStart_(0)
+    {
+    }
+
+    void add(WordT word)
+    {
+        const std::size_t wordEnd = wordStart_ + kWordBitNum;
+
+        for (; excludedPos_ < excludedDocs_.size() &&
+                 excludedDocs_[excludedPos_] < wordEnd; ++excludedPos_)
+        {
+            const std::size_t docId = excludedDocs_[excludedPos_];
+            if (docId >= wordStart_)
+            {
+                word &= ~(WordT(1) << (docId - wordStart_));
+            }
+        }
+
+        bitmap_.add(word);
+        wordStart_ = wordEnd;
+    }
+
+private:
+    BitmapT& bitmap_;
+
+    const std::vector<DocIdT>& excludedDocs_;
+
+    std::size_t excludedPos_;
+
+    /** the doc of the lowest bit in the next word */
+    std::size_t wordStart_;
+};
+
+} // namespace sf1r
+
+#endif // SF1R_NUMERIC_FILTER_SCANNER_H
@@ -332,6 +332,18 @@ float ORDocumentIterator::getUB()
     return minUB / (1 - missRate_);
 }
 
+count_t ORDocumentIterator::getPrunedDocCount()
+{
+    count_t prunedCount = 0;
+    std::vector<DocumentIterator*>::iterator it = docIteratorList_.begin();
+    for (; it != docIteratorList_.end(); it++)
+    {
+        if (*it)
+            prunedCount += (*it)->getPrunedDocCount();
+    }
+    return prunedCount;
+}
+
 count_t ORDocumentIterator::tf()
 {
     DocumentIterator* pEntry;
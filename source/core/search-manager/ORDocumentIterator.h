@@ -84,6 +84,8 @@ public:
     
     float getUB();
 
+    count_t getPrunedDocCount();
+
     const char* getProperty()
     {
         if (docIteratorList_.begin() == docIteratorList_.end())
@@ -0,0 +1,51 @@
+/**
+ * @file PruneThreshold.h
+ * @brief the threshold fed back to the doc iterator in dynamic pruning.
+ */
+
+#ifndef SF1R_PRUNE_THRESHOLD_H
+#define SF1R_PRUNE_THRESHOLD_H
+
+#include <common/inttypes.h>
+#include <limits>
+#include <cmath> // fabs, nextafter
+#include <algorithm> // max
+
+namespace sf1r
+{
+
+/**
+ * the relative margin below the heap minimum, so that a doc is not pruned
+ * by the rounding error of the float upper bounds summed in WAND.
+ */
+const double kPruneThresholdMargin = 1e-5;
+
+/**
+ * get the threshold from the lowest score in a full @c ScoreSortedHitQueue,
+ * the docs whose score upper bound is not greater than it are skipped.
+ *
+ * As @c ScoreLessThan breaks the tie within float epsilon by docid, a later
+ * doc with such a score still replaces the minimum, so the threshold is
+ * below the minimum by at least epsilon. The margin is applied in double,
+ * then the result is rounded down to @c score_t, otherwise, such as for the
+ * scores above 2, the float conversion would round it back to the minimum.
+ */
+inline score_t getPruneThreshold(double minScore)
+{
+    const double margin = std::max(
+        static_cast<double>(std::numeric_limits<score_t>::epsilon()),
+        std::fabs(minScore) * kPruneThresholdMargin);
+    const double bound = minScore - margin;
+
+    score_t threshold = static_cast<score_t>(bound);
+    if (threshold >= bound)
+    {
+        threshold = std::nextafter(threshold,
+                                   -std::numeric_limits<score_t>::infinity());
+    }
+    return threshold;
+}
+
+} // namespace sf1r
+
+#endif // SF1R_PRUNE_THRESHOLD_H
@@ -13,8 +13,10 @@
 #include "PersonalSearchDocumentIterator.h"
 #include "VirtualTermDocumentIterator.h"
 #include "FilterCache.h"
+#include "NumericFilterScanner.h"
 
 #include <common/TermTypeDetector.h>
+#include <common/NumericPropertyTable.h>
 
 #include <ir/index_manager/utility/Bitset.h>
 
@@ -27,6 +29,7 @@
 
 #include <boost/token_iterator.hpp>
 #include <boost/scoped_ptr.hpp>
+#include <boost/type_traits/is_arithmetic.hpp>
 
 //#define VERBOSE_SERACH_MANAGER 1
 
@@ -38,6 +41,96 @@ using izenelib::ir::indexmanager::TermReader;
 namespace sf1r
 {
 
+namespace
+{
+
+/**
+ * convert a numeric filter value to @p T,
+ * it returns false for a non-numeric value, or if the value could not be
+ * converted without changing the filter condition.
+ */
+template <typename T>
+class PropertyValue2Numeric : public boost::static_visitor<bool>
+{
+public:
+    PropertyValue2Numeric(
+        QueryFiltering::FilteringOperation operation,
+        std::size_t index,
+        T& out)
+        : operation_(operation)
+        , index_(index)
+        , out_(out)
+    {}
+
+    template <typename V>
+    bool operator()(const V& value) const
+    {
+        return convert_(value, boost::is_arithmetic<V>());
+    }
+
+private:
+    template <typename V>
+    bool convert_(const V& value, boost::true_type) const
+    {
+        return NumericFilterScanner<T>::convertValue(
+            operation_, index_, value, out_);
+    }
+
+    template <typename V>
+    bool convert_(const V& value, boost::false_type) const
+    {
+        return false;
+    }
+
+private:
+    const QueryFiltering::FilteringOperation operation_;
+    const std::size_t index_;
+    T& out_;
+};
+
+/**
+ * scan the values in @p table to get the docs matching @p filteringRule,
+ * the docs in @p deletedDocs are excluded.
+ * @return false if @p table is not a plain NumericPropertyTable<T>, such as
+ *         NumericRangePropertyTable, or the filter values are not numeric.
+ */
+template <typename T>
+bool scanNumericFilter(
+    const NumericPropertyTableBase& table,
+    const QueryFiltering::FilteringType& filteringRule,
+    std::size_t bitsNum,
+    const std::vector<docid_t>& deletedDocs,
+    InvertedIndexManager::FilterBitmapT& filterBitmap)
+{
+    const NumericPropertyTable<T>* typedTable =
+        dynamic_cast<const NumericPropertyTable<T>*>(&table);
+    if (!typedTable)
+        return false;
+
+    const std::vector<PropertyValue>& filterParam = filteringRule.values_;
+    std::vector<T> values(filterParam.size());
+    for (std::size_t i = 0; i < filterParam.size(); ++i)
+    {
+        PropertyValue2Numeric<T> converter(filteringRule.operation_, i, values[i]);
+        if (!boost::apply_visitor(converter, filterParam[i].getVariant()))
+            return false;
+    }
+
+    NumericFilterScanner<T> scanner(typedTable->getInvalidValue());
+    if (!scanner.init(filteringRule.operation_, values))
+        return false;
+
+    NumericPropertyTableBase::ScopedReadLock lock(table.getMutex());
+    const T* data = static_cast<const T*>(typedTable->getValueList());
+    ExcludedDocsBitmap<InvertedIndexManager::FilterBitmapT, docid_t>
+        bitmap(filterBitmap, deletedDocs);
+    scanner.scan(data, typedTable->size(false), bitsNum, bitmap);
+
+    return true;
+}
+
+}
+
 QueryBuilder::QueryBuilder(
     const boost::shared_ptr<DocumentManager> documentManager,
     const boost::shared_ptr<InvertedIndexManager> indexManager,
@@ -62,25 +155,41 @@ void QueryBuilder::reset_cache()
     filterCache_->clear();
 }
 
+void QueryBuilder::invalidate_cache(const std::vector<std::string>& properties)
+{
+    filterCache_->invalidate(properties);
+}
+
+QueryBuilder::DeletedDocList::DeletedDocList(DocumentManager& documentManager)
+    : documentManager_(documentManager)
+    , isLoaded_(false)
+    , docGeneration_(0)
+{
+}
+
+const std::vector<docid_t>& QueryBuilder::DeletedDocList::get(GenerationSnapshot& snapshot)
+{
+    if (!isLoaded_)
+    {
+        documentManager_.getDeletedDocIdList(docIds_);
+        docGeneration_ = snapshot.docGeneration;
+        isLoaded_ = true;
+    }
+
+    // the filter is invalidated by any doc change since the docs were got
+    snapshot.docGeneration = std::min(snapshot.docGeneration, docGeneration_);
+    return docIds_;
+}
+
 bool QueryBuilder::do_process_filtertree(
     const ConditionsNode& conditionsTree_,
-    boost::shared_ptr<InvertedIndexManager::FilterBitmapT>& pFilterBitmap)
+    boost::shared_ptr<InvertedIndexManager::FilterBitmapT>& pFilterBitmap,
+    DeletedDocList& deletedDocs)
 {
     if (conditionsTree_.conditionLeafList_.size() == 1 
             && conditionsTree_.conditionsNodeList_.size() == 0)
     {
-        if (!filterCache_->get(conditionsTree_.conditionLeafList_[0], pFilterBitmap))
-        {
-            pFilterBitmap.reset(new InvertedIndexManager::FilterBitmapT);
-
-            QueryFiltering::FilteringOperation filterOperation = conditionsTree_.conditionLeafList_[0].operation_;
-            const std::string& property = conditionsTree_.conditionLeafList_[0].property_;
-            const std::vector<PropertyValue>& filterParam = conditionsTree_.conditionLeafList_[0].values_;
-
-            indexManagerPtr_->makeRangeQuery(filterOperation, property, filterParam, pFilterBitmap);
-
-            filterCache_->set(conditionsTree_.conditionLeafList_[0], pFilterBitmap);
-        }
+        get_filter_bitmap_(conditionsTree_.conditionLeafList_[0], pFilterBitmap, deletedDocs);
         return true;
     }
     /// not leaf node;
@@ -89,25 +198,14 @@ bool QueryBuilder::do_process_filtertree(
     filterBitmapTList1.resize(conditionsTree_.conditionLeafList_.size());
     for (unsigned int i = 0; i < conditionsTree_.conditionLeafList_.size(); ++i)
     {
-        if (!filterCache_->get(conditionsTree_.conditionLeafList_[i], filterBitmapTList1[i]))
-        {
-            filterBitmapTList1[i].reset(new InvertedIndexManager::FilterBitmapT);
-
-            QueryFiltering::FilteringOperation filterOperation = conditionsTree_.conditionLeafList_[i].operation_;
-            const std::string& property = conditionsTree_.conditionLeafList_[i].property_;
-            const std::vector<PropertyValue>& filterParam = conditionsTree_.conditionLeafList_[i].values_;
-
-            indexManagerPtr_->makeRangeQuery(filterOperation, property, filterParam, filterBitmapTList1[i]);
-
-            filterCache_->set(conditionsTree_.conditionLeafList_[i], filterBitmapTList1[i]);
-        }
+        get_filter_bitmap_(conditionsTree_.conditionLeafList_[i], filterBitmapTList1[i], deletedDocs);
     }
 
     std::vector<boost::shared_ptr<InvertedIndexManager::FilterBitmapT> > filterBitmapTList2;
     filterBitmapTList2.resize(conditionsTree_.conditionsNodeList_.size());
     for (unsigned int j = 0; j < conditionsTree_.conditionsNodeList_.size(); ++j)
     {
-        if (!do_process_filtertree(conditionsTree_.conditionsNodeList_[j], filterBitmapTList2[j]))
+        if (!do_process_filtertree(conditionsTree_.conditionsNodeList_[j], filterBitmapTList2[j], deletedDocs))
             return false;
     }
 
@@ -153,98 +251,91 @@ bool QueryBuilder::do_process_filtertree(
     return true;
 }
 
-bool QueryBuilder::prepare_filter(
-        const ConditionsNode& conditionsTree_,
-        boost::shared_ptr<InvertedIndexManager::FilterBitmapT>& pFilterBitmapx)
+void QueryBuilder::get_filter_bitmap_(
+    const QueryFiltering::FilteringType& filteringRule,
+    boost::shared_ptr<InvertedIndexManager::FilterBitmapT>& pFilterBitmap,
+    DeletedDocList& deletedDocs)
 {
-    return do_process_filtertree(conditionsTree_, pFilterBitmapx);
+    if (filterCache_->get(filteringRule, pFilterBitmap))
+        return;
+
+    GenerationSnapshot snapshot;
+    filterCache_->takeSnapshot(filteringRule, snapshot);
+    pFilterBitmap.reset(new InvertedIndexManager::FilterBitmapT);
+
+    make_filter_bitmap_(filteringRule, pFilterBitmap, deletedDocs, snapshot);
+
+    filterCache_->set(filteringRule, pFilterBitmap, snapshot);
 }
-/*
-void QueryBuilder::do_process_node(
-    QueryFiltering::FilteringTreeValue &filteringTreeRules
-    , std::stack<boost::shared_ptr<InvertedIndexManager::FilterBitmapT> >& BitMapSetStack
-    , boost::shared_ptr<InvertedIndexManager::FilterBitmapT>& pFilterBitmap)
+
+void QueryBuilder::make_filter_bitmap_(
+    const QueryFiltering::FilteringType& filteringRule,
+    boost::shared_ptr<InvertedIndexManager::FilterBitmapT>& pFilterBitmap,
+    DeletedDocList& deletedDocs,
+    GenerationSnapshot& snapshot)
 {
-    std::string relation = filteringTreeRules.relation_;
-    std::vector<boost::shared_ptr<InvertedIndexManager::FilterBitmapT> > pFilterBitmaplist;
-    pFilterBitmaplist.resize(filteringTreeRules.childNum_);
+    if (scan_numeric_filter_(filteringRule, *pFilterBitmap, deletedDocs, snapshot))
+        return;
 
-    for (unsigned int j = 0; j < filteringTreeRules.childNum_; ++j)
-    {
-        pFilterBitmaplist[j] = BitMapSetStack.top();
-        BitMapSetStack.pop();
-    }
-    //get new FitlerBitMap by the relation
-    pFilterBitmap = pFilterBitmaplist[0];
-    if (relation == "and")
-    {
-        for (unsigned int k = 1; k < pFilterBitmaplist.size(); ++k)
-        {
-            boost::shared_ptr<InvertedIndexManager::FilterBitmapT> dest(new InvertedIndexManager::FilterBitmapT);
-            pFilterBitmap->logicaland(*pFilterBitmaplist[k], *dest);
-            pFilterBitmap = dest;
-        }
-    }
-    else if (relation == "or")
-    {
-        for (unsigned int k = 1; k < pFilterBitmaplist.size(); ++k)
-        {
-            boost::shared_ptr<InvertedIndexManager::FilterBitmapT> dest(new InvertedIndexManager::FilterBitmapT);
-            pFilterBitmap->logicalor(*pFilterBitmaplist[k], *dest);
-            pFilterBitmap = dest;
-        }
-    }
+    indexManagerPtr_->makeRangeQuery(filteringRule.operation_,
+                                     filteringRule.property_,
+                                     filteringRule.values_,
+                                     pFilterBitmap);
 }
 
-void QueryBuilder::prepare_filter(
-    std::vector<QueryFiltering::FilteringTreeValue> filteringTreeRules_,
-    boost::shared_ptr<InvertedIndexManager::FilterBitmapT>& pFilterBitmapx)
+bool QueryBuilder::scan_numeric_filter_(
+    const QueryFiltering::FilteringType& filteringRule,
+    InvertedIndexManager::FilterBitmapT& filterBitmap,
+    DeletedDocList& deletedDocList,
+    GenerationSnapshot& snapshot)
 {
-    // use stack to deal with filteringTreeRules_
-    std::stack<boost::shared_ptr<InvertedIndexManager::FilterBitmapT> > BitMapSetStack;
-    //for buttom to top
-    for (int i = filteringTreeRules_.size() - 1; i >= 0; i--)
+    if (!NumericFilterScanner<int32_t>::isSupported(filteringRule.operation_))
+        return false;
+
+    const boost::shared_ptr<NumericPropertyTableBase>& numericTable =
+        documentManagerPtr_->getNumericPropertyTable(filteringRule.property_);
+    if (!numericTable)
+        return false;
+
+    const std::size_t bitsNum = documentManagerPtr_->getMaxDocId() + 1;
+
+    // mask out the deleted docs as the BTree index does, as the docs
+    // of "*" query are not checked by the delete flags
+    const std::vector<docid_t>& deletedDocs = deletedDocList.get(snapshot);
+
+    switch (numericTable->getType())
     {
-        if (filteringTreeRules_[i].isRelationNode_)
-        {
-            if (i != 0)
-            {
-                boost::shared_ptr<InvertedIndexManager::FilterBitmapT> pFilterBitmap;
-                pFilterBitmap.reset(new InvertedIndexManager::FilterBitmapT);
-                
-                do_process_node(filteringTreeRules_[i]
-                                , BitMapSetStack
-                                , pFilterBitmap);
-
-                BitMapSetStack.push(pFilterBitmap);
-            }
-            else
-            {
-                do_process_node(filteringTreeRules_[i]
-                                , BitMapSetStack
-                                , pFilterBitmapx);
-            }
+    case INT8_PROPERTY_TYPE:
+        return scanNumericFilter<int8_t>(*numericTable, filteringRule, bitsNum, deletedDocs, filterBitmap);
 
-        }
-        else
-        {
-            boost::shared_ptr<InvertedIndexManager::FilterBitmapT> pFilterBitmap;
-            
-            if (!filterCache_->get(filteringTreeRules_[i].fitleringType_, pFilterBitmap))
-            {
-                pFilterBitmap.reset(new InvertedIndexManager::FilterBitmapT);
-                QueryFiltering::FilteringOperation filterOperation = filteringTreeRules_[i].fitleringType_.operation_;
-                const std::string& property = filteringTreeRules_[i].fitleringType_.property_;
-                const std::vector<PropertyValue>& filterParam = filteringTreeRules_[i].fitleringType_.values_;
-                indexManagerPtr_->makeRangeQuery(filterOperation, property, filterParam, pFilterBitmap);
-                filterCache_->set(filteringTreeRules_[i].fitleringType_, pFilterBitmap);
-            }
-            
-            BitMapSetStack.push(pFilterBitmap);
-        }
+    case INT16_PROPERTY_TYPE:
+        return scanNumericFilter<int16_t>(*numericTable, filteringRule, bitsNum, deletedDocs, filterBitmap);
+
+    case INT32_PROPERTY_TYPE:
+        return scanNumericFilter<int32_t>(*numericTable, filteringRule, bitsNum, deletedDocs, filterBitmap);
+
+    case INT64_PROPERTY_TYPE:
+    case DATETIME_PROPERTY_TYPE:
+        return scanNumericFilter<int64_t>(*numericTable, filteringRule, bitsNum, deletedDocs, filterBitmap);
+
+    case FLOAT_PROPERTY_TYPE:
+        return scanNumericFilter<float>(*numericTable, filteringRule, bitsNum, deletedDocs, filterBitmap);
+
+    case DOUBLE_PROPERTY_TYPE:
+        return scanNumericFilter<double>(*numericTable, filteringRule, bitsNum, deletedDocs, filterBitmap);
+
+    default:
+        return false;
     }
 }
-*/
+
+bool QueryBuilder::prepare_filter(
+        const ConditionsNode& conditionsTree_,
+        boost::shared_ptr<InvertedIndexManager::FilterBitmapT>& pFilterBitmapx)
+{
+    DeletedDocList deletedDocs(*documentManagerPtr_);
+    return do_process_filtertree(conditionsTree_, pFilterBitmapx, deletedDocs);
+}
 
 WANDDocumentIterator* QueryBuilder::prepare_wand_dociterator(
     const SearchKeywordOperation& actionOperation,
@@ -481,12 +572,14 @@ void QueryBuilder::prefetch_term_doc_readers_(
                 filteringRule.values_ = filterParam;
                 if(!filterCache_->get(filteringRule, pFilterBitmap))
                 {
+                    GenerationSnapshot snapshot;
+                    filterCache_->takeSnapshot(filteringRule, snapshot);
                     pFilterBitmap.reset(new InvertedIndexManager::FilterBitmapT);
                     pBitset.reset(new Bitset(pIndexReader_->maxDoc() + 1));
 
                     indexManagerPtr_->getDocsByNumericValue(colID, property, value, *pBitset);
                     pBitset->compress(*pFilterBitmap);
-                    filterCache_->set(filteringRule, pFilterBitmap);
+                    filterCache_->set(filteringRule, pFilterBitmap, snapshot);
                 }
                 TermDocFreqs* pTermDocReader = new InvertedIndexManager::FilterTermDocFreqsT(pFilterBitmap);
                 termDocReaders[termId].push_back(pTermDocReader);
@@ -32,6 +32,7 @@ using namespace sf1r::QueryFiltering;
 namespace sf1r
 {
 class FilterCache;
+struct GenerationSnapshot;
 typedef DocumentIterator* DocumentIteratorPointer;
 class QueryBuilder
 {
@@ -78,14 +79,6 @@ public:
         bool readPositions,
         const std::vector<std::map<termid_t, unsigned> >& termIndexMaps
     );
-/*
-    void prepare_filter(
-        std::vector<QueryFiltering::FilteringTreeValue> filteringTreeRules_,
-        boost::shared_ptr<IndexManager::FilterBitmapT>& pFilterBitmap);
-    bool prepare_filter(
-        boost::shared_ptr<ConditionsNode>& conditionsTree_,
-        boost::shared_ptr<InvertedIndexManager::FilterBitmapT>& pFilterBitmapx);*/
-
     bool prepare_filter(
         const ConditionsNode& conditionsTree_,
         boost::shared_ptr<InvertedIndexManager::FilterBitmapT>& pFilterBitmapx);
@@ -97,6 +90,11 @@ public:
 
     void reset_cache();
 
+    /**
+     * @brief invalidate the cached filters on any of @p properties.
+     */
+    void invalidate_cache(const std::vector<std::string>& properties);
+
     /**
      * @brief get corresponding id of the property, returns 0 if the property
      * does not exist.
@@ -202,14 +200,62 @@ private:
         std::vector<termid_t>& outTermIndexes
     );
 
+    /**
+     * the deleted docs masked out in building one filter, they are got
+     * on the first condition scanned, then shared by the other conditions.
+     */
+    class DeletedDocList
+    {
+    public:
+        explicit DeletedDocList(DocumentManager& documentManager);
+
+        /**
+         * @param snapshot the generations taken before making the filter
+         *        of one condition, if the docs were got before it, its doc
+         *        generation is set back to the one when they were got.
+         */
+        const std::vector<docid_t>& get(GenerationSnapshot& snapshot);
+
+    private:
+        DocumentManager& documentManager_;
+        bool isLoaded_;
+        uint64_t docGeneration_;
+        std::vector<docid_t> docIds_;
+    };
+
     bool do_process_filtertree(
         const ConditionsNode& conditionsTree_,
-        boost::shared_ptr<InvertedIndexManager::FilterBitmapT>& pFilterBitmap);
-/*
-    void do_process_node(
-        QueryFiltering::FilteringTreeValue &filteringTreeRules,
-        std::stack<boost::shared_ptr<IndexManager::FilterBitmapT> >& BitMapSetStack, 
-        boost::shared_ptr<IndexManager::FilterBitmapT>& pFilterBitmap);*/
+        boost::shared_ptr<InvertedIndexManager::FilterBitmapT>& pFilterBitmap,
+        DeletedDocList& deletedDocs);
+
+    /**
+     * get the docs matching one filter condition from the filter cache,
+     * or make them on cache miss.
+     */
+    void get_filter_bitmap_(
+        const QueryFiltering::FilteringType& filteringRule,
+        boost::shared_ptr<InvertedIndexManager::FilterBitmapT>& pFilterBitmap,
+        DeletedDocList& deletedDocs);
+
+    /**
+     * get the docs matching one filter condition, it scans the numeric
+     * property table if possible, otherwise it walks the BTree index.
+     */
+    void make_filter_bitmap_(
+        const QueryFiltering::FilteringType& filteringRule,
+        boost::shared_ptr<InvertedIndexManager::FilterBitmapT>& pFilterBitmap,
+        DeletedDocList& deletedDocs,
+        GenerationSnapshot& snapshot);
+
+    /**
+     * @return false if the condition could not be evaluated by scanning
+     *         the numeric property table.
+     */
+    bool scan_numeric_filter_(
+        const QueryFiltering::FilteringType& filteringRule,
+        InvertedIndexManager::FilterBitmapT& filterBitmap,
+        DeletedDocList& deletedDocList,
+        GenerationSnapshot& snapshot);
 
 private:
     boost::shared_ptr<DocumentManager> documentManagerPtr_;
@@ -19,6 +19,36 @@ ScoreDocEvaluator::ScoreDocEvaluator(
 }
 
 void ScoreDocEvaluator::evaluate(ScoreDoc& scoreDoc)
+{
+    evaluateExceptCustom(scoreDoc);
+
+    if (customRanker_)
+    {
+        scoreDoc.custom_score = customRanker_->evaluate(scoreDoc.docId);
+    }
+}
+
+void ScoreDocEvaluator::evaluateCustom(ScoreDoc* scoreDocs, std::size_t num)
+{
+    if (!customRanker_ || num == 0)
+        return;
+
+    docIds_.resize(num);
+    customScores_.resize(num);
+    for (std::size_t i = 0; i < num; ++i)
+    {
+        docIds_[i] = scoreDocs[i].docId;
+    }
+
+    customRanker_->evaluate(&docIds_[0], num, &customScores_[0]);
+
+    for (std::size_t i = 0; i < num; ++i)
+    {
+        scoreDocs[i].custom_score = customScores_[i];
+    }
+}
+
+void ScoreDocEvaluator::evaluateExceptCustom(ScoreDoc& scoreDoc)
 {
     if (productScorer_)
     {
@@ -29,11 +59,6 @@ void ScoreDocEvaluator::evaluate(ScoreDoc& scoreDoc)
         scoreDoc.score = kDefaultScore;
     }
 
-    if (customRanker_)
-    {
-        scoreDoc.custom_score = customRanker_->evaluate(scoreDoc.docId);
-    }
-
     if (geoLocationRanker_)
     {
         scoreDoc.geo_dist = geoLocationRanker_->evaluate(scoreDoc.docId);
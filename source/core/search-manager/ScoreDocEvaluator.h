@@ -12,6 +12,7 @@
 #include "GeoLocationRanker.h"
 #include <mining-manager/product-scorer/ProductScorer.h>
 #include <boost/scoped_ptr.hpp>
+#include <vector>
 
 namespace sf1r
 {
@@ -27,12 +28,31 @@ public:
 
     void evaluate(ScoreDoc& scoreDoc);
 
+    /**
+     * evaluate the scores except the custom ranking score,
+     * as the relevance score is read from the doc iterator,
+     * it should be called before the iterator moves to the next doc.
+     */
+    void evaluateExceptCustom(ScoreDoc& scoreDoc);
+
+    /**
+     * evaluate the custom ranking scores of a block of docs together,
+     * the other scores are not touched.
+     */
+    void evaluateCustom(ScoreDoc* scoreDocs, std::size_t num);
+
+    bool hasCustomRanker() const { return customRanker_.get() != NULL; }
+
 private:
     boost::scoped_ptr<ProductScorer> productScorer_;
 
     CustomRankerPtr customRanker_;
 
     GeoLocationRankerPtr geoLocationRanker_;
+
+    /** the buffers to evaluate a block of docs */
+    std::vector<docid_t> docIds_;
+    std::vector<double> customScores_;
 };
 
 } // namespace sf1r
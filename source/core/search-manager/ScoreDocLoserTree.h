@@ -0,0 +1,149 @@
+/**
+ * @file ScoreDocLoserTree.h
+ * @brief k-way merge of sorted ScoreDoc lists by a loser tree (tournament tree).
+ *
+ * Each input list is sorted from the top doc to the bottom doc, that is,
+ * for adjacent docs a and b in one list, lessThan(b, a) is true.
+ * The merged docs are output in the same order, each output costs
+ * O(log k) comparisons with k as the number of lists.
+ */
+
+#ifndef SF1R_SCORE_DOC_LOSER_TREE_H
+#define SF1R_SCORE_DOC_LOSER_TREE_H
+
+#include "ScoreDoc.h"
+#include <vector>
+#include <algorithm> // swap
+
+namespace sf1r
+{
+
+/**
+ * @p LessThan is a functor with the same semantics as
+ * @c HitQueue's lessThan(), that is, lessThan(a, b) means @p a is ranked
+ * lower than @p b.
+ */
+template <class LessThan>
+class ScoreDocLoserTree
+{
+public:
+    typedef std::vector<ScoreDoc> ScoreDocList;
+
+    ScoreDocLoserTree(
+        const std::vector<const ScoreDocList*>& lists,
+        LessThan lessThan)
+        : lists_(lists)
+        , lessThan_(lessThan)
+        , listNum_(lists.size())
+        , positions_(listNum_, 0)
+        , tree_(std::max<std::size_t>(listNum_, 1), listNum_)
+    {
+        for (std::size_t i = 0; i < listNum_; ++i)
+        {
+            adjust_(i);
+        }
+    }
+
+    /**
+     * get the next top doc.
+     * @return false if all lists are exhausted.
+     */
+    bool next(ScoreDoc& doc)
+    {
+        const std::size_t winner = tree_[0];
+        if (winner >= listNum_ || isExhausted_(winner))
+            return false;
+
+        doc = (*lists_[winner])[positions_[winner]++];
+        adjust_(winner);
+        return true;
+    }
+
+private:
+    bool isExhausted_(std::size_t list) const
+    {
+        return positions_[list] >= lists_[list]->size();
+    }
+
+    /**
+     * @return true if the current doc in list @p a beats the one in @p b,
+     *         the index @c listNum_ is a virtual list which beats all others,
+     *         and an exhausted list is beaten by all others.
+     */
+    bool beats_(std::size_t a, std::size_t b) const
+    {
+        if (a == listNum_)
+            return true;
+        if (b == listNum_)
+            return false;
+        if (isExhausted_(a))
+            return false;
+        if (isExhausted_(b))
+            return true;
+
+        return lessThan_((*lists_[b])[positions_[b]],
+                         (*lists_[a])[positions_[a]]);
+    }
+
+    /**
+     * replay the matches from leaf @p list to the root, the loser stays
+     * in each internal node, and the final winner is stored in tree_[0].
+     */
+    void adjust_(std::size_t list)
+    {
+        std::size_t winner = list;
+        for (std::size_t node = (list + listNum_) / 2; node > 0; node /= 2)
+        {
+            if (beats_(tree_[node], winner))
+            {
+                std::swap(tree_[node], winner);
+            }
+        }
+        tree_[0] = winner;
+    }
+
+private:
+    const std::vector<const ScoreDocList*>& lists_;
+
+    LessThan lessThan_;
+
+    const std::size_t listNum_;
+
+    /** the current position in each list */
+    std::vector<std::size_t> positions_;
+
+    /** tree_[0] is the winner, other nodes are losers */
+    std::vector<std::size_t> tree_;
+};
+
+/**
+ * merge the sorted @p lists into @p result, at most @p maxNum docs are output.
+ */
+template <class LessThan>
+void mergeSortedScoreDocs(
+    const std::vector<const std::vector<ScoreDoc>*>& lists,
+    LessThan lessThan,
+    std::size_t maxNum,
+    std::vector<ScoreDoc>& result)
+{
+    ScoreDocLoserTree<LessThan> loserTree(lists, lessThan);
+
+    std::size_t totalNum = 0;
+    for (std::size_t i = 0; i < lists.size(); ++i)
+    {
+        totalNum += lists[i]->size();
+    }
+
+    result.clear();
+    result.reserve(std::min(totalNum, maxNum));
+
+    ScoreDoc doc;
+    while (result.size() < maxNum && loserTree.next(doc))
+    {
+        result.push_back(doc);
+    }
+}
+
+} // namespace sf1r
+
+#endif // SF1R_SCORE_DOC_LOSER_TREE_H
@@ -3,6 +3,7 @@
 #include "SearchManagerPreProcessor.h"
 #include "SearchThreadParam.h"
 #include "HitQueue.h"
+#include "ScoreDocLoserTree.h"
 
 #include <common/PropSharedLockSet.h>
 #include <query-manager/SearchKeywordOperation.h>
@@ -11,12 +12,25 @@
 #include <bundles/index/IndexBundleConfiguration.h>
 
 #include <omp.h>
+#include <boost/bind.hpp>
+#include <boost/ref.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread/thread.hpp>
 #include <util/cpu_topology.h>
 
 using namespace sf1r;
 
 #define PARALLEL_THRESHOLD 80000
 
+namespace
+{
+/** the docid chunks for each thread, to balance the skewed hits */
+const std::size_t kChunkNumPerThread = 16;
+
+/** the minimum docs in one chunk */
+const std::size_t kMinChunkDocNum = 2000;
+}
+
 static izenelib::util::CpuTopologyT s_cpu_topology_info;
 static int s_round = 0;
 static int s_cpunum = 0;
@@ -74,6 +88,20 @@ void SearchThreadMaster::prepareThreadParams(
 
     if (threadNum > 1)
     {
+        // instead of the static ranges above, the docid ranges are
+        // scheduled by chunks, so that the idle threads could steal
+        // chunks from the busy ones.
+        const docid_t docNum = maxDocId + 1;
+        const std::size_t chunkNum = std::min(threadNum * kChunkNumPerThread,
+                                              docNum / kMinChunkDocNum);
+        boost::shared_ptr<DocIdChunkScheduler> chunkScheduler(
+            new DocIdChunkScheduler(docNum, threadNum, chunkNum));
+
+        for (std::size_t i = 0; i < threadNum; ++i)
+        {
+            threadParams[i].chunkScheduler = chunkScheduler;
+        }
+
         // Because the top attribute info can not be decided until
         // all threads' result merged, we need to get all the
         // attribute info in each thread.
@@ -103,12 +131,10 @@ bool SearchThreadMaster::mergeThreadParams(
         return false;
 
     std::size_t& masterTotalCount = masterParam.totalCount;
+    DocIdChunkStats& masterChunkStats = masterParam.chunkStats;
     PropertyRange& masterPropertyRange = masterParam.propertyRange;
     std::map<std::string, unsigned int>& masterCounterResults = masterParam.counterResults;
-    faceted::GroupRep& masterGroupRep = masterParam.groupRep;
-    faceted::OntologyRep& masterAttrRep = masterParam.attrRep;
-    std::list<const faceted::OntologyRep*> otherAttrReps;
-    boost::shared_ptr<HitQueue> masterQueue(masterParam.scoreItemQueue);
+    std::vector<const std::vector<ScoreDoc>*> hitLists(1, &masterParam.sortedHits);
 
     for (std::size_t i = 1; i < threadNum; ++i)
     {
@@ -117,10 +143,9 @@ bool SearchThreadMaster::mergeThreadParams(
             return false;
 
         masterTotalCount += param.totalCount;
-        while (param.scoreItemQueue->size() > 0)
-        {
-            masterQueue->insert(param.scoreItemQueue->pop());
-        }
+        masterParam.prunedDocCount += param.prunedDocCount;
+        masterChunkStats.merge(param.chunkStats);
+        hitLists.push_back(&param.sortedHits);
 
         float lowValue = param.propertyRange.lowValue_;
         float highValue = param.propertyRange.highValue_;
@@ -139,7 +164,62 @@ bool SearchThreadMaster::mergeThreadParams(
         {
             masterCounterResults[cit->first] += cit->second;
         }
+    }
+
+    LOG(INFO) << "searched " << masterChunkStats.chunkNum << " chunks in "
+              << threadNum << " threads, steals: " << masterChunkStats.stealNum
+              << ", total chunk time: " << masterChunkStats.totalChunkTime
+              << ", max chunk time: " << masterChunkStats.maxChunkTime;
+
+    // the facets are merged in another thread along with the hits
+    boost::scoped_ptr<boost::thread> facetThread;
+    if (!masterParam.actionOperation->actionItem_.groupParam_.isEmpty())
+    {
+        facetThread.reset(new boost::thread(
+            boost::bind(&SearchThreadMaster::mergeFacets_,
+                        this, boost::ref(threadParams))));
+    }
+
+    std::vector<ScoreDoc> mergedHits;
+    if (masterParam.pSorter)
+    {
+        mergeSortedScoreDocs(hitLists,
+                             SorterLessThan(masterParam.pSorter.get()),
+                             masterParam.heapSize,
+                             mergedHits);
+    }
+    else
+    {
+        mergeSortedScoreDocs(hitLists,
+                             ScoreLessThan(),
+                             masterParam.heapSize,
+                             mergedHits);
+    }
+
+    if (facetThread)
+    {
+        facetThread->join();
+    }
+    else
+    {
+        mergeFacets_(threadParams);
+    }
+
+    masterParam.sortedHits.swap(mergedHits);
+    return true;
+}
+
+void SearchThreadMaster::mergeFacets_(
+    std::vector<SearchThreadParam>& threadParams) const
+{
+    SearchThreadParam& masterParam = threadParams[0];
+    faceted::GroupRep& masterGroupRep = masterParam.groupRep;
+    faceted::OntologyRep& masterAttrRep = masterParam.attrRep;
+    std::list<const faceted::OntologyRep*> otherAttrReps;
 
+    for (std::size_t i = 1; i < threadParams.size(); ++i)
+    {
+        SearchThreadParam& param = threadParams[i];
         masterGroupRep.merge(param.groupRep);
         otherAttrReps.push_back(&param.attrRep);
     }
@@ -147,8 +227,6 @@ bool SearchThreadMaster::mergeThreadParams(
     int& attrGroupNum = masterParam.actionOperation->actionItem_.groupParam_.attrGroupNum_;
     std::swap(attrGroupNum, masterParam.originAttrGroupNum);
     masterAttrRep.merge(attrGroupNum, otherAttrReps);
-
-    return true;
 }
 
 bool SearchThreadMaster::fetchSearchResult(
@@ -156,6 +234,12 @@ bool SearchThreadMaster::fetchSearchResult(
     SearchThreadParam& threadParam,
     KeywordSearchResult& searchResult)
 {
+    if (threadParam.prunedDocCount)
+    {
+        LOG(INFO) << "dynamic pruning skipped " << threadParam.prunedDocCount
+                  << " docs, scored docs: " << threadParam.totalCount;
+    }
+
     std::swap(searchResult.totalCount_, threadParam.totalCount);
     searchResult.groupRep_.swap(threadParam.groupRep);
     searchResult.attrRep_.swap(threadParam.attrRep);
@@ -166,14 +250,21 @@ bool SearchThreadMaster::fetchSearchResult(
     std::vector<float>& rankScoreList = searchResult.topKRankScoreList_;
     std::vector<float>& customRankScoreList = searchResult.topKCustomRankScoreList_;
     std::vector<float>& geoDistanceList = searchResult.topKGeoDistanceList_;
-    boost::shared_ptr<HitQueue> scoreItemQueue(threadParam.scoreItemQueue);
+    std::vector<ScoreDoc>& sortedHits = threadParam.sortedHits;
     CustomRankerPtr customRanker = threadParam.customRanker;
     GeoLocationRankerPtr geoLocationRanker = threadParam.geoLocationRanker;
 
+    // in single thread, the hits are still in queue
+    HitQueue* scoreItemQueue = threadParam.scoreItemQueue.get();
+    if (scoreItemQueue && scoreItemQueue->size() > 0)
+    {
+        scoreItemQueue->popSorted(sortedHits);
+    }
+
     std::size_t count = 0;
-    if (offset < scoreItemQueue->size())
+    if (offset < sortedHits.size())
     {
-        count = scoreItemQueue->size() - offset;
+        count = sortedHits.size() - offset;
     }
     docIdList.resize(count);
     rankScoreList.resize(count);
@@ -188,12 +279,9 @@ bool SearchThreadMaster::fetchSearchResult(
         geoDistanceList.resize(count);
     }
 
-    // here PriorityQueue is used to get topK elements, as PriorityQueue::pop()
-    // will always get the element with current lowest score, we need to reverse
-    // the output sequence.
-    for (int i = count-1; i >= 0; --i)
+    for (std::size_t i = 0; i < count; ++i)
     {
-        const ScoreDoc& pScoreItem = scoreItemQueue->pop();
+        const ScoreDoc& pScoreItem = sortedHits[offset + i];
         docIdList[i] = pScoreItem.docId;
         rankScoreList[i] = pScoreItem.score;
         if (customRanker)
@@ -322,6 +410,13 @@ void SearchThreadMaster::runSearchJob_(
     if (pParam)
     {
         pParam->isSuccess = searchThreadWorker_.search(*pParam);
+
+        // sort the hits in this thread, so that the master
+        // could merge them without re-inserting into queue
+        if (pParam->isSuccess && pParam->scoreItemQueue)
+        {
+            pParam->scoreItemQueue->popSorted(pParam->sortedHits);
+        }
     }
     ++(*finishedJobs);
 }
@@ -66,6 +66,12 @@ private:
         SearchThreadParam* pParam,
         boost::detail::atomic_count* finishedJobs);
 
+    /**
+     * merge the group and attribute results into the first param.
+     */
+    void mergeFacets_(
+        std::vector<SearchThreadParam>& threadParams) const;
+
 private:
     const bool isParallelEnabled_;
 
@@ -10,12 +10,15 @@
 
 #include "CustomRanker.h"
 #include "GeoLocationRanker.h"
+#include "DocIdChunkScheduler.h"
+#include "ScoreDoc.h"
 #include <common/ResultType.h>
 #include <mining-manager/group-manager/GroupRep.h>
 #include <mining-manager/group-manager/ontology_rep.h>
 #include <boost/shared_ptr.hpp>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace sf1r
 {
@@ -29,7 +32,15 @@ struct SearchThreadParam
     const SearchKeywordOperation* actionOperation;
     DistKeywordSearchInfo* distSearchInfo;
 
+    /**
+     * the number of docs evaluated, in dynamic pruning, the docs skipped
+     * by the doc iterator are not counted, so it is only an estimate (a
+     * lower bound) of the number of matched docs.
+     */
     std::size_t totalCount;
+
+    /** the number of postings skipped in dynamic pruning */
+    std::size_t prunedDocCount;
     sf1r::PropertyRange propertyRange;
     std::map<std::string, unsigned int> counterResults;
 
@@ -44,11 +55,18 @@ struct SearchThreadParam
     std::size_t heapSize;
     boost::shared_ptr<HitQueue> scoreItemQueue;
 
+    /** the hits sorted from the top to the bottom, popped from queue */
+    std::vector<ScoreDoc> sortedHits;
+
     int runningNode;
     std::size_t threadId;
     std::size_t docIdBegin;
     std::size_t docIdEnd;
 
+    /** if not NULL, the docid ranges are scheduled by it among threads */
+    boost::shared_ptr<DocIdChunkScheduler> chunkScheduler;
+    DocIdChunkStats chunkStats;
+
     bool isSuccess;
 
     SearchThreadParam(
@@ -59,6 +77,7 @@ struct SearchThreadParam
         : actionOperation(_actionOperation)
         , distSearchInfo(_distSearchInfo)
         , totalCount(0)
+        , prunedDocCount(0)
         , originAttrGroupNum(0)
         , heapSize(_heapSize)
         , runningNode(_runningNode)
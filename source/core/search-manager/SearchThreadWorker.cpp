@@ -8,6 +8,8 @@
 #include "AllDocumentIterator.h"
 #include "CustomRankDocumentIterator.h"
 #include "HitQueue.h"
+#include "DocIdChunkScheduler.h"
+#include "PruneThreshold.h"
 
 #include <common/PropSharedLockSet.h>
 #include <bundles/index/IndexBundleConfiguration.h>
@@ -29,6 +31,27 @@ using namespace sf1r;
 namespace
 {
 const int kStarSearchAttrIterDocNum = 200;
+
+/** the number of docs whose custom ranking scores are evaluated together */
+const std::size_t kScoreBlockSize = CustomRankProgram::kBlockSize;
+
+void evaluateScoreBlock(
+    ScoreDocEvaluator& scoreDocEvaluator,
+    std::vector<ScoreDoc>& scoreBlock,
+    HitQueue& scoreQueue)
+{
+    if (scoreBlock.empty())
+        return;
+
+    scoreDocEvaluator.evaluateCustom(&scoreBlock[0], scoreBlock.size());
+
+    for (std::vector<ScoreDoc>::iterator it = scoreBlock.begin();
+         it != scoreBlock.end(); ++it)
+    {
+        scoreQueue.insert(*it);
+    }
+    scoreBlock.clear();
+}
 }
 
 SearchThreadWorker::SearchThreadWorker(
@@ -297,6 +320,11 @@ bool SearchThreadWorker::search(SearchThreadParam& param)
     ProductScorer* productScorer = preprocessor_.createProductScorer(
         actionOperation.actionItem_, propSharedLockSet, relevanceScorer);
 
+    const bool isDynamicPruning = isDynamicPruning_(param,
+                                                    groupFilter.get(),
+                                                    productScorer,
+                                                    relevanceScorer);
+
     ScoreDocEvaluator scoreDocEvaluator(productScorer, param.customRanker, param.geoLocationRanker);
 
     try
@@ -306,7 +334,8 @@ bool SearchThreadWorker::search(SearchThreadParam& param)
                              *docIterPtr,
                              groupFilter.get(),
                              scoreDocEvaluator,
-                             propSharedLockSet);
+                             propSharedLockSet,
+                             isDynamicPruning);
 
         if (time(NULL) - start_search > 5)
             LOG(INFO) << "dosearch cost too long, " << start_search << ", " << time(NULL);
@@ -354,12 +383,44 @@ DocumentIterator* SearchThreadWorker::combineCustomDocIterator_(
     return originDocIterator;
 }
 
+bool SearchThreadWorker::isDynamicPruning_(
+    const SearchThreadParam& param,
+    const faceted::GroupFilter* groupFilter,
+    const ProductScorer* productScorer,
+    const ProductScorer* relevanceScorer) const
+{
+    const KeywordSearchActionItem& actionItem = param.actionOperation->actionItem_;
+
+    if (!actionItem.searchingMode_.useDynamicPruning_ ||
+        actionItem.searchingMode_.mode_ != SearchingMode::WAND)
+        return false;
+
+    // the hits are not sorted by relevance score
+    if (param.pSorter || param.customRanker || param.geoLocationRanker ||
+        productScorer == NULL || productScorer != relevanceScorer)
+    {
+        LOG(INFO) << "dynamic pruning is disabled as it is not sorted by relevance";
+        return false;
+    }
+
+    // each hit is required in grouping, counter and range
+    if (groupFilter || !actionItem.counterList_.empty() ||
+        !actionItem.rangePropertyName_.empty())
+    {
+        LOG(INFO) << "dynamic pruning is disabled as all hits are required";
+        return false;
+    }
+
+    return true;
+}
+
 bool SearchThreadWorker::doSearch_(
     SearchThreadParam& param,
     DocumentIterator& docIterator,
     faceted::GroupFilter* groupFilter,
     ScoreDocEvaluator& scoreDocEvaluator,
-    PropSharedLockSet& propSharedLockSet)
+    PropSharedLockSet& propSharedLockSet,
+    bool isDynamicPruning)
 {
     CREATE_PROFILER(computerankscore, "SearchThreadWorker", "doSearch_: overall time for scoring a doc");
     CREATE_PROFILER(inserttoqueue, "SearchThreadWorker", "doSearch_: overall time for inserting to result queue");
@@ -394,14 +455,39 @@ bool SearchThreadWorker::doSearch_(
         }
     }
 
-    docIterator.skipTo(param.docIdBegin);
+    HitQueue& scoreQueue = *param.scoreItemQueue;
+    score_t pruneThreshold = 0;
+
+    docid_t docIdBegin = param.docIdBegin;
+    docid_t docIdEnd = param.docIdEnd;
+    DocIdChunkScheduler* chunkScheduler = param.chunkScheduler.get();
+
+    if (chunkScheduler &&
+        !chunkScheduler->nextChunk(param.threadId, docIdBegin, docIdEnd))
+    {
+        // all chunks have been taken, the loop below would stop at once
+        docIdBegin = docIdEnd = 0;
+    }
+
+    // the custom ranking scores are evaluated block by block,
+    // except in dynamic pruning, which needs the threshold of each doc
+    const bool isBlockEvaluated = scoreDocEvaluator.hasCustomRanker() &&
+        !isDynamicPruning;
+    std::vector<ScoreDoc> scoreBlock;
+    if (isBlockEvaluated)
+    {
+        scoreBlock.reserve(kScoreBlockSize);
+    }
+
+    docIterator.skipTo(docIdBegin);
 
     do
     {
 
         docid_t curDocId = docIterator.doc();
 
-        if (curDocId >= param.docIdEnd)
+        if (curDocId >= docIdEnd &&
+            !nextDocIdRange_(param, docIterator, curDocId, docIdBegin, docIdEnd))
             break;
 
         if (groupFilter && !groupFilter->test(curDocId))
@@ -437,6 +523,22 @@ bool SearchThreadWorker::doSearch_(
             }
         }
 
+        if (isBlockEvaluated)
+        {
+            ++param.totalCount;
+            scoreBlock.push_back(ScoreDoc(curDocId));
+
+            // the relevance score depends on the current position of
+            // docIterator, so only the custom ranking score is deferred
+            scoreDocEvaluator.evaluateExceptCustom(scoreBlock.back());
+
+            if (scoreBlock.size() >= kScoreBlockSize)
+            {
+                evaluateScoreBlock(scoreDocEvaluator, scoreBlock, scoreQueue);
+            }
+            continue;
+        }
+
         ScoreDoc scoreItem(curDocId);
 
         START_PROFILER(computerankscore)
@@ -449,9 +551,35 @@ bool SearchThreadWorker::doSearch_(
         START_PROFILER(inserttoqueue)
         param.scoreItemQueue->insert(scoreItem);
         STOP_PROFILER(inserttoqueue)
+
+        if (isDynamicPruning && scoreQueue.size() >= param.heapSize)
+        {
+            // the later doc with the same score could still replace the
+            // minimum, so the threshold is kept below it
+            score_t threshold = getPruneThreshold(scoreQueue.top().score);
+            if (threshold > pruneThreshold)
+            {
+                pruneThreshold = threshold;
+                docIterator.setThreshold(pruneThreshold);
+            }
+        }
     }
     while (docIterator.next());
 
+    evaluateScoreBlock(scoreDocEvaluator, scoreBlock, scoreQueue);
+
+    if (isDynamicPruning)
+    {
+        param.prunedDocCount = docIterator.getPrunedDocCount();
+    }
+
+    if (chunkScheduler)
+    {
+        // only finish the last chunk, no more chunk is taken
+        chunkScheduler->finishChunk(param.threadId);
+        param.chunkStats = chunkScheduler->getStats(param.threadId);
+    }
+
     if (rangePropertyTable && lowValue <= highValue)
     {
         param.propertyRange.highValue_ = highValue;
@@ -467,3 +595,31 @@ bool SearchThreadWorker::doSearch_(
     }
     return true;
 }
+
+bool SearchThreadWorker::nextDocIdRange_(
+    const SearchThreadParam& param,
+    DocumentIterator& docIterator,
+    docid_t& curDocId,
+    docid_t& docIdBegin,
+    docid_t& docIdEnd)
+{
+    DocIdChunkScheduler* chunkScheduler = param.chunkScheduler.get();
+    if (!chunkScheduler)
+        return false;
+
+    // the chunks are in ascending order, so the iterator only moves forward
+    while (curDocId >= docIdEnd)
+    {
+        if (!chunkScheduler->nextChunk(param.threadId, docIdBegin, docIdEnd))
+            return false;
+
+        if (curDocId < docIdBegin)
+        {
+            curDocId = docIterator.skipTo(docIdBegin);
+            if (curDocId == MAX_DOC_ID)
+                return false;
+        }
+    }
+
+    return true;
+}
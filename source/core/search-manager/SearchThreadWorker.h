@@ -25,6 +25,7 @@ class PropSharedLockSet;
 class QueryBuilder;
 class IndexBundleConfiguration;
 class RankingManager;
+class ProductScorer;
 struct SearchThreadParam;
 
 namespace faceted
@@ -60,12 +61,36 @@ private:
         const KeywordSearchActionItem& actionItem,
         DocumentIterator* originDocIterator);
 
+    /**
+     * @return true if the documents which could not beat the minimum score
+     *         in hit queue could be skipped, that is, the score is just the
+     *         relevance score and no one needs to visit every hit.
+     */
+    bool isDynamicPruning_(
+        const SearchThreadParam& param,
+        const faceted::GroupFilter* groupFilter,
+        const ProductScorer* productScorer,
+        const ProductScorer* relevanceScorer) const;
+
     bool doSearch_(
         SearchThreadParam& param,
         DocumentIterator& docIterator,
         faceted::GroupFilter* groupFilter,
         ScoreDocEvaluator& scoreDocEvaluator,
-        PropSharedLockSet& propSharedLockSet);
+        PropSharedLockSet& propSharedLockSet,
+        bool isDynamicPruning);
+
+    /**
+     * move to the next docid range from @c SearchThreadParam::chunkScheduler,
+     * until @p curDocId is less than @p docIdEnd.
+     * @return false if no more range is available.
+     */
+    bool nextDocIdRange_(
+        const SearchThreadParam& param,
+        DocumentIterator& docIterator,
+        docid_t& curDocId,
+        docid_t& docIdBegin,
+        docid_t& docIdEnd);
 
 private:
     const IndexBundleConfiguration& config_;
@@ -1,6 +1,8 @@
 #include "SortPropertyComparator.h"
 #include <common/RTypeStringPropTable.h>
 
+#include <string.h>
+
 namespace sf1r
 {
 
@@ -70,6 +72,83 @@ int SortPropertyComparator::compare(const ScoreDoc& doc1, const ScoreDoc& doc2)
     return (this->*comparator_)(doc1, doc2);
 }
 
+bool SortPropertyComparator::canEncodeKey() const
+{
+    switch (type_)
+    {
+    case STRING_PROPERTY_TYPE:
+        return RTypePropTable_.get() != NULL;
+    case INT32_PROPERTY_TYPE:
+    case FLOAT_PROPERTY_TYPE:
+    case DATETIME_PROPERTY_TYPE:
+    case INT8_PROPERTY_TYPE:
+    case INT16_PROPERTY_TYPE:
+    case INT64_PROPERTY_TYPE:
+    case DOUBLE_PROPERTY_TYPE:
+        return numericPropTable_.get() != NULL && !numericPropTable_->isRange();
+    default:
+        return true;
+    }
+}
+
+uint64_t SortPropertyComparator::encodeKey(const ScoreDoc& doc) const
+{
+    switch (type_)
+    {
+    case STRING_PROPERTY_TYPE:
+        return RTypePropTable_->getSortCode(doc.docId, false);
+    case INT32_PROPERTY_TYPE:
+    case DATETIME_PROPERTY_TYPE:
+    case INT8_PROPERTY_TYPE:
+    case INT16_PROPERTY_TYPE:
+    case INT64_PROPERTY_TYPE:
+    {
+        int64_t value = 0;
+        if (!numericPropTable_->getInt64Value(doc.docId, value, false))
+            return 0;
+        return encodeInt64(value);
+    }
+    case FLOAT_PROPERTY_TYPE:
+    case DOUBLE_PROPERTY_TYPE:
+    {
+        double value = 0;
+        if (!numericPropTable_->getDoubleValue(doc.docId, value, false))
+            return 0;
+        return encodeDouble(value);
+    }
+    case UNKNOWN_DATA_PROPERTY_TYPE:
+        return encodeDouble(doc.score);
+    case CUSTOM_RANKING_PROPERTY_TYPE:
+        return encodeDouble(doc.custom_score);
+    case GEOLOCATION_PROPERTY_TYPE:
+        return encodeDouble(doc.geo_dist);
+    default:
+        return 0;
+    }
+}
+
+uint64_t SortPropertyComparator::encodeInt64(int64_t value)
+{
+    // flip the sign bit, so that the negative values are less,
+    // INT64_MIN is encoded as 1 to be greater than the doc without value.
+    uint64_t key = static_cast<uint64_t>(value) ^ (uint64_t(1) << 63);
+    return key == 0 ? 1 : key;
+}
+
+uint64_t SortPropertyComparator::encodeDouble(double value)
+{
+    if (value == 0)
+        value = 0; // -0.0 equals to 0.0
+
+    uint64_t bits = 0;
+    memcpy(&bits, &value, sizeof(bits));
+
+    // flip all bits of the negative values, and the sign bit of the others
+    const uint64_t signBit = uint64_t(1) << 63;
+    uint64_t key = (bits & signBit) ? ~bits : (bits | signBit);
+    return key == 0 ? 1 : key;
+}
+
 int SortPropertyComparator::compareImplDefault(const ScoreDoc& doc1, const ScoreDoc& doc2) const
 {
     return 0;
@@ -13,6 +13,7 @@
 #include "CustomRanker.h"
 
 #include <boost/shared_ptr.hpp>
+#include <stdint.h>
 
 namespace sf1r
 {
@@ -24,6 +25,21 @@ class SortPropertyComparator
 public:
     int compare(const ScoreDoc& doc1, const ScoreDoc& doc2) const;
 
+    /**
+     * whether the value of a doc could be encoded by @c encodeKey().
+     */
+    bool canEncodeKey() const;
+
+    /**
+     * encode the value of @p doc into an unsigned integer, the order of
+     * the integers is the same as @c compare(), the doc without value
+     * is encoded as 0.
+     */
+    uint64_t encodeKey(const ScoreDoc& doc) const;
+
+    static uint64_t encodeInt64(int64_t value);
+    static uint64_t encodeDouble(double value);
+
 private:
     boost::shared_ptr<NumericPropertyTableBase> numericPropTable_;
     boost::shared_ptr<RTypeStringPropTable> RTypePropTable_;
@@ -184,6 +184,19 @@ void Sorter::createComparators(PropSharedLockSet& propSharedLockSet)
 }
 
 
+bool Sorter::canEncodeKeys() const
+{
+    if (nNumProperties_ > SortKeyDoc::MAX_KEY_NUM)
+        return false;
+
+    for (std::size_t i = 0; i < nNumProperties_; ++i)
+    {
+        if (!ppSortProperties_[i]->pComparator_->canEncodeKey())
+            return false;
+    }
+    return true;
+}
+
 SortPropertyComparator* Sorter::createRTypeStringComparator_(
     const std::string& propName,
     PropSharedLockSet& propSharedLockSet)
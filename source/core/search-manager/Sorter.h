@@ -102,6 +102,19 @@ private:
     friend class Sorter;
 };
 
+/**
+ * @brief the sort keys of a doc materialized when it is inserted into the
+ * hit queue, so that comparing docs is comparing the integers in order,
+ * without reading the property tables again.
+ */
+struct SortKeyDoc
+{
+    enum { MAX_KEY_NUM = 4 };
+
+    uint64_t keys[MAX_KEY_NUM];
+    ScoreDoc doc;
+};
+
 /*
 * @brief Sorter main interface exposed.
 */
@@ -151,6 +164,37 @@ public:
 //    return c < 0;
     }
 
+    /**
+     * whether all sort properties could be encoded into @c SortKeyDoc,
+     * it should be called after @c createComparators().
+     */
+    bool canEncodeKeys() const;
+
+    /**
+     * encode the sort keys of @p doc, the keys of the reversed properties
+     * are inverted, so that @c lessThan(const SortKeyDoc&, const SortKeyDoc&)
+     * always compares in ascending order.
+     */
+    void encodeKeys(const ScoreDoc& doc, SortKeyDoc& keyDoc) const
+    {
+        for (std::size_t i = 0; i < nNumProperties_; ++i)
+        {
+            uint64_t key = ppSortProperties_[i]->pComparator_->encodeKey(doc);
+            keyDoc.keys[i] = reverseMul_[i] < 0 ? ~key : key;
+        }
+        keyDoc.doc = doc;
+    }
+
+    bool lessThan(const SortKeyDoc& doc1, const SortKeyDoc& doc2) const
+    {
+        for (std::size_t i = 0; i < nNumProperties_; ++i)
+        {
+            if (doc1.keys[i] != doc2.keys[i])
+                return doc1.keys[i] < doc2.keys[i];
+        }
+        return doc1.doc.docId < doc2.doc.docId;
+    }
+
     ///This interface would be called after an instance of Sorter is established,
     /// it will generate SortPropertyComparator for internal usage
     void createComparators(PropSharedLockSet& propSharedLockSet);
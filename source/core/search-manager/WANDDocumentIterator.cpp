@@ -14,14 +14,18 @@
 #include <common/type_defs.h>
 #include <util/get.h>
 
+#include <algorithm>
+
 namespace sf1r
 {
 
 WANDDocumentIterator::WANDDocumentIterator()
 {
     currThreshold_ = 0.0;
+    initThreshold_ = 0.0;
     currDoc_   = 0;
     pivotDoc_  = 0;
+    prunedDocCount_ = 0;
 }
 
 WANDDocumentIterator::~WANDDocumentIterator()
@@ -92,13 +96,14 @@ void WANDDocumentIterator::initThreshold(float threshold)
     {
         currThreshold_ = sumUBs * 0.5;
     }
+    initThreshold_ = currThreshold_;
 
     //LOG(INFO)<<"the initial currThreshold = "<<currThreshold_<<"for property:  "<<(*docIteratorList_.begin())->getProperty();
 }
 
 void WANDDocumentIterator::setThreshold(float realThreshold)
 {
-    currThreshold_ = realThreshold;
+    currThreshold_ = std::max(initThreshold_, realThreshold);
     //LOG(INFO)<<"the updated threshold :"<<currThreshold_;
 }
 
@@ -165,6 +170,8 @@ bool WANDDocumentIterator::processPrePostings(docid_t target)//multimap sorter a
     DocumentIterator* front = docIteratorSorter_.begin()->second;
     while (front != NULL && front->doc() < target)
     {
+        if (front->doc() != currDoc_)
+            ++prunedDocCount_;
         nFoundId = front->skipTo(target);
         if((MAX_DOC_ID == nFoundId) || (nFoundId < target))
         {
@@ -50,8 +50,17 @@ public:
 
     void initThreshold(float threshold);
 
+    /**
+     * raise the pivot threshold to @p realThreshold, it would not be lower
+     * than the one set by @c initThreshold().
+     */
     void setThreshold (float realThreshold);
 
+    count_t getPrunedDocCount()
+    {
+        return prunedDocCount_;
+    }
+
     bool next();
 
     docid_t doc()
@@ -106,8 +115,12 @@ protected:
 
     float currThreshold_;
 
+    float initThreshold_;
+
     docid_t pivotDoc_;
 
+    count_t prunedDocCount_;
+
     boost::mutex mutex_;
 };
 
@@ -26,9 +26,17 @@ public:
 
     bool test(uint32_t docId) const
     {
-        return !documentManager_.isDeleted(docId) &&
-            (!filterBitset_ || filterBitset_->test(docId)) &&
-            (!groupFilter_ || groupFilter_->test(docId));
+        if (documentManager_.isDeleted(docId) ||
+            (filterBitset_ && !filterBitset_->test(docId)))
+            return false;
+
+        if (!groupFilter_)
+            return true;
+
+        // the properties are retrieved in parallel,
+        // while the group filter is not thread safe
+        boost::mutex::scoped_lock lock(groupFilterMutex_);
+        return groupFilter_->test(docId);
     }
 
     uint32_t find_first(bool reverse) const
@@ -60,6 +68,7 @@ private:
     const DocumentManager& documentManager_;
     boost::shared_ptr<faceted::GroupFilter> groupFilter_;
     boost::shared_ptr<izenelib::ir::indexmanager::Bitset> filterBitset_;
+    mutable boost::mutex groupFilterMutex_;
 };
 
 } // namespace sf1r
@@ -26,6 +26,7 @@
 #include <common/XmlConfigParser.h>
 #include <common/CollectionManager.h>
 #include <common/CollectionTaskScheduler.h>
+#include <common/JobScheduler.h>
 
 #include <util/ustring/UString.h>
 #include <util/driver/IPRestrictor.h>
@@ -236,6 +237,10 @@ bool CobraProcess::initNodeManager()
 
         DistributeRequestHooker::get()->init();
         ReqLogMgr::initWriteRequestSet();
+
+        // the write requests are hooked one by one in distributed mode,
+        // so the tasks could neither run in parallel nor be nested
+        JobScheduler::get()->setSerialized(true);
     }
 
     return true;
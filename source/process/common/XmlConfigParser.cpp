@@ -1184,12 +1184,17 @@ void CollectionConfig::parseIndexBundleParam(const ticpp::Element * index, Colle
     params.Get("Sia/triggerqa", indexBundleConfig.bTriggerQA_);
     params.Get("Sia/enable_parallel_searching", indexBundleConfig.enable_parallel_searching_);
     params.Get("Sia/enable_forceget_doc", indexBundleConfig.enable_forceget_doc_);
+    params.Get("Sia/enable_column_doc_store", indexBundleConfig.enable_column_doc_store_);
     params.Get<std::size_t>("Sia/doccachenum", indexBundleConfig.documentCacheNum_);
     params.Get<std::size_t>("Sia/searchcachenum", indexBundleConfig.searchCacheNum_);
     params.Get("Sia/refreshsearchcache", indexBundleConfig.refreshSearchCache_);
     params.Get<time_t>("Sia/refreshcacheinterval", indexBundleConfig.refreshCacheInterval_);
     params.Get<std::size_t>("Sia/filtercachenum", indexBundleConfig.filterCacheNum_);
     params.Get<std::size_t>("Sia/mastersearchcachenum", indexBundleConfig.masterSearchCacheNum_);
+    params.Get<std::size_t>("Sia/distsearchdeadline", indexBundleConfig.distSearchDeadline_);
+    params.Get<std::size_t>("Sia/distsearchhedgedelay", indexBundleConfig.distSearchHedgeDelay_);
+    params.Get<std::size_t>("Sia/distsearchprefetchsummarynum", indexBundleConfig.distSearchPrefetchSummaryNum_);
+    params.Get<time_t>("Sia/distsearchresultttl", indexBundleConfig.distSearchResultTTL_);
     params.Get<std::size_t>("Sia/topknum", indexBundleConfig.topKNum_);
     params.Get<std::size_t>("Sia/sortcacheupdateinterval", indexBundleConfig.sortCacheUpdateInterval_);
     params.GetString("LanguageIdentifier/dbpath", indexBundleConfig.languageIdentifierDbPath_, "");
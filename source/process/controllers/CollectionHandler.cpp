@@ -89,7 +89,7 @@ bool CollectionHandler::create(const ::izenelib::driver::Value& document)
         return indexTaskService_->createDocument(document);
     }
     task_type task = boost::bind(&IndexTaskService::createDocument, indexTaskService_, document);
-    JobScheduler::get()->addTask(task, collection_);
+    JobScheduler::get()->addTask(task, collection_, JobScheduler::REALTIME_UPDATE);
     return true;
 }
 
@@ -100,7 +100,7 @@ bool CollectionHandler::update(const ::izenelib::driver::Value& document)
         return indexTaskService_->updateDocument(document);
     }
     task_type task = boost::bind(&IndexTaskService::updateDocument, indexTaskService_, document);
-    JobScheduler::get()->addTask(task, collection_);
+    JobScheduler::get()->addTask(task, collection_, JobScheduler::REALTIME_UPDATE);
     return true;
 }
 
@@ -111,7 +111,7 @@ bool CollectionHandler::update_inplace(const ::izenelib::driver::Value& request)
         return indexTaskService_->updateDocumentInplace(request);
     }
     task_type task = boost::bind(&IndexTaskService::updateDocumentInplace, indexTaskService_, request);
-    JobScheduler::get()->addTask(task, collection_);
+    JobScheduler::get()->addTask(task, collection_, JobScheduler::REALTIME_UPDATE);
     return true;
 }
 
@@ -122,7 +122,7 @@ bool CollectionHandler::destroy(const ::izenelib::driver::Value& document)
         return indexTaskService_->destroyDocument(document);
     }
     task_type task = boost::bind(&IndexTaskService::destroyDocument, indexTaskService_, document);
-    JobScheduler::get()->addTask(task, collection_);
+    JobScheduler::get()->addTask(task, collection_, JobScheduler::REALTIME_UPDATE);
     return true;
 }
 
@@ -116,7 +116,7 @@ void CommandsController::mining()
         return;
     }
     task_type task = boost::bind(&MiningTaskService::DoMiningCollectionFromAPI, miningService);
-    JobScheduler::get()->addTask(task, collectionName_);
+    JobScheduler::get()->addTask(task, collectionName_, JobScheduler::FULL_MINING);
 }
 
 /**
@@ -157,7 +157,7 @@ void CommandsController::optimize_index()
         return;
     }
     task_type task = boost::bind(&IndexTaskService::optimizeIndex, taskService);
-    JobScheduler::get()->addTask(task, collectionName_);
+    JobScheduler::get()->addTask(task, collectionName_, JobScheduler::OPTIMIZE_INDEX);
 }
 
 /*
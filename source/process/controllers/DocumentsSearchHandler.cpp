@@ -121,6 +121,8 @@ void DocumentsSearchHandler::search()
             if (doSearch(searchResult))
             {
                 response_[Keys::total_count] = searchResult.totalCount_;
+                if (searchResult.distSearchInfo_.isPartial_)
+                    response_[Keys::partial_result] = true;
 
                 std::size_t topKCount = searchResult.topKDocs_.size();
                 if(IsTopKComesFromConfig(actionItem_))
@@ -9,9 +9,11 @@
 #include <node-manager/NodeManagerBase.h>
 #include <node-manager/MasterManagerBase.h>
 #include <bundles/index/IndexTaskService.h>
+#include <bundles/index/IndexSearchService.h>
 
 #include <common/Status.h>
 #include <common/Keys.h>
+#include <common/JobScheduler.h>
 
 namespace sf1r
 {
@@ -60,6 +62,23 @@ bool StatusController::checkCollectionService(std::string& error)
  *     00:00:00 UTC) of the last modified time.
  *   - @b counter (@c UInt): A counter which is increased after each build
  * - @b mining (@c Object): Mining status. Same structure with @b index.
+ * - @b search_cache (@c Object): Statistics of the search cache on worker.
+ *   - @b hit_count (@c UInt): The number of cache hits.
+ *   - @b miss_count (@c UInt): The number of cache misses.
+ *   - @b invalidation_count (@c UInt): The number of cached results dropped
+ *     as their dependent properties have been updated.
+ * - @b master_search_cache (@c Object): Statistics of the search cache on
+ *   master. Same structure with @b search_cache.
+ * - @b task_queue (@c Object): Status of the index, optimize and mining tasks
+ *   of the collection in the job scheduler.
+ *   - @b status (@c String): @c running or @c idle.
+ *   - @b pending_count (@c UInt): The number of tasks waiting in queue.
+ *   - @b oldest_wait_time (@c Double): The seconds the oldest pending task
+ *     has waited.
+ *   - @b average_wait_time (@c Double): The average seconds the started
+ *     tasks have waited in queue.
+ *   - @b max_wait_time (@c Double): The max seconds the started tasks have
+ *     waited in queue.
  */
 void StatusController::index()
 {
@@ -87,6 +106,36 @@ void StatusController::index()
         indexStatusResponse[Keys::counter] = indexStatus.counter();
     }
 
+    // search cache
+    IndexSearchService* indexSearchService = collectionHandler_->indexSearchService_;
+    if (indexSearchService)
+    {
+        CacheStats masterStats;
+        CacheStats workerStats;
+        indexSearchService->getSearchCacheStats(masterStats, workerStats);
+
+        Value& workerCacheResponse = response()[Keys::search_cache];
+        workerCacheResponse[Keys::hit_count] = workerStats.hitNum;
+        workerCacheResponse[Keys::miss_count] = workerStats.missNum;
+        workerCacheResponse[Keys::invalidation_count] = workerStats.invalidationNum;
+
+        Value& masterCacheResponse = response()[Keys::master_search_cache];
+        masterCacheResponse[Keys::hit_count] = masterStats.hitNum;
+        masterCacheResponse[Keys::miss_count] = masterStats.missNum;
+        masterCacheResponse[Keys::invalidation_count] = masterStats.invalidationNum;
+    }
+
+    // task queue
+    JobScheduler::QueueStatus queueStatus;
+    JobScheduler::get()->getQueueStatus(collectionName_, queueStatus);
+
+    Value& taskQueueResponse = response()[Keys::task_queue];
+    taskQueueResponse[Keys::status] = queueStatus.isRunning_ ? "running" : "idle";
+    taskQueueResponse[Keys::pending_count] = queueStatus.pendingNum_;
+    taskQueueResponse[Keys::oldest_wait_time] = queueStatus.oldestWaitTime_;
+    taskQueueResponse[Keys::average_wait_time] = queueStatus.averageWaitTime_;
+    taskQueueResponse[Keys::max_wait_time] = queueStatus.maxWaitTime_;
+
     // mining
 //     Value& miningStatusResponse = response()[Keys::mining];
 //     miningStatusResponse[Keys::status] = "stopped";
@@ -155,14 +155,32 @@ private:
         req.params().convert(&params);
         NotifyMSG msg = params.get<0>();
 
-        if (msg.method == "CLEAR_SEARCH_CACHE")
+        if (msg.method == "CLEAR_SEARCH_CACHE" || msg.method == "INVALIDATE_SEARCH_CACHE")
         {
             CollectionManager::MutexType* mutex = CollectionManager::get()->getCollectionMutex(msg.collection);
             CollectionManager::ScopedReadLock lock(*mutex);
             CollectionHandler* collectionHandler = CollectionManager::get()->findHandler(msg.collection);
             if (collectionHandler)
             {
-                collectionHandler->indexSearchService_->OnUpdateSearchCache();
+                if (msg.method == "CLEAR_SEARCH_CACHE")
+                    collectionHandler->indexSearchService_->OnUpdateSearchCache();
+                else
+                    collectionHandler->indexSearchService_->OnInvalidateSearchCache(msg.properties);
+            }
+            else
+            {
+                std::string error = "No collectionHandler found for " + msg.collection;
+                req.error(error);
+            }
+        }
+        else if (msg.method == "UPDATE_TERM_STATS")
+        {
+            CollectionManager::MutexType* mutex = CollectionManager::get()->getCollectionMutex(msg.collection);
+            CollectionManager::ScopedReadLock lock(*mutex);
+            CollectionHandler* collectionHandler = CollectionManager::get()->findHandler(msg.collection);
+            if (collectionHandler)
+            {
+                collectionHandler->indexSearchService_->OnUpdateTermStats();
             }
             else
             {
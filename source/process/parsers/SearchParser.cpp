@@ -90,6 +90,12 @@ using driver::Keys;
  *   the search results only contain the longest suffix of query.
  *   If this is omitted, @b and searching mode is used as the default value.
  *   - @b zambezi search in the zambezi index (an in-memory inverted index).
+ *   \b dynamic_pruning is a switch for \b wand mode, if it is set as true,
+ *   documents whose score upper bound could not exceed the current top K
+ *   lowest score are skipped without being scored. It is ignored when the
+ *   result is sorted by other properties, or when grouping, counter or range
+ *   need to visit all hits. As the skipped documents are not counted, the
+ *   total count in the result is only an estimate (a lower bound) in this mode.
  * - @b log_keywords (@c Bool = @c true): Whether the keywords should be
  *   logged.
  * - @b analyzer (@c Object): Keywords analyzer options
@@ -431,6 +437,12 @@ bool SearchParser::parse(const Value& search)
         {
             searchingModeInfo_.usefuzzy_ = asBool(searching_mode[Keys::use_fuzzy]);
         }
+
+        if (searching_mode.hasKey(Keys::dynamic_pruning))
+        {
+            searchingModeInfo_.useDynamicPruning_ = asBool(searching_mode[Keys::dynamic_pruning]);
+        }
+
         if (searching_mode.hasKey(Keys::filter_mode))
         {
             Value::StringType filter_mode = asString(searching_mode[Keys::filter_mode]);
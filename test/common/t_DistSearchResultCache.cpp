@@ -0,0 +1,224 @@
+#include <common/DistSearchResultCache.h>
+
+#include <boost/test/unit_test.hpp>
+#include <set>
+#include <string>
+#include <utility> // make_pair
+#include <vector>
+#include <unistd.h> // sleep
+
+using namespace sf1r;
+
+namespace
+{
+/** the max number of docs retrieved in searching */
+const std::size_t kLimit = 10;
+
+/** the end of the first page */
+const std::size_t kPageEnd = 2;
+
+void makeKey(const std::string& query, DistSearchResultCache::key_type& key)
+{
+    key.query = query;
+    key.properties.push_back("Title");
+}
+
+void makeResult(KeywordSearchResult& result)
+{
+    result.totalCount_ = 3;
+    result.topKDocs_.push_back(7);
+    result.topKDocs_.push_back(3);
+    result.topKDocs_.push_back(5);
+    result.start_ = 0;
+    result.count_ = 2;
+
+    result.distSearchInfo_.include_summary_data_ = true;
+    result.fullTextOfDocumentInPage_.resize(1);
+    result.fullTextOfDocumentInPage_[0].resize(2);
+}
+
+void setResult(
+    DistSearchResultCache& cache,
+    const DistSearchResultCache::key_type& key,
+    KeywordSearchResult& result)
+{
+    GenerationSnapshot snapshot;
+    cache.takeSnapshot(key, snapshot);
+    cache.set(key, kLimit, result, snapshot);
+}
+}
+
+BOOST_AUTO_TEST_SUITE(DistSearchResultCache_test)
+
+BOOST_AUTO_TEST_CASE(testGetAndSet)
+{
+    DistSearchResultCache cache(10, 30);
+    BOOST_CHECK(cache.isEnabled());
+
+    DistSearchResultCache::key_type key;
+    makeKey("apple", key);
+
+    KeywordSearchResult result;
+    BOOST_CHECK(!cache.get(key, kPageEnd, result));
+
+    KeywordSearchResult searched;
+    makeResult(searched);
+    setResult(cache, key, searched);
+
+    // the page summary is kept in the result set
+    BOOST_CHECK(searched.distSearchInfo_.include_summary_data_);
+    BOOST_CHECK_EQUAL(searched.fullTextOfDocumentInPage_.size(), 1U);
+
+    // but not in the cache
+    BOOST_REQUIRE(cache.get(key, kPageEnd, result));
+    BOOST_CHECK_EQUAL(result.totalCount_, 3U);
+    BOOST_CHECK_EQUAL_COLLECTIONS(result.topKDocs_.begin(), result.topKDocs_.end(),
+                                  searched.topKDocs_.begin(), searched.topKDocs_.end());
+    BOOST_CHECK(!result.distSearchInfo_.include_summary_data_);
+    BOOST_CHECK(result.fullTextOfDocumentInPage_.empty());
+
+    DistSearchResultCache::key_type otherKey;
+    makeKey("orange", otherKey);
+    BOOST_CHECK(!cache.get(otherKey, kPageEnd, result));
+
+    CacheStats stats = cache.getStats();
+    BOOST_CHECK_EQUAL(stats.hitNum, 1U);
+    BOOST_CHECK_EQUAL(stats.missNum, 2U);
+}
+
+BOOST_AUTO_TEST_CASE(testPageRange)
+{
+    DistSearchResultCache cache(10, 30);
+
+    DistSearchResultCache::key_type key;
+    makeKey("apple", key);
+
+    // the top kLimit docs are retrieved, and there are more matched docs
+    KeywordSearchResult searched;
+    makeResult(searched);
+    searched.topKDocs_.resize(kLimit, 9);
+    setResult(cache, key, searched);
+
+    KeywordSearchResult result;
+    BOOST_CHECK(cache.get(key, kPageEnd, result));
+    BOOST_CHECK(cache.get(key, kLimit, result));
+
+    // the page is beyond the docs retrieved
+    BOOST_CHECK(!cache.get(key, kLimit + 1, result));
+
+    // all the matched docs are retrieved
+    KeywordSearchResult allSearched;
+    makeResult(allSearched);
+    setResult(cache, key, allSearched);
+    BOOST_CHECK(cache.get(key, kLimit + 1, result));
+    BOOST_CHECK_EQUAL(result.topKDocs_.size(), 3U);
+}
+
+BOOST_AUTO_TEST_CASE(testInvalidate)
+{
+    DistSearchResultCache cache(10, 30);
+
+    DistSearchResultCache::key_type key;
+    makeKey("apple", key);
+
+    KeywordSearchResult searched;
+    makeResult(searched);
+    setResult(cache, key, searched);
+
+    // the property not depended
+    cache.invalidate(std::vector<std::string>(1, "Price"));
+    KeywordSearchResult result;
+    BOOST_CHECK(cache.get(key, kPageEnd, result));
+
+    cache.invalidate(std::vector<std::string>(1, "Title"));
+    BOOST_CHECK(!cache.get(key, kPageEnd, result));
+    BOOST_CHECK_EQUAL(cache.getStats().invalidationNum, 1U);
+
+    setResult(cache, key, searched);
+    cache.clear();
+    BOOST_CHECK(!cache.get(key, kPageEnd, result));
+}
+
+BOOST_AUTO_TEST_CASE(testUpdateDuringSearch)
+{
+    DistSearchResultCache cache(10, 30);
+
+    DistSearchResultCache::key_type key;
+    makeKey("apple", key);
+
+    // the snapshot is taken before searching
+    GenerationSnapshot snapshot;
+    cache.takeSnapshot(key, snapshot);
+
+    // the property is updated during searching
+    cache.invalidate(std::vector<std::string>(1, "Title"));
+
+    KeywordSearchResult searched;
+    makeResult(searched);
+    cache.set(key, kLimit, searched, snapshot);
+
+    KeywordSearchResult result;
+    BOOST_CHECK(!cache.get(key, kPageEnd, result));
+
+    // the cache is cleared during searching
+    cache.takeSnapshot(key, snapshot);
+    cache.clear();
+    cache.set(key, kLimit, searched, snapshot);
+    BOOST_CHECK(!cache.get(key, kPageEnd, result));
+}
+
+BOOST_AUTO_TEST_CASE(testProductRankProperties)
+{
+    DistSearchResultCache cache(10, 30);
+
+    std::set<std::string> productRankProps;
+    productRankProps.insert("Category");
+    cache.setProductRankProperties(productRankProps);
+
+    DistSearchResultCache::key_type rankKey;
+    makeKey("apple", rankKey);
+    rankKey.sortInfo.push_back(std::make_pair("_rank", false));
+
+    DistSearchResultCache::key_type priceKey;
+    makeKey("apple", priceKey);
+    priceKey.sortInfo.push_back(std::make_pair("Price", true));
+
+    KeywordSearchResult searched;
+    makeResult(searched);
+    setResult(cache, rankKey, searched);
+    setResult(cache, priceKey, searched);
+
+    cache.invalidate(std::vector<std::string>(1, "Category"));
+
+    // only the result ranked by product ranking depends on "Category"
+    KeywordSearchResult result;
+    BOOST_CHECK(!cache.get(rankKey, kPageEnd, result));
+    BOOST_CHECK(cache.get(priceKey, kPageEnd, result));
+
+    cache.invalidate(std::vector<std::string>(1, "Price"));
+    BOOST_CHECK(!cache.get(priceKey, kPageEnd, result));
+}
+
+BOOST_AUTO_TEST_CASE(testExpire)
+{
+    DistSearchResultCache::key_type key;
+    makeKey("apple", key);
+
+    DistSearchResultCache disabledCache(10, 0);
+    BOOST_CHECK(!disabledCache.isEnabled());
+
+    KeywordSearchResult searched;
+    makeResult(searched);
+    setResult(disabledCache, key, searched);
+    KeywordSearchResult result;
+    BOOST_CHECK(!disabledCache.get(key, kPageEnd, result));
+
+    DistSearchResultCache cache(10, 1);
+    setResult(cache, key, searched);
+    BOOST_CHECK(cache.get(key, kPageEnd, result));
+
+    sleep(2);
+    BOOST_CHECK(!cache.get(key, kPageEnd, result));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
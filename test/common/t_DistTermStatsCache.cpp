@@ -0,0 +1,128 @@
+#include <common/DistTermStatsCache.h>
+
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include <vector>
+
+using namespace sf1r;
+
+namespace
+{
+void makeActionItem(
+    const std::string& query,
+    const std::string& prop,
+    KeywordSearchActionItem& item)
+{
+    item.env_.queryString_ = query;
+    item.searchingMode_.mode_ = SearchingMode::WAND;
+    item.searchPropertyList_.push_back(prop);
+}
+
+void makeTermStats(float df, DistKeywordSearchInfo& info)
+{
+    info.dfmap_["Title"][1] = df;
+    info.ctfmap_["Title"][1] = df * 2;
+    info.maxtfmap_["Title"][1] = 3;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(DistTermStatsCache_test)
+
+BOOST_AUTO_TEST_CASE(testGetAndSet)
+{
+    DistTermStatsCache cache(10);
+
+    KeywordSearchActionItem item;
+    makeActionItem("apple", "Title", item);
+    DistTermStatsCache::key_type key;
+    DistTermStatsCache::makeKey(item, key);
+
+    DistKeywordSearchInfo info;
+    BOOST_CHECK(!cache.get(key, info));
+
+    GenerationSnapshot snapshot;
+    cache.takeSnapshot(key, snapshot);
+    DistKeywordSearchInfo gathered;
+    makeTermStats(5, gathered);
+    cache.set(key, gathered, snapshot);
+
+    // the fields not deciding the query terms are not in key
+    KeywordSearchActionItem pageItem = item;
+    pageItem.pageInfo_.start_ = 20;
+    pageItem.sortPriorityList_.push_back(std::make_pair("Price", false));
+    DistTermStatsCache::key_type pageKey;
+    DistTermStatsCache::makeKey(pageItem, pageKey);
+
+    BOOST_REQUIRE(cache.get(pageKey, info));
+    BOOST_CHECK_EQUAL(info.dfmap_["Title"][1], 5);
+    BOOST_CHECK_EQUAL(info.ctfmap_["Title"][1], 10);
+    BOOST_CHECK_EQUAL(info.maxtfmap_["Title"][1], 3);
+
+    KeywordSearchActionItem otherItem;
+    makeActionItem("orange", "Title", otherItem);
+    DistTermStatsCache::key_type otherKey;
+    DistTermStatsCache::makeKey(otherItem, otherKey);
+    DistKeywordSearchInfo otherInfo;
+    BOOST_CHECK(!cache.get(otherKey, otherInfo));
+
+    CacheStats stats = cache.getStats();
+    BOOST_CHECK_EQUAL(stats.hitNum, 1U);
+    BOOST_CHECK_EQUAL(stats.missNum, 2U);
+}
+
+BOOST_AUTO_TEST_CASE(testInvalidate)
+{
+    DistTermStatsCache cache(10);
+
+    KeywordSearchActionItem item;
+    makeActionItem("apple", "Title", item);
+    DistTermStatsCache::key_type key;
+    DistTermStatsCache::makeKey(item, key);
+
+    GenerationSnapshot snapshot;
+    cache.takeSnapshot(key, snapshot);
+    DistKeywordSearchInfo gathered;
+    makeTermStats(5, gathered);
+    cache.set(key, gathered, snapshot);
+
+    // the property not searched
+    cache.invalidate(std::vector<std::string>(1, "Price"));
+    DistKeywordSearchInfo info;
+    BOOST_CHECK(cache.get(key, info));
+
+    cache.invalidate(std::vector<std::string>(1, "Title"));
+    BOOST_CHECK(!cache.get(key, info));
+
+    cache.takeSnapshot(key, snapshot);
+    cache.set(key, gathered, snapshot);
+    BOOST_CHECK(cache.get(key, info));
+
+    cache.clear();
+    BOOST_CHECK(!cache.get(key, info));
+    BOOST_CHECK_EQUAL(cache.getStats().invalidationNum, 2U);
+}
+
+BOOST_AUTO_TEST_CASE(testUpdateWhileGathering)
+{
+    DistTermStatsCache cache(10);
+
+    KeywordSearchActionItem item;
+    makeActionItem("apple", "Title", item);
+    DistTermStatsCache::key_type key;
+    DistTermStatsCache::makeKey(item, key);
+
+    GenerationSnapshot snapshot;
+    cache.takeSnapshot(key, snapshot);
+
+    // a worker indexes before the gathered statistics are set
+    cache.clear();
+
+    DistKeywordSearchInfo gathered;
+    makeTermStats(5, gathered);
+    cache.set(key, gathered, snapshot);
+
+    DistKeywordSearchInfo info;
+    BOOST_CHECK(!cache.get(key, info));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
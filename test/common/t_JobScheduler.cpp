@@ -0,0 +1,298 @@
+#include <common/JobScheduler.h>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <string>
+#include <vector>
+
+using namespace sf1r;
+
+namespace
+{
+/** the max seconds to wait in each test */
+const int kTimeoutSeconds = 10;
+
+class TaskRecorder
+{
+public:
+    TaskRecorder() : isGateOpen_(false) {}
+
+    void record(const std::string& name)
+    {
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        names_.push_back(name);
+        cond_.notify_all();
+    }
+
+    /** record @p name, then wait until the gate is open */
+    void block(const std::string& name)
+    {
+        record(name);
+
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        while (!isGateOpen_)
+        {
+            cond_.wait(lock);
+        }
+    }
+
+    /** record @p name, then run until the gate is open or timeout */
+    void runUntilOpen(const std::string& name)
+    {
+        record(name);
+
+        const boost::posix_time::ptime deadline =
+            boost::posix_time::microsec_clock::universal_time() +
+            boost::posix_time::seconds(kTimeoutSeconds);
+
+        while (!isOpen())
+        {
+            if (boost::posix_time::microsec_clock::universal_time() > deadline)
+            {
+                record("timeout");
+                return;
+            }
+
+            boost::this_thread::interruption_point();
+            JobScheduler::preemptionPoint();
+            boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+        }
+    }
+
+    void open()
+    {
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        isGateOpen_ = true;
+        cond_.notify_all();
+    }
+
+    bool isOpen()
+    {
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        return isGateOpen_;
+    }
+
+    /** wait until @p num names are recorded */
+    bool waitRecordNum(std::size_t num)
+    {
+        const boost::system_time deadline = boost::get_system_time() +
+            boost::posix_time::seconds(kTimeoutSeconds);
+
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        while (names_.size() < num)
+        {
+            if (!cond_.timed_wait(lock, deadline))
+                return false;
+        }
+        return true;
+    }
+
+    std::string names()
+    {
+        boost::unique_lock<boost::mutex> lock(mutex_);
+        std::string result;
+        for (std::size_t i = 0; i < names_.size(); ++i)
+        {
+            result += names_[i];
+            result += ";";
+        }
+        return result;
+    }
+
+private:
+    boost::mutex mutex_;
+    boost::condition_variable cond_;
+    std::vector<std::string> names_;
+    bool isGateOpen_;
+};
+
+task_type recordTask(TaskRecorder& recorder, const std::string& name)
+{
+    return boost::bind(&TaskRecorder::record, &recorder, name);
+}
+
+task_type blockTask(TaskRecorder& recorder, const std::string& name)
+{
+    return boost::bind(&TaskRecorder::block, &recorder, name);
+}
+
+task_type runUntilOpenTask(TaskRecorder& recorder, const std::string& name)
+{
+    return boost::bind(&TaskRecorder::runUntilOpen, &recorder, name);
+}
+
+/** run until the gate is open, then record it is finished */
+void runUntilOpenThenFinish(TaskRecorder& recorder, const std::string& name)
+{
+    recorder.runUntilOpen(name);
+    recorder.record(name + " finished");
+}
+}
+
+BOOST_AUTO_TEST_SUITE(JobScheduler_test)
+
+BOOST_AUTO_TEST_CASE(testCollectionOrder)
+{
+    JobScheduler scheduler;
+    TaskRecorder recorder;
+
+    // the less urgent task added before is run first in the same collection
+    scheduler.addTask(recordTask(recorder, "a1"), "a", JobScheduler::FULL_MINING);
+    scheduler.addTask(recordTask(recorder, "a2"), "a", JobScheduler::REALTIME_UPDATE);
+    scheduler.addTask(recordTask(recorder, "a3"), "a", JobScheduler::OPTIMIZE_INDEX);
+    scheduler.waitCurrentFinish("a");
+
+    BOOST_CHECK_EQUAL(recorder.names(), "a1;a2;a3;");
+
+    JobScheduler::QueueStatus status;
+    BOOST_CHECK(scheduler.getQueueStatus("a", status));
+    BOOST_CHECK_EQUAL(status.collection_, "a");
+    BOOST_CHECK_EQUAL(status.pendingNum_, 0U);
+    BOOST_CHECK(!status.isRunning_);
+    BOOST_CHECK(!scheduler.getQueueStatus("b", status));
+}
+
+BOOST_AUTO_TEST_CASE(testPriority)
+{
+    JobScheduler scheduler;
+    scheduler.setWorkerNum(2);
+    TaskRecorder recorder;
+    TaskRecorder otherRecorder;
+
+    scheduler.addTask(blockTask(recorder, "a1"), "a");
+    scheduler.addTask(blockTask(otherRecorder, "b1"), "b");
+    BOOST_REQUIRE(recorder.waitRecordNum(1));
+    BOOST_REQUIRE(otherRecorder.waitRecordNum(1));
+
+    scheduler.addTask(recordTask(recorder, "c1"), "c", JobScheduler::FULL_MINING);
+    scheduler.addTask(recordTask(recorder, "d1"), "d", JobScheduler::OPTIMIZE_INDEX);
+    scheduler.addTask(recordTask(recorder, "e1"), "e", JobScheduler::REALTIME_UPDATE);
+
+    JobScheduler::QueueStatus status;
+    BOOST_CHECK(scheduler.getQueueStatus("a", status));
+    BOOST_CHECK(status.isRunning_);
+    BOOST_CHECK(scheduler.getQueueStatus("c", status));
+    BOOST_CHECK_EQUAL(status.pendingNum_, 1U);
+    BOOST_CHECK(!status.isRunning_);
+
+    std::vector<JobScheduler::QueueStatus> statusList;
+    scheduler.getQueueStatus(statusList);
+    BOOST_CHECK_EQUAL(statusList.size(), 5U);
+
+    // only one worker is free, the blocked tasks are not preempted,
+    // as they do not check preemption
+    recorder.open();
+    scheduler.waitCurrentFinish("c");
+    BOOST_CHECK_EQUAL(recorder.names(), "a1;e1;d1;c1;");
+
+    otherRecorder.open();
+    scheduler.waitCurrentFinish();
+    BOOST_CHECK_EQUAL(otherRecorder.names(), "b1;");
+}
+
+BOOST_AUTO_TEST_CASE(testPreemption)
+{
+    JobScheduler scheduler;
+    scheduler.setWorkerNum(2);
+    TaskRecorder recorder;
+
+    scheduler.addTask(runUntilOpenTask(recorder, "a1"), "a");
+    scheduler.addTask(runUntilOpenTask(recorder, "b1"), "b");
+    BOOST_REQUIRE(recorder.waitRecordNum(2));
+
+    // a less urgent task is not run inline
+    scheduler.addTask(recordTask(recorder, "c1"), "c", JobScheduler::FULL_MINING);
+    scheduler.addTask(boost::bind(&TaskRecorder::open, &recorder),
+                      "d", JobScheduler::REALTIME_UPDATE);
+
+    BOOST_CHECK(recorder.waitRecordNum(3));
+    scheduler.waitCurrentFinish();
+
+    BOOST_CHECK(recorder.isOpen());
+    BOOST_CHECK_EQUAL(recorder.names().substr(6), "c1;");
+}
+
+BOOST_AUTO_TEST_CASE(testSerialized)
+{
+    JobScheduler scheduler;
+    scheduler.setSerialized(true);
+    TaskRecorder recorder;
+
+    scheduler.addTask(runUntilOpenTask(recorder, "a1"), "a");
+    BOOST_REQUIRE(recorder.waitRecordNum(1));
+
+    // the urgent task is neither run by the free worker nor run inline
+    scheduler.addTask(recordTask(recorder, "b1"), "b", JobScheduler::REALTIME_UPDATE);
+    boost::this_thread::sleep(boost::posix_time::milliseconds(100));
+    BOOST_CHECK_EQUAL(recorder.names(), "a1;");
+
+    JobScheduler::QueueStatus status;
+    BOOST_CHECK(scheduler.getQueueStatus("b", status));
+    BOOST_CHECK_EQUAL(status.pendingNum_, 1U);
+
+    // the more urgent task is selected first among the pending tasks
+    scheduler.addTask(recordTask(recorder, "c1"), "c", JobScheduler::FULL_MINING);
+    recorder.open();
+    scheduler.waitCurrentFinish();
+    BOOST_CHECK_EQUAL(recorder.names(), "a1;b1;c1;");
+}
+
+BOOST_AUTO_TEST_CASE(testRemoveTask)
+{
+    JobScheduler scheduler;
+    TaskRecorder recorder;
+
+    scheduler.addTask(runUntilOpenTask(recorder, "a1"), "a");
+    BOOST_REQUIRE(recorder.waitRecordNum(1));
+
+    scheduler.addTask(recordTask(recorder, "a2"), "a");
+    scheduler.removeTask("a");
+
+    JobScheduler::QueueStatus status;
+    BOOST_CHECK(!scheduler.getQueueStatus("a", status));
+    BOOST_CHECK(!recorder.isOpen());
+
+    scheduler.addTask(recordTask(recorder, "a3"), "a");
+    scheduler.waitCurrentFinish("a");
+    BOOST_CHECK_EQUAL(recorder.names(), "a1;a3;");
+}
+
+BOOST_AUTO_TEST_CASE(testRemovePreemptedTask)
+{
+    JobScheduler scheduler;
+    TaskRecorder recorder;
+    TaskRecorder urgentRecorder;
+
+    // by default, there is only one worker
+    scheduler.addTask(runUntilOpenTask(recorder, "a1"), "a");
+    BOOST_REQUIRE(recorder.waitRecordNum(1));
+
+    // the urgent task is run inline in the task of collection "a"
+    scheduler.addTask(boost::bind(&runUntilOpenThenFinish,
+                                  boost::ref(urgentRecorder), "b1"),
+                      "b", JobScheduler::REALTIME_UPDATE);
+    BOOST_REQUIRE(urgentRecorder.waitRecordNum(1));
+
+    // it waits for the task of collection "a" to be interrupted
+    boost::thread removeThread(&JobScheduler::removeTask, &scheduler, "a");
+
+    JobScheduler::QueueStatus status;
+    BOOST_CHECK(!removeThread.timed_join(boost::posix_time::milliseconds(100)));
+    BOOST_CHECK(scheduler.getQueueStatus("a", status));
+
+    // the inline task is not interrupted, and the task of collection "a"
+    // is interrupted once the inline task returns
+    urgentRecorder.open();
+    BOOST_CHECK(removeThread.timed_join(boost::posix_time::seconds(kTimeoutSeconds)));
+    BOOST_CHECK_EQUAL(urgentRecorder.names(), "b1;b1 finished;");
+    BOOST_CHECK_EQUAL(recorder.names(), "a1;");
+    BOOST_CHECK(!scheduler.getQueueStatus("a", status));
+
+    scheduler.addTask(recordTask(recorder, "a2"), "a");
+    scheduler.waitCurrentFinish();
+    BOOST_CHECK_EQUAL(recorder.names(), "a1;a2;");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
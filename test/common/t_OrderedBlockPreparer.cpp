@@ -0,0 +1,172 @@
+#include <common/OrderedBlockPreparer.h>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <stdexcept>
+#include <vector>
+#include <cstdlib>
+
+using namespace sf1r;
+
+namespace
+{
+const std::size_t kThreadNum = 4;
+
+const std::size_t kBlockNum = 100;
+
+const std::size_t kBlockSize = 10;
+
+const std::size_t kMaxPendingNum = kThreadNum * 2;
+
+struct DocBlock
+{
+    std::vector<unsigned int> docIds;
+    bool isPrepared;
+
+    DocBlock() : isPrepared(false) {}
+};
+typedef boost::shared_ptr<DocBlock> DocBlockPtr;
+
+DocBlockPtr createBlock(unsigned int startDocId)
+{
+    DocBlockPtr block(new DocBlock);
+    for (std::size_t i = 0; i < kBlockSize; ++i)
+    {
+        block->docIds.push_back(startDocId + i);
+    }
+    return block;
+}
+
+/** the later blocks might be prepared before the earlier ones */
+void prepareBlock(DocBlock& block)
+{
+    boost::this_thread::sleep(boost::posix_time::microseconds(std::rand() % 1000));
+    block.isPrepared = true;
+}
+
+class BlockConsumer
+{
+public:
+    BlockConsumer() : failDocId_(0) {}
+
+    void setFailDocId(unsigned int docId)
+    {
+        failDocId_ = docId;
+    }
+
+    void consume(DocBlock& block)
+    {
+        BOOST_CHECK(block.isPrepared);
+
+        if (failDocId_ == block.docIds.front())
+            throw std::runtime_error("fail to consume");
+
+        docIds_.insert(docIds_.end(), block.docIds.begin(), block.docIds.end());
+    }
+
+    const std::vector<unsigned int>& docIds() const
+    {
+        return docIds_;
+    }
+
+private:
+    unsigned int failDocId_;
+    std::vector<unsigned int> docIds_;
+};
+
+void checkDocIdOrder(const std::vector<unsigned int>& docIds,
+                     unsigned int startDocId,
+                     std::size_t docNum)
+{
+    BOOST_REQUIRE_EQUAL(docIds.size(), docNum);
+
+    for (std::size_t i = 0; i < docNum; ++i)
+    {
+        BOOST_CHECK_EQUAL(docIds[i], startDocId + i);
+    }
+}
+}
+
+BOOST_AUTO_TEST_SUITE(OrderedBlockPreparer_test)
+
+BOOST_AUTO_TEST_CASE(testLazyStart)
+{
+    BlockConsumer consumer;
+    OrderedBlockPreparer<DocBlock> preparer(
+        kThreadNum, &prepareBlock,
+        boost::bind(&BlockConsumer::consume, &consumer, _1));
+
+    BOOST_CHECK_EQUAL(preparer.startedThreadNum(), 0U);
+
+    preparer.consume(0);
+    BOOST_CHECK_EQUAL(preparer.startedThreadNum(), 0U);
+
+    preparer.add(createBlock(1));
+    BOOST_CHECK_EQUAL(preparer.startedThreadNum(), kThreadNum);
+
+    preparer.add(createBlock(1 + kBlockSize));
+    BOOST_CHECK_EQUAL(preparer.startedThreadNum(), kThreadNum);
+
+    preparer.consume(0);
+    BOOST_CHECK_EQUAL(preparer.pendingNum(), 0U);
+    checkDocIdOrder(consumer.docIds(), 1, kBlockSize * 2);
+}
+
+BOOST_AUTO_TEST_CASE(testConsumeInDocIdOrder)
+{
+    BlockConsumer consumer;
+    OrderedBlockPreparer<DocBlock> preparer(
+        kThreadNum, &prepareBlock,
+        boost::bind(&BlockConsumer::consume, &consumer, _1));
+
+    for (std::size_t i = 0; i < kBlockNum; ++i)
+    {
+        preparer.add(createBlock(1 + i * kBlockSize));
+        preparer.consume(kMaxPendingNum);
+        BOOST_CHECK_LE(preparer.pendingNum(), kMaxPendingNum);
+    }
+
+    preparer.consume(0);
+    BOOST_CHECK_EQUAL(preparer.pendingNum(), 0U);
+    checkDocIdOrder(consumer.docIds(), 1, kBlockNum * kBlockSize);
+}
+
+BOOST_AUTO_TEST_CASE(testResetAfterException)
+{
+    BlockConsumer consumer;
+    OrderedBlockPreparer<DocBlock> preparer(
+        kThreadNum, &prepareBlock,
+        boost::bind(&BlockConsumer::consume, &consumer, _1));
+
+    const unsigned int failDocId = 1 + 3 * kBlockSize;
+    consumer.setFailDocId(failDocId);
+
+    for (std::size_t i = 0; i < kMaxPendingNum; ++i)
+    {
+        preparer.add(createBlock(1 + i * kBlockSize));
+    }
+
+    BOOST_CHECK_THROW(preparer.consume(0), std::runtime_error);
+    checkDocIdOrder(consumer.docIds(), 1, failDocId - 1);
+
+    // the blocks left are dropped
+    preparer.reset();
+    BOOST_CHECK_EQUAL(preparer.pendingNum(), 0U);
+
+    // the blocks added later are consumed as usual
+    consumer.setFailDocId(0);
+
+    const unsigned int startDocId = 1 + kMaxPendingNum * kBlockSize;
+    for (std::size_t i = 0; i < kBlockNum; ++i)
+    {
+        preparer.add(createBlock(startDocId + i * kBlockSize));
+    }
+    preparer.consume(0);
+
+    std::vector<unsigned int> nextDocIds(
+        consumer.docIds().begin() + failDocId - 1, consumer.docIds().end());
+    checkDocIdOrder(nextDocIds, startDocId, kBlockNum * kBlockSize);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,74 @@
+#include <common/PropertyGenerations.h>
+
+#include <boost/test/unit_test.hpp>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace sf1r;
+
+namespace
+{
+std::vector<std::string> makeProps(const std::string& prop)
+{
+    return std::vector<std::string>(1, prop);
+}
+}
+
+BOOST_AUTO_TEST_SUITE(PropertyGenerations_test)
+
+BOOST_AUTO_TEST_CASE(testPropGeneration)
+{
+    PropertyGenerations generations;
+
+    std::set<std::string> props;
+    props.insert("Title");
+    props.insert("Price");
+
+    GenerationSnapshot snapshot;
+    generations.takeSnapshot(&props, snapshot);
+    BOOST_CHECK(generations.isValid(snapshot));
+
+    // update the property not depended on
+    generations.increasePropGeneration(makeProps("Content"));
+    BOOST_CHECK(generations.isValid(snapshot));
+
+    generations.increasePropGeneration(makeProps("Price"));
+    BOOST_CHECK(!generations.isValid(snapshot));
+
+    // a new snapshot is valid again
+    generations.takeSnapshot(&props, snapshot);
+    BOOST_CHECK(generations.isValid(snapshot));
+
+    // empty update changes nothing
+    generations.increasePropGeneration(std::vector<std::string>());
+    BOOST_CHECK(generations.isValid(snapshot));
+}
+
+BOOST_AUTO_TEST_CASE(testAllProps)
+{
+    PropertyGenerations generations;
+
+    GenerationSnapshot snapshot;
+    generations.takeSnapshot(NULL, snapshot);
+    BOOST_CHECK(generations.isValid(snapshot));
+
+    generations.increasePropGeneration(makeProps("Content"));
+    BOOST_CHECK(!generations.isValid(snapshot));
+}
+
+BOOST_AUTO_TEST_CASE(testDocGeneration)
+{
+    PropertyGenerations generations;
+
+    std::set<std::string> props;
+    props.insert("Title");
+
+    GenerationSnapshot snapshot;
+    generations.takeSnapshot(&props, snapshot);
+
+    generations.increaseDocGeneration();
+    BOOST_CHECK(!generations.isValid(snapshot));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,186 @@
+#include <common/ScdParallelParser.h>
+#include <common/PropertyValue.h>
+#include "ScdBuilder.h"
+
+#include <boost/test/unit_test.hpp>
+#include <string>
+#include <vector>
+
+using namespace sf1r;
+
+namespace
+{
+const std::string kFileName("B-00-201301011000-11111-I-C.SCD");
+
+const int kDocNum = 10;
+
+const std::size_t kMaxThreadNum = 1000;
+
+const std::size_t kWindowSize = 2;
+
+fs::path createCleanTempDir(const std::string& name)
+{
+    fs::path tmpdir = fs::path("tmp") / "ScdParallelParser" / name;
+    fs::remove_all(tmpdir);
+    fs::create_directories(tmpdir);
+
+    return tmpdir;
+}
+
+/**
+ * create the SCD file, the content of some docs contains "<DOCID>",
+ * which is not at the beginning of a line, so it is not a doc boundary.
+ */
+void createScd(const fs::path& scdPath)
+{
+    ScdBuilder scd(scdPath);
+    for (int i = 1; i <= kDocNum; ++i)
+    {
+        scd("DOCID") << i;
+        scd("Title") << "Title " << i;
+
+        if (i % 3 == 0)
+        {
+            scd("Content") << "Content " << i << " <DOCID>" << i + 100;
+        }
+        else
+        {
+            scd("Content") << "Content " << i;
+        }
+    }
+}
+
+struct ParsedDoc
+{
+    std::string docId;
+    std::string content;
+    offset_type offset;
+};
+
+void parseInSequence(const std::string& fileName, std::vector<ParsedDoc>& docs)
+{
+    ScdParser parser(izenelib::util::UString::UTF_8);
+    BOOST_REQUIRE(parser.load(fileName));
+
+    for (ScdParser::iterator it = parser.begin(); it != parser.end(); ++it)
+    {
+        SCDDocPtr doc = *it;
+        BOOST_REQUIRE(doc);
+        BOOST_REQUIRE_EQUAL(doc->size(), 3U);
+
+        ParsedDoc parsedDoc;
+        parsedDoc.docId = propstr_to_str((*doc)[0].second);
+        parsedDoc.content = propstr_to_str((*doc)[2].second);
+        parsedDoc.offset = it.getOffset();
+        docs.push_back(parsedDoc);
+    }
+}
+
+void checkParseInParallel(
+    const std::string& fileName,
+    offset_type chunkSize,
+    const std::vector<ParsedDoc>& expectDocs)
+{
+    ScdParallelParser parser(izenelib::util::UString::UTF_8,
+                             kMaxThreadNum, kWindowSize, chunkSize);
+    BOOST_REQUIRE(parser.load(fileName));
+
+    SCDDocPtr doc;
+    offset_type offset = 0;
+    std::size_t docNum = 0;
+
+    for (; parser.next(doc, offset); ++docNum)
+    {
+        BOOST_REQUIRE(doc);
+        BOOST_REQUIRE_LT(docNum, expectDocs.size());
+
+        const ParsedDoc& expectDoc = expectDocs[docNum];
+        BOOST_CHECK_EQUAL(propstr_to_str((*doc)[0].second), expectDoc.docId);
+        BOOST_CHECK_EQUAL(propstr_to_str((*doc)[2].second), expectDoc.content);
+        BOOST_CHECK_EQUAL(offset, expectDoc.offset);
+    }
+
+    BOOST_CHECK_MESSAGE(docNum == expectDocs.size(),
+                        "chunk size: " << chunkSize
+                        << ", doc num: " << docNum);
+}
+}
+
+BOOST_AUTO_TEST_SUITE(ScdParallelParser_test)
+
+BOOST_AUTO_TEST_CASE(testSplitAtDocBegin)
+{
+    fs::path scdPath = createCleanTempDir("testSplitAtDocBegin") / kFileName;
+    createScd(scdPath);
+
+    std::vector<ParsedDoc> expectDocs;
+    parseInSequence(scdPath.string(), expectDocs);
+    BOOST_REQUIRE_EQUAL(expectDocs.size(), static_cast<std::size_t>(kDocNum));
+
+    // each doc is in its own chunk, the "<DOCID>" in content is skipped
+    ScdParallelParser parser(izenelib::util::UString::UTF_8,
+                             kMaxThreadNum, kWindowSize, 1);
+    BOOST_REQUIRE(parser.load(scdPath.string()));
+    BOOST_CHECK_EQUAL(parser.chunkNum(), static_cast<std::size_t>(kDocNum));
+
+    // the file is not split if it is smaller than the chunk size
+    ScdParallelParser oneChunkParser(izenelib::util::UString::UTF_8,
+                                     kMaxThreadNum, kWindowSize);
+    BOOST_REQUIRE(oneChunkParser.load(scdPath.string()));
+    BOOST_CHECK_EQUAL(oneChunkParser.chunkNum(), 1U);
+}
+
+BOOST_AUTO_TEST_CASE(testChunkBoundary)
+{
+    fs::path scdPath = createCleanTempDir("testChunkBoundary") / kFileName;
+    createScd(scdPath);
+
+    std::vector<ParsedDoc> expectDocs;
+    parseInSequence(scdPath.string(), expectDocs);
+
+    const offset_type fileSize = fs::file_size(scdPath);
+
+    // the split position falls on each byte of the file, including the
+    // beginning of each doc and the '\n' just before it
+    for (offset_type chunkSize = 1; chunkSize <= fileSize; ++chunkSize)
+    {
+        checkParseInParallel(scdPath.string(), chunkSize, expectDocs);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testStopBeforeAllGot)
+{
+    fs::path scdPath = createCleanTempDir("testStopBeforeAllGot") / kFileName;
+    createScd(scdPath);
+
+    ScdParallelParser parser(izenelib::util::UString::UTF_8,
+                             kMaxThreadNum, kWindowSize, 1);
+    BOOST_REQUIRE(parser.load(scdPath.string()));
+
+    SCDDocPtr doc;
+    offset_type offset = 0;
+    BOOST_REQUIRE(parser.next(doc, offset));
+    BOOST_CHECK_EQUAL(propstr_to_str((*doc)[0].second), "1");
+
+    // the parsing threads waiting for the window to move exit
+    parser.stop();
+}
+
+BOOST_AUTO_TEST_CASE(testEmptyFile)
+{
+    fs::path scdPath = createCleanTempDir("testEmptyFile") / kFileName;
+    {
+        ScdBuilder scd(scdPath);
+    }
+
+    ScdParallelParser parser(izenelib::util::UString::UTF_8,
+                             kMaxThreadNum, kWindowSize, 1);
+    BOOST_REQUIRE(parser.load(scdPath.string()));
+
+    SCDDocPtr doc;
+    offset_type offset = 0;
+    BOOST_CHECK(!parser.next(doc, offset));
+    BOOST_CHECK(!parser.next(doc, offset));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,82 @@
+#include <common/SpscQueue.h>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <vector>
+
+using namespace sf1r;
+
+namespace
+{
+const int kValueNum = 100000;
+
+void produce(SpscQueue<int>& queue)
+{
+    for (int i = 0; i < kValueNum; ++i)
+    {
+        while (!queue.tryPush(i))
+        {
+            boost::this_thread::yield();
+        }
+    }
+}
+}
+
+BOOST_AUTO_TEST_SUITE(SpscQueue_test)
+
+BOOST_AUTO_TEST_CASE(testPushPop)
+{
+    SpscQueue<int> queue(2);
+    int value = 0;
+
+    BOOST_CHECK_EQUAL(queue.capacity(), 2U);
+    BOOST_CHECK(queue.empty());
+    BOOST_CHECK(!queue.tryPop(value));
+
+    BOOST_CHECK(queue.tryPush(1));
+    BOOST_CHECK(queue.tryPush(2));
+    BOOST_CHECK(!queue.tryPush(3));
+    BOOST_CHECK(!queue.empty());
+
+    BOOST_CHECK(queue.tryPop(value));
+    BOOST_CHECK_EQUAL(value, 1);
+
+    BOOST_CHECK(queue.tryPush(3));
+    BOOST_CHECK(queue.tryPop(value));
+    BOOST_CHECK_EQUAL(value, 2);
+    BOOST_CHECK(queue.tryPop(value));
+    BOOST_CHECK_EQUAL(value, 3);
+
+    BOOST_CHECK(queue.empty());
+    BOOST_CHECK(!queue.tryPop(value));
+}
+
+BOOST_AUTO_TEST_CASE(testProducerConsumer)
+{
+    SpscQueue<int> queue(64);
+    boost::thread producer(boost::bind(&produce, boost::ref(queue)));
+
+    std::vector<int> values;
+    int value = 0;
+    while (values.size() < static_cast<std::size_t>(kValueNum))
+    {
+        if (queue.tryPop(value))
+        {
+            values.push_back(value);
+        }
+        else
+        {
+            boost::this_thread::yield();
+        }
+    }
+    producer.join();
+
+    for (int i = 0; i < kValueNum; ++i)
+    {
+        BOOST_REQUIRE_EQUAL(values[i], i);
+    }
+    BOOST_CHECK(queue.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,136 @@
+#include <common/StringSortDict.h>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/lexical_cast.hpp>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace sf1r;
+
+namespace
+{
+int compareString(const std::string& lhs, const std::string& rhs)
+{
+    // the doc without value is less than the others
+    if (lhs.empty() || rhs.empty())
+        return int(!lhs.empty()) - int(!rhs.empty());
+
+    if (lhs < rhs) return -1;
+    if (lhs > rhs) return 1;
+    return 0;
+}
+
+void checkOrder(const StringSortDict& dict, const std::vector<std::string>& docValues)
+{
+    for (std::size_t i = 0; i < docValues.size(); ++i)
+    {
+        for (std::size_t j = 0; j < docValues.size(); ++j)
+        {
+            BOOST_REQUIRE_EQUAL(dict.compare(i, j),
+                                compareString(docValues[i], docValues[j]));
+        }
+    }
+}
+
+std::string randomValue(int range)
+{
+    return boost::lexical_cast<std::string>(std::rand() % range);
+}
+}
+
+BOOST_AUTO_TEST_SUITE(StringSortDict_test)
+
+BOOST_AUTO_TEST_CASE(testBuild)
+{
+    std::vector<std::string> docValues;
+    docValues.push_back("banana");
+    docValues.push_back("");
+    docValues.push_back("apple");
+    docValues.push_back("cherry");
+    docValues.push_back("apple");
+
+    StringSortDict dict;
+    dict.build(docValues);
+
+    BOOST_CHECK_EQUAL(dict.docNum(), 5U);
+    BOOST_CHECK_EQUAL(dict.valueNum(), 3U);
+    BOOST_CHECK_EQUAL(dict.getCode(1), StringSortDict::code_t(StringSortDict::INVALID_CODE));
+    BOOST_CHECK_EQUAL(dict.getCode(2), dict.getCode(4));
+    checkOrder(dict, docValues);
+
+    // the doc out of range has no value
+    BOOST_CHECK_EQUAL(dict.compare(10, 1), 0);
+    BOOST_CHECK_EQUAL(dict.compare(10, 0), -1);
+}
+
+BOOST_AUTO_TEST_CASE(testRandomUpdate)
+{
+    std::srand(0);
+    std::vector<std::string> docValues(300);
+    for (std::size_t i = 0; i < docValues.size(); ++i)
+    {
+        if (std::rand() % 5)
+            docValues[i] = randomValue(100);
+    }
+
+    StringSortDict dict;
+    dict.build(docValues);
+    checkOrder(dict, docValues);
+
+    for (int k = 0; k < 20000; ++k)
+    {
+        std::size_t docId = std::rand() % 400;
+        if (docId >= docValues.size())
+            docValues.resize(docId + 1);
+        docValues[docId] = std::rand() % 10 ? randomValue(100000) : "";
+        dict.setValue(docId, docValues[docId]);
+    }
+    checkOrder(dict, docValues);
+
+    // the values not used any more are dropped in re-encoding
+    BOOST_CHECK(dict.getReEncodeNum() > 0);
+    BOOST_CHECK(dict.valueNum() <= 2 * docValues.size() + 1024);
+}
+
+BOOST_AUTO_TEST_CASE(testAppendInOrder)
+{
+    StringSortDict dict;
+    std::vector<std::string> docValues;
+    for (int i = 0; i < 10000; ++i)
+    {
+        docValues.push_back(boost::lexical_cast<std::string>(100000 + i));
+        dict.setValue(i, docValues.back());
+    }
+
+    for (std::size_t i = 1; i < docValues.size(); ++i)
+    {
+        BOOST_REQUIRE(dict.getCode(i - 1) < dict.getCode(i));
+    }
+    // the codes are re-encoded only when the number of values doubles
+    BOOST_CHECK(dict.getReEncodeNum() < 10);
+}
+
+BOOST_AUTO_TEST_CASE(testInsertBetween)
+{
+    StringSortDict dict;
+    std::vector<std::string> docValues;
+    docValues.push_back("a");
+    docValues.push_back("b");
+    dict.setValue(0, docValues[0]);
+    dict.setValue(1, docValues[1]);
+
+    // each value is inserted just after the previous one, which uses up the gap
+    std::string value = "a";
+    for (int i = 0; i < 100; ++i)
+    {
+        value += "a";
+        docValues.push_back(value);
+        dict.setValue(docValues.size() - 1, value);
+    }
+
+    BOOST_CHECK(dict.getReEncodeNum() > 0);
+    checkOrder(dict, docValues);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
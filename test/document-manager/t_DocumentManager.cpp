@@ -21,11 +21,13 @@
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/path.hpp>
 #include <boost/random.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/uniform_int.hpp>
 #include <boost/random/variate_generator.hpp>
 #include <common/Utilities.h>
+#include <3rdparty/am/luxio/array.h>
 #include <iostream>
 #include <fstream>
 #include <map>
@@ -84,7 +86,7 @@ void makeSchema(IndexBundleSchema& indexSchema)
 
 
 boost::shared_ptr<DocumentManager>
-createDocumentManager()
+createDocumentManager(bool isColumnStore = false)
 {
     bfs::path dmPath(bfs::path(".") /"document/");
     bfs::create_directories(dmPath);
@@ -95,7 +97,8 @@ createDocumentManager()
             dmPath.string(),
             indexSchema,
             encoding,
-            2000
+            2000,
+            isColumnStore
         )
     );
     return ret;
@@ -438,4 +441,102 @@ BOOST_AUTO_TEST_CASE(summary)
     BOOST_CHECK_EQUAL(outFullTextList.size(), docNum);
 }
 
+BOOST_AUTO_TEST_CASE(columnStore)
+{
+    clearFiles();
+    std::vector<Document> expectDocs(100);
+    std::vector<unsigned int> ids;
+    {
+        boost::shared_ptr<DocumentManager> documentManager = createDocumentManager(true);
+        for(unsigned int i = 1; i <= expectDocs.size(); ++i)
+        {
+            Document& document = expectDocs[i-1];
+            prepareDocument(i, document);
+            BOOST_CHECK_EQUAL(documentManager->insertDocument(document),true);
+            ids.push_back(i);
+        }
+        documentManager->flush();
+    }
+
+    // reopen to check the columns are restored
+    boost::shared_ptr<DocumentManager> documentManager = createDocumentManager(true);
+    for(unsigned int i = 1; i <= expectDocs.size(); ++i)
+    {
+        Document document;
+        BOOST_CHECK_EQUAL(documentManager->getDocument(i, document),true);
+        BOOST_CHECK(document.property("Content") == expectDocs[i-1].property("Content"));
+        BOOST_CHECK(document.property("ImgURL") == expectDocs[i-1].property("ImgURL"));
+    }
+
+    std::vector<std::string> propertyNames;
+    propertyNames.push_back("Title");
+    propertyNames.push_back("DATE");
+    std::vector<Document> docs;
+    BOOST_CHECK_EQUAL(documentManager->getDocuments(ids, propertyNames, docs),true);
+    BOOST_REQUIRE_EQUAL(docs.size(), ids.size());
+    for(unsigned int i = 0; i < docs.size(); ++i)
+    {
+        BOOST_CHECK(docs[i].property("Title") == expectDocs[i].property("Title"));
+        BOOST_CHECK(docs[i].property("DATE") == expectDocs[i].property("DATE"));
+        BOOST_CHECK_EQUAL(docs[i].hasProperty("Content"), false);
+    }
+
+    Document::doc_prop_value_strtype title;
+    Document::doc_prop_value_strtype expectTitle;
+    BOOST_CHECK(documentManager->getPropertyValue(1, "Title", title));
+    BOOST_CHECK(expectDocs[0].getProperty("Title", expectTitle));
+    BOOST_CHECK(title == expectTitle);
+
+    // the property not in the updated doc is removed
+    Document updateDoc;
+    updateDoc.setId(1);
+    updateDoc.property("Title") = str_to_propstr("new title");
+    BOOST_CHECK_EQUAL(documentManager->updateDocument(updateDoc),true);
+
+    Document document;
+    BOOST_CHECK_EQUAL(documentManager->getDocument(1, document),true);
+    BOOST_CHECK(document.property("Title") == updateDoc.property("Title"));
+    BOOST_CHECK_EQUAL(document.hasProperty("Content"), false);
+}
+
+BOOST_AUTO_TEST_CASE(columnStoreCorrupted)
+{
+    clearFiles();
+    std::vector<Document> expectDocs(2);
+    {
+        boost::shared_ptr<DocumentManager> documentManager = createDocumentManager(true);
+        for(unsigned int i = 1; i <= expectDocs.size(); ++i)
+        {
+            prepareDocument(i, expectDocs[i-1]);
+            BOOST_CHECK_EQUAL(documentManager->insertDocument(expectDocs[i-1]),true);
+        }
+        documentManager->flush();
+    }
+
+    // overwrite the values of doc 1 by the records too short to be read
+    const char corruptedValue[] = "x";
+    for (std::size_t columnId = 0; ; ++columnId)
+    {
+        const std::string fileName = "./document/DocumentPropertyTable." +
+            boost::lexical_cast<std::string>(columnId);
+        if (!bfs::exists(fileName))
+            break;
+
+        Lux::IO::Array column(Lux::IO::NONCLUSTER);
+        column.set_noncluster_params(Lux::IO::Linked);
+        column.open(fileName.c_str(), Lux::IO::DB_RDWR);
+        BOOST_CHECK(column.put(1, corruptedValue, 1, Lux::IO::OVERWRITE));
+        column.close();
+    }
+
+    boost::shared_ptr<DocumentManager> documentManager = createDocumentManager(true);
+    Document document;
+    BOOST_CHECK_EQUAL(documentManager->getDocument(1, document),false);
+    BOOST_CHECK_EQUAL(documentManager->getDocument(2, document),true);
+
+    Document::doc_prop_value_strtype title;
+    BOOST_CHECK_EQUAL(documentManager->getPropertyValue(1, "Title", title),false);
+    BOOST_CHECK_EQUAL(documentManager->getPropertyValue(2, "Title", title),true);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
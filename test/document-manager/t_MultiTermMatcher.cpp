@@ -0,0 +1,165 @@
+#include <document-manager/highlighter/MultiTermMatcher.h>
+#include <document-manager/highlighter/Highlighter.h>
+
+#include <boost/test/unit_test.hpp>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace sf1r;
+using izenelib::util::UString;
+
+namespace
+{
+const UString::EncodingType kEncoding = UString::UTF_8;
+
+void createTerms(const char* terms[], std::size_t num, std::vector<UString>& termList)
+{
+    for (std::size_t i = 0; i < num; ++i)
+    {
+        termList.push_back(UString(terms[i], kEncoding));
+    }
+}
+
+/** find the occurrences by comparing each offset */
+void findByCompare(
+    const UString& text,
+    const std::vector<UString>& termList,
+    std::vector<MultiTermMatcher::Match>& matches)
+{
+    for (MultiTermMatcher::CharacterOffset offset = 0; offset < text.length(); ++offset)
+    {
+        for (uint32_t termIndex = 0; termIndex < termList.size(); ++termIndex)
+        {
+            const UString& term = termList[termIndex];
+            if (term.empty() || offset + term.length() > text.length())
+                continue;
+
+            MultiTermMatcher::CharacterOffset i = 0;
+            while (i < term.length() &&
+                   MultiTermMatcher::foldCase(text[offset + i]) ==
+                   MultiTermMatcher::foldCase(term[i]))
+            {
+                ++i;
+            }
+
+            if (i == term.length())
+            {
+                matches.push_back(MultiTermMatcher::Match(offset, termIndex));
+            }
+        }
+    }
+}
+
+void checkMatches(
+    const std::vector<MultiTermMatcher::Match>& expected,
+    const std::vector<MultiTermMatcher::Match>& actual)
+{
+    BOOST_REQUIRE_EQUAL(actual.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(actual[i].offset, expected[i].offset);
+        BOOST_CHECK_EQUAL(actual[i].termIndex, expected[i].termIndex);
+    }
+}
+
+std::string getHighlightedText(const char* text, const MultiTermMatcher& termMatcher)
+{
+    Highlighter highlighter;
+    UString highlightedText;
+    std::string result;
+
+    if (highlighter.getHighlightedText(UString(text, kEncoding), termMatcher,
+                                       kEncoding, highlightedText))
+    {
+        highlightedText.convertString(result, kEncoding);
+    }
+
+    return result;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(MultiTermMatcher_test)
+
+BOOST_AUTO_TEST_CASE(testEmpty)
+{
+    std::vector<UString> termList;
+    termList.push_back(UString());
+
+    MultiTermMatcher termMatcher(termList);
+    BOOST_CHECK_EQUAL(termMatcher.termNum(), 1U);
+
+    std::vector<MultiTermMatcher::Match> matches;
+    termMatcher.match(UString("abc", kEncoding), matches);
+    BOOST_CHECK(matches.empty());
+}
+
+BOOST_AUTO_TEST_CASE(testOverlapTerms)
+{
+    const char* terms[] = {"he", "she", "his", "hers", "HE"};
+    std::vector<UString> termList;
+    createTerms(terms, sizeof(terms) / sizeof(terms[0]), termList);
+
+    MultiTermMatcher termMatcher(termList);
+    UString text("uSHErs hishe", kEncoding);
+
+    std::vector<MultiTermMatcher::Match> actual;
+    termMatcher.match(text, actual);
+
+    std::vector<MultiTermMatcher::Match> expected;
+    findByCompare(text, termList, expected);
+
+    BOOST_CHECK_EQUAL(expected.size(), 8U);
+    checkMatches(expected, actual);
+}
+
+BOOST_AUTO_TEST_CASE(testRandomText)
+{
+    const char* terms[] = {"ab", "abab", "b", "bba", "cab", "a", "AB"};
+    std::vector<UString> termList;
+    createTerms(terms, sizeof(terms) / sizeof(terms[0]), termList);
+
+    MultiTermMatcher termMatcher(termList);
+    const char alphabet[] = "abcABC";
+    std::srand(0);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        std::string str;
+        const int length = std::rand() % 64;
+        for (int j = 0; j < length; ++j)
+        {
+            str += alphabet[std::rand() % (sizeof(alphabet) - 1)];
+        }
+        UString text(str, kEncoding);
+
+        std::vector<MultiTermMatcher::Match> actual;
+        termMatcher.match(text, actual);
+
+        std::vector<MultiTermMatcher::Match> expected;
+        findByCompare(text, termList, expected);
+
+        checkMatches(expected, actual);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testHighlight)
+{
+    const char* terms[] = {"apple", "123", "pine apple"};
+    std::vector<UString> termList;
+    createTerms(terms, sizeof(terms) / sizeof(terms[0]), termList);
+
+    MultiTermMatcher termMatcher(termList);
+
+    // prefix of english word and number is not highlighted
+    BOOST_CHECK_EQUAL(getHighlightedText("Apple apples 123 1234 pineapple x", termMatcher),
+                      "<!HS>Apple<!HE> apples <!HS>123<!HE> 1234 pineapple x");
+
+    // overlapped terms are merged into one tag
+    BOOST_CHECK_EQUAL(getHighlightedText("a Pine Apple", termMatcher),
+                      "a <!HS>Pine Apple<!HE>");
+
+    BOOST_CHECK_EQUAL(getHighlightedText("banana", termMatcher), "");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
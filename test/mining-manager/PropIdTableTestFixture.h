@@ -12,6 +12,7 @@
 #include <mining-manager/MiningException.hpp>
 #include "test_util.h"
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
 
 namespace sf1r
 {
@@ -28,6 +29,11 @@ public:
 
     void checkOverFlow();
 
+    /**
+     * check countIdList() on all docs, including the doc out of range.
+     */
+    void checkCountIdList();
+
 private:
     typedef faceted::PropIdTable<valueid_t, index_t> PropIdTable;
     typedef std::vector<valueid_t> InputIdList;
@@ -125,6 +131,43 @@ void PropIdTableTestFixture<valueid_t, index_t>::checkOverFlow()
     checkIdList();
 }
 
+template <typename valueid_t, typename index_t>
+void PropIdTableTestFixture<valueid_t, index_t>::checkCountIdList()
+{
+    std::vector<docid_t> docIds;
+    valueid_t maxId = 0;
+    std::size_t goldDocNum = 0;
+
+    const std::size_t docNum = inputIdTable_.size();
+    for (std::size_t docId = 0; docId <= docNum; ++docId)
+    {
+        docIds.push_back(docId);
+
+        if (docId < docNum && !inputIdTable_[docId].empty())
+        {
+            const InputIdList& inputIdList = inputIdTable_[docId];
+            maxId = std::max(maxId, *std::max_element(inputIdList.begin(), inputIdList.end()));
+            ++goldDocNum;
+        }
+    }
+
+    std::vector<unsigned int> goldCounts(maxId + 1);
+    for (std::size_t docId = 0; docId < docNum; ++docId)
+    {
+        const InputIdList& inputIdList = inputIdTable_[docId];
+        for (std::size_t i = 0; i < inputIdList.size(); ++i)
+        {
+            ++goldCounts[inputIdList[i]];
+        }
+    }
+
+    std::vector<unsigned int> counts(maxId + 1);
+    std::size_t countDocNum = propIdTable_.countIdList(&docIds[0], docIds.size(), &counts[0]);
+
+    BOOST_CHECK_EQUAL(countDocNum, goldDocNum);
+    BOOST_CHECK(counts == goldCounts);
+}
+
 template <typename valueid_t, typename index_t>
 void PropIdTableTestFixture<valueid_t, index_t>::checkOverFlow_(valueid_t valueId)
 {
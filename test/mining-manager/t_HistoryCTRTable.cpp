@@ -0,0 +1,65 @@
+#include <mining-manager/ad-index-manager/HistoryCTRTable.h>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/unordered_map.hpp>
+#include <cstdlib>
+
+using namespace sf1r;
+
+BOOST_AUTO_TEST_SUITE(HistoryCTRTable_test)
+
+BOOST_AUTO_TEST_CASE(testFindInsert)
+{
+    HistoryCTRTable table(4);
+    double ctr = 0;
+
+    BOOST_CHECK(table.empty());
+    BOOST_CHECK(!table.find(HistoryCTRTable::makeKey(0, 0), ctr));
+
+    table.insert(HistoryCTRTable::makeKey(0, 0), 0.1);
+    table.insert(HistoryCTRTable::makeKey(0, 1), 0.2);
+    table.insert(HistoryCTRTable::makeKey(1, 0), 0.3);
+    BOOST_CHECK_EQUAL(table.size(), 3U);
+
+    BOOST_CHECK(table.find(HistoryCTRTable::makeKey(0, 1), ctr));
+    BOOST_CHECK_EQUAL(ctr, 0.2);
+    BOOST_CHECK(table.find(HistoryCTRTable::makeKey(1, 0), ctr));
+    BOOST_CHECK_EQUAL(ctr, 0.3);
+    BOOST_CHECK(!table.find(HistoryCTRTable::makeKey(1, 1), ctr));
+
+    // overwrite
+    table.insert(HistoryCTRTable::makeKey(0, 1), 0.5);
+    BOOST_CHECK_EQUAL(table.size(), 3U);
+    BOOST_CHECK(table.find(HistoryCTRTable::makeKey(0, 1), ctr));
+    BOOST_CHECK_EQUAL(ctr, 0.5);
+}
+
+BOOST_AUTO_TEST_CASE(testRehash)
+{
+    std::srand(1);
+
+    HistoryCTRTable table;
+    boost::unordered_map<HistoryCTRTable::KeyT, double> expected;
+
+    for (int i = 0; i < 100000; ++i)
+    {
+        HistoryCTRTable::KeyT key = HistoryCTRTable::makeKey(
+            std::rand() % 1000, std::rand() % 65536);
+        double ctr = std::rand() / static_cast<double>(RAND_MAX);
+
+        table.insert(key, ctr);
+        expected[key] = ctr;
+    }
+    BOOST_CHECK_EQUAL(table.size(), expected.size());
+
+    double ctr = 0;
+    for (boost::unordered_map<HistoryCTRTable::KeyT, double>::const_iterator it = expected.begin();
+        it != expected.end(); ++it)
+    {
+        BOOST_REQUIRE(table.find(it->first, ctr));
+        BOOST_CHECK_EQUAL(ctr, it->second);
+    }
+    BOOST_CHECK(!table.find(HistoryCTRTable::makeKey(1000, 0), ctr));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
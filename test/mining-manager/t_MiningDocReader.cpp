@@ -0,0 +1,178 @@
+///
+/// @file t_MiningDocReader.cpp
+/// @brief test the docs are read in docid order across batch boundaries.
+///
+
+#include <mining-manager/MiningDocReader.h>
+#include <document-manager/DocumentManager.h>
+#include <document-manager/Document.h>
+#include <configuration-manager/PropertyConfig.h>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <string>
+#include <vector>
+
+using namespace sf1r;
+
+namespace bfs = boost::filesystem;
+
+namespace
+{
+const izenelib::util::UString::EncodingType ENCODING_TYPE = izenelib::util::UString::UTF_8;
+const char* TEST_DIR_STR = "mining_doc_reader_test";
+const char* PROP_NAME_TITLE = "Title";
+
+const docid_t kDocNum = 25;
+
+const docid_t kRemovedDocId = 7;
+
+std::string getTitle(docid_t docId)
+{
+    return "title " + boost::lexical_cast<std::string>(docId);
+}
+
+class MiningDocReaderTestFixture
+{
+public:
+    MiningDocReaderTestFixture()
+    {
+        bfs::remove_all(TEST_DIR_STR);
+        bfs::path dmPath(bfs::path(TEST_DIR_STR) / "dm/");
+        bfs::create_directories(dmPath);
+
+        initSchema_();
+        documentManager_.reset(new DocumentManager(
+            dmPath.string(), schema_, ENCODING_TYPE, 2000));
+
+        for (docid_t docId = 1; docId <= kDocNum; ++docId)
+        {
+            Document document;
+            document.setId(docId);
+            document.property("DOCID") = str_to_propstr(
+                boost::lexical_cast<std::string>(docId), ENCODING_TYPE);
+            document.property(PROP_NAME_TITLE) = str_to_propstr(
+                getTitle(docId), ENCODING_TYPE);
+            BOOST_CHECK(documentManager_->insertDocument(document));
+        }
+        BOOST_CHECK(documentManager_->removeDocument(kRemovedDocId));
+    }
+
+    /**
+     * read the docs in [startDocId, endDocId], and check each doc is
+     * got once in docid order.
+     */
+    void checkRead(
+        bool isAllProperties,
+        docid_t startDocId,
+        docid_t endDocId,
+        std::size_t batchSize)
+    {
+        std::vector<std::string> propertyNames;
+        if (!isAllProperties)
+        {
+            propertyNames.push_back(PROP_NAME_TITLE);
+        }
+
+        MiningDocReader docReader(*documentManager_, isAllProperties,
+                                  propertyNames, startDocId, endDocId,
+                                  batchSize);
+
+        docid_t expectDocId = startDocId;
+        docid_t batchDocId = 0;
+        std::vector<Document> docs;
+
+        while (docReader.nextBatch(batchDocId, docs))
+        {
+            BOOST_CHECK_EQUAL(batchDocId, expectDocId);
+            BOOST_CHECK_EQUAL(docs.size(),
+                std::min<std::size_t>(batchSize, endDocId - expectDocId + 1));
+
+            for (std::size_t i = 0; i < docs.size(); ++i, ++expectDocId)
+            {
+                const Document& doc = docs[i];
+                if (expectDocId == kRemovedDocId || expectDocId > kDocNum)
+                {
+                    BOOST_CHECK_EQUAL(doc.getId(), 0U);
+                    continue;
+                }
+
+                BOOST_CHECK_EQUAL(doc.getId(), expectDocId);
+
+                Document::doc_prop_value_strtype title;
+                BOOST_CHECK(doc.getProperty(PROP_NAME_TITLE, title));
+                BOOST_CHECK_EQUAL(propstr_to_str(title), getTitle(expectDocId));
+                BOOST_CHECK_EQUAL(doc.hasProperty("DOCID"), isAllProperties);
+            }
+        }
+
+        BOOST_CHECK_EQUAL(expectDocId, endDocId + 1);
+        BOOST_CHECK(!docReader.nextBatch(batchDocId, docs));
+    }
+
+protected:
+    boost::shared_ptr<DocumentManager> documentManager_;
+
+private:
+    void initSchema_()
+    {
+        PropertyConfigBase config1;
+        config1.propertyName_ = "DOCID";
+        config1.propertyType_ = STRING_PROPERTY_TYPE;
+        schema_.insert(config1);
+
+        PropertyConfigBase config2;
+        config2.propertyName_ = PROP_NAME_TITLE;
+        config2.propertyType_ = STRING_PROPERTY_TYPE;
+        schema_.insert(config2);
+    }
+
+private:
+    IndexBundleSchema schema_;
+};
+}
+
+BOOST_FIXTURE_TEST_SUITE(MiningDocReader_test, MiningDocReaderTestFixture)
+
+BOOST_AUTO_TEST_CASE(testReadInOrder)
+{
+    // a single batch
+    checkRead(true, 1, kDocNum, 1000);
+
+    // the last batch is partial
+    checkRead(true, 1, kDocNum, 10);
+    checkRead(false, 1, kDocNum, 10);
+
+    // more batches than the read-ahead queue could hold
+    checkRead(false, 4, 23, 3);
+    checkRead(true, 1, kDocNum, 1);
+
+    // the docs beyond the max doc id are empty
+    checkRead(false, 20, kDocNum + 5, 4);
+}
+
+BOOST_AUTO_TEST_CASE(testEmptyRange)
+{
+    std::vector<std::string> propertyNames;
+    MiningDocReader docReader(*documentManager_, true, propertyNames, 5, 4);
+
+    docid_t batchDocId = 0;
+    std::vector<Document> docs;
+    BOOST_CHECK(!docReader.nextBatch(batchDocId, docs));
+}
+
+BOOST_AUTO_TEST_CASE(testStopEarly)
+{
+    std::vector<std::string> propertyNames;
+    docid_t batchDocId = 0;
+    std::vector<Document> docs;
+
+    // the read-ahead thread waiting on a full queue is stopped in destructor
+    MiningDocReader docReader(*documentManager_, true, propertyNames, 1, kDocNum, 2);
+    BOOST_CHECK(docReader.nextBatch(batchDocId, docs));
+    BOOST_CHECK_EQUAL(batchDocId, 1U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,124 @@
+#include <mining-manager/query-recommendation/PrefixTable.h>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace sf1r::Recommend;
+namespace bfs = boost::filesystem;
+
+namespace
+{
+const std::string TEST_DIR("prefix_table_test");
+
+std::string toString(const UserQueryList& uqList)
+{
+    std::string result;
+    for (UserQueryList::const_iterator it = uqList.begin(); it != uqList.end(); ++it)
+    {
+        result += it->userQuery();
+        result += ";";
+    }
+    return result;
+}
+
+std::string search(const PrefixTable& table, const std::string& userQuery)
+{
+    UserQueryList uqList;
+    table.search(userQuery, uqList);
+    return toString(uqList);
+}
+
+std::string randomQuery()
+{
+    const char alphabet[] = "abcd";
+    std::string query;
+    const int length = 1 + std::rand() % 6;
+    for (int i = 0; i < length; ++i)
+    {
+        query += alphabet[std::rand() % (sizeof(alphabet) - 1)];
+    }
+    return query;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(PrefixTable_test)
+
+BOOST_AUTO_TEST_CASE(testSearch)
+{
+    bfs::remove_all(TEST_DIR);
+    bfs::create_directory(TEST_DIR);
+
+    PrefixTable table(TEST_DIR);
+    table.insert("iphone", 10);
+    table.insert("iphone5", 20);
+    table.insert("iphone6", 30);
+    table.insert("iphone55", 40);
+    table.insert("ipad", 50);
+    table.insert("aphone5", 60);
+    table.insert("iphone5", 5);
+    table.buildIndex();
+
+    BOOST_CHECK_EQUAL(search(table, "iphone5"), "iphone;iphone5;iphone6;iphone55;");
+    BOOST_CHECK_EQUAL(search(table, "iphnoe"), "");
+    BOOST_CHECK_EQUAL(search(table, "ipda"), "");
+
+    UserQueryList uqList;
+    table.search("iphone5", uqList);
+    BOOST_CHECK_EQUAL(uqList.size(), 4U);
+    BOOST_CHECK_EQUAL(uqList.begin()->freq(), 10);
+    BOOST_CHECK_EQUAL((++uqList.begin())->freq(), 25);
+
+    bfs::remove_all(TEST_DIR);
+}
+
+BOOST_AUTO_TEST_CASE(testIndexSameAsScan)
+{
+    bfs::remove_all(TEST_DIR);
+    bfs::create_directory(TEST_DIR);
+
+    std::srand(0);
+    std::vector<std::string> queries;
+    for (int i = 0; i < 200; ++i)
+    {
+        queries.push_back(randomQuery());
+    }
+
+    std::vector<std::string> expected;
+    {
+        PrefixTable table(TEST_DIR);
+        for (std::size_t i = 0; i < queries.size(); ++i)
+        {
+            table.insert(queries[i], i + 1);
+        }
+
+        // not indexed yet, it compares each query of the same prefix
+        for (std::size_t i = 0; i < queries.size(); ++i)
+        {
+            expected.push_back(search(table, queries[i] + "a"));
+            expected.push_back(search(table, queries[i]));
+        }
+
+        table.buildIndex();
+        for (std::size_t i = 0; i < queries.size(); ++i)
+        {
+            BOOST_CHECK_EQUAL(search(table, queries[i] + "a"), expected[i*2]);
+            BOOST_CHECK_EQUAL(search(table, queries[i]), expected[i*2+1]);
+        }
+        table.flush();
+    }
+
+    // load the saved index
+    PrefixTable table(TEST_DIR);
+    for (std::size_t i = 0; i < queries.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(search(table, queries[i] + "a"), expected[i*2]);
+        BOOST_CHECK_EQUAL(search(table, queries[i]), expected[i*2+1]);
+    }
+
+    bfs::remove_all(TEST_DIR);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,210 @@
+///
+/// @file t_ProductForwardManager.cpp
+/// @brief test the jaccard similarity on packed features is the same as
+///        the one on the sets of features.
+///
+
+#include <mining-manager/product-forward/ProductForwardManager.h>
+
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace sf1r
+{
+
+class ProductForwardManagerTest
+{
+public:
+    ProductForwardManagerTest()
+        : manager_(".", "Title")
+    {}
+
+    void pack(const std::vector<std::string>& index)
+    {
+        packed_ = manager_.packFeatures_(index);
+    }
+
+    double compare(
+        uint32_t q_brand,
+        uint32_t q_model,
+        const std::vector<uint32_t>& q_res,
+        docid_t lastDocid,
+        docid_t docid) const
+    {
+        // the query set is built in the same way as in forwardSearch()
+        std::vector<uint32_t> q_set(q_res);
+        if (q_brand > 0) q_set.push_back(q_brand);
+        if (q_model > 0) q_set.push_back(q_model);
+        std::sort(q_set.begin(), q_set.end());
+        q_set.erase(std::unique(q_set.begin(), q_set.end()), q_set.end());
+
+        return manager_.compare_(*packed_, q_set, lastDocid, docid);
+    }
+
+private:
+    ProductForwardManager manager_;
+
+    ProductForwardManager::PackedFeaturesPtr packed_;
+};
+
+}
+
+using namespace sf1r;
+
+namespace
+{
+struct Features
+{
+    uint32_t brand;
+    uint32_t model;
+    std::vector<uint32_t> ids;
+
+    Features(uint32_t b, uint32_t m) : brand(b), model(m) {}
+
+    Features& add(uint32_t id)
+    {
+        ids.push_back(id);
+        return *this;
+    }
+
+    /** the format in forward index */
+    std::string str() const
+    {
+        std::ostringstream oss;
+        oss << brand << ' ' << model;
+        for (std::size_t i = 0; i < ids.size(); ++i)
+        {
+            oss << ' ' << ids[i];
+        }
+        return oss.str();
+    }
+};
+
+/** the jaccard similarity on std::set, as it was computed before packing */
+double setJaccard(const Features& q, const Features& t)
+{
+    std::set<uint32_t> qset(q.ids.begin(), q.ids.end());
+    if (q.brand > 0) qset.insert(q.brand);
+    if (q.model > 0) qset.insert(q.model);
+
+    std::set<uint32_t> tset(t.ids.begin(), t.ids.end());
+    if (t.brand > 0) tset.insert(t.brand);
+    if (t.model > 0) tset.insert(t.model);
+
+    double common = 0;
+    for (std::set<uint32_t>::const_iterator it = qset.begin(); it != qset.end(); ++it)
+    {
+        if (tset.find(*it) != tset.end())
+            common++;
+    }
+
+    return common / (qset.size() + tset.size() - common);
+}
+
+void checkScore(double score, double expect, const std::string& message)
+{
+    // both are NaN if the two sets are empty
+    if (std::isnan(expect))
+    {
+        BOOST_CHECK_MESSAGE(std::isnan(score), message << ", score: " << score);
+        return;
+    }
+
+    BOOST_CHECK_MESSAGE(score == expect, message << ", score: " << score
+                        << ", expect: " << expect);
+}
+}
+
+BOOST_AUTO_TEST_SUITE(ProductForwardManager_test)
+
+BOOST_AUTO_TEST_CASE(testCompareWithSetJaccard)
+{
+    std::vector<Features> docs;
+    // doc 0 is not used
+    docs.push_back(Features(0, 0));
+    // empty
+    docs.push_back(Features(0, 0));
+    // brand and model only
+    docs.push_back(Features(100, 200));
+    // model equals to brand
+    docs.push_back(Features(100, 100).add(1).add(2));
+    // duplicate features, and the features equal to brand or model
+    docs.push_back(Features(100, 200).add(3).add(1).add(3).add(100).add(200));
+    // disjoint with all queries
+    docs.push_back(Features(900, 0).add(901).add(902));
+    // overlapping
+    docs.push_back(Features(0, 200).add(1).add(5).add(9));
+    docs.push_back(Features(100, 300).add(2).add(3).add(4).add(5));
+
+    std::vector<std::string> index;
+    for (std::size_t i = 0; i < docs.size(); ++i)
+    {
+        index.push_back(docs[i].str());
+    }
+
+    ProductForwardManagerTest test;
+    test.pack(index);
+
+    std::vector<Features> queries;
+    // empty
+    queries.push_back(Features(0, 0));
+    queries.push_back(Features(100, 0));
+    queries.push_back(Features(0, 200));
+    queries.push_back(Features(100, 200).add(1).add(3));
+    // duplicate features, and the features equal to brand or model
+    queries.push_back(Features(100, 100).add(5).add(1).add(5).add(100));
+    queries.push_back(Features(300, 200).add(2).add(4).add(9).add(100));
+    // disjoint with all docs
+    queries.push_back(Features(500, 600).add(700));
+
+    // the docs at or beyond lastDocid have no features
+    const docid_t lastDocid = docs.size() - 1;
+    const Features emptyDoc(0, 0);
+
+    for (std::size_t i = 0; i < queries.size(); ++i)
+    {
+        const Features& q = queries[i];
+        for (docid_t docid = 0; docid < docs.size() + 2; ++docid)
+        {
+            const Features& t = docid < lastDocid ? docs[docid] : emptyDoc;
+            std::ostringstream message;
+            message << "query: " << q.str() << ", docid: " << docid;
+
+            checkScore(test.compare(q.brand, q.model, q.ids, lastDocid, docid),
+                       setJaccard(q, t), message.str());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testJaccardValue)
+{
+    std::vector<std::string> index;
+    index.push_back("");
+    index.push_back(Features(100, 200).add(1).add(2).str());
+
+    ProductForwardManagerTest test;
+    test.pack(index);
+
+    // empty and disjoint
+    std::vector<uint32_t> q_res;
+    BOOST_CHECK_EQUAL(test.compare(0, 0, q_res, 2, 1), 0);
+    q_res.push_back(3);
+    BOOST_CHECK_EQUAL(test.compare(300, 0, q_res, 2, 1), 0);
+
+    // overlapping: {100, 1, 3} and {100, 200, 1, 2}
+    q_res.push_back(1);
+    BOOST_CHECK_CLOSE(test.compare(100, 0, q_res, 2, 1), 2.0 / 5, 1e-9);
+
+    // same
+    q_res.clear();
+    q_res.push_back(2);
+    q_res.push_back(1);
+    BOOST_CHECK_EQUAL(test.compare(100, 200, q_res, 2, 1), 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -29,6 +29,22 @@ BOOST_FIXTURE_TEST_CASE(checkPropId, PropIdTestFixture)
     appendIdList("10000 1000 100 10 1");
 
     checkIdList();
+    checkCountIdList();
+}
+
+BOOST_FIXTURE_TEST_CASE(checkCountSingleId, PropIdTestFixture)
+{
+    checkCountIdList();
+
+    for (int i = 0; i < 100; ++i)
+    {
+        appendIdList(i % 3 ? "" : "5");
+        appendIdList("65535");
+        appendIdList(i % 7 ? "123" : "");
+    }
+
+    checkIdList();
+    checkCountIdList();
 }
 
 typedef sf1r::PropIdTableTestFixture<uint32_t, uint32_t> AttrIdTestFixture;
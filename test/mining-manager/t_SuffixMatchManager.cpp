@@ -0,0 +1,188 @@
+///
+/// @file t_SuffixMatchManager.cpp
+/// @brief test searching docs in both main and delta fm-index.
+///
+
+#include <mining-manager/suffix-match-manager/SuffixMatchManager.hpp>
+#include <mining-manager/suffix-match-manager/FMIndexManager.h>
+#include <mining-manager/product-tokenizer/FuzzyAlphaNumNormalizer.h>
+#include <mining-manager/MiningTaskBuilder.h>
+#include <document-manager/DocumentManager.h>
+#include <document-manager/Document.h>
+#include <configuration-manager/PropertyConfig.h>
+#include <configuration-manager/SuffixMatchConfig.h>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace sf1r;
+
+namespace bfs = boost::filesystem;
+
+namespace
+{
+const izenelib::util::UString::EncodingType ENCODING_TYPE = izenelib::util::UString::UTF_8;
+const char* TEST_DIR_STR = "suffix_match_test";
+const char* PROP_NAME_TITLE = "Title";
+
+/** the docs in main fm-index */
+const docid_t kMainDocNum = 30;
+
+const docid_t kDeletedMainDocId = 5;
+
+const size_t kMaxDocs = 100;
+
+typedef std::set<docid_t> DocIdSet;
+
+class SuffixMatchTestFixture
+{
+public:
+    SuffixMatchTestFixture()
+    {
+        bfs::remove_all(TEST_DIR_STR);
+        bfs::path dmPath(bfs::path(TEST_DIR_STR) / "dm/");
+        bfs::create_directories(dmPath);
+
+        initSchema_();
+        documentManager_.reset(new DocumentManager(
+            dmPath.string(), schema_, ENCODING_TYPE, 2000));
+
+        suffixMatchManager_.reset(new SuffixMatchManager(
+            (bfs::path(TEST_DIR_STR) / "suffix").string(),
+            documentManager_, NULL, NULL, NULL,
+            new FuzzyAlphaNumNormalizer));
+
+        std::vector<std::string> properties(1, PROP_NAME_TITLE);
+        suffixMatchManager_->addFMIndexProperties(
+            properties, VirtualConfig(), FMIndexManager::COMMON, true);
+
+        suffixMatchManager_->buildMiningTask();
+        miningTaskBuilder_.reset(new MiningTaskBuilder(documentManager_));
+        miningTaskBuilder_->addTask(suffixMatchManager_->getMiningTask());
+    }
+
+    ~SuffixMatchTestFixture()
+    {
+        // the mining task is owned by the task builder
+        miningTaskBuilder_.reset();
+        suffixMatchManager_.reset();
+    }
+
+    void insertDocument(docid_t docId, const std::string& title)
+    {
+        Document document;
+        document.setId(docId);
+        document.property("DOCID") = str_to_propstr(
+            boost::lexical_cast<std::string>(docId), ENCODING_TYPE);
+        document.property(PROP_NAME_TITLE) = str_to_propstr(title, ENCODING_TYPE);
+
+        BOOST_CHECK(documentManager_->insertDocument(document));
+    }
+
+    void removeDocument(docid_t docId)
+    {
+        BOOST_CHECK(documentManager_->removeDocument(docId));
+    }
+
+    void buildCollection()
+    {
+        BOOST_CHECK(miningTaskBuilder_->buildCollection(0));
+    }
+
+    void checkMatch(const std::string& pattern, const DocIdSet& expectDocIds)
+    {
+        std::vector<std::string> properties(1, PROP_NAME_TITLE);
+        std::vector<std::pair<double, uint32_t> > resList;
+        suffixMatchManager_->longestSuffixMatch(pattern, properties, kMaxDocs, resList);
+
+        DocIdSet docIds;
+        for (size_t i = 0; i < resList.size(); ++i)
+        {
+            BOOST_CHECK_MESSAGE(docIds.insert(resList[i].second).second,
+                                "duplicate doc id: " << resList[i].second);
+        }
+
+        BOOST_CHECK_MESSAGE(docIds == expectDocIds,
+                            "pattern: " << pattern
+                            << ", result doc num: " << docIds.size()
+                            << ", expect doc num: " << expectDocIds.size());
+    }
+
+private:
+    void initSchema_()
+    {
+        PropertyConfigBase config1;
+        config1.propertyName_ = "DOCID";
+        config1.propertyType_ = STRING_PROPERTY_TYPE;
+        schema_.insert(config1);
+
+        PropertyConfigBase config2;
+        config2.propertyName_ = PROP_NAME_TITLE;
+        config2.propertyType_ = STRING_PROPERTY_TYPE;
+        schema_.insert(config2);
+    }
+
+private:
+    IndexBundleSchema schema_;
+    boost::shared_ptr<DocumentManager> documentManager_;
+    boost::scoped_ptr<SuffixMatchManager> suffixMatchManager_;
+    boost::scoped_ptr<MiningTaskBuilder> miningTaskBuilder_;
+};
+}
+
+BOOST_AUTO_TEST_SUITE(SuffixMatchManager_test)
+
+/**
+ * the docs appended after the main fm-index is built go into delta
+ * fm-index, they are searched even if nothing matches in main fm-index,
+ * and only the docs with the longest match are returned.
+ */
+BOOST_FIXTURE_TEST_CASE(testMainAndDeltaIndex, SuffixMatchTestFixture)
+{
+    DocIdSet mainDocIds;
+    for (docid_t docId = 1; docId <= kMainDocNum; ++docId)
+    {
+        insertDocument(docId, "red apple");
+        mainDocIds.insert(docId);
+    }
+    buildCollection();
+
+    checkMatch("apple", mainDocIds);
+    checkMatch("kiwi", DocIdSet());
+
+    const docid_t kiwiDocId = kMainDocNum + 1;
+    const docid_t bananaDocId = kMainDocNum + 2;
+    const docid_t deletedDeltaDocId = kMainDocNum + 3;
+    insertDocument(kiwiDocId, "kiwi");
+    insertDocument(bananaDocId, "apple banana");
+    insertDocument(deletedDeltaDocId, "kiwi");
+
+    // the appended docs are few enough to be built into delta fm-index,
+    // the deleted docs are kept in fm-index, and filtered out in searching
+    removeDocument(kDeletedMainDocId);
+    removeDocument(deletedDeltaDocId);
+    buildCollection();
+
+    // nothing matches in main fm-index
+    DocIdSet kiwiDocIds;
+    kiwiDocIds.insert(kiwiDocId);
+    checkMatch("kiwi", kiwiDocIds);
+
+    // the match in delta fm-index is longer than the one in main fm-index
+    DocIdSet bananaDocIds;
+    bananaDocIds.insert(bananaDocId);
+    checkMatch("banana", bananaDocIds);
+
+    // the match length is the same in both main and delta fm-index
+    DocIdSet appleDocIds(mainDocIds);
+    appleDocIds.erase(kDeletedMainDocId);
+    appleDocIds.insert(bananaDocId);
+    checkMatch("apple", appleDocIds);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
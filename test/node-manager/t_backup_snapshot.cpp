@@ -0,0 +1,108 @@
+#include <stdlib.h>
+#include <fstream>
+#include <iostream>
+#include <boost/filesystem.hpp>
+#include <node-manager/BackupSnapshot.h>
+#undef NDEBUG
+#define DEBUG
+#include <assert.h>
+
+using namespace std;
+using namespace sf1r;
+namespace bfs = boost::filesystem;
+
+static void writeFile(const bfs::path& file, const std::string& data, std::time_t mtime)
+{
+    bfs::create_directories(file.parent_path());
+    std::ofstream ofs(file.c_str());
+    ofs << data;
+    ofs.close();
+    bfs::last_write_time(file, mtime);
+}
+
+static std::string readFile(const bfs::path& file)
+{
+    std::ifstream ifs(file.c_str());
+    std::string data;
+    std::getline(ifs, data);
+    return data;
+}
+
+int main()
+{
+    bfs::path test_dir("./test_backup_snapshot");
+    bfs::remove_all(test_dir);
+    bfs::path src = test_dir/"src";
+    bfs::path backup1 = test_dir/"backup/1";
+    bfs::path backup2 = test_dir/"backup/2";
+
+    std::time_t old_time = std::time(NULL) - 100;
+    writeFile(src/"index/barrel_0", "barrel_0", old_time);
+    writeFile(src/"index/barrel_1", "barrel_1", old_time);
+    writeFile(src/"meta", "meta", old_time);
+    writeFile(src/"barrel_0_removed.rollback", "removed", old_time);
+
+    // the first snapshot copies all files.
+    {
+        BackupSnapshot snapshot(backup1, bfs::path());
+        snapshot.addDir(src, "data");
+        assert(snapshot.finish());
+        assert(snapshot.getLinkedFileNum() == 0);
+        assert(snapshot.getCopiedFileNum() == 3);
+    }
+    assert(!bfs::exists(backup1/"data/barrel_0_removed.rollback"));
+    assert(readFile(backup1/"data/index/barrel_1") == "barrel_1");
+
+    BackupManifest manifest1;
+    assert(manifest1.load(backup1));
+    assert(manifest1.getFileInfoMap().size() == 3);
+    assert(manifest1.verify(backup1));
+    assert(manifest1.isUnchanged("data/meta", 4, old_time));
+    assert(!manifest1.isUnchanged("data/meta", 5, old_time));
+    assert(!manifest1.isUnchanged("data/none", 4, old_time));
+
+    // modify one file, the others are linked.
+    writeFile(src/"meta", "meta_v2", old_time + 10);
+    writeFile(src/"index/barrel_2", "barrel_2", old_time + 10);
+    {
+        BackupSnapshot snapshot(backup2, backup1);
+        snapshot.addDir(src, "data");
+        assert(snapshot.finish());
+        assert(snapshot.getLinkedFileNum() == 2);
+        assert(snapshot.getCopiedFileNum() == 2);
+    }
+    assert(readFile(backup2/"data/meta") == "meta_v2");
+    assert(readFile(backup1/"data/meta") == "meta");
+    assert(readFile(backup2/"data/index/barrel_0") == "barrel_0");
+    assert(bfs::hard_link_count(backup2/"data/index/barrel_0") == 2);
+    assert(bfs::last_write_time(backup2/"data/index/barrel_2") == old_time + 10);
+
+    BackupManifest manifest2;
+    assert(manifest2.load(backup2));
+    assert(manifest2.getFileInfo("data/index/barrel_0")->linked);
+    assert(!manifest2.getFileInfo("data/meta")->linked);
+    assert(manifest2.verify(backup2));
+
+    // the linked files are still valid after the base snapshot removed.
+    bfs::remove_all(backup1);
+    assert(readFile(backup2/"data/index/barrel_1") == "barrel_1");
+
+    // the file modified in the same second as the snapshot is not trusted.
+    BackupManifest manifest3;
+    BackupManifest::FileInfo info;
+    info.size = 4;
+    info.mtime = 1000;
+    manifest3.addFile("data/meta", info);
+    manifest3.setSnapshotTime(1000);
+    assert(!manifest3.isUnchanged("data/meta", 4, 1000));
+    manifest3.setSnapshotTime(1001);
+    assert(manifest3.isUnchanged("data/meta", 4, 1000));
+
+    // a copied file truncated makes the snapshot invalid.
+    writeFile(backup2/"data/meta", "", old_time + 10);
+    assert(!manifest2.verify(backup2));
+
+    bfs::remove_all(test_dir);
+    std::cout << "all backup snapshot tests passed." << std::endl;
+    return 0;
+}
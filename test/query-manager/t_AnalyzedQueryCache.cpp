@@ -0,0 +1,92 @@
+#include <la-manager/AnalyzedQueryCache.h>
+
+#include <boost/test/unit_test.hpp>
+#include <string>
+
+using namespace sf1r;
+using izenelib::util::UString;
+
+namespace
+{
+const char* kDictPath = "dict/user.dic";
+
+la::TermList createTermList(const std::string& str)
+{
+    la::Term term;
+    term.text_ = UString(str, UString::UTF_8);
+
+    la::TermList termList;
+    termList.push_back(term);
+    return termList;
+}
+
+bool checkCachedTerm(
+    AnalyzedQueryCache& cache,
+    const UString& text,
+    const AnalysisInfo& analysisInfo,
+    const std::string& expectTerm)
+{
+    la::TermList termList;
+    if (!cache.get(text, analysisInfo, termList))
+        return false;
+
+    BOOST_REQUIRE_EQUAL(termList.size(), 1U);
+
+    std::string term;
+    termList.begin()->text_.convertString(term, UString::UTF_8);
+    BOOST_CHECK_EQUAL(term, expectTerm);
+    return true;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(AnalyzedQueryCache_test)
+
+BOOST_AUTO_TEST_CASE(testGetSet)
+{
+    AnalyzedQueryCache cache(10);
+    const UString text("iphone", UString::UTF_8);
+
+    AnalysisInfo analysisInfo;
+    analysisInfo.analyzerId_ = "la_korall";
+
+    BOOST_CHECK(!checkCachedTerm(cache, text, analysisInfo, "iphone"));
+
+    cache.set(text, analysisInfo, createTermList("iphone"), cache.generation());
+    BOOST_CHECK(checkCachedTerm(cache, text, analysisInfo, "iphone"));
+
+    // the analyzer is a part of the key
+    AnalysisInfo otherInfo;
+    otherInfo.analyzerId_ = "la_char";
+    BOOST_CHECK(!checkCachedTerm(cache, text, otherInfo, "iphone"));
+}
+
+BOOST_AUTO_TEST_CASE(testInvalidateOnDictUpdate)
+{
+    AnalyzedQueryCache cache(10);
+    AnalyzedQueryCacheInvalidator invalidator(cache);
+    const UString text("iphone", UString::UTF_8);
+
+    AnalysisInfo analysisInfo;
+    analysisInfo.analyzerId_ = "la_korall";
+
+    invalidator.update(kDictPath, 100);
+    cache.set(text, analysisInfo, createTermList("iphone"), cache.generation());
+    BOOST_CHECK(checkCachedTerm(cache, text, analysisInfo, "iphone"));
+
+    // the dictionary is not modified
+    invalidator.update(kDictPath, 100);
+    BOOST_CHECK(checkCachedTerm(cache, text, analysisInfo, "iphone"));
+
+    // the terms analyzed before reload are not cached as valid
+    const unsigned int oldGeneration = cache.generation();
+    invalidator.update(kDictPath, 200);
+    BOOST_CHECK(!checkCachedTerm(cache, text, analysisInfo, "iphone"));
+
+    cache.set(text, analysisInfo, createTermList("iphone"), oldGeneration);
+    BOOST_CHECK(!checkCachedTerm(cache, text, analysisInfo, "iphone"));
+
+    cache.set(text, analysisInfo, createTermList("i phone"), cache.generation());
+    BOOST_CHECK(checkCachedTerm(cache, text, analysisInfo, "i phone"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,137 @@
+#include <search-manager/CustomRankProgram.h>
+#include <search-manager/CustomRanker.h>
+#include <common/NumericPropertyTable.h>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/shared_ptr.hpp>
+#include <cmath>
+#include <vector>
+
+using namespace sf1r;
+
+namespace
+{
+typedef boost::shared_ptr<NumericPropertyTableBase> NumericPropertyTablePtr;
+
+ExpSyntaxTreePtr makeNode(ExpSyntaxTree::NodeType type)
+{
+    return ExpSyntaxTreePtr(new ExpSyntaxTree(type));
+}
+
+ExpSyntaxTreePtr makeConstant(double value)
+{
+    ExpSyntaxTreePtr node = makeNode(ExpSyntaxTree::CONSTANT);
+    node->value_ = value;
+    return node;
+}
+
+ExpSyntaxTreePtr makeParameter(const NumericPropertyTablePtr& table)
+{
+    ExpSyntaxTreePtr node = makeNode(ExpSyntaxTree::PARAMETER);
+    node->propertyData_ = table;
+    return node;
+}
+
+ExpSyntaxTreePtr makeOperator(
+    ExpSyntaxTree::NodeType type,
+    const ExpSyntaxTreePtr& x,
+    const ExpSyntaxTreePtr& y = ExpSyntaxTreePtr())
+{
+    ExpSyntaxTreePtr node = makeNode(type);
+    node->children_.push_back(x);
+    if (y)
+    {
+        node->children_.push_back(y);
+    }
+    return node;
+}
+
+ExpSyntaxTree makeRoot(const ExpSyntaxTreePtr& child)
+{
+    ExpSyntaxTree root(ExpSyntaxTree::ROOT);
+    root.children_.push_back(child);
+    return root;
+}
+}
+
+BOOST_AUTO_TEST_SUITE(CustomRankProgram_test)
+
+BOOST_AUTO_TEST_CASE(testConstantFolding)
+{
+    std::string exp("1 + 2 * pow(3, 2) - sqrt(16)");
+    CustomRanker customRanker(exp);
+    BOOST_REQUIRE(customRanker.parse());
+
+    docid_t docid = 1;
+    BOOST_CHECK_CLOSE(customRanker.evaluate(docid), 15.0, 1e-9);
+
+    CustomRankProgram program;
+    ExpSyntaxTree root = makeRoot(makeOperator(ExpSyntaxTree::SUM,
+        makeConstant(1), makeOperator(ExpSyntaxTree::PRODUCT,
+                                      makeConstant(2), makeConstant(3))));
+    BOOST_REQUIRE(program.compile(root));
+    BOOST_CHECK_EQUAL(program.getInstructions().size(), 1U);
+    BOOST_CHECK_EQUAL(program.evaluate(docid), 7.0);
+}
+
+BOOST_AUTO_TEST_CASE(testEvaluate)
+{
+    const docid_t docNum = 200;
+    NumericPropertyTablePtr sales(new NumericPropertyTable<int32_t>(INT32_PROPERTY_TYPE));
+    NumericPropertyTablePtr rating(new NumericPropertyTable<float>(FLOAT_PROPERTY_TYPE));
+    sales->resize(docNum);
+    rating->resize(docNum);
+
+    for (docid_t i = 1; i < docNum; ++i)
+    {
+        sales->setInt32Value(i, i * 10);
+        // leave some docs without rating
+        if (i % 7)
+        {
+            rating->setFloatValue(i, i % 5);
+        }
+    }
+
+    // log(sales)*0.3 + sqrt(rating) / (1 + 1)
+    ExpSyntaxTree root = makeRoot(makeOperator(ExpSyntaxTree::SUM,
+        makeOperator(ExpSyntaxTree::PRODUCT,
+                     makeOperator(ExpSyntaxTree::LOG, makeParameter(sales)),
+                     makeConstant(0.3)),
+        makeOperator(ExpSyntaxTree::DIV,
+                     makeOperator(ExpSyntaxTree::SQRT, makeParameter(rating)),
+                     makeOperator(ExpSyntaxTree::SUM, makeConstant(1), makeConstant(1)))));
+
+    CustomRankProgram program;
+    BOOST_REQUIRE(program.compile(root));
+
+    std::vector<docid_t> docids;
+    for (docid_t i = 1; i < docNum; ++i)
+    {
+        docids.push_back(i);
+    }
+    std::vector<double> scores(docids.size());
+    program.evaluate(&docids[0], docids.size(), &scores[0]);
+
+    for (std::size_t i = 0; i < docids.size(); ++i)
+    {
+        docid_t docid = docids[i];
+        double ratingValue = (docid % 7) ? docid % 5 : 0;
+        double expected = std::log(docid * 10.0) * 0.3 + std::sqrt(ratingValue) / 2;
+
+        BOOST_CHECK_CLOSE(scores[i], expected, 1e-6);
+        BOOST_CHECK_CLOSE(program.evaluate(docid), expected, 1e-6);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testInvalidTree)
+{
+    CustomRankProgram program;
+    ExpSyntaxTree root(ExpSyntaxTree::ROOT);
+    BOOST_CHECK(!program.compile(root));
+
+    root.children_.push_back(makeNode(ExpSyntaxTree::SUM));
+    BOOST_CHECK(!program.compile(root));
+    BOOST_CHECK(program.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
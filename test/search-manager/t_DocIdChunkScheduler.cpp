@@ -0,0 +1,190 @@
+#include <search-manager/DocIdChunkScheduler.h>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <vector>
+#include <utility>
+
+using namespace sf1r;
+
+namespace
+{
+typedef std::pair<docid_t, docid_t> DocIdRange;
+typedef std::vector<DocIdRange> RangeList;
+
+void consumeChunks(
+    DocIdChunkScheduler& scheduler,
+    std::size_t threadId,
+    RangeList& ranges)
+{
+    docid_t docIdBegin = 0;
+    docid_t docIdEnd = 0;
+    while (scheduler.nextChunk(threadId, docIdBegin, docIdEnd))
+    {
+        ranges.push_back(DocIdRange(docIdBegin, docIdEnd));
+    }
+}
+
+void checkAscending(const RangeList& ranges)
+{
+    for (std::size_t i = 1; i < ranges.size(); ++i)
+    {
+        BOOST_CHECK_LE(ranges[i-1].second, ranges[i].first);
+    }
+}
+
+void checkCoverage(const std::vector<RangeList>& threadRanges, docid_t docNum)
+{
+    std::vector<int> visitNum(docNum, 0);
+    for (std::size_t i = 0; i < threadRanges.size(); ++i)
+    {
+        const RangeList& ranges = threadRanges[i];
+        for (std::size_t j = 0; j < ranges.size(); ++j)
+        {
+            for (docid_t docId = ranges[j].first; docId < ranges[j].second; ++docId)
+            {
+                ++visitNum[docId];
+            }
+        }
+    }
+
+    for (docid_t docId = 0; docId < docNum; ++docId)
+    {
+        BOOST_CHECK_EQUAL(visitNum[docId], 1);
+    }
+}
+/**
+ * thread @p busyId claims the last batch and becomes busy on its first
+ * chunk, then thread @p idleId steals the rest of that batch.
+ */
+void checkStealLastBatch(std::size_t idleId, std::size_t busyId)
+{
+    const docid_t docNum = 1600;
+    DocIdChunkScheduler scheduler(docNum, 2, 16);
+    BOOST_REQUIRE_EQUAL(scheduler.getBatchSize(), 2U);
+
+    std::vector<RangeList> threadRanges(2);
+    docid_t docIdBegin = 0;
+    docid_t docIdEnd = 0;
+
+    // the idle thread claims all batches except the last one
+    for (std::size_t i = 0; i < 14; ++i)
+    {
+        BOOST_REQUIRE(scheduler.nextChunk(idleId, docIdBegin, docIdEnd));
+        threadRanges[idleId].push_back(DocIdRange(docIdBegin, docIdEnd));
+    }
+
+    BOOST_REQUIRE(scheduler.nextChunk(busyId, docIdBegin, docIdEnd));
+    BOOST_CHECK_EQUAL(docIdBegin, 1400U);
+    threadRanges[busyId].push_back(DocIdRange(docIdBegin, docIdEnd));
+
+    consumeChunks(scheduler, idleId, threadRanges[idleId]);
+    consumeChunks(scheduler, busyId, threadRanges[busyId]);
+
+    BOOST_CHECK_EQUAL(scheduler.getStats(idleId).stealNum, 1U);
+    BOOST_CHECK_EQUAL(threadRanges[idleId].size(), 15U);
+    BOOST_CHECK_EQUAL(threadRanges[busyId].size(), 1U);
+
+    checkAscending(threadRanges[0]);
+    checkAscending(threadRanges[1]);
+    checkCoverage(threadRanges, docNum);
+}
+}
+
+BOOST_AUTO_TEST_SUITE(DocIdChunkScheduler_test)
+
+BOOST_AUTO_TEST_CASE(testSingleThread)
+{
+    const docid_t docNum = 1001;
+    DocIdChunkScheduler scheduler(docNum, 1, 10);
+    BOOST_CHECK_EQUAL(scheduler.getChunkNum(), 10U);
+
+    std::vector<RangeList> threadRanges(1);
+    consumeChunks(scheduler, 0, threadRanges[0]);
+
+    BOOST_CHECK_EQUAL(threadRanges[0].size(), 10U);
+    checkAscending(threadRanges[0]);
+    checkCoverage(threadRanges, docNum);
+
+    const DocIdChunkStats& stats = scheduler.getStats(0);
+    BOOST_CHECK_EQUAL(stats.chunkNum, 10U);
+    BOOST_CHECK_EQUAL(stats.stealNum, 0U);
+}
+
+BOOST_AUTO_TEST_CASE(testEveryThreadSteals)
+{
+    // no thread is fixed to the tail, so either thread could steal
+    checkStealLastBatch(0, 1);
+    checkStealLastBatch(1, 0);
+}
+
+BOOST_AUTO_TEST_CASE(testNotStealBackward)
+{
+    const docid_t docNum = 1600;
+    DocIdChunkScheduler scheduler(docNum, 2, 16);
+
+    // thread 0 becomes busy on the first chunk of its batch
+    std::vector<RangeList> threadRanges(2);
+    docid_t docIdBegin = 0;
+    docid_t docIdEnd = 0;
+    BOOST_REQUIRE(scheduler.nextChunk(0, docIdBegin, docIdEnd));
+    threadRanges[0].push_back(DocIdRange(docIdBegin, docIdEnd));
+
+    // thread 1 searches the other batches, it could not steal
+    // the chunks before the ones it has searched
+    consumeChunks(scheduler, 1, threadRanges[1]);
+    consumeChunks(scheduler, 0, threadRanges[0]);
+
+    BOOST_CHECK_EQUAL(threadRanges[0].size(), 2U);
+    BOOST_CHECK_EQUAL(threadRanges[1].size(), 14U);
+    BOOST_CHECK_EQUAL(scheduler.getStats(1).stealNum, 0U);
+    checkCoverage(threadRanges, docNum);
+}
+
+BOOST_AUTO_TEST_CASE(testFinishChunk)
+{
+    DocIdChunkScheduler scheduler(400, 1, 4);
+
+    docid_t docIdBegin = 0;
+    docid_t docIdEnd = 0;
+    BOOST_REQUIRE(scheduler.nextChunk(0, docIdBegin, docIdEnd));
+    BOOST_CHECK_EQUAL(docIdBegin, 0U);
+
+    // the chunk is finished, while no chunk is taken
+    scheduler.finishChunk(0);
+    BOOST_CHECK_EQUAL(scheduler.getStats(0).chunkNum, 1U);
+    scheduler.finishChunk(0);
+    BOOST_CHECK_EQUAL(scheduler.getStats(0).chunkNum, 1U);
+
+    BOOST_REQUIRE(scheduler.nextChunk(0, docIdBegin, docIdEnd));
+    BOOST_CHECK_EQUAL(docIdBegin, 100U);
+}
+
+BOOST_AUTO_TEST_CASE(testMultiThreads)
+{
+    const docid_t docNum = 100000;
+    const std::size_t threadNum = 8;
+    DocIdChunkScheduler scheduler(docNum, threadNum, threadNum * 16);
+
+    std::vector<RangeList> threadRanges(threadNum);
+    boost::thread_group threads;
+    for (std::size_t i = 0; i < threadNum; ++i)
+    {
+        threads.create_thread(boost::bind(consumeChunks,
+                                          boost::ref(scheduler), i,
+                                          boost::ref(threadRanges[i])));
+    }
+    threads.join_all();
+
+    DocIdChunkStats totalStats;
+    for (std::size_t i = 0; i < threadNum; ++i)
+    {
+        checkAscending(threadRanges[i]);
+        totalStats.merge(scheduler.getStats(i));
+    }
+    checkCoverage(threadRanges, docNum);
+    BOOST_CHECK_EQUAL(totalStats.chunkNum, threadNum * 16);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,272 @@
+#include <search-manager/NumericFilterScanner.h>
+
+#include <boost/test/unit_test.hpp>
+#include <algorithm> // find
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+using namespace sf1r;
+
+namespace
+{
+typedef NumericFilterScanner<int32_t>::WordT WordT;
+
+const int32_t kInvalidValue = std::numeric_limits<int32_t>::max();
+
+/** a bitmap which just keeps the added words */
+struct WordBitmap
+{
+    std::vector<WordT> words;
+
+    void add(WordT word)
+    {
+        words.push_back(word);
+    }
+
+    bool test(std::size_t pos) const
+    {
+        return words[pos / 64] >> (pos % 64) & 1;
+    }
+};
+
+bool expectMatch(
+    QueryFiltering::FilteringOperation operation,
+    const std::vector<int32_t>& values,
+    int32_t x)
+{
+    if (x == kInvalidValue)
+        return false;
+
+    switch (operation)
+    {
+    case QueryFiltering::EQUAL:
+        return x == values[0];
+    case QueryFiltering::NOT_EQUAL:
+        return x != values[0];
+    case QueryFiltering::GREATER_THAN:
+        return x > values[0];
+    case QueryFiltering::GREATER_THAN_EQUAL:
+        return x >= values[0];
+    case QueryFiltering::LESS_THAN:
+        return x < values[0];
+    case QueryFiltering::LESS_THAN_EQUAL:
+        return x <= values[0];
+    case QueryFiltering::RANGE:
+        return x >= values[0] && x <= values[1];
+    case QueryFiltering::INCLUDE:
+    case QueryFiltering::EXCLUDE:
+    {
+        bool found = false;
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            if (x == values[i])
+                found = true;
+        }
+        return (operation == QueryFiltering::INCLUDE) == found;
+    }
+    default:
+        return false;
+    }
+}
+
+void checkScan(
+    QueryFiltering::FilteringOperation operation,
+    const std::vector<int32_t>& values,
+    const std::vector<int32_t>& data,
+    std::size_t bitsNum)
+{
+    NumericFilterScanner<int32_t> scanner(kInvalidValue);
+    BOOST_REQUIRE(scanner.init(operation, values));
+
+    WordBitmap bitmap;
+    scanner.scan(data.empty() ? NULL : &data[0], data.size(), bitsNum, bitmap);
+
+    BOOST_REQUIRE_EQUAL(bitmap.words.size(), (bitsNum + 63) / 64);
+    for (std::size_t i = 0; i < bitmap.words.size() * 64; ++i)
+    {
+        bool expected = i < bitsNum && i < data.size() &&
+            expectMatch(operation, values, data[i]);
+        BOOST_CHECK_MESSAGE(bitmap.test(i) == expected,
+                            "operation: " << operation << ", doc: " << i);
+    }
+}
+}
+
+BOOST_AUTO_TEST_SUITE(NumericFilterScanner_test)
+
+BOOST_AUTO_TEST_CASE(testInit)
+{
+    NumericFilterScanner<int32_t> scanner(kInvalidValue);
+    std::vector<int32_t> values;
+
+    BOOST_CHECK(!scanner.init(QueryFiltering::GREATER_THAN, values));
+
+    values.push_back(1);
+    BOOST_CHECK(!scanner.init(QueryFiltering::RANGE, values));
+    BOOST_CHECK(!scanner.init(QueryFiltering::PREFIX, values));
+    BOOST_CHECK(scanner.init(QueryFiltering::GREATER_THAN, values));
+
+    values.push_back(2);
+    BOOST_CHECK(scanner.init(QueryFiltering::RANGE, values));
+}
+
+BOOST_AUTO_TEST_CASE(testOperations)
+{
+    std::srand(1);
+
+    std::vector<int32_t> data(1000);
+    for (std::size_t i = 0; i < data.size(); ++i)
+    {
+        data[i] = std::rand() % 10 ? std::rand() % 100 : kInvalidValue;
+    }
+
+    std::vector<int32_t> values;
+    values.push_back(30);
+    values.push_back(60);
+    values.push_back(90);
+
+    const QueryFiltering::FilteringOperation operations[] = {
+        QueryFiltering::EQUAL,
+        QueryFiltering::NOT_EQUAL,
+        QueryFiltering::INCLUDE,
+        QueryFiltering::EXCLUDE,
+        QueryFiltering::GREATER_THAN,
+        QueryFiltering::GREATER_THAN_EQUAL,
+        QueryFiltering::LESS_THAN,
+        QueryFiltering::LESS_THAN_EQUAL,
+        QueryFiltering::RANGE
+    };
+    const std::size_t operationNum = sizeof(operations) / sizeof(operations[0]);
+
+    for (std::size_t i = 0; i < operationNum; ++i)
+    {
+        checkScan(operations[i], values, data, data.size());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testSize)
+{
+    std::vector<int32_t> values(1, 5);
+    std::vector<int32_t> data(130, 10);
+
+    // the docs beyond the table have no value
+    checkScan(QueryFiltering::GREATER_THAN, values, data, 300);
+
+    // the docs beyond bitsNum are not scanned
+    checkScan(QueryFiltering::GREATER_THAN, values, data, 100);
+    checkScan(QueryFiltering::GREATER_THAN, values, data, 128);
+
+    data.clear();
+    checkScan(QueryFiltering::GREATER_THAN, values, data, 65);
+}
+
+BOOST_AUTO_TEST_CASE(testConvertFractionalValue)
+{
+    const QueryFiltering::FilteringOperation operations[] = {
+        QueryFiltering::GREATER_THAN,
+        QueryFiltering::GREATER_THAN_EQUAL,
+        QueryFiltering::LESS_THAN,
+        QueryFiltering::LESS_THAN_EQUAL
+    };
+    const std::size_t operationNum = sizeof(operations) / sizeof(operations[0]);
+    const double bounds[] = {-2.5, -2, 0.5, 2, 2.5};
+    const std::size_t boundNum = sizeof(bounds) / sizeof(bounds[0]);
+
+    // the integer bound gives the same result as the fractional one
+    for (std::size_t i = 0; i < operationNum; ++i)
+    {
+        for (std::size_t j = 0; j < boundNum; ++j)
+        {
+            int32_t value = 0;
+            BOOST_REQUIRE(NumericFilterScanner<int32_t>::convertValue(
+                operations[i], 0, bounds[j], value));
+
+            for (int32_t x = -5; x <= 5; ++x)
+            {
+                bool expected = false;
+                switch (operations[i])
+                {
+                case QueryFiltering::GREATER_THAN:
+                    expected = x > bounds[j];
+                    break;
+                case QueryFiltering::GREATER_THAN_EQUAL:
+                    expected = x >= bounds[j];
+                    break;
+                case QueryFiltering::LESS_THAN:
+                    expected = x < bounds[j];
+                    break;
+                default:
+                    expected = x <= bounds[j];
+                    break;
+                }
+
+                BOOST_CHECK_MESSAGE(
+                    expectMatch(operations[i], std::vector<int32_t>(1, value), x) == expected,
+                    "operation: " << operations[i] << ", bound: " << bounds[j]
+                    << ", x: " << x);
+            }
+        }
+    }
+
+    // the lower bound is rounded up, and the upper bound is rounded down
+    int32_t low = 0;
+    int32_t high = 0;
+    BOOST_CHECK(NumericFilterScanner<int32_t>::convertValue(QueryFiltering::RANGE, 0, 1.5, low));
+    BOOST_CHECK(NumericFilterScanner<int32_t>::convertValue(QueryFiltering::RANGE, 1, 3.5, high));
+    BOOST_CHECK_EQUAL(low, 2);
+    BOOST_CHECK_EQUAL(high, 3);
+
+    // an integer never equals a fractional value
+    int32_t value = 0;
+    BOOST_CHECK(!NumericFilterScanner<int32_t>::convertValue(QueryFiltering::EQUAL, 0, 2.5, value));
+    BOOST_CHECK(!NumericFilterScanner<int32_t>::convertValue(QueryFiltering::INCLUDE, 1, 2.5, value));
+    BOOST_CHECK(NumericFilterScanner<int32_t>::convertValue(QueryFiltering::EQUAL, 0, 2.0, value));
+    BOOST_CHECK_EQUAL(value, 2);
+
+    // out of the range of the integer type
+    int8_t int8Value = 0;
+    BOOST_CHECK(!NumericFilterScanner<int8_t>::convertValue(QueryFiltering::GREATER_THAN, 0, 300.5, int8Value));
+    BOOST_CHECK(!NumericFilterScanner<int8_t>::convertValue(QueryFiltering::GREATER_THAN, 0, int64_t(300), int8Value));
+    int64_t int64Value = 0;
+    BOOST_CHECK(!NumericFilterScanner<int64_t>::convertValue(QueryFiltering::LESS_THAN, 0, 1e19, int64Value));
+    BOOST_CHECK(NumericFilterScanner<int8_t>::convertValue(QueryFiltering::GREATER_THAN, 0, int64_t(-128), int8Value));
+    BOOST_CHECK_EQUAL(int8Value, -128);
+
+    // the floating point value is not rounded for a floating point type
+    float floatValue = 0;
+    BOOST_CHECK(NumericFilterScanner<float>::convertValue(QueryFiltering::EQUAL, 0, 2.5, floatValue));
+    BOOST_CHECK_EQUAL(floatValue, 2.5f);
+}
+
+BOOST_AUTO_TEST_CASE(testExcludeDeletedDocs)
+{
+    std::vector<int32_t> values(1, 5);
+    std::vector<int32_t> data(200, 10);
+
+    std::vector<uint32_t> deletedDocs;
+    deletedDocs.push_back(0);
+    deletedDocs.push_back(63);
+    deletedDocs.push_back(64);
+    deletedDocs.push_back(130);
+    deletedDocs.push_back(199);
+    // beyond the scanned docs
+    deletedDocs.push_back(500);
+
+    NumericFilterScanner<int32_t> scanner(kInvalidValue);
+    BOOST_REQUIRE(scanner.init(QueryFiltering::GREATER_THAN, values));
+
+    WordBitmap bitmap;
+    ExcludedDocsBitmap<WordBitmap, uint32_t> excludedBitmap(bitmap, deletedDocs);
+    scanner.scan(&data[0], data.size(), data.size(), excludedBitmap);
+
+    BOOST_REQUIRE_EQUAL(bitmap.words.size(), 4U);
+    for (std::size_t i = 0; i < data.size(); ++i)
+    {
+        bool isDeleted = std::find(deletedDocs.begin(), deletedDocs.end(), i)
+            != deletedDocs.end();
+        BOOST_CHECK_MESSAGE(bitmap.test(i) == !isDeleted, "doc: " << i);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
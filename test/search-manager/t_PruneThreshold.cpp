@@ -0,0 +1,152 @@
+#include <search-manager/PruneThreshold.h>
+#include <search-manager/ScoreDoc.h>
+
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace sf1r;
+
+namespace
+{
+typedef std::vector<ScoreDoc> ScoreDocList;
+
+/** the same order as ScoreLessThan in HitQueue.h */
+struct TestLessThan
+{
+    bool operator()(const ScoreDoc& o1, const ScoreDoc& o2) const
+    {
+        if (std::fabs(o1.score - o2.score) < std::numeric_limits<score_t>::epsilon())
+            return o1.docId < o2.docId;
+        return o1.score < o2.score;
+    }
+};
+
+struct TestGreaterThan
+{
+    bool operator()(const ScoreDoc& o1, const ScoreDoc& o2) const
+    {
+        return TestLessThan()(o2, o1);
+    }
+};
+
+/**
+ * keep the top @p heapSize docs in a min heap as ScoreSortedHitQueue does,
+ * if @p isPruning is true, the docs whose upper bound is not greater than
+ * the threshold are skipped as the WAND pivot does.
+ */
+void getTopDocs(
+    const ScoreDocList& docs,
+    std::size_t heapSize,
+    bool isPruning,
+    ScoreDocList& topDocs,
+    std::size_t& prunedNum)
+{
+    ScoreDocList heap;
+    score_t threshold = 0;
+    prunedNum = 0;
+
+    for (ScoreDocList::const_iterator it = docs.begin(); it != docs.end(); ++it)
+    {
+        // the upper bound is summed in float
+        const score_t upperBound = static_cast<score_t>(it->score);
+        if (isPruning && upperBound <= threshold)
+        {
+            ++prunedNum;
+            continue;
+        }
+
+        if (heap.size() < heapSize)
+        {
+            heap.push_back(*it);
+            std::push_heap(heap.begin(), heap.end(), TestGreaterThan());
+        }
+        else if (TestLessThan()(heap.front(), *it))
+        {
+            std::pop_heap(heap.begin(), heap.end(), TestGreaterThan());
+            heap.back() = *it;
+            std::push_heap(heap.begin(), heap.end(), TestGreaterThan());
+        }
+
+        if (isPruning && heap.size() >= heapSize)
+        {
+            threshold = std::max(threshold, getPruneThreshold(heap.front().score));
+        }
+    }
+
+    std::sort(heap.begin(), heap.end(), TestGreaterThan());
+    topDocs.swap(heap);
+}
+
+void checkTopDocs(const ScoreDocList& docs, std::size_t heapSize)
+{
+    ScoreDocList expectDocs;
+    ScoreDocList prunedDocs;
+    std::size_t prunedNum = 0;
+
+    getTopDocs(docs, heapSize, false, expectDocs, prunedNum);
+    getTopDocs(docs, heapSize, true, prunedDocs, prunedNum);
+
+    BOOST_REQUIRE_EQUAL(prunedDocs.size(), expectDocs.size());
+    for (std::size_t i = 0; i < expectDocs.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(prunedDocs[i].docId, expectDocs[i].docId);
+        BOOST_CHECK_EQUAL(prunedDocs[i].score, expectDocs[i].score);
+    }
+}
+}
+
+BOOST_AUTO_TEST_SUITE(PruneThreshold_test)
+
+BOOST_AUTO_TEST_CASE(testBelowMinScore)
+{
+    const double scores[] = {0, 1e-3, 0.5, 1, 2, 3, 10.5, 1000, 1e6};
+    const std::size_t scoreNum = sizeof(scores) / sizeof(scores[0]);
+
+    for (std::size_t i = 0; i < scoreNum; ++i)
+    {
+        const score_t threshold = getPruneThreshold(scores[i]);
+
+        // the doc whose score equals the minimum is not pruned,
+        // even if its upper bound is rounded down in float
+        BOOST_CHECK_LT(threshold, static_cast<score_t>(scores[i]));
+        BOOST_CHECK_LT(threshold, scores[i] - std::numeric_limits<score_t>::epsilon());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testSameTopDocsWithTies)
+{
+    // the scores above 2 are included, and many docs have the same score,
+    // so the later doc replaces the minimum in tie
+    const double scores[] = {0.5, 1.5, 3, 10, 10 + 1e-6, 100.25, 1000.5};
+    const std::size_t scoreNum = sizeof(scores) / sizeof(scores[0]);
+
+    std::srand(1);
+    ScoreDocList docs;
+    for (docid_t docId = 1; docId <= 5000; ++docId)
+    {
+        // more docs with the lower scores
+        std::size_t index = std::rand() % scoreNum;
+        index = std::min(index, static_cast<std::size_t>(std::rand() % scoreNum));
+        docs.push_back(ScoreDoc(docId, scores[index]));
+    }
+
+    const std::size_t heapSizes[] = {1, 10, 100, 1000, 10000};
+    const std::size_t heapSizeNum = sizeof(heapSizes) / sizeof(heapSizes[0]);
+
+    for (std::size_t i = 0; i < heapSizeNum; ++i)
+    {
+        checkTopDocs(docs, heapSizes[i]);
+    }
+
+    // the docs below the top are still pruned
+    ScoreDocList topDocs;
+    std::size_t prunedNum = 0;
+    getTopDocs(docs, 10, true, topDocs, prunedNum);
+    BOOST_CHECK_GT(prunedNum, 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
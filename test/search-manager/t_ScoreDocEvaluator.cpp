@@ -0,0 +1,183 @@
+#include <search-manager/ScoreDocEvaluator.h>
+#include <search-manager/ScoreDoc.h>
+#include <search-manager/DocumentIterator.h>
+#include <search-manager/CustomRanker.h>
+#include <search-manager/NumericPropertyTableBuilder.h>
+#include <mining-manager/product-scorer/RelevanceScorer.h>
+#include <common/NumericPropertyTable.h>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/shared_ptr.hpp>
+#include <string>
+#include <vector>
+
+using namespace sf1r;
+
+namespace
+{
+typedef boost::shared_ptr<NumericPropertyTableBase> NumericPropertyTablePtr;
+
+const docid_t kDocNum = 1000;
+
+/** the custom ranking scores are evaluated in blocks of this size */
+const std::size_t kBlockSize = CustomRankProgram::kBlockSize;
+
+/**
+ * the iterator of a keyword query, the relevance score of each doc
+ * is its doc id, which is only available at the current doc.
+ */
+class KeywordDocumentIterator : public DocumentIterator
+{
+public:
+    explicit KeywordDocumentIterator(const std::vector<docid_t>& docIds)
+        : docIds_(docIds)
+        , pos_(-1)
+    {
+    }
+
+    virtual void add(DocumentIterator* pDocIterator) {}
+
+    virtual bool next()
+    {
+        return ++pos_ < static_cast<int>(docIds_.size());
+    }
+
+    virtual docid_t doc()
+    {
+        return pos_ < static_cast<int>(docIds_.size()) ? docIds_[pos_] : MAX_DOC_ID;
+    }
+
+    virtual void doc_item(RankDocumentProperty& rankDocumentProperty, unsigned propIndex) {}
+
+    virtual void df_cmtf(DocumentFrequencyInProperties& dfmap,
+                         CollectionTermFrequencyInProperties& ctfmap,
+                         MaxTermFrequencyInProperties& maxtfmap) {}
+
+    virtual count_t tf() { return 1; }
+
+    virtual double score(
+        const std::vector<RankQueryProperty>& rankQueryProperties,
+        const std::vector<boost::shared_ptr<PropertyRanker> >& propertyRankers)
+    {
+        return doc();
+    }
+
+private:
+    const std::vector<docid_t> docIds_;
+    int pos_;
+};
+
+class PriceTableBuilder : public NumericPropertyTableBuilder
+{
+public:
+    PriceTableBuilder()
+        : priceTable_(new NumericPropertyTable<int32_t>(INT32_PROPERTY_TYPE))
+    {
+        priceTable_->resize(kDocNum + 1);
+        for (docid_t docId = 1; docId <= kDocNum; ++docId)
+        {
+            priceTable_->setInt32Value(docId, docId % 100);
+        }
+    }
+
+    virtual NumericPropertyTablePtr& createPropertyTable(const std::string& propertyName)
+    {
+        return propertyName == "price" ? priceTable_ : emptyTable_;
+    }
+
+private:
+    NumericPropertyTablePtr priceTable_;
+    NumericPropertyTablePtr emptyTable_;
+};
+
+CustomRankerPtr createCustomRanker(PriceTableBuilder& tableBuilder)
+{
+    CustomRankerPtr customRanker(new CustomRanker);
+    std::string exp("price * 2");
+    BOOST_REQUIRE(customRanker->parse(exp));
+    BOOST_REQUIRE(customRanker->setPropertyData(&tableBuilder));
+
+    return customRanker;
+}
+
+void checkScoreDoc(const ScoreDoc& scoreDoc)
+{
+    BOOST_CHECK_EQUAL(scoreDoc.score, static_cast<double>(scoreDoc.docId));
+    BOOST_CHECK_EQUAL(scoreDoc.custom_score, (scoreDoc.docId % 100) * 2.0);
+}
+}
+
+BOOST_AUTO_TEST_SUITE(ScoreDocEvaluator_test)
+
+/**
+ * the custom ranking scores of a keyword query are evaluated in blocks,
+ * while the relevance score of each doc is still got before the iterator
+ * moves to the next doc, just like in SearchThreadWorker::doSearch_().
+ */
+BOOST_AUTO_TEST_CASE(testKeywordQueryWithCustomRank)
+{
+    std::vector<docid_t> docIds;
+    for (docid_t docId = 1; docId <= kDocNum; docId += 3)
+    {
+        docIds.push_back(docId);
+    }
+
+    KeywordDocumentIterator docIterator(docIds);
+    std::vector<RankQueryProperty> rankQueryProps;
+    std::vector<boost::shared_ptr<PropertyRanker> > propRankers;
+
+    PriceTableBuilder tableBuilder;
+    ScoreDocEvaluator scoreDocEvaluator(
+        new RelevanceScorer(docIterator, rankQueryProps, propRankers),
+        createCustomRanker(tableBuilder),
+        GeoLocationRankerPtr());
+    BOOST_REQUIRE(scoreDocEvaluator.hasCustomRanker());
+
+    std::vector<ScoreDoc> scoreBlock;
+    std::vector<ScoreDoc> results;
+    while (docIterator.next())
+    {
+        scoreBlock.push_back(ScoreDoc(docIterator.doc()));
+        scoreDocEvaluator.evaluateExceptCustom(scoreBlock.back());
+
+        if (scoreBlock.size() >= kBlockSize)
+        {
+            scoreDocEvaluator.evaluateCustom(&scoreBlock[0], scoreBlock.size());
+            results.insert(results.end(), scoreBlock.begin(), scoreBlock.end());
+            scoreBlock.clear();
+        }
+    }
+
+    // the last block is not full
+    BOOST_CHECK(!scoreBlock.empty());
+    scoreDocEvaluator.evaluateCustom(&scoreBlock[0], scoreBlock.size());
+    results.insert(results.end(), scoreBlock.begin(), scoreBlock.end());
+
+    BOOST_REQUIRE_EQUAL(results.size(), docIds.size());
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(results[i].docId, docIds[i]);
+        checkScoreDoc(results[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testEvaluateOneDoc)
+{
+    std::vector<docid_t> docIds(1, 7);
+    KeywordDocumentIterator docIterator(docIds);
+    std::vector<RankQueryProperty> rankQueryProps;
+    std::vector<boost::shared_ptr<PropertyRanker> > propRankers;
+
+    PriceTableBuilder tableBuilder;
+    ScoreDocEvaluator scoreDocEvaluator(
+        new RelevanceScorer(docIterator, rankQueryProps, propRankers),
+        createCustomRanker(tableBuilder),
+        GeoLocationRankerPtr());
+
+    BOOST_REQUIRE(docIterator.next());
+    ScoreDoc scoreDoc(docIterator.doc());
+    scoreDocEvaluator.evaluate(scoreDoc);
+    checkScoreDoc(scoreDoc);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
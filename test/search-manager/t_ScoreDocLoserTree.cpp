@@ -0,0 +1,107 @@
+#include <search-manager/ScoreDocLoserTree.h>
+
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+using namespace sf1r;
+
+namespace
+{
+typedef std::vector<ScoreDoc> ScoreDocList;
+
+struct TestLessThan
+{
+    bool operator()(const ScoreDoc& o1, const ScoreDoc& o2) const
+    {
+        if (o1.score == o2.score)
+            return o1.docId < o2.docId;
+        return o1.score < o2.score;
+    }
+};
+
+struct TestGreaterThan
+{
+    bool operator()(const ScoreDoc& o1, const ScoreDoc& o2) const
+    {
+        return TestLessThan()(o2, o1);
+    }
+};
+
+void createLists(
+    std::size_t listNum,
+    std::size_t maxListSize,
+    std::vector<ScoreDocList>& lists)
+{
+    lists.resize(listNum);
+    docid_t docId = 0;
+
+    for (std::size_t i = 0; i < listNum; ++i)
+    {
+        ScoreDocList& list = lists[i];
+        std::size_t listSize = std::rand() % (maxListSize + 1);
+
+        for (std::size_t j = 0; j < listSize; ++j)
+        {
+            list.push_back(ScoreDoc(docId++, std::rand() % 100));
+        }
+        std::sort(list.begin(), list.end(), TestGreaterThan());
+    }
+}
+
+void checkMerge(const std::vector<ScoreDocList>& lists, std::size_t maxNum)
+{
+    std::vector<const ScoreDocList*> listPtrs;
+    ScoreDocList expected;
+    for (std::size_t i = 0; i < lists.size(); ++i)
+    {
+        listPtrs.push_back(&lists[i]);
+        expected.insert(expected.end(), lists[i].begin(), lists[i].end());
+    }
+    std::sort(expected.begin(), expected.end(), TestGreaterThan());
+    if (expected.size() > maxNum)
+    {
+        expected.resize(maxNum);
+    }
+
+    ScoreDocList result;
+    mergeSortedScoreDocs(listPtrs, TestLessThan(), maxNum, result);
+
+    BOOST_REQUIRE_EQUAL(result.size(), expected.size());
+    for (std::size_t i = 0; i < result.size(); ++i)
+    {
+        BOOST_CHECK_EQUAL(result[i].docId, expected[i].docId);
+        BOOST_CHECK_EQUAL(result[i].score, expected[i].score);
+    }
+}
+}
+
+BOOST_AUTO_TEST_SUITE(ScoreDocLoserTree_test)
+
+BOOST_AUTO_TEST_CASE(testEmpty)
+{
+    std::vector<ScoreDocList> lists;
+    checkMerge(lists, 10);
+
+    lists.resize(3);
+    checkMerge(lists, 10);
+}
+
+BOOST_AUTO_TEST_CASE(testListNum)
+{
+    std::srand(1);
+
+    for (std::size_t listNum = 1; listNum <= 33; ++listNum)
+    {
+        std::vector<ScoreDocList> lists;
+        createLists(listNum, 50, lists);
+
+        checkMerge(lists, 0);
+        checkMerge(lists, 1);
+        checkMerge(lists, 20);
+        checkMerge(lists, 10000);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -18,6 +18,9 @@
 #include <boost/random.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
+#include <limits>
+#include <vector>
+
 using namespace sf1r;
 
 
@@ -166,4 +169,79 @@ BOOST_AUTO_TEST_CASE(sorter3)
     delete scoreItemQueue;
 }
 
+BOOST_AUTO_TEST_CASE(encodeKey)
+{
+    const int64_t intValues[] = {
+        std::numeric_limits<int64_t>::min(), -100, -1, 0, 1, 100,
+        std::numeric_limits<int64_t>::max()};
+    const size_t intNum = sizeof(intValues) / sizeof(intValues[0]);
+    for (size_t i = 1; i < intNum; ++i)
+    {
+        BOOST_CHECK(SortPropertyComparator::encodeInt64(intValues[i-1]) <
+                    SortPropertyComparator::encodeInt64(intValues[i]));
+    }
+    // the doc without value is encoded as 0
+    BOOST_CHECK(SortPropertyComparator::encodeInt64(intValues[0]) > 0);
+
+    const double doubleValues[] = {
+        -std::numeric_limits<double>::infinity(), -1e10, -1.5, -1e-10, 0,
+        1e-10, 1.5, 1e10, std::numeric_limits<double>::infinity()};
+    const size_t doubleNum = sizeof(doubleValues) / sizeof(doubleValues[0]);
+    for (size_t i = 1; i < doubleNum; ++i)
+    {
+        BOOST_CHECK(SortPropertyComparator::encodeDouble(doubleValues[i-1]) <
+                    SortPropertyComparator::encodeDouble(doubleValues[i]));
+    }
+    BOOST_CHECK_EQUAL(SortPropertyComparator::encodeDouble(-0.0),
+                      SortPropertyComparator::encodeDouble(0.0));
+}
+
+BOOST_AUTO_TEST_CASE(sortKeyOrder)
+{
+    boost::shared_ptr<NumericPropertyTableBase> priceTable(
+        new NumericPropertyTable<float>(FLOAT_PROPERTY_TYPE));
+    priceTable->resize(MAXDOC * 10);
+    boost::shared_ptr<NumericPropertyTableBase> salesTable(
+        new NumericPropertyTable<int32_t>(INT32_PROPERTY_TYPE));
+    salesTable->resize(MAXDOC * 10);
+
+    boost::mt19937 engine(0);
+    boost::uniform_int<> distribution(-5, 5);
+    boost::variate_generator<boost::mt19937&, boost::uniform_int<> > random(engine, distribution);
+    std::vector<ScoreDoc> docs;
+    for (size_t i = 0; i < MAXDOC * 10; ++i)
+    {
+        priceTable->setFloatValue(i, random() * 0.5f);
+        salesTable->setInt32Value(i, random());
+        docs.push_back(ScoreDoc(i, random()));
+    }
+
+    // price asc, sales desc, rank desc
+    boost::shared_ptr<Sorter> pSorter(new Sorter(NULL));
+    pSorter->addSortProperty(new SortProperty("price", FLOAT_PROPERTY_TYPE,
+        new SortPropertyComparator(priceTable), SortProperty::AUTO, false));
+    pSorter->addSortProperty(new SortProperty("sales", INT32_PROPERTY_TYPE,
+        new SortPropertyComparator(salesTable), SortProperty::AUTO, true));
+    pSorter->addSortProperty(new SortProperty("RANK", UNKNOWN_DATA_PROPERTY_TYPE,
+        SortProperty::SCORE, true));
+
+    PropSharedLockSet propSharedLockSet;
+    PropertySortedHitQueue scoreItemQueue(pSorter, docs.size(), propSharedLockSet);
+    BOOST_REQUIRE(pSorter->canEncodeKeys());
+
+    std::vector<SortKeyDoc> keyDocs(docs.size());
+    for (size_t i = 0; i < docs.size(); ++i)
+    {
+        pSorter->encodeKeys(docs[i], keyDocs[i]);
+    }
+    for (size_t i = 0; i < docs.size(); ++i)
+    {
+        for (size_t j = 0; j < docs.size(); ++j)
+        {
+            BOOST_CHECK_EQUAL(pSorter->lessThan(docs[i], docs[j]),
+                              pSorter->lessThan(keyDocs[i], keyDocs[j]));
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
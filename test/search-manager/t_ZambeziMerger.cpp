@@ -0,0 +1,212 @@
+#include <index-manager/zambezi-manager/ZambeziMerger.h>
+
+#include <boost/test/unit_test.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+using namespace sf1r;
+
+namespace
+{
+typedef std::vector<docid_t> DocIdList;
+typedef std::vector<float> ScoreList;
+
+void createLists(
+    std::size_t listNum,
+    std::size_t maxListSize,
+    bool reverse,
+    std::vector<DocIdList>& docidsList,
+    std::vector<ScoreList>& scoresList,
+    std::vector<float>& weightList)
+{
+    docidsList.resize(listNum);
+    scoresList.resize(listNum);
+    weightList.resize(listNum);
+
+    for (std::size_t i = 0; i < listNum; ++i)
+    {
+        const std::size_t listSize = std::rand() % (maxListSize + 1);
+        docid_t docId = 0;
+
+        for (std::size_t j = 0; j < listSize; ++j)
+        {
+            docId += 1 + std::rand() % 3;
+            docidsList[i].push_back(docId);
+            scoresList[i].push_back(std::rand() % 10);
+        }
+
+        if (reverse)
+        {
+            std::reverse(docidsList[i].begin(), docidsList[i].end());
+        }
+        weightList[i] = 1 + std::rand() % 3;
+    }
+}
+
+/** merge by a map, all docs are output */
+void mergeByMap(
+    const std::vector<DocIdList>& docidsList,
+    const std::vector<ScoreList>& scoresList,
+    const std::vector<float>& weightList,
+    bool reverse,
+    DocIdList& docids,
+    ScoreList& scores)
+{
+    std::map<docid_t, float> docScores;
+    for (std::size_t i = 0; i < docidsList.size(); ++i)
+    {
+        for (std::size_t j = 0; j < docidsList[i].size(); ++j)
+        {
+            docScores[docidsList[i][j]] += scoresList[i][j] * weightList[i];
+        }
+    }
+
+    for (std::map<docid_t, float>::const_iterator it = docScores.begin();
+         it != docScores.end(); ++it)
+    {
+        docids.push_back(it->first);
+        scores.push_back(it->second);
+    }
+
+    if (reverse)
+    {
+        std::reverse(docids.begin(), docids.end());
+        std::reverse(scores.begin(), scores.end());
+    }
+}
+
+void checkMerge(std::size_t listNum, std::size_t limit, bool reverse, bool isPrefix)
+{
+    std::vector<DocIdList> docidsList;
+    std::vector<ScoreList> scoresList;
+    std::vector<float> weightList;
+    createLists(listNum, limit, reverse, docidsList, scoresList, weightList);
+
+    DocIdList expectDocIds;
+    ScoreList expectScores;
+    mergeByMap(docidsList, scoresList, weightList, reverse,
+               expectDocIds, expectScores);
+    if (isPrefix && expectDocIds.size() > limit)
+    {
+        expectDocIds.resize(limit);
+        expectScores.resize(limit);
+    }
+
+    DocIdList docids;
+    ScoreList scores;
+    mergeZambeziResults(docidsList, scoresList, weightList, reverse,
+                        isPrefix, limit, docids, scores);
+
+    BOOST_CHECK_EQUAL_COLLECTIONS(docids.begin(), docids.end(),
+                                  expectDocIds.begin(), expectDocIds.end());
+    BOOST_CHECK_EQUAL_COLLECTIONS(scores.begin(), scores.end(),
+                                  expectScores.begin(), expectScores.end());
+}
+}
+
+BOOST_AUTO_TEST_SUITE(ZambeziMerger_test)
+
+BOOST_AUTO_TEST_CASE(testEmpty)
+{
+    std::vector<DocIdList> docidsList(3);
+    std::vector<ScoreList> scoresList(3);
+    std::vector<float> weightList(3, 1);
+
+    DocIdList docids(1, 1);
+    ScoreList scores(1, 1);
+    mergeZambeziResults(docidsList, scoresList, weightList, false, true, 10,
+                        docids, scores);
+
+    BOOST_CHECK(docids.empty());
+    BOOST_CHECK(scores.empty());
+}
+
+BOOST_AUTO_TEST_CASE(testWeightedSum)
+{
+    std::vector<DocIdList> docidsList(2);
+    std::vector<ScoreList> scoresList(2);
+    std::vector<float> weightList;
+    weightList.push_back(1);
+    weightList.push_back(2);
+
+    docidsList[0].push_back(9);
+    docidsList[0].push_back(5);
+    docidsList[0].push_back(2);
+    scoresList[0].assign(3, 1);
+
+    docidsList[1].push_back(7);
+    docidsList[1].push_back(5);
+    scoresList[1].assign(2, 1);
+
+    DocIdList docids;
+    ScoreList scores;
+    mergeZambeziResults(docidsList, scoresList, weightList, true, true, 3,
+                        docids, scores);
+
+    BOOST_REQUIRE_EQUAL(docids.size(), 3U);
+    BOOST_CHECK_EQUAL(docids[0], 9U);
+    BOOST_CHECK_EQUAL(docids[1], 7U);
+    BOOST_CHECK_EQUAL(docids[2], 5U);
+    BOOST_CHECK_EQUAL(scores[0], 1);
+    BOOST_CHECK_EQUAL(scores[1], 2);
+    BOOST_CHECK_EQUAL(scores[2], 3);
+}
+
+BOOST_AUTO_TEST_CASE(testRandomLists)
+{
+    std::srand(0);
+    for (int i = 0; i < 100; ++i)
+    {
+        const std::size_t listNum = 1 + std::rand() % 4;
+        const std::size_t limit = 1 + std::rand() % 50;
+        checkMerge(listNum, limit, false, true);
+        checkMerge(listNum, limit, true, true);
+        checkMerge(listNum, limit, false, false);
+        checkMerge(listNum, limit, true, false);
+    }
+}
+
+/**
+ * the lists retrieved by WAND are the top docs by score, sorted by docid,
+ * the doc after the first @c limit merged docs might get the highest
+ * score, so it is not dropped.
+ */
+BOOST_AUTO_TEST_CASE(testTopScoreLists)
+{
+    std::vector<DocIdList> docidsList(2);
+    std::vector<ScoreList> scoresList(2);
+    std::vector<float> weightList(2, 1);
+
+    docidsList[0].push_back(1);
+    docidsList[0].push_back(50);
+    scoresList[0].push_back(1);
+    scoresList[0].push_back(5);
+
+    docidsList[1].push_back(2);
+    docidsList[1].push_back(50);
+    scoresList[1].push_back(1);
+    scoresList[1].push_back(5);
+
+    DocIdList docids;
+    ScoreList scores;
+    mergeZambeziResults(docidsList, scoresList, weightList, false, false, 2,
+                        docids, scores);
+
+    BOOST_REQUIRE_EQUAL(docids.size(), 3U);
+    BOOST_CHECK_EQUAL(docids[0], 1U);
+    BOOST_CHECK_EQUAL(docids[1], 2U);
+    BOOST_CHECK_EQUAL(docids[2], 50U);
+    BOOST_CHECK_EQUAL(scores[2], 10);
+
+    // the merge stops at the limit for prefix lists
+    mergeZambeziResults(docidsList, scoresList, weightList, false, true, 2,
+                        docids, scores);
+
+    BOOST_REQUIRE_EQUAL(docids.size(), 2U);
+    BOOST_CHECK_EQUAL(docids[0], 1U);
+    BOOST_CHECK_EQUAL(docids[1], 2U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()